@@ -0,0 +1,224 @@
+#include "benchmark/benchmark.h"
+
+#include "bramble.hpp"
+
+#include <string>
+#include <vector>
+
+static std::string make_line(size_t tokens)
+{
+    std::string retval;
+
+    for(size_t i=0; i < tokens; i++){
+
+        switch(i % 4){
+        default:
+        case 0:
+            retval.append("freq=868100000");
+            break;
+        case 1:
+            retval.append("--encoding=hex");
+            break;
+        case 2:
+            retval.append("buffer='make sure to send this message'");
+            break;
+        case 3:
+            retval.append("escaped\\ token");
+            break;
+        }
+
+        retval.push_back(' ');
+    }
+
+    return retval;
+}
+
+static void Argument_tokenize(benchmark::State& state)
+{
+    auto line = make_line(state.range(0));
+    std::vector<char> working(line.size() + 1);
+
+    for(auto _ : state){
+
+        Bramble::Argument args(line.c_str(), working.data(), working.size());
+
+        benchmark::DoNotOptimize(args.size());
+    }
+
+    state.SetBytesProcessed(int64_t(state.iterations()) * int64_t(line.size()));
+}
+BENCHMARK(Argument_tokenize)->Arg(1)->Arg(10)->Arg(100);
+
+static void Argument_index_access(benchmark::State& state)
+{
+    auto line = make_line(100);
+    std::vector<char> working(line.size() + 1);
+    std::vector<Bramble::StringView> index(state.range(0));
+
+    Bramble::Argument args(line.c_str(), working.data(), working.size(), index.data(), index.size());
+
+    for(auto _ : state){
+
+        for(size_t i=0; i < args.size(); i++){
+
+            benchmark::DoNotOptimize(args[i]);
+        }
+    }
+}
+BENCHMARK(Argument_index_access)->Arg(0)->Arg(100);
+
+static const char *named_keys[] = {"freq", "dbm", "sf", "bw", "cr", "power", "port", "missing"};
+
+static std::string make_named_line(size_t tokens)
+{
+    std::string retval("tx");
+
+    for(size_t i=0; i < tokens; i++){
+
+        retval.push_back(' ');
+        retval.append(named_keys[i % 7]);
+        retval.append(std::to_string(i / 7));
+        retval.append("=12");
+    }
+
+    return retval;
+}
+
+// look up every key by scanning the tokens with Decoder::name_eq()
+static void Argument_name_eq_lookup(benchmark::State& state)
+{
+    auto line = make_named_line(state.range(0));
+    std::vector<char> working(line.size() + 1);
+    std::vector<Bramble::StringView> index(state.range(0) + 1);
+
+    Bramble::Argument args(line.c_str(), working.data(), working.size(), index.data(), index.size());
+
+    for(auto _ : state){
+
+        for(auto key : named_keys){
+
+            Bramble::StringView found;
+
+            for(auto token : args){
+
+                Bramble::Decoder d(token);
+
+                if(d.name_eq(key)){
+
+                    found = d.named_value();
+                    break;
+                }
+            }
+
+            benchmark::DoNotOptimize(found);
+        }
+    }
+
+    state.SetItemsProcessed(int64_t(state.iterations()) * int64_t(sizeof(named_keys) / sizeof(*named_keys)));
+}
+BENCHMARK(Argument_name_eq_lookup)->Arg(4)->Arg(16)->Arg(64);
+
+// build a NamedArguments index then look up every key
+static void NamedArguments_lookup(benchmark::State& state)
+{
+    auto line = make_named_line(state.range(0));
+    std::vector<char> working(line.size() + 1);
+    std::vector<Bramble::StringView> index(state.range(0) + 1);
+
+    Bramble::Argument args(line.c_str(), working.data(), working.size(), index.data(), index.size());
+
+    for(auto _ : state){
+
+        Bramble::NamedArguments<64> named(args);
+
+        for(auto key : named_keys){
+
+            benchmark::DoNotOptimize(named.find(key));
+        }
+    }
+
+    state.SetItemsProcessed(int64_t(state.iterations()) * int64_t(sizeof(named_keys) / sizeof(*named_keys)));
+}
+BENCHMARK(NamedArguments_lookup)->Arg(4)->Arg(16)->Arg(64);
+
+struct Transmit {
+
+    uint32_t freq;
+    int8_t dbm;
+    uint8_t sf;
+    uint32_t bw;
+};
+
+using TransmitSchema = Bramble::Schema<Transmit>;
+
+static constexpr TransmitSchema::Field transmit_fields[] = {
+    TransmitSchema::required<Bramble::Range<uint32_t, 863000000, 870000000>, &Transmit::freq>("freq"),
+    TransmitSchema::optional<Bramble::Range<int8_t, -10, 20>, &Transmit::dbm>("dbm"),
+    TransmitSchema::required<Bramble::Range<uint8_t, 7, 12>, &Transmit::sf>("sf"),
+    TransmitSchema::optional<uint32_t, &Transmit::bw>("bw")
+};
+
+static constexpr auto transmit_schema = TransmitSchema::make(transmit_fields);
+
+static const char transmit_line[] = "tx freq=868100000 dbm=14 sf=7 bw=125000";
+
+// the decode loop handlers write by hand
+static void Argument_decode_loop(benchmark::State& state)
+{
+    std::vector<char> working(sizeof(transmit_line));
+    Bramble::StringView index[8];
+
+    Bramble::Argument args(transmit_line, working.data(), working.size(), index, 8);
+
+    for(auto _ : state){
+
+        Transmit t = {0, 0, 0, 0};
+        bool ok = true;
+
+        for(auto token : args){
+
+            Bramble::Decoder d(token);
+            Bramble::Decoder v(d.named_value());
+
+            if(d.name_eq("freq")){
+
+                ok = ok && v.get_uint32(t.freq) && (t.freq >= 863000000) && (t.freq <= 870000000);
+            }
+            else if(d.name_eq("dbm")){
+
+                ok = ok && v.get_int8(t.dbm) && (t.dbm >= -10) && (t.dbm <= 20);
+            }
+            else if(d.name_eq("sf")){
+
+                ok = ok && v.get_uint8(t.sf) && (t.sf >= 7) && (t.sf <= 12);
+            }
+            else if(d.name_eq("bw")){
+
+                ok = ok && v.get_uint32(t.bw);
+            }
+        }
+
+        benchmark::DoNotOptimize(ok);
+        benchmark::DoNotOptimize(t);
+    }
+}
+BENCHMARK(Argument_decode_loop);
+
+static void Schema_bind(benchmark::State& state)
+{
+    std::vector<char> working(sizeof(transmit_line));
+    Bramble::StringView index[8];
+
+    Bramble::Argument args(transmit_line, working.data(), working.size(), index, 8);
+
+    for(auto _ : state){
+
+        Transmit t = {0, 0, 0, 0};
+
+        benchmark::DoNotOptimize(transmit_schema.bind(args, t).ok());
+        benchmark::DoNotOptimize(t);
+    }
+}
+BENCHMARK(Schema_bind);
+
+BENCHMARK_MAIN();
@@ -0,0 +1,413 @@
+#include "benchmark/benchmark.h"
+
+#include "bramble.hpp"
+
+#include <string>
+#include <vector>
+#include <cstdio>
+#include <cstdlib>
+
+static std::vector<uint8_t> make_payload(size_t size)
+{
+    std::vector<uint8_t> retval(size);
+
+    for(size_t i=0; i < size; i++){
+
+        retval[i] = uint8_t((i * 131U) ^ (i >> 7));
+    }
+
+    return retval;
+}
+
+static std::string make_b64(const std::vector<uint8_t>& payload)
+{
+    std::vector<char> buffer(((payload.size() + 2U) / 3U) * 4U);
+    Bramble::BufferStream s(buffer.data(), buffer.size());
+
+    Bramble::Encoder(s).put_b64_string(payload.data(), payload.size());
+
+    return std::string(buffer.begin(), buffer.end());
+}
+
+// values spread over every digit length
+static std::vector<uint64_t> make_integers(size_t n)
+{
+    std::vector<uint64_t> retval(n);
+    uint64_t x = 88172645463325252ULL;
+
+    for(size_t i=0; i < n; i++){
+
+        x ^= x << 13;
+        x ^= x >> 7;
+        x ^= x << 17;
+
+        retval[i] = x >> (i % 64U);
+    }
+
+    return retval;
+}
+
+static void Encoder_put_int_uint32(benchmark::State& state)
+{
+    auto values = make_integers(256);
+    char buffer[256 * 11];
+
+    for(auto _ : state){
+
+        Bramble::BufferStream s(buffer, sizeof(buffer));
+        Bramble::Encoder e(s);
+
+        for(auto v : values){
+
+            (void)e.put_int(uint32_t(v));
+        }
+
+        benchmark::DoNotOptimize(buffer);
+        benchmark::ClobberMemory();
+    }
+
+    state.SetItemsProcessed(state.iterations() * values.size());
+}
+
+static void Encoder_put_int_int64(benchmark::State& state)
+{
+    auto values = make_integers(256);
+    char buffer[256 * 21];
+
+    for(auto _ : state){
+
+        Bramble::BufferStream s(buffer, sizeof(buffer));
+        Bramble::Encoder e(s);
+
+        for(size_t i=0; i < values.size(); i++){
+
+            (void)e.put_int(int64_t(values[i]) * (((i & 1U) != 0U) ? -1 : 1));
+        }
+
+        benchmark::DoNotOptimize(buffer);
+        benchmark::ClobberMemory();
+    }
+
+    state.SetItemsProcessed(state.iterations() * values.size());
+}
+
+static void Decoder_get_uint64(benchmark::State& state)
+{
+    auto values = make_integers(256);
+    std::vector<std::string> input;
+    uint64_t sum = 0;
+
+    for(auto v : values){
+
+        input.push_back(std::to_string(v));
+    }
+
+    for(auto _ : state){
+
+        for(auto& s : input){
+
+            uint64_t v = 0;
+
+            (void)Bramble::Decoder(s.c_str(), s.size()).get_uint64(v);
+
+            sum += v;
+        }
+
+        benchmark::DoNotOptimize(sum);
+    }
+
+    state.SetItemsProcessed(state.iterations() * input.size());
+}
+
+static void Decoder_get_int32(benchmark::State& state)
+{
+    auto values = make_integers(256);
+    std::vector<std::string> input;
+    int64_t sum = 0;
+
+    for(size_t i=0; i < values.size(); i++){
+
+        input.push_back(std::to_string(int32_t(values[i] >> 33) * (((i & 1U) != 0U) ? -1 : 1)));
+    }
+
+    for(auto _ : state){
+
+        for(auto& s : input){
+
+            int32_t v = 0;
+
+            (void)Bramble::Decoder(s.c_str(), s.size()).get_int32(v);
+
+            sum += v;
+        }
+
+        benchmark::DoNotOptimize(sum);
+    }
+
+    state.SetItemsProcessed(state.iterations() * input.size());
+}
+
+static std::vector<double> make_doubles(size_t n)
+{
+    std::vector<double> retval(n);
+    uint64_t x = 88172645463325252ULL;
+
+    for(size_t i=0; i < n; i++){
+
+        x ^= x << 13;
+        x ^= x >> 7;
+        x ^= x << 17;
+
+        // measurement-like values with a few decimal places
+        retval[i] = double(x % 100000000U) / double(1U << (i % 16U));
+    }
+
+    return retval;
+}
+
+static void Encoder_put_double(benchmark::State& state)
+{
+    auto values = make_doubles(256);
+    char buffer[256 * 32];
+
+    for(auto _ : state){
+
+        Bramble::BufferStream s(buffer, sizeof(buffer));
+        Bramble::Encoder e(s);
+
+        for(auto v : values){
+
+            (void)e.put_double(v);
+        }
+
+        benchmark::DoNotOptimize(buffer);
+        benchmark::ClobberMemory();
+    }
+
+    state.SetItemsProcessed(state.iterations() * values.size());
+}
+
+static void snprintf_double(benchmark::State& state)
+{
+    auto values = make_doubles(256);
+    char buffer[32];
+
+    for(auto _ : state){
+
+        for(auto v : values){
+
+            benchmark::DoNotOptimize(snprintf(buffer, sizeof(buffer), "%.17g", v));
+        }
+    }
+
+    state.SetItemsProcessed(state.iterations() * values.size());
+}
+
+static void Decoder_get_double(benchmark::State& state)
+{
+    auto values = make_doubles(256);
+    std::vector<std::string> input;
+    double sum = 0;
+
+    for(auto v : values){
+
+        char buffer[32];
+        Bramble::BufferStream s(buffer, sizeof(buffer));
+
+        Bramble::Encoder(s).put_double(v);
+
+        input.push_back(std::string(buffer, s.tell()));
+    }
+
+    for(auto _ : state){
+
+        for(auto& s : input){
+
+            double v = 0;
+
+            (void)Bramble::Decoder(s.c_str(), s.size()).get_double(v);
+
+            sum += v;
+        }
+
+        benchmark::DoNotOptimize(sum);
+    }
+
+    state.SetItemsProcessed(state.iterations() * input.size());
+}
+
+static void strtod_double(benchmark::State& state)
+{
+    auto values = make_doubles(256);
+    std::vector<std::string> input;
+    double sum = 0;
+
+    for(auto v : values){
+
+        char buffer[32];
+
+        (void)snprintf(buffer, sizeof(buffer), "%.17g", v);
+
+        input.push_back(buffer);
+    }
+
+    for(auto _ : state){
+
+        for(auto& s : input){
+
+            sum += strtod(s.c_str(), nullptr);
+        }
+
+        benchmark::DoNotOptimize(sum);
+    }
+
+    state.SetItemsProcessed(state.iterations() * input.size());
+}
+
+static const char *classify_input[] = {
+    "true", "868100000", "-14", "0x1f", "1.5e3", "deadbeef", "QUJDRA==", "hello", "18446744073709551616", "0b1010"
+};
+
+// what a handler does to find out what kind of value it was given
+static void Decoder_getters(benchmark::State& state)
+{
+    for(auto _ : state){
+
+        for(auto s : classify_input){
+
+            Bramble::Decoder d(s);
+            bool b;
+            uint64_t u;
+            int64_t i;
+            double f;
+
+            benchmark::DoNotOptimize(d.get_bool(b));
+            benchmark::DoNotOptimize(d.get_uint64(u));
+            benchmark::DoNotOptimize(d.get_int64(i));
+            benchmark::DoNotOptimize(d.get_double(f));
+            benchmark::DoNotOptimize(d.is_hex_string());
+            benchmark::DoNotOptimize(d.is_b64_string());
+        }
+    }
+
+    state.SetItemsProcessed(state.iterations() * (sizeof(classify_input) / sizeof(*classify_input)));
+}
+
+static void Decoder_classify(benchmark::State& state)
+{
+    for(auto _ : state){
+
+        for(auto s : classify_input){
+
+            benchmark::DoNotOptimize(Bramble::Decoder(s).classify());
+        }
+    }
+
+    state.SetItemsProcessed(state.iterations() * (sizeof(classify_input) / sizeof(*classify_input)));
+}
+
+static void Encoder_put_hex_string(benchmark::State& state)
+{
+    auto payload = make_payload(state.range(0));
+    std::vector<char> buffer(payload.size() * 2U);
+
+    for(auto _ : state){
+
+        Bramble::BufferStream s(buffer.data(), buffer.size());
+
+        Bramble::Encoder(s).put_hex_string(payload.data(), payload.size());
+
+        benchmark::DoNotOptimize(buffer.data());
+        benchmark::ClobberMemory();
+    }
+
+    state.SetBytesProcessed(state.iterations() * state.range(0));
+}
+
+static void Decoder_get_hex_string(benchmark::State& state)
+{
+    auto payload = make_payload(state.range(0));
+    std::vector<char> input(payload.size() * 2U);
+    std::vector<uint8_t> output(payload.size());
+
+    Bramble::BufferStream s(input.data(), input.size());
+
+    Bramble::Encoder(s).put_hex_string(payload.data(), payload.size());
+
+    for(auto _ : state){
+
+        Bramble::Decoder d(input.data(), input.size());
+
+        benchmark::DoNotOptimize(d.get_hex_string(output.data(), output.size()));
+        benchmark::ClobberMemory();
+    }
+
+    state.SetBytesProcessed(state.iterations() * state.range(0));
+}
+
+static void Encoder_put_b64_string(benchmark::State& state)
+{
+    auto payload = make_payload(state.range(0));
+    std::vector<char> buffer(((payload.size() + 2U) / 3U) * 4U);
+
+    for(auto _ : state){
+
+        Bramble::BufferStream s(buffer.data(), buffer.size());
+
+        Bramble::Encoder(s).put_b64_string(payload.data(), payload.size());
+
+        benchmark::DoNotOptimize(buffer.data());
+        benchmark::ClobberMemory();
+    }
+
+    state.SetBytesProcessed(state.iterations() * state.range(0));
+}
+
+static void Decoder_get_b64_string(benchmark::State& state)
+{
+    auto payload = make_payload(state.range(0));
+    auto input = make_b64(payload);
+    std::vector<uint8_t> output(payload.size());
+
+    for(auto _ : state){
+
+        Bramble::Decoder d(input.c_str(), input.size());
+
+        benchmark::DoNotOptimize(d.get_b64_string(output.data(), output.size()));
+        benchmark::ClobberMemory();
+    }
+
+    state.SetBytesProcessed(state.iterations() * state.range(0));
+}
+
+static void Decoder_is_b64_string(benchmark::State& state)
+{
+    auto input = make_b64(make_payload(state.range(0)));
+
+    for(auto _ : state){
+
+        Bramble::Decoder d(input.c_str(), input.size());
+
+        benchmark::DoNotOptimize(d.is_b64_string());
+    }
+
+    state.SetBytesProcessed(state.iterations() * state.range(0));
+}
+
+BENCHMARK(Encoder_put_int_uint32);
+BENCHMARK(Encoder_put_int_int64);
+BENCHMARK(Decoder_get_uint64);
+BENCHMARK(Decoder_get_int32);
+BENCHMARK(Encoder_put_double);
+BENCHMARK(snprintf_double);
+BENCHMARK(Decoder_get_double);
+BENCHMARK(strtod_double);
+BENCHMARK(Decoder_getters);
+BENCHMARK(Decoder_classify);
+BENCHMARK(Encoder_put_hex_string)->RangeMultiplier(8)->Range(16, 1 << 20);
+BENCHMARK(Decoder_get_hex_string)->RangeMultiplier(8)->Range(16, 1 << 20);
+BENCHMARK(Encoder_put_b64_string)->RangeMultiplier(8)->Range(16, 1 << 20);
+BENCHMARK(Decoder_get_b64_string)->RangeMultiplier(8)->Range(16, 1 << 20);
+BENCHMARK(Decoder_is_b64_string)->RangeMultiplier(8)->Range(16, 1 << 20);
+
+BENCHMARK_MAIN();
@@ -0,0 +1,97 @@
+#include "benchmark/benchmark.h"
+
+#include "bramble.hpp"
+
+#include <string>
+#include <vector>
+
+static void on_option(Bramble::GetOpt& self)
+{
+    benchmark::DoNotOptimize(self.value());
+}
+
+static constexpr Bramble::GetOpt::Option options[] = {
+    {"freq", 'f', Bramble::GetOpt::Value::Required, on_option},
+    {"power", 'p', Bramble::GetOpt::Value::Required, on_option},
+    {"sf", 's', Bramble::GetOpt::Value::Required, on_option},
+    {"bw", 'b', Bramble::GetOpt::Value::Required, on_option},
+    {"encoding", 'e', Bramble::GetOpt::Value::Required, on_option},
+    {"crc", 'c', Bramble::GetOpt::Value::None, on_option},
+    {"verbose", 'v', Bramble::GetOpt::Value::None, on_option},
+    {"confirmed", 'k', Bramble::GetOpt::Value::Optional, on_option}
+};
+
+static constexpr Bramble::GetOpt::Index<sizeof(options) / sizeof(*options)> option_index(options);
+
+static const char line[] = "--freq=868100000 -v --power 14 -s 7 --bw=125000 --crc --encoding=hex -k";
+
+static void GetOpt_parse_table(benchmark::State& state)
+{
+    std::vector<char> working(sizeof(line));
+    Bramble::StringView tokens[16];
+
+    Bramble::Argument args(line, working.data(), working.size(), tokens, 16);
+
+    for(auto _ : state){
+
+        Bramble::GetOpt parser(args.begin(), args.end(), options, sizeof(options) / sizeof(*options));
+
+        while(!parser.finished()){
+
+            parser.next();
+        }
+
+        benchmark::DoNotOptimize(parser.unknown());
+    }
+
+    state.SetItemsProcessed(int64_t(state.iterations()) * int64_t(args.size()));
+}
+BENCHMARK(GetOpt_parse_table);
+
+static void GetOpt_parse_index(benchmark::State& state)
+{
+    std::vector<char> working(sizeof(line));
+    Bramble::StringView tokens[16];
+
+    Bramble::Argument args(line, working.data(), working.size(), tokens, 16);
+
+    for(auto _ : state){
+
+        Bramble::GetOpt parser(args.begin(), args.end(), option_index);
+
+        while(!parser.finished()){
+
+            parser.next();
+        }
+
+        benchmark::DoNotOptimize(parser.unknown());
+    }
+
+    state.SetItemsProcessed(int64_t(state.iterations()) * int64_t(args.size()));
+}
+BENCHMARK(GetOpt_parse_index);
+
+// tokenize and parse, as a handler would for every command
+static void GetOpt_tokenize_and_parse(benchmark::State& state)
+{
+    std::vector<char> working(sizeof(line));
+    Bramble::StringView tokens[16];
+
+    for(auto _ : state){
+
+        Bramble::Argument args(line, working.data(), working.size(), tokens, 16);
+        Bramble::GetOpt parser(args.begin(), args.end(), option_index);
+
+        while(!parser.finished()){
+
+            parser.next();
+        }
+
+        benchmark::DoNotOptimize(parser.unknown());
+    }
+
+    state.SetBytesProcessed(int64_t(state.iterations()) * int64_t(sizeof(line) - 1U));
+}
+BENCHMARK(GetOpt_tokenize_and_parse);
+
+BENCHMARK_MAIN();
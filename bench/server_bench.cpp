@@ -0,0 +1,127 @@
+#include "benchmark/benchmark.h"
+
+#include "bramble.hpp"
+
+#include <string>
+
+static void noop(Bramble::Server::Command&, const Bramble::Argument&)
+{
+}
+
+static void echo(Bramble::Server::Command& cmd, const Bramble::Argument& args)
+{
+    Bramble::Encoder encoder(cmd.ack_with_arg());
+
+    for(auto iter = args.begin() + 1; iter != args.end(); ++iter){
+
+        encoder.put_string(*iter).space();
+    }
+}
+
+struct Transmit {
+
+    uint32_t freq;
+    int8_t dbm;
+    uint8_t sf;
+};
+
+using TransmitSchema = Bramble::Schema<Transmit>;
+
+static constexpr TransmitSchema::Field transmit_fields[] = {
+    TransmitSchema::required<Bramble::Range<uint32_t, 863000000, 870000000>, &Transmit::freq>("freq"),
+    TransmitSchema::optional<Bramble::Range<int8_t, -10, 20>, &Transmit::dbm>("dbm"),
+    TransmitSchema::required<Bramble::Range<uint8_t, 7, 12>, &Transmit::sf>("sf")
+};
+
+static constexpr auto transmit_schema = TransmitSchema::make(transmit_fields);
+
+static void transmit(Bramble::Server::Command& cmd, const Bramble::Argument& args)
+{
+    Transmit t = {0, 14, 0};
+
+    if(transmit_schema.bind(cmd, args, t)){
+
+        cmd.ack(t.freq);
+    }
+}
+
+static constexpr Bramble::Registry::Entry commands[] = {
+    {"noop", noop},
+    {"echo", echo},
+    {"tx", transmit}
+};
+
+static constexpr auto registry = Bramble::Registry::make(commands);
+
+class Host : public Bramble::Server::Host {
+public:
+
+    size_t output = 0;
+
+    bool call(Bramble::Server::Command& cmd, const Bramble::Argument& args)
+    {
+        return registry.call(cmd, args);
+    }
+
+    void write(const char *, size_t size)
+    {
+        output += size;
+    }
+};
+
+static std::string repeat(const char *line, size_t n)
+{
+    std::string retval;
+
+    for(size_t i=0; i < n; i++){
+
+        retval.append(line);
+    }
+
+    return retval;
+}
+
+static void process_lines(benchmark::State& state, const char *line)
+{
+    const size_t lines = 64;
+    auto input = repeat(line, lines);
+
+    Host host;
+    Bramble::StaticServer<128, 16> server(host);
+
+    for(auto _ : state){
+
+        server.process(input.data(), input.size());
+    }
+
+    benchmark::DoNotOptimize(host.output);
+
+    state.SetItemsProcessed(int64_t(state.iterations()) * int64_t(lines));
+    state.SetBytesProcessed(int64_t(state.iterations()) * int64_t(input.size()));
+}
+
+static void Server_process_noop(benchmark::State& state)
+{
+    process_lines(state, "noop\r");
+}
+BENCHMARK(Server_process_noop);
+
+static void Server_process_echo(benchmark::State& state)
+{
+    process_lines(state, "echo freq=868100000 'buffer=make sure to send this message' --encoding=hex\r");
+}
+BENCHMARK(Server_process_echo);
+
+static void Server_process_schema(benchmark::State& state)
+{
+    process_lines(state, "tx freq=868100000 dbm=14 sf=7\r");
+}
+BENCHMARK(Server_process_schema);
+
+static void Server_process_unknown(benchmark::State& state)
+{
+    process_lines(state, "unknown command with arguments\r");
+}
+BENCHMARK(Server_process_unknown);
+
+BENCHMARK_MAIN();
@@ -2,60 +2,78 @@
 
 #include <cstdio>
 #include <string>
-#include <vector>
 #include <deque>
-#include <list>
+#include <memory>
 #include <boost/asio.hpp>
 
 #define LOG(...) do{printf(__VA_ARGS__);printf("\n");fflush(stdout);}while(0);
 
-class Host : public Bramble::Server::Host {
+static void echo(Bramble::Server::Command& cmd, const Bramble::Argument& args)
+{
+    Bramble::Encoder encoder(cmd.ack_with_arg());
+
+    for(auto iter : args){
+
+        encoder.put_string(iter);
+        encoder.space();
+    }
+}
+
+static constexpr Bramble::Registry::Entry commands[] = {
+    {"echo", echo}
+};
+
+// shared by every session
+static constexpr auto registry = Bramble::Registry::make(commands);
+
+using Pool = Bramble::SessionPool<4>;
+
+class Connection : public Bramble::Server::Host, public std::enable_shared_from_this<Connection> {
 public:
 
-    using handler_fn = std::function<void(Bramble::Server::Command&, const Bramble::Argument&)>;
+    using tcp = boost::asio::ip::tcp;
 
-    Host(boost::asio::io_context& ctx, uint16_t ip_port)
+    Connection(tcp::socket socket, Pool& pool)
         :
-        endpoint(tcp::v4(), ip_port),
-        acceptor(ctx, endpoint),
-        socket(ctx),
-        cli_server(nullptr)
+        socket(std::move(socket)),
+        pool(pool),
+        cli_server(pool.open(*this))
     {
         input.fill(0);
-        acceptor.set_option(tcp::acceptor::reuse_address(true));
-        do_accept();
     }
 
-    void add_handler(const char *name, const handler_fn& handler)
+    ~Connection()
     {
-        list.emplace_back(name, handler);
+        if(cli_server != nullptr){
+
+            pool.close(*cli_server);
+        }
     }
 
-    bool call(Bramble::Server::Command& self, const Bramble::Argument& args)
+    void start()
     {
-        bool retval = false;
+        if(cli_server != nullptr){
 
-        for(auto iter = list.begin(); iter != list.end(); ++iter){
+            LOG("start: session %u", (unsigned)cli_server->session())
 
-            if(Bramble::StringView(iter->name.c_str()) == self.name()){
-
-                iter->handler(self, args);
-                retval = true;
-                break;
-            }
+            do_socket_read();
         }
+        else{
 
-        return retval;
+            LOG("start: no sessions available, closing...")
+        }
     }
 
-    void put_char(char c)
+    bool call(Bramble::Server::Command& self, const Bramble::Argument& args)
     {
-        output += c;
+        return registry.call(self, args);
+    }
 
-        if((c == '\n') || (output.size() > 512)){
+    void write(const char *buffer, size_t size)
+    {
+        output.append(buffer, size);
 
-            drain();
-        }
+        drain();
     }
 
     void drain()
@@ -82,118 +100,118 @@ public:
         output.clear();
     }
 
-    uint16_t get_port() const
-    {
-        return acceptor.local_endpoint().port();
-    }
-
-    void set_server(Bramble::Server& server)
-    {
-        cli_server = &server;
-    }
-
 private:
 
-    struct Record {
-
-        Record(const char *name, const handler_fn& handler)
-            :
-            name(name),
-            handler(handler)
-        {}
-
-        std::string name;
-        handler_fn handler;
-    };
-
-    std::list<Record> list;
-
     std::deque<std::string> send_queue;
 
-    using tcp = boost::asio::ip::tcp;
-
     std::string output;
 
-    tcp::endpoint endpoint;
-    tcp::acceptor acceptor;
     tcp::socket socket;
 
     std::array<char, 1024> input;
 
+    Pool& pool;
     Bramble::Server *cli_server;
 
-    void do_accept()
+    void do_socket_read()
     {
-        LOG("%u", (unsigned)get_port())
+        auto self = shared_from_this();
 
-        acceptor.async_accept(
-            [this](std::error_code ec, tcp::socket s)
+        socket.async_read_some(
+            boost::asio::buffer(input.data(), input.size()),
+            [this, self](std::error_code ec, size_t size)
             {
                 if(!ec){
 
-                    LOG("do_accept: accepted connection")
+                    LOG("do_socket_read: session %u: %uB", (unsigned)cli_server->session(), (unsigned)size)
 
-                    socket = std::move(s);
+                    cli_server->process((const char *)input.data(), size);
 
                     do_socket_read();
                 }
                 else{
 
-                    LOG("do_accept: acceptor error, shutting down")
+                    LOG("do_socket_read: session %u: socket error, closing...", (unsigned)cli_server->session())
+
+                    socket.close();
                 }
             }
         );
     }
 
-    void do_socket_read()
+    void do_socket_write()
     {
-        socket.async_read_some(
-            boost::asio::buffer(input.data(), input.size()),
-            [this](std::error_code ec, size_t size)
+        auto self = shared_from_this();
+
+        boost::asio::async_write(socket,
+            boost::asio::buffer(send_queue.front().data(), send_queue.front().size()),
+            [this, self](std::error_code ec, size_t size)
             {
                 if(!ec){
 
-                    LOG("do_socket_read: %uB", (unsigned)size)
+                    LOG("do_socket_write: wrote %u bytes", (unsigned)size)
 
-                    if(this->cli_server != nullptr){
+                    send_queue.pop_front();
 
-                        this->cli_server->process((const char *)input.data(), size);
-                    }
+                    if(!send_queue.empty()){
 
-                    do_socket_read();
+                        do_socket_write();
+                    }
                 }
                 else{
 
-                    LOG("do_socket_read: socket error, closing...")
-
                     socket.close();
-
-                    do_accept();
                 }
             }
         );
     }
+};
 
-    void do_socket_write()
+class Listener {
+public:
+
+    using tcp = boost::asio::ip::tcp;
+
+    Listener(boost::asio::io_context& ctx, uint16_t ip_port)
+        :
+        endpoint(tcp::v4(), ip_port),
+        acceptor(ctx, endpoint)
     {
-        boost::asio::async_write(socket,
-            boost::asio::buffer(send_queue.front().data(), send_queue.front().size()),
-            [this](std::error_code ec, size_t size)
+        acceptor.set_option(tcp::acceptor::reuse_address(true));
+
+        LOG("%u", (unsigned)get_port())
+
+        do_accept();
+    }
+
+    uint16_t get_port() const
+    {
+        return acceptor.local_endpoint().port();
+    }
+
+private:
+
+    tcp::endpoint endpoint;
+    tcp::acceptor acceptor;
+
+    Pool pool;
+
+    void do_accept()
+    {
+        acceptor.async_accept(
+            [this](std::error_code ec, tcp::socket s)
             {
                 if(!ec){
 
-                    LOG("do_socket_write: wrote %u bytes", (unsigned)size)
-
-                    send_queue.pop_front();
+                    LOG("do_accept: accepted connection")
 
-                    if(!send_queue.empty()){
+                    std::make_shared<Connection>(std::move(s), pool)->start();
 
-                        do_socket_write();
-                    }
+                    do_accept();
                 }
                 else{
 
-                    socket.close();
+                    LOG("do_accept: acceptor error, shutting down")
                 }
             }
         );
@@ -203,20 +221,7 @@ private:
 int main(int, char **)
 {
     boost::asio::io_context ctx;
-    Host host(ctx, 0);
-    Bramble::Server server(host);
-    host.set_server(server);
-
-    host.add_handler("echo", [](Bramble::Server::Command& cmd, const Bramble::Argument& args){
-
-        Bramble::Encoder encoder(cmd.ack_with_arg());
-
-        for(auto iter : args){
-
-            encoder.put_string(iter);
-            encoder.space();
-        }
-    });
+    Listener listener(ctx, 0);
 
     for(;;){
 
@@ -25,5 +25,13 @@
 
 #include "bramble_version.hpp"
 #include "bramble_server.hpp"
+#include "bramble_static_server.hpp"
+#include "bramble_registry.hpp"
+#include "bramble_session_pool.hpp"
+#include "bramble_line_queue.hpp"
+#include "bramble_event_queue.hpp"
+#include "bramble_task.hpp"
+#include "bramble_named_arguments.hpp"
+#include "bramble_schema.hpp"
 
 #endif
@@ -27,6 +27,9 @@
 #include "bramble_buffer_stream.hpp"
 
 #include <cstddef>
+#include <cstring>
+#include <iterator>
+#include <algorithm>
 
 namespace Bramble {
 
@@ -47,67 +50,95 @@ namespace Bramble {
          * Consequence of a too-small working buffer is that not all tokens will accounted for
          * and accessible.
          *
+         * An optional index table can be supplied to record the position and size of each token
+         * as it is found. This makes random access and iteration O(1) per step. If there are more tokens
+         * than the index can hold, the container falls back to scanning the working buffer.
+         *
          * @param[in] s         null-terminated input buffer
          * @param[in] working   working buffer (can be same memory as s)
          * @param[in] max       maximum size of working buffer
+         * @param[in] index     index table (optional)
+         * @param[in] index_max number of entries in index table
          *
          * */
-        Argument(const char *s, char *working, size_t max)
+        Argument(const char *s, char *working, size_t max, StringView *index = nullptr, size_t index_max = 0)
             :
             buffer(working),
             max(0),
-            count(0)
+            count(0),
+            index(index),
+            index_max(index_max)
         {
-            StringView input(s);
             BufferStream output(working, max);
 
             size_t token_size = 0;
 
-            bool escape = false;
             bool quote = false;
 
-            char quote_char;
+            char quote_char = 0;
 
-            for(auto iter = input.begin(); iter != input.end(); ++iter){
+            auto iter = (s != nullptr) ? s : "";
 
-                if(escape){
+            while(*iter != 0){
 
-                    escape = false;
-                    put_char(output, *iter);
-                }
-                else if(quote){
+                if(quote){
 
-                    if(quote_char == *iter){
+                    auto close = strchr(iter, quote_char);
+                    auto n = (close != nullptr) ? size_t(close - iter) : strlen(iter);
 
-                        quote = false;
-                    }
-                    else{
+                    put_string(output, iter, n);
+                    token_size += n;
+                    iter += n;
+
+                    if(close != nullptr){
 
-                        put_char(output, *iter);
-                        token_size++;
+                        quote = false;
+                        iter++;
                     }
                 }
-                else if(*iter == '\\'){
+                else{
 
-                    escape = true;
-                }
-                else if(*iter == ' '){
+                    // copy everything up to the next character that needs a decision
+                    auto n = strcspn(iter, " \\'\"");
 
-                    if(token_size > 0){
+                    put_string(output, iter, n);
+                    token_size += n;
+                    iter += n;
 
-                        put_char(output, 0);
-                        token_size = 0;
-                    }
-                }
-                else if((*iter == '\'') || (*iter == '"')){
+                    switch(*iter){
+                    case '\\':
 
-                    quote_char = *iter;
-                    quote = true;
-                }
-                else{
+                        iter++;
+
+                        if(*iter != 0){
 
-                    put_char(output, *iter);
-                    token_size++;
+                            put_char(output, *iter);
+                            iter++;
+                        }
+                        break;
+
+                    case ' ':
+
+                        if(token_size > 0){
+
+                            put_char(output, 0);
+                            token_size = 0;
+                        }
+
+                        iter++;
+                        break;
+
+                    case '\'':
+                    case '"':
+
+                        quote_char = *iter;
+                        quote = true;
+                        iter++;
+                        break;
+
+                    default:
+                        break;
+                    }
                 }
             }
 
@@ -131,13 +162,17 @@ namespace Bramble {
          * @param[in] argv      buffer of tokens
          * @param[in] working   working buffer
          * @param[in] max       maximum size of working buffer
+         * @param[in] index     index table (optional)
+         * @param[in] index_max number of entries in index table
          *
          * */
-        Argument(size_t argc, const char **argv, char *working, size_t max)
+        Argument(size_t argc, const char **argv, char *working, size_t max, StringView *index = nullptr, size_t index_max = 0)
             :
             buffer(working),
             max(0),
-            count(argc)
+            count(0),
+            index(index),
+            index_max(index_max)
         {
             BufferStream output(working, max);
 
@@ -162,23 +197,33 @@ namespace Bramble {
         class iterator {
         public:
 
-            using iterator_category = std::forward_iterator_tag;
+            using iterator_category = std::random_access_iterator_tag;
             using difference_type   = std::ptrdiff_t;
             using value_type        = StringView;
             using pointer           = const StringView*;
             using reference         = const StringView&;
 
+            iterator()
+                :
+                arg(nullptr),
+                pos(0),
+                offset(0)
+            {
+            }
+
             iterator(const Argument& arg)
                 :
                 arg(&arg),
+                pos(0),
                 offset(0),
-                v(arg.buffer)
+                v((arg.indexed() && (arg.count > 0)) ? arg.index[0] : StringView(arg.buffer))
             {
             }
 
             iterator(const Argument& arg, bool)
                 :
                 arg(&arg),
+                pos(arg.count),
                 offset(arg.max),
                 v(arg.buffer, 0)
             {
@@ -188,17 +233,18 @@ namespace Bramble {
             {
                 if(offset < arg->max){
 
-                    offset += v.size();
-                    offset++;
-                }
+                    if(arg->indexed()){
 
-                if(offset < arg->max){
+                        seek(pos + 1);
+                    }
+                    else{
 
-                    v = StringView(arg->buffer + offset);
-                }
-                else{
+                        pos++;
+                        offset += v.size();
+                        offset++;
 
-                    v = StringView();
+                        v = (offset < arg->max) ? StringView(arg->buffer + offset) : StringView();
+                    }
                 }
 
                 return *this;
@@ -211,18 +257,67 @@ namespace Bramble {
                 return retval;
             }
 
-            iterator operator+(size_t n) const
+            iterator& operator--()
+            {
+                return *this -= 1;
+            }
+
+            iterator operator--(int)
             {
                 auto retval = *this;
+                --(*this);
+                return retval;
+            }
+
+            iterator& operator+=(difference_type n)
+            {
+                if(arg->indexed()){
+
+                    seek(pos + n);
+                }
+                else if(n >= 0){
 
-                for(size_t i=0; i < n; ++i){
+                    for(difference_type i=0; i < n; ++i){
 
-                    ++retval;
+                        ++(*this);
+                    }
                 }
+                else{
+
+                    // no way to walk backwards without an index
+                    auto target = std::max(difference_type(pos) + n, difference_type(0));
+
+                    *this = iterator(*arg);
+                    *this += target;
+                }
+
+                return *this;
+            }
+
+            iterator& operator-=(difference_type n)
+            {
+                return *this += -n;
+            }
+
+            iterator operator+(difference_type n) const
+            {
+                auto retval = *this;
+                retval += n;
+                return retval;
+            }
 
+            iterator operator-(difference_type n) const
+            {
+                auto retval = *this;
+                retval -= n;
                 return retval;
             }
 
+            difference_type operator-(const iterator& other) const
+            {
+                return difference_type(pos) - difference_type(other.pos);
+            }
+
             StringView operator*() const
             {
                 return v;
@@ -233,23 +328,63 @@ namespace Bramble {
                 return &v;
             }
 
+            StringView operator[](difference_type n) const
+            {
+                return *(*this + n);
+            }
+
             bool operator==(const iterator& other) const
             {
-                //return v == other.v;
                 return offset == other.offset;
             }
 
             bool operator!=(const iterator& other) const
             {
-                //return v != other.v;
                 return offset != other.offset;
             }
 
+            bool operator<(const iterator& other) const
+            {
+                return pos < other.pos;
+            }
+
+            bool operator>(const iterator& other) const
+            {
+                return pos > other.pos;
+            }
+
+            bool operator<=(const iterator& other) const
+            {
+                return pos <= other.pos;
+            }
+
+            bool operator>=(const iterator& other) const
+            {
+                return pos >= other.pos;
+            }
+
         private:
 
             const Argument *arg;
+            size_t pos;
             size_t offset;
             StringView v;
+
+            void seek(size_t n)
+            {
+                if(n < arg->count){
+
+                    pos = n;
+                    v = arg->index[n];
+                    offset = size_t(v.data() - arg->buffer);
+                }
+                else{
+
+                    pos = arg->count;
+                    offset = arg->max;
+                    v = StringView();
+                }
+            }
         };
 
         typedef iterator const_iterator;
@@ -287,7 +422,18 @@ namespace Bramble {
          * */
         StringView front() const
         {
-            return StringView(buffer);
+            return (indexed() && (count > 0)) ? index[0] : StringView(buffer);
+        }
+
+        /** Accesses the token at position n
+         *
+         * This is O(1) when the container was created with a large enough index table,
+         * otherwise the working buffer is scanned from the beginning.
+         *
+         * */
+        StringView operator[](size_t n) const
+        {
+            return *(begin() + n);
         }
 
         /** Removes the first token from the container
@@ -303,6 +449,12 @@ namespace Bramble {
             max -=  retval.size();
             max--;
 
+            if(indexed()){
+
+                index++;
+                index_max--;
+            }
+
             return retval;
         }
 
@@ -334,12 +486,38 @@ namespace Bramble {
         size_t max;
         size_t count;
 
+        StringView *index;
+        size_t index_max;
+
+        bool indexed() const
+        {
+            return index != nullptr;
+        }
+
+        void put_string(BufferStream& s, const char *value, size_t size)
+        {
+            (void)s.write(value, size);
+        }
+
         void put_char(BufferStream& s, char c)
         {
             auto n = s.write(&c, 1);
 
             if((c == 0) && (n > 0)){
 
+                if(indexed()){
+
+                    if(count < index_max){
+
+                        index[count] = StringView(buffer + max, s.tell() - max - 1);
+                    }
+                    else{
+
+                        // too many tokens to index
+                        index = nullptr;
+                    }
+                }
+
                 count++;
                 max = s.tell();
             }
@@ -71,8 +71,9 @@ namespace Bramble {
 
             if(write_ptr != nullptr){
 
+                // source may overlap when rewriting a buffer in place
                 retval = std::min(max - pos, size);
-                (void)memcpy(&write_ptr[pos], buffer, retval);
+                (void)memmove(&write_ptr[pos], buffer, retval);
                 pos += retval;
             }
 
@@ -25,8 +25,14 @@
 
 #include "bramble_string_view.hpp"
 #include "bramble_buffer_stream.hpp"
+#include "bramble_float_format.hpp"
 
 #include <cctype>
+#include <cstdint>
+#include <cstring>
+#include <limits>
+#include <algorithm>
+#include <utility>
 
 namespace Bramble {
 
@@ -37,6 +43,8 @@ namespace Bramble {
     public:
 
         Decoder()
+            :
+            eq(StringView::npos)
         {
         }
 
@@ -49,6 +57,7 @@ namespace Bramble {
             :
             input(s, strlen(s))
         {
+            analyse();
         }
 
         /** decode a string
@@ -61,6 +70,7 @@ namespace Bramble {
             :
             input(s, size)
         {
+            analyse();
         }
 
         /** decode a string view
@@ -72,25 +82,30 @@ namespace Bramble {
             :
             input(v)
         {
+            analyse();
         }
 
         Decoder(const Decoder& other)
             :
-            input(other.input)
+            input(other.input),
+            stripped(other.stripped),
+            eq(other.eq)
         {
         }
 
         const Decoder& operator=(const Decoder& other)
         {
             input = other.input;
+            stripped = other.stripped;
+            eq = other.eq;
             return *this;
         }
 
         void swap(Decoder& other)
         {
-            auto tmp = other.input;
-            other.input = input;
-            input = tmp;
+            input.swap(other.input);
+            stripped.swap(other.stripped);
+            std::swap(eq, other.eq);
         }
 
         /** Test if input is a named argument
@@ -101,7 +116,7 @@ namespace Bramble {
          * */
         bool is_named() const
         {
-            return input.find_first_of('=') != input.npos;
+            return eq_offset() != StringView::npos;
         }
 
         /** Get the name of a named argument
@@ -111,7 +126,7 @@ namespace Bramble {
          * */
         StringView name() const
         {
-            return is_named() ? strip(input).substr(0, strip(input).find_first_of('=')) : StringView();
+            return is_named() ? stripped.substr(0, eq_offset() - size_t(stripped.data() - input.data())) : StringView();
         }
 
         /** Get the value associated with name()
@@ -121,7 +136,7 @@ namespace Bramble {
          * */
         StringView named_value() const
         {
-            return input.substr(input.find_first_of('=')+1);
+            return input.substr(eq_offset()+1);
         }
 
         /** Get the input value as-is
@@ -173,29 +188,10 @@ namespace Bramble {
          * */
         bool is_int() const
         {
-            bool retval = false;
-
-            auto tmp = strip(input);
-
-            if(!tmp.empty()){
-
-                if(tmp.front() == '-'){
-
-                    tmp.remove_prefix(1);
-                }
-
-                retval = true;
-
-                for(auto iter = tmp.begin(); (iter != tmp.end()) && retval; ++iter){
-
-                    if((*iter < '0') || (*iter > '9')){
-
-                        retval = false;
-                    }
-                }
-            }
+            int64_t i;
+            uint64_t u;
 
-            return retval;
+            return get_int64(i) || get_uint64(u);
         }
 
         /** Test if value() is unsigned integer
@@ -206,24 +202,9 @@ namespace Bramble {
          * */
         bool is_unsigned() const
         {
-            bool retval = false;
-
-            auto tmp = strip(input);
-
-            if(!tmp.empty()){
-
-                retval = true;
-
-                for(auto iter = tmp.begin(); (iter != tmp.end()) && retval; ++iter){
-
-                    if((*iter < '0') || (*iter > '9')){
-
-                        retval = false;
-                    }
-                }
-            }
+            uint64_t u;
 
-            return retval;
+            return get_uint64(u);
         }
 
         /** Remove whitespace from before and after non-whitespace characters
@@ -282,6 +263,105 @@ namespace Bramble {
             return get_b64_string(nullptr, 0) > 0;
         }
 
+        /** Flags returned by classify()
+         *
+         * */
+        enum Kind : unsigned {
+
+            Bool = 1U,          ///< get_bool() would succeed
+            Unsigned = 2U,      ///< get_uint64() would succeed
+            Signed = 4U,        ///< get_int64() would succeed
+            Float = 8U,         ///< get_double() would succeed
+            Hex = 16U,          ///< is_hex_string() is true
+            Base64 = 32U        ///< is_b64_string() is true
+        };
+
+        /** Classify value()
+         *
+         * Equivalent to testing each of the getters in Kind, but the characters
+         * are scanned once and a getter is only tried when every character could
+         * belong to it.
+         *
+         * @return Kind flags (0 if value() is none of these)
+         *
+         * */
+        unsigned classify() const
+        {
+            unsigned retval = 0U;
+            auto in = stripped.data();
+            auto size = stripped.size();
+
+            // character classes common to every character
+            uint8_t common = (size > 0U) ? 0xffU : 0U;
+            size_t pad = StringView::npos;
+            size_t pads = 0U;
+
+            for(size_t i = 0; i < size; i++){
+
+                common &= char_class(in[i]);
+
+                if(in[i] == '='){
+
+                    pad = std::min(pad, i);
+                    pads++;
+                }
+            }
+
+            if((size == 4U) || (size == 5U)){
+
+                bool b;
+
+                retval |= get_bool(b) ? unsigned(Bool) : 0U;
+            }
+
+            if((common & kClassHex) != 0U){
+
+                retval |= Hex;
+            }
+
+            if(((common & kClassB64) != 0U) && ((size % 4U) == 0U) && b64_padding_ok(in, size, pad, pads)){
+
+                retval |= Base64;
+            }
+
+            if((common & kClassDec) != 0U){
+
+                // digits only: no need to try every getter
+                uint64_t u;
+
+                if(digits_to_uint64(stripped, Base::Dec, u)){
+
+                    retval |= Unsigned | Float | ((u <= uint64_t(INT64_MAX)) ? unsigned(Signed) : 0U);
+                }
+                else{
+
+                    double d;
+
+                    retval |= get_double(d) ? unsigned(Float) : 0U;
+                }
+            }
+            else if((common & kClassNumber) != 0U){
+
+                uint64_t u;
+                int64_t i;
+                double d;
+
+                if(in[0] != '-'){
+
+                    // anything other than decimal that fits 64 bits fits as two's complement
+                    retval |= get_uint64(u) ? unsigned(Unsigned | Signed) : 0U;
+                }
+                else{
+
+                    retval |= get_int64(i) ? unsigned(Signed) : 0U;
+                }
+
+                retval |= get_double(d) ? unsigned(Float) : 0U;
+            }
+
+            return retval;
+        }
+
         /** Get boolean from value()
          *
          * @param[out] v    output
@@ -297,7 +377,7 @@ namespace Bramble {
             const StringView v_true("true");
             const StringView v_false("false");
 
-            auto vv = strip(value());
+            auto vv = stripped;
 
             if(case_insensitive_compare(v_true, vv)){
 
@@ -316,6 +396,10 @@ namespace Bramble {
         }
 
         /** Get signed integer from value()
+         *
+         * @note value() may be decimal with an optional leading '-', or
+         * hexadecimal ("0x") or binary ("0b") giving the two's complement of
+         * the value widened to at least 32 bits (as put by Encoder::put_int())
          *
          * @param[out] v    output
          *
@@ -347,6 +431,8 @@ namespace Bramble {
         }
 
         /** Get unsigned integer from value()
+         *
+         * @note value() may be decimal, hexadecimal ("0x") or binary ("0b")
          *
          * @param[out] v    output
          *
@@ -387,16 +473,7 @@ namespace Bramble {
          * */
         bool get_uint8(uint8_t& v) const
         {
-            bool retval = false;
-            uint32_t tmp;
-
-            if(get_uint32(tmp) && (tmp <= UINT8_MAX)){
-
-                v = uint8_t(tmp);
-                retval = true;
-            }
-
-            return retval;
+            return s_to_uint<uint8_t>(stripped, v);
         }
 
         /** Get uint16_t from value()
@@ -409,16 +486,7 @@ namespace Bramble {
          * */
         bool get_uint16(uint16_t& v) const
         {
-            bool retval = false;
-            uint32_t tmp;
-
-            if(get_uint32(tmp) && (tmp <= UINT16_MAX)){
-
-                v = uint16_t(tmp);
-                retval = true;
-            }
-
-            return retval;
+            return s_to_uint<uint16_t>(stripped, v);
         }
 
         /** Get uint32_t from value()
@@ -431,7 +499,7 @@ namespace Bramble {
          * */
         bool get_uint32(uint32_t& v) const
         {
-            return s_to_uint<uint32_t>(strip(value()), v, Base::Dec);
+            return s_to_uint<uint32_t>(stripped, v);
         }
 
         /** Get uint64_t from value()
@@ -444,7 +512,7 @@ namespace Bramble {
          * */
         bool get_uint64(uint64_t& v) const
         {
-            return s_to_uint<uint64_t>(strip(value()), v, Base::Dec);
+            return s_to_uint<uint64_t>(stripped, v);
         }
 
         /** Get int8_t from value()
@@ -457,16 +525,7 @@ namespace Bramble {
          * */
         bool get_int8(int8_t& v) const
         {
-            bool retval = false;
-            int32_t tmp;
-
-            if(get_int32(tmp) && (tmp <= INT8_MAX) && (tmp >= INT8_MIN)){
-
-                v = int8_t(tmp);
-                retval = true;
-            }
-
-            return retval;
+            return s_to_int<int8_t>(stripped, v);
         }
 
         /** Get int16_t from value()
@@ -479,16 +538,7 @@ namespace Bramble {
          * */
         bool get_int16(int16_t& v) const
         {
-            bool retval = false;
-            int32_t tmp;
-
-            if(get_int32(tmp) && (tmp <= INT16_MAX) && (tmp >= INT16_MIN)){
-
-                v = int16_t(tmp);
-                retval = true;
-            }
-
-            return retval;
+            return s_to_int<int16_t>(stripped, v);
         }
 
         /** Get int32_t from value()
@@ -501,7 +551,7 @@ namespace Bramble {
          * */
         bool get_int32(int32_t& v) const
         {
-            return s_to_int<int32_t, uint32_t, INT32_MAX>(strip(value()), v);
+            return s_to_int<int32_t>(stripped, v);
         }
 
         /** Get int64_t from value()
@@ -514,7 +564,102 @@ namespace Bramble {
          * */
         bool get_int64(int64_t& v) const
         {
-            return s_to_int<int64_t, uint64_t, INT64_MAX>(strip(value()), v);
+            return s_to_int<int64_t>(stripped, v);
+        }
+
+        /** Get double from value()
+         *
+         * @note accepts [-]digits[.digits][(e|E)[+|-]digits], "inf" and "nan"
+         *
+         * @param[out] v    output
+         *
+         * @retval true     success
+         * @retval false    failure
+         *
+         * */
+        bool get_double(double& v) const
+        {
+            return s_to_float<double>(stripped, v);
+        }
+
+        /// @copydoc get_double(double&) const
+        bool get_float(float& v) const
+        {
+            return s_to_float<float>(stripped, v);
+        }
+
+        /** Get a fixed point decimal from value()
+         *
+         * e.g. "868.1" with decimals=3 gives 868100
+         *
+         * Fails if value() has more non-zero digits after the decimal point
+         * than decimals, or if the scaled value does not fit.
+         *
+         * @param[out] v        value scaled by 10^decimals
+         * @param[in] decimals  number of digits after the decimal point (at most 18)
+         *
+         * @retval true     success
+         * @retval false    failure
+         *
+         * */
+        bool get_fixed(int64_t& v, unsigned decimals) const
+        {
+            bool retval = false;
+            auto tmp = stripped;
+            auto iter = tmp.begin();
+            bool negative = (iter != tmp.end()) && (*iter == '-');
+            bool any = false;
+            uint64_t mag = 0;
+
+            if(negative){
+
+                ++iter;
+            }
+
+            retval = (decimals <= 18U);
+
+            // integer part
+            for(; retval && (iter != tmp.end()) && (*iter != '.'); ++iter){
+
+                retval = digit_into(*iter, mag);
+                any = true;
+            }
+
+            // fraction part
+            if(retval && (iter != tmp.end())){
+
+                ++iter;
+            }
+
+            for(unsigned i = 0; i < decimals; i++){
+
+                if(retval && (iter != tmp.end())){
+
+                    retval = digit_into(*iter, mag);
+                    any = true;
+                    ++iter;
+                }
+                else{
+
+                    retval = retval && digit_into('0', mag);
+                }
+            }
+
+            // more decimals than fit must be zero
+            for(; retval && (iter != tmp.end()); ++iter){
+
+                retval = (*iter == '0');
+                any = true;
+            }
+
+            retval = retval && any && (mag <= (uint64_t(INT64_MAX) + (negative ? 1U : 0U)));
+
+            if(retval){
+
+                v = negative ? ((mag == 0U) ? 0 : (-int64_t(mag - 1U) - 1)) : int64_t(mag);
+            }
+
+            return retval;
         }
 
         /** Interpret value() as hex encoded memory
@@ -529,42 +674,97 @@ namespace Bramble {
          * */
         size_t get_hex_string(void *buffer, size_t max) const
         {
-            size_t retval = 0;
-            uint8_t cc, c;
-            BufferStream output(buffer, max);
+            size_t error;
+
+            return get_hex_string(buffer, max, error);
+        }
+
+        /** Interpret value() as hex encoded memory and report where decoding failed
+         *
+         * Validation and decoding happen in a single pass. If buffer is too small
+         * the remaining input is still validated.
+         *
+         * @param[out] buffer   output (may be nullptr to only validate)
+         * @param[out] max      maximum size of buffer
+         * @param[out] error    offset of first non-hex character in the stripped value (StringView::npos if none)
+         *
+         * @retval bytes decoded (0 if value() is not a hex string)
+         *
+         * */
+        size_t get_hex_string(void *buffer, size_t max, size_t& error) const
+        {
+            auto tmp = stripped;
+            auto in = tmp.data();
+            auto end = in + tmp.size();
+            auto out = static_cast<uint8_t *>(buffer);
+
+            size_t pairs = tmp.size() / 2U;
+            size_t stored = (buffer != nullptr) ? std::min(max, pairs) : 0U;
+            size_t i;
+
+            error = StringView::npos;
 
-            auto tmp = strip(value());
+            // decode into buffer four bytes at a time
+            for(i = 0; ((i + 4U) <= stored); i += 4U){
 
-            for(auto iter = tmp.begin(); iter != tmp.end(); ++iter){
+                auto p = &in[i * 2U];
 
-                if(!hex_to_value(*iter, cc)){
+                uint8_t h0 = hex_table(p[0]), l0 = hex_table(p[1]);
+                uint8_t h1 = hex_table(p[2]), l1 = hex_table(p[3]);
+                uint8_t h2 = hex_table(p[4]), l2 = hex_table(p[5]);
+                uint8_t h3 = hex_table(p[6]), l3 = hex_table(p[7]);
+
+                if((h0 | l0 | h1 | l1 | h2 | l2 | h3 | l3) > 0xfU){
 
-                    retval = 0;
                     break;
                 }
 
-                if(((iter - tmp.begin()) & 1) == 0){
+                out[i] = uint8_t(h0 << 4) | l0;
+                out[i+1] = uint8_t(h1 << 4) | l1;
+                out[i+2] = uint8_t(h2 << 4) | l2;
+                out[i+3] = uint8_t(h3 << 4) | l3;
+            }
+
+            for(; i < stored; i++){
 
-                    c = (cc << 4) & uint8_t(0xf0);
+                uint8_t h = hex_table(in[i * 2U]), l = hex_table(in[(i * 2U) + 1U]);
 
-                    if((iter+1) == tmp.end()){
+                if((h | l) > 0xfU){
 
-                        output.write(&c, sizeof(c));
-                        retval++;
-                    }
+                    break;
                 }
-                else{
 
-                    c |= (cc & uint8_t(0xf));
+                out[i] = uint8_t(h << 4) | l;
+            }
+
+            // validate what doesn't fit in buffer
+            if(i == stored){
+
+                auto pos = find_non_hex(&in[i * 2U], end);
 
-                    output.write(&c, sizeof(c));
-                    retval++;
+                if(pos != end){
+
+                    error = size_t(pos - in);
+                }
+                else if((tmp.size() & 1U) && (out != nullptr) && (pairs < max)){
+
+                    // odd digit is the high nibble of the final byte
+                    out[pairs] = uint8_t(hex_table(tmp.back()) << 4);
                 }
             }
+            else{
 
-            return retval;
+                error = size_t(find_non_hex(&in[i * 2U], end) - in);
+            }
+
+            return (error == StringView::npos) ? ((tmp.size() + 1U) / 2U) : 0U;
         }
 
+        /** Get the number of bytes value() decodes to as a hex string
+         *
+         * @return bytes (0 if value() is not a hex string)
+         *
+         * */
         size_t get_hex_string_size() const
         {
             return get_hex_string(nullptr, 0);
@@ -582,53 +782,100 @@ namespace Bramble {
          * */
         size_t get_b64_string(void *buffer, size_t max) const
         {
+            size_t error;
+
+            return get_b64_string(buffer, max, error);
+        }
+
+        /** Interpret value() as base64 encoded memory and report where decoding failed
+         *
+         * Padding is strict: value() must be a multiple of four characters,
+         * '=' may only appear as the final one or two characters, and bits
+         * made redundant by padding must be zero. If buffer is too small the
+         * remaining input is still validated.
+         *
+         * @param[out] buffer   output (may be nullptr to only validate)
+         * @param[out] max      maximum size of buffer
+         * @param[out] error    offset of the first invalid character in the stripped value (StringView::npos if none)
+         *
+         * @retval bytes decoded (0 if value() is not a base64 string)
+         *
+         * */
+        size_t get_b64_string(void *buffer, size_t max, size_t& error) const
+        {
+            auto tmp = stripped;
+            auto in = tmp.data();
+            auto end = in + tmp.size();
+            auto out = static_cast<uint8_t *>(buffer);
+
             size_t retval = 0;
-            uint8_t c, out, acc;
-            BufferStream output(buffer, max);
 
-            auto tmp = strip(value());
+            error = StringView::npos;
 
-            for(auto iter = tmp.begin(); iter != tmp.end(); ++iter){
+            if(tmp.empty() || ((tmp.size() % 4U) != 0U)){
 
-                if(b64_to_value(*iter, c)){
+                auto pos = find_non_b64(in, end);
+
+                error = (pos != end) ? size_t(pos - in) : tmp.size();
+            }
+            else{
+
+                // every quad except the last cannot contain padding
+                size_t body = (tmp.size() / 4U) - 1U;
+                size_t direct = (buffer != nullptr) ? std::min(body, max / 3U) : 0U;
+                size_t i;
+                uint8_t block[3];
+
+                for(i = 0; i < direct; i++){
+
+                    if(!b64_quad_to_bytes(&in[i * 4U], &out[i * 3U])){
 
-                    switch((iter - tmp.begin()) % 4){
-                    case 0:
-                        acc = (c << 2);
-                        break;
-                    case 1:
-                        out = acc | (c >> 4);
-                        acc = (c << 4);
-                        output.write(&out, sizeof(out));
-                        retval++;
-                        break;
-                    case 2:
-                        out = acc | (c >> 2);
-                        acc = (c << 6);
-                        output.write(&out, sizeof(out));
-                        retval++;
-                        break;
-                    case 3:
-                        out = acc | c;
-                        output.write(&out, sizeof(out));
-                        retval++;
                         break;
                     }
                 }
-                else if(*iter == '='){
 
-                    // skip
+                if(i == direct){
+
+                    for(; i < body; i++){
+
+                        if(!b64_quad_to_bytes(&in[i * 4U], block)){
+
+                            break;
+                        }
+
+                        copy_partial(out, max, i * 3U, block, sizeof(block));
+                    }
+                }
+
+                if(i < body){
+
+                    error = size_t(find_non_b64(&in[i * 4U], end) - in);
                 }
                 else{
 
-                    retval = 0;
-                    break;
+                    auto last = &in[body * 4U];
+                    size_t size = b64_final_quad_to_bytes(last, block, error);
+
+                    if(error == StringView::npos){
+
+                        copy_partial(out, max, body * 3U, block, size);
+                        retval = (body * 3U) + size;
+                    }
+                    else{
+
+                        error += body * 4U;
+                    }
                 }
             }
 
             return retval;
         }
 
+        /** Get the number of bytes value() decodes to as a base64 string
+         *
+         * @return bytes (0 if value() is not a base64 string)
+         *
+         * */
         size_t get_b64_string_size() const
         {
             return get_b64_string(nullptr, 0);
@@ -639,121 +886,415 @@ namespace Bramble {
         enum class Base {
 
             Dec,
-            Hex
+            Hex,
+            Bin
         };
 
         StringView input;
 
-        template<typename T>
-        bool s_to_uint(StringView s, T& value, Base base) const
+        // input without surrounding whitespace
+        StringView stripped;
+
+        // offset of the first '=' in input (StringView::npos if none, unscanned until needed)
+        mutable size_t eq;
+
+        static const size_t unscanned = StringView::npos - 1U;
+
+        void analyse()
         {
-            bool retval = false;
+            stripped = strip(input);
+            eq = unscanned;
+        }
 
-            if(!s.empty()){
+        size_t eq_offset() const
+        {
+            if(eq == unscanned){
 
-                value = 0;
+                eq = input.find_first_of('=');
+            }
 
-                retval = true;
+            return eq;
+        }
 
-                for(auto iter = s.begin(); (iter != s.end()) && retval; ++iter){
+        // remove a "0x" or "0b" prefix and return the base it selects
+        static Base remove_base_prefix(StringView& s)
+        {
+            Base retval = Base::Dec;
 
-                    switch(base){
-                    default:
-                    case Base::Dec:
+            if((s.size() > 2U) && (s[0] == '0')){
 
-                        if((*iter < '0') || (*iter > '9')){
+                switch(s[1]){
+                case 'x':
+                case 'X':
+                    retval = Base::Hex;
+                    s.remove_prefix(2);
+                    break;
+                case 'b':
+                case 'B':
+                    retval = Base::Bin;
+                    s.remove_prefix(2);
+                    break;
+                default:
+                    break;
+                }
+            }
 
-                            retval = false;
-                        }
-                        else{
+            return retval;
+        }
 
-                            auto pre = value;
+        // true if eight characters are all decimal digits
+        static bool is_eight_digits(uint64_t chunk)
+        {
+            return ((chunk & 0xf0f0f0f0f0f0f0f0ULL) == 0x3030303030303030ULL) &&
+                (((chunk + 0x0606060606060606ULL) & 0xf0f0f0f0f0f0f0f0ULL) == 0x3030303030303030ULL);
+        }
 
-                            value *= 10;
-                            value += (*iter - '0');
+        // value of eight decimal digits (first digit in the least significant byte)
+        static uint32_t eight_digits_to_value(uint64_t chunk)
+        {
+            uint64_t v = chunk - 0x3030303030303030ULL;
 
-                            // overflow
-                            if(value < pre){
+            v = (v * 10U) + (v >> 8);
+            v = (((v & 0x000000ff000000ffULL) * (100U + (1000000ULL << 32))) +
+                (((v >> 16) & 0x000000ff000000ffULL) * (1U + (10000ULL << 32)))) >> 32;
 
-                                retval = false;
-                            }
-                        }
-                        break;
-                    }
+            return uint32_t(v);
+        }
+
+        static uint64_t load_eight(const char *p)
+        {
+            // assembled bytewise so that it is independent of byte order
+            return uint64_t(uint8_t(p[0])) |
+                (uint64_t(uint8_t(p[1])) << 8) |
+                (uint64_t(uint8_t(p[2])) << 16) |
+                (uint64_t(uint8_t(p[3])) << 24) |
+                (uint64_t(uint8_t(p[4])) << 32) |
+                (uint64_t(uint8_t(p[5])) << 40) |
+                (uint64_t(uint8_t(p[6])) << 48) |
+                (uint64_t(uint8_t(p[7])) << 56);
+        }
+
+        // parse digits (no prefix or sign) without overflow
+        static bool digits_to_uint64(StringView s, Base base, uint64_t& value)
+        {
+            bool retval = false;
+            auto iter = s.data();
+            auto end = iter + s.size();
+
+            // leading zeros are insignificant
+            while(((end - iter) > 1) && (*iter == '0')){
+
+                ++iter;
+            }
+
+            if(iter != end){
+
+                switch(base){
+                default:
+                case Base::Dec:
+                    retval = dec_to_uint64(iter, end, value);
+                    break;
+                case Base::Hex:
+                    retval = hex_to_uint64(iter, end, value);
+                    break;
+                case Base::Bin:
+                    retval = bin_to_uint64(iter, end, value);
+                    break;
                 }
             }
 
             return retval;
         }
 
-        template<typename T, typename TU, size_t T_MAX>
-        bool s_to_int(StringView s, T& value) const
+        static bool dec_to_uint64(const char *iter, const char *end, uint64_t& value)
         {
-            bool retval = false;
-            bool negative;
-            TU v;
+            bool retval = true;
+            uint64_t v = 0;
+            size_t n = size_t(end - iter);
 
-            if(!s.empty()){
+            // UINT64_MAX has 20 digits, only the 20th can overflow
+            auto last = (n == 20U) ? (end - 1) : end;
 
-                retval = true;
+            if(n > 20U){
+
+                retval = false;
+            }
+
+            for(; retval && ((last - iter) >= 8); iter += 8){
 
-                v = 0;
+                uint64_t chunk = load_eight(iter);
 
-                if(s.front() == '-'){
+                if(is_eight_digits(chunk)){
 
-                    negative = true;
-                    s.remove_prefix(1);
+                    v = (v * 100000000ULL) + eight_digits_to_value(chunk);
                 }
                 else{
 
-                    negative = false;
+                    retval = false;
                 }
+            }
 
-                retval = s_to_uint<TU>(s, v, Base::Dec);
+            for(; retval && (iter != last); ++iter){
 
-                if(retval){
+                if((*iter < '0') || (*iter > '9')){
 
-                    if(negative){
+                    retval = false;
+                }
+                else{
 
-                        // overflow
-                        if(v > T_MAX){
+                    v = (v * 10U) + uint64_t(*iter - '0');
+                }
+            }
 
-                            retval = false;
-                        }
-                        else{
+            if(retval && (last != end)){
 
-                            value = T(0) - T(v);
-                        }
-                    }
-                    else{
+                uint64_t d = uint64_t(*last - '0');
 
-                        value = T(v);
-                    }
+                if((*last < '0') || (*last > '9') || (v > ((UINT64_MAX - d) / 10U))){
+
+                    retval = false;
+                }
+                else{
+
+                    v = (v * 10U) + d;
                 }
             }
 
+            value = v;
+
             return retval;
         }
 
-        static bool hex_to_value(char c, uint8_t& v)
+        static bool hex_to_uint64(const char *iter, const char *end, uint64_t& value)
         {
-            bool retval = true;
+            bool retval = ((end - iter) <= 16);
+            uint64_t v = 0;
+
+            for(; retval && (iter != end); ++iter){
+
+                uint8_t d = hex_table(*iter);
+
+                if(d > 0xfU){
+
+                    retval = false;
+                }
+                else{
+
+                    v = (v << 4) | d;
+                }
+            }
+
+            value = v;
+
+            return retval;
+        }
+
+        static bool bin_to_uint64(const char *iter, const char *end, uint64_t& value)
+        {
+            bool retval = ((end - iter) <= 64);
+            uint64_t v = 0;
+
+            for(; retval && (iter != end); ++iter){
+
+                if((*iter != '0') && (*iter != '1')){
+
+                    retval = false;
+                }
+                else{
+
+                    v = (v << 1) | uint64_t(*iter - '0');
+                }
+            }
+
+            value = v;
+
+            return retval;
+        }
+
+        template<typename T>
+        static bool s_to_uint(StringView s, T& value)
+        {
+            uint64_t v;
+            Base base = remove_base_prefix(s);
+            bool retval = digits_to_uint64(s, base, v) && (v <= uint64_t(std::numeric_limits<T>::max()));
+
+            if(retval){
+
+                value = T(v);
+            }
+
+            return retval;
+        }
+
+        template<typename T>
+        static bool s_to_float(StringView s, T& value)
+        {
+            auto end = s.data() + s.size();
+            T v;
+
+            bool retval = !s.empty() && (FloatFormat::from_chars(s.data(), end, v) == end);
+
+            if(retval){
+
+                value = v;
+            }
+
+            return retval;
+        }
+
+        // append decimal digit c to value
+        static bool digit_into(char c, uint64_t& value)
+        {
+            bool retval = false;
 
             if((c >= '0') && (c <= '9')){
 
-                v = c - '0';
+                uint64_t d = uint64_t(c - '0');
+
+                if(value <= ((UINT64_MAX - d) / 10U)){
+
+                    value = (value * 10U) + d;
+                    retval = true;
+                }
+            }
+
+            return retval;
+        }
+
+        template<typename T>
+        static bool s_to_int(StringView s, T& value)
+        {
+            bool retval = false;
+            bool negative = !s.empty() && (s.front() == '-');
+            uint64_t v;
+            int64_t x = 0;
+
+            if(negative){
+
+                s.remove_prefix(1);
+            }
+
+            // sign is only valid with decimal
+            Base base = negative ? Base::Dec : remove_base_prefix(s);
+
+            if(digits_to_uint64(s, base, v)){
+
+                if(negative){
+
+                    // magnitude of the minimum is max + 1
+                    retval = (v <= (uint64_t(std::numeric_limits<T>::max()) + 1U));
+                    x = (v == 0U) ? 0 : (-int64_t(v - 1U) - 1);
+                }
+                else if(base == Base::Dec){
+
+                    retval = (v <= uint64_t(std::numeric_limits<T>::max()));
+                    x = int64_t(v);
+                }
+                else if(sizeof(T) <= sizeof(int32_t)){
+
+                    // two's complement of the value widened to 32 bits
+                    retval = (v <= UINT32_MAX);
+                    x = (v > uint64_t(INT32_MAX)) ? (-int64_t(UINT32_MAX - v) - 1) : int64_t(v);
+                }
+                else{
+
+                    retval = true;
+                    x = (v > uint64_t(INT64_MAX)) ? (-int64_t(UINT64_MAX - v) - 1) : int64_t(v);
+                }
+
+                retval = retval && (x >= int64_t(std::numeric_limits<T>::min())) && (x <= int64_t(std::numeric_limits<T>::max()));
             }
-            else if((c >= 'a') && (c <= 'f')){
 
-                v = c - 'a' + 10;
+            if(retval){
+
+                value = T(x);
             }
-            else if((c >= 'A') && (c <= 'F')){
 
-                v = c - 'A' + 10;
+            return retval;
+        }
+
+        static bool hex_to_value(char c, uint8_t& v)
+        {
+            v = hex_table(c);
+
+            return v <= 0xfU;
+        }
+
+        static const char *find_non_hex(const char *begin, const char *end)
+        {
+            auto iter = begin;
+
+            while((iter != end) && (hex_table(*iter) <= 0xfU)){
+
+                ++iter;
             }
-            else{
 
-                retval = false;
+            return iter;
+        }
+
+        // value of hex digit c, or 0xff if c is not a hex digit
+        static uint8_t hex_table(char c)
+        {
+            static const uint8_t table[256] = {
+                0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff,
+                0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff,
+                0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff,
+                0x00, 0x01, 0x02, 0x03, 0x04, 0x05, 0x06, 0x07, 0x08, 0x09, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff,
+                0xff, 0x0a, 0x0b, 0x0c, 0x0d, 0x0e, 0x0f, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff,
+                0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff,
+                0xff, 0x0a, 0x0b, 0x0c, 0x0d, 0x0e, 0x0f, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff,
+                0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff,
+                0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff,
+                0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff,
+                0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff,
+                0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff,
+                0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff,
+                0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff,
+                0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff,
+                0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff
+            };
+
+            return table[uint8_t(c)];
+        }
+
+        static const uint8_t kClassDec = 1U;       // 0-9
+        static const uint8_t kClassHex = 2U;       // 0-9, a-f, A-F
+        static const uint8_t kClassB64 = 4U;       // base64 alphabet and '='
+        static const uint8_t kClassNumber = 8U;    // characters that can appear in an integer or float
+
+        static uint8_t char_class(char c)
+        {
+            static const uint8_t table[256] = {
+                0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00,
+                0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00,
+                0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x0c, 0x00, 0x08, 0x08, 0x04,
+                0x0f, 0x0f, 0x0f, 0x0f, 0x0f, 0x0f, 0x0f, 0x0f, 0x0f, 0x0f, 0x00, 0x00, 0x00, 0x04, 0x00, 0x00,
+                0x00, 0x0e, 0x0e, 0x0e, 0x0e, 0x0e, 0x0e, 0x04, 0x04, 0x0c, 0x04, 0x04, 0x04, 0x04, 0x0c, 0x04,
+                0x04, 0x04, 0x04, 0x04, 0x04, 0x04, 0x04, 0x04, 0x0c, 0x04, 0x04, 0x00, 0x00, 0x00, 0x00, 0x00,
+                0x00, 0x0e, 0x0e, 0x0e, 0x0e, 0x0e, 0x0e, 0x04, 0x04, 0x0c, 0x04, 0x04, 0x04, 0x04, 0x0c, 0x04,
+                0x04, 0x04, 0x04, 0x04, 0x04, 0x04, 0x04, 0x04, 0x0c, 0x04, 0x04, 0x00, 0x00, 0x00, 0x00, 0x00,
+                0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00,
+                0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00,
+                0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00,
+                0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00,
+                0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00,
+                0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00,
+                0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00,
+                0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00
+            };
+
+            return table[uint8_t(c)];
+        }
+
+        // check '=' only appears as the final one or two characters and covers zero bits
+        static bool b64_padding_ok(const char *in, size_t size, size_t pad, size_t pads)
+        {
+            bool retval = (pads == 0U);
+            uint8_t v;
+
+            if(!retval && (pads <= 2U) && (pad == (size - pads)) && b64_to_value(in[pad - 1U], v)){
+
+                retval = (v & ((pads == 1U) ? 0x3U : 0xfU)) == 0U;
             }
 
             return retval;
@@ -761,36 +1302,139 @@ namespace Bramble {
 
         static bool b64_to_value(char c, uint8_t& v)
         {
-            bool retval = true;
+            v = b64_table(c);
+
+            return v <= 0x3fU;
+        }
+
+        static const char *find_non_b64(const char *begin, const char *end)
+        {
+            auto iter = begin;
+
+            while((iter != end) && (b64_table(*iter) <= 0x3fU)){
+
+                ++iter;
+            }
+
+            return iter;
+        }
+
+        // decode four characters that must not contain padding
+        static bool b64_quad_to_bytes(const char *in, uint8_t *out)
+        {
+            bool retval = false;
+
+            uint8_t a = b64_table(in[0]), b = b64_table(in[1]), c = b64_table(in[2]), d = b64_table(in[3]);
 
-            if((c >= 'A') && (c <= 'Z')){
+            if((a | b | c | d) <= 0x3fU){
 
-                v = c - 'A';
+                uint32_t v = (uint32_t(a) << 18) | (uint32_t(b) << 12) | (uint32_t(c) << 6) | uint32_t(d);
+
+                out[0] = uint8_t(v >> 16);
+                out[1] = uint8_t(v >> 8);
+                out[2] = uint8_t(v);
+
+                retval = true;
             }
-            else if((c >= 'a') && (c <= 'z')){
 
-                v = c - 'a' + 26;
+            return retval;
+        }
+
+        // decode the last four characters where padding is allowed
+        static size_t b64_final_quad_to_bytes(const char *in, uint8_t *out, size_t& error)
+        {
+            size_t retval = 0;
+
+            uint8_t a = b64_table(in[0]), b = b64_table(in[1]), c = b64_table(in[2]), d = b64_table(in[3]);
+
+            error = StringView::npos;
+
+            if(a > 0x3fU){
+
+                error = 0;
             }
-            else if((c >= '0') && (c <= '9')){
+            else if(b > 0x3fU){
 
-                v = c - '0' + 26 + 26;
+                error = 1;
             }
-            else if(c == '+'){
+            else if(c > 0x3fU){
+
+                if((in[2] != '=') || (in[3] != '=')){
+
+                    error = (in[2] != '=') ? 2 : 3;
+                }
+                else if((b & 0xfU) != 0U){
+
+                    error = 1;
+                }
+                else{
 
-                v = 26 + 26 + 10;
+                    out[0] = uint8_t((a << 2) | (b >> 4));
+                    retval = 1;
+                }
             }
-            else if(c == '/'){
+            else if(d > 0x3fU){
+
+                if(in[3] != '='){
+
+                    error = 3;
+                }
+                else if((c & 0x3U) != 0U){
+
+                    error = 2;
+                }
+                else{
 
-                v = 26 + 26 + 10 + 1;
+                    out[0] = uint8_t((a << 2) | (b >> 4));
+                    out[1] = uint8_t((b << 4) | (c >> 2));
+                    retval = 2;
+                }
             }
             else{
 
-                retval = false;
+                out[0] = uint8_t((a << 2) | (b >> 4));
+                out[1] = uint8_t((b << 4) | (c >> 2));
+                out[2] = uint8_t((c << 6) | d);
+                retval = 3;
             }
 
             return retval;
         }
 
+        // copy decoded bytes at offset into buffer, discarding what doesn't fit
+        static void copy_partial(uint8_t *buffer, size_t max, size_t offset, const uint8_t *bytes, size_t size)
+        {
+            if((buffer != nullptr) && (offset < max)){
+
+                (void)memcpy(&buffer[offset], bytes, std::min(size, max - offset));
+            }
+        }
+
+        // value of base64 digit c, or 0xff if c is not a base64 digit ('=' included)
+        static uint8_t b64_table(char c)
+        {
+            static const uint8_t table[256] = {
+                0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff,
+                0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff,
+                0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0x3e, 0xff, 0xff, 0xff, 0x3f,
+                0x34, 0x35, 0x36, 0x37, 0x38, 0x39, 0x3a, 0x3b, 0x3c, 0x3d, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff,
+                0xff, 0x00, 0x01, 0x02, 0x03, 0x04, 0x05, 0x06, 0x07, 0x08, 0x09, 0x0a, 0x0b, 0x0c, 0x0d, 0x0e,
+                0x0f, 0x10, 0x11, 0x12, 0x13, 0x14, 0x15, 0x16, 0x17, 0x18, 0x19, 0xff, 0xff, 0xff, 0xff, 0xff,
+                0xff, 0x1a, 0x1b, 0x1c, 0x1d, 0x1e, 0x1f, 0x20, 0x21, 0x22, 0x23, 0x24, 0x25, 0x26, 0x27, 0x28,
+                0x29, 0x2a, 0x2b, 0x2c, 0x2d, 0x2e, 0x2f, 0x30, 0x31, 0x32, 0x33, 0xff, 0xff, 0xff, 0xff, 0xff,
+                0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff,
+                0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff,
+                0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff,
+                0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff,
+                0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff,
+                0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff,
+                0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff,
+                0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff
+            };
+
+            return table[uint8_t(c)];
+        }
+
         static bool case_insensitive_compare(const StringView& a, const StringView& b)
         {
             bool retval = false;
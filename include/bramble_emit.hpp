@@ -0,0 +1,283 @@
+/* Copyright (c) 2024 Cameron Harper
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ *
+ */
+
+#ifndef BRAMBLE_EMIT_H_INCLUDED
+#define BRAMBLE_EMIT_H_INCLUDED
+
+#include "bramble_encoder.hpp"
+#include "bramble_string_view.hpp"
+
+#include <cstddef>
+#include <cstdint>
+#include <type_traits>
+
+namespace Bramble {
+
+    /** A key=value argument, see kv()
+     *
+     * */
+    template<typename T>
+    struct KeyValue {
+
+        const char *key;    ///< key
+        T value;            ///< value
+    };
+
+    /** A binary argument encoded as hexadecimal, see hex()
+     *
+     * */
+    struct Hex {
+
+        const void *data;   ///< input buffer
+        size_t size;        ///< size of input buffer
+    };
+
+    /** A binary argument encoded as base64, see b64()
+     *
+     * */
+    struct B64 {
+
+        const void *data;   ///< input buffer
+        size_t size;        ///< size of input buffer
+    };
+
+    /** Check if T can be passed as an argument to the variadic emission functions
+     *
+     * Integers, floating point, bool, char, strings, StringView, KeyValue, Hex
+     * and B64 can be emitted.
+     *
+     * */
+    template<typename T, typename = void>
+    struct is_argument : std::false_type {};
+
+    /// @private
+    template<typename T>
+    struct is_argument<T, typename std::enable_if<std::is_integral<T>::value>::type> : std::true_type {};
+
+    /// @private
+    template<typename T>
+    struct is_argument<T, typename std::enable_if<std::is_floating_point<T>::value>::type> : std::true_type {};
+
+    /// @private
+    template<>
+    struct is_argument<const char *> : std::true_type {};
+
+    /// @private
+    template<>
+    struct is_argument<char *> : std::true_type {};
+
+    /// @private
+    template<size_t N>
+    struct is_argument<char[N]> : std::true_type {};
+
+    /// @private
+    template<>
+    struct is_argument<StringView> : std::true_type {};
+
+    /// @private
+    template<>
+    struct is_argument<Hex> : std::true_type {};
+
+    /// @private
+    template<>
+    struct is_argument<B64> : std::true_type {};
+
+    /// @private
+    template<typename T>
+    struct is_argument<KeyValue<T>> : is_argument<T> {};
+
+    /** Check if every type in a pack satisfies is_argument
+     *
+     * */
+    template<typename... T>
+    struct are_arguments : std::true_type {};
+
+    /// @private
+    template<typename T, typename... Rest>
+    struct are_arguments<T, Rest...> : std::integral_constant<bool, is_argument<T>::value && are_arguments<Rest...>::value> {};
+
+    /** Emit value as key=value
+     *
+     * @param[in] key       key
+     * @param[in] value     value (any type that satisfies is_argument except KeyValue)
+     *
+     * @return KeyValue
+     *
+     * */
+    template<typename T>
+    KeyValue<typename std::decay<const T>::type> kv(const char *key, const T& value)
+    {
+        return KeyValue<typename std::decay<const T>::type>{key, value};
+    }
+
+    /** Emit a buffer as hexadecimal
+     *
+     * @param[in] data      input buffer (must remain valid until emitted)
+     * @param[in] size      size of input buffer
+     *
+     * @return Hex
+     *
+     * */
+    inline Hex hex(const void *data, size_t size)
+    {
+        return Hex{data, size};
+    }
+
+    /** Emit a buffer as base64
+     *
+     * @param[in] data      input buffer (must remain valid until emitted)
+     * @param[in] size      size of input buffer
+     *
+     * @return B64
+     *
+     * */
+    inline B64 b64(const void *data, size_t size)
+    {
+        return B64{data, size};
+    }
+
+    /** Put a single argument
+     *
+     * Overloads are chosen at compile time according to the type of the argument.
+     *
+     * @param[in] e         encoder
+     * @param[in] value     argument
+     *
+     * */
+    template<typename T>
+    typename std::enable_if<std::is_integral<T>::value && std::is_signed<T>::value>::type
+    put_argument(Encoder& e, T value)
+    {
+        if(sizeof(T) > sizeof(int32_t)){
+
+            (void)e.put_int(int64_t(value));
+        }
+        else{
+
+            (void)e.put_int(int32_t(value));
+        }
+    }
+
+    /// @copydoc put_argument(Encoder&, T)
+    template<typename T>
+    typename std::enable_if<std::is_integral<T>::value && std::is_unsigned<T>::value>::type
+    put_argument(Encoder& e, T value)
+    {
+        if(sizeof(T) > sizeof(uint32_t)){
+
+            (void)e.put_int(uint64_t(value));
+        }
+        else{
+
+            (void)e.put_int(uint32_t(value));
+        }
+    }
+
+    /// @copydoc put_argument(Encoder&, T)
+    template<typename T>
+    typename std::enable_if<std::is_floating_point<T>::value>::type
+    put_argument(Encoder& e, T value)
+    {
+        if(sizeof(T) > sizeof(float)){
+
+            (void)e.put_double(double(value));
+        }
+        else{
+
+            (void)e.put_float(float(value));
+        }
+    }
+
+    /// @copydoc put_argument(Encoder&, T)
+    inline void put_argument(Encoder& e, bool value)
+    {
+        (void)e.put_bool(value);
+    }
+
+    /// @copydoc put_argument(Encoder&, T)
+    inline void put_argument(Encoder& e, char value)
+    {
+        (void)e.put_char(value);
+    }
+
+    /// @copydoc put_argument(Encoder&, T)
+    inline void put_argument(Encoder& e, const char *value)
+    {
+        (void)e.put_string(value);
+    }
+
+    /// @copydoc put_argument(Encoder&, T)
+    inline void put_argument(Encoder& e, const StringView& value)
+    {
+        (void)e.put_string(value);
+    }
+
+    /// @copydoc put_argument(Encoder&, T)
+    inline void put_argument(Encoder& e, const Hex& value)
+    {
+        (void)e.put_hex_string(value.data, value.size);
+    }
+
+    /// @copydoc put_argument(Encoder&, T)
+    inline void put_argument(Encoder& e, const B64& value)
+    {
+        (void)e.put_b64_string(value.data, value.size);
+    }
+
+    /// @copydoc put_argument(Encoder&, T)
+    template<typename T>
+    void put_argument(Encoder& e, const KeyValue<T>& value)
+    {
+        (void)e.put_string(value.key).put_char('=');
+        put_argument(e, value.value);
+    }
+
+    /** Put arguments separated by delimiters
+     *
+     * @param[in] e         encoder
+     *
+     * */
+    inline void put_arguments(Encoder& e)
+    {
+        (void)e;
+    }
+
+    /** @copydoc put_arguments(Encoder&)
+     *
+     * @param[in] first     first argument
+     * @param[in] rest      remaining arguments
+     *
+     * */
+    template<typename T, typename... Rest>
+    void put_arguments(Encoder& e, const T& first, const Rest&... rest)
+    {
+        put_argument(e, first);
+
+        if(sizeof...(Rest) > 0){
+
+            (void)e.space();
+            put_arguments(e, rest...);
+        }
+    }
+};
+
+#endif
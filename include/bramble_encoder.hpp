@@ -25,8 +25,11 @@
 
 #include "bramble_stream.hpp"
 #include "bramble_string_view.hpp"
+#include "bramble_integer_format.hpp"
+#include "bramble_float_format.hpp"
 
 #include <cstdint>
+#include <cstring>
 #include <cstddef>
 #include <array>
 #include <algorithm>
@@ -48,6 +51,13 @@ namespace Bramble {
             k16     ///< hexadecimal
         };
 
+        /** letter case of hexadecimal digits */
+        enum class Case {
+
+            kLower,     ///< a-f
+            kUpper      ///< A-F
+        };
+
         /** Create an Encoder
          *
          * @param[in] s output stream
@@ -180,23 +190,13 @@ namespace Bramble {
         /// @copydoc put_int(uint8_t)
         Encoder& put_int(int32_t value, Base base=Base::k10)
         {
-            if((base == Base::k10) && (value < 0)){
-
-                (void)put_char('-');
-            }
-
-            return put_int(uint32_t(std::abs(value)), base);
+            return int_to_s<int32_t, uint32_t>(value, base);
         }
 
         /// @copydoc put_int(uint8_t)
         Encoder& put_int(int64_t value, Base base=Base::k10)
         {
-            if((base == Base::k10) && (value < 0)){
-
-                (void)put_char('-');
-            }
-
-            return put_int(uint64_t(std::abs(value)), base);
+            return int_to_s<int64_t, uint64_t>(value, base);
         }
 
         /** put an unsigned integer
@@ -277,6 +277,90 @@ namespace Bramble {
             return put_int(value, base);
         }
 
+        /** put a floating point value
+         *
+         * The shortest representation that reads back as the same value is
+         * put, e.g. "868.1", "1e-7", "nan", "inf" or "-inf".
+         *
+         * @param[in] value     floating point value
+         *
+         * @return Encoder&
+         *
+         * */
+        Encoder& put_double(double value)
+        {
+            char buf[FloatFormat::max_chars];
+
+            (void)s.write(buf, size_t(FloatFormat::to_chars(buf, buf + sizeof(buf), value) - buf));
+
+            return *this;
+        }
+
+        /// @copydoc put_double(double)
+        Encoder& put_float(float value)
+        {
+            char buf[FloatFormat::max_chars];
+
+            (void)s.write(buf, size_t(FloatFormat::to_chars(buf, buf + sizeof(buf), value) - buf));
+
+            return *this;
+        }
+
+        /** put a fixed point decimal value
+         *
+         * e.g. put_fixed(868100, 3) puts "868.100"
+         *
+         * @param[in] value     value scaled by 10^decimals
+         * @param[in] decimals  number of digits after the decimal point (at most 18)
+         *
+         * @return Encoder&
+         *
+         * */
+        Encoder& put_fixed(int64_t value, unsigned decimals)
+        {
+            // sign, 19 integer digits, point and 18 decimals
+            char buf[40];
+            char *p = buf;
+
+            uint64_t scale = 1U;
+            uint64_t mag = (value < 0) ? (uint64_t(0) - uint64_t(value)) : uint64_t(value);
+
+            decimals = (decimals > 18U) ? 18U : decimals;
+
+            for(unsigned i = 0; i < decimals; i++){
+
+                scale *= 10U;
+            }
+
+            if(value < 0){
+
+                *p = '-';
+                p++;
+            }
+
+            p = IntegerFormat::to_chars(p, buf + sizeof(buf), uint64_t(mag / scale));
+
+            if(decimals > 0U){
+
+                char digits[IntegerFormat::max_chars];
+                uint64_t frac = mag % scale;
+                size_t n = size_t(IntegerFormat::to_chars(digits, digits + sizeof(digits), frac) - digits);
+
+                *p = '.';
+                p++;
+
+                (void)memset(p, '0', decimals - n);
+                p += decimals - n;
+
+                (void)memcpy(p, digits, n);
+                p += n;
+            }
+
+            (void)s.write(buf, size_t(p - buf));
+
+            return *this;
+        }
+
         /** put a boolean value
          *
          * @param[in] value     boolean value
@@ -299,16 +383,41 @@ namespace Bramble {
          * */
         Encoder& put_hex_string(const void *value, size_t size)
         {
-            auto begin = (const uint8_t *)value;
-            auto end = begin + size;
-
-            for(auto iter = begin; iter != end; ++iter){
+            return bytes_to_hex(static_cast<const uint8_t *>(value), size, 0, ' ', Case::kLower);
+        }
 
-                (void)put_char(nibble_to_hex((*iter) >> 4));
-                (void)put_char(nibble_to_hex(*iter));
-            }
+        /** put value as hexadecimal string
+         *
+         * @param[in] value     input buffer
+         * @param[in] size      size of input buffer
+         * @param[in] letters   letter case of digits
+         *
+         * @return Encoder&
+         *
+         * */
+        Encoder& put_hex_string(const void *value, size_t size, Case letters)
+        {
+            return bytes_to_hex(static_cast<const uint8_t *>(value), size, 0, ' ', letters);
+        }
 
-            return *this;
+        /** put value as groups of hexadecimal digits
+         *
+         * e.g. group=4 gives "00112233 44556677 8899"
+         *
+         * @note with the default separator each group is a separate token
+         *
+         * @param[in] value     input buffer
+         * @param[in] size      size of input buffer
+         * @param[in] group     bytes per group (0 for no grouping)
+         * @param[in] separator character put between groups
+         * @param[in] letters   letter case of digits
+         *
+         * @return Encoder&
+         *
+         * */
+        Encoder& put_hex_dump(const void *value, size_t size, size_t group, char separator = ' ', Case letters = Case::kLower)
+        {
+            return bytes_to_hex(static_cast<const uint8_t *>(value), size, group, separator, letters);
         }
 
         /** put value as hexadecimal string
@@ -345,45 +454,56 @@ namespace Bramble {
          * */
         Encoder& put_b64_string(const void *value, size_t size)
         {
-            auto begin = (const uint8_t *)value;
-            auto end = begin + size;
+            auto in = static_cast<const uint8_t *>(value);
+            char chunk[128];
+            size_t pos = 0;
 
-            for(auto iter = begin; iter != end;){
+            // three input bytes become four characters, written to the stream a chunk at a time
+            for(; size >= 3U; in += 3U, size -= 3U){
 
-                switch(std::distance(iter, end)){
-                default:
+                uint32_t v = (uint32_t(in[0]) << 16) | (uint32_t(in[1]) << 8) | uint32_t(in[2]);
 
-                    (void)put_char(byte_to_b64(iter[0] >> 2));
-                    (void)put_char(byte_to_b64((iter[1] >> 4) | (iter[0] << 4)));
-                    (void)put_char(byte_to_b64((iter[2] >> 6) | (iter[1] << 2)));
-                    (void)put_char(byte_to_b64(iter[2]));
+                chunk[pos] = byte_to_b64(uint8_t(v >> 18));
+                chunk[pos+1] = byte_to_b64(uint8_t(v >> 12));
+                chunk[pos+2] = byte_to_b64(uint8_t(v >> 6));
+                chunk[pos+3] = byte_to_b64(uint8_t(v));
+
+                pos += 4U;
+
+                if(pos == sizeof(chunk)){
+
+                    (void)s.write(chunk, pos);
+                    pos = 0;
+                }
+            }
 
-                    ++iter;
-                    ++iter;
-                    ++iter;
-                    break;
+            switch(size){
+            default:
+            case 0:
+                break;
 
-                case 1:
+            case 1:
 
-                    (void)put_char(byte_to_b64(iter[0] >> 2));
-                    (void)put_char(byte_to_b64(iter[0] << 4));
-                    (void)put_char('=');
-                    (void)put_char('=');
+                chunk[pos] = byte_to_b64(in[0] >> 2);
+                chunk[pos+1] = byte_to_b64(uint8_t(in[0] << 4));
+                chunk[pos+2] = '=';
+                chunk[pos+3] = '=';
+                pos += 4U;
+                break;
 
-                    ++iter;
-                    break;
+            case 2:
 
-                case 2:
+                chunk[pos] = byte_to_b64(in[0] >> 2);
+                chunk[pos+1] = byte_to_b64(uint8_t((in[1] >> 4) | (in[0] << 4)));
+                chunk[pos+2] = byte_to_b64(uint8_t(in[1] << 2));
+                chunk[pos+3] = '=';
+                pos += 4U;
+                break;
+            }
 
-                    (void)put_char(byte_to_b64(iter[0] >> 2));
-                    (void)put_char(byte_to_b64((iter[1] >> 4) | (iter[0] << 4)));
-                    (void)put_char(byte_to_b64(iter[1] << 2));
-                    (void)put_char('=');
+            if(pos > 0U){
 
-                    ++iter;
-                    ++iter;
-                    break;
-                }
+                (void)s.write(chunk, pos);
             }
 
             return *this;
@@ -415,74 +535,146 @@ namespace Bramble {
 
     protected:
 
-        template<typename T>
-        Encoder& uint_to_s(T value, Base base)
+        Encoder& bytes_to_hex(const uint8_t *in, size_t size, size_t group, char separator, Case letters)
         {
-            T v = value;
+            const char *table = (letters == Case::kUpper) ? hex_pairs_upper() : hex_pairs_lower();
+            char chunk[128];
+            size_t pos = 0;
+            size_t run = (group > 0U) ? group : size;
 
-            // at most 20 digits for 64bit
-            std::array<char,20> buf;
+            // expand into a local chunk two digits at a time, writing to the stream when the chunk is full
+            for(size_t i = 0; i < size;){
 
-            auto iter = buf.rbegin();
+                size_t n = std::min(std::min(run, size - i), (sizeof(chunk) - pos) / 2U);
 
-            switch(base){
-            default:
-            case Base::k10:
+                for(size_t k = 0; k < n; k++){
 
-                do{
-
-                    *iter = '0' + char(v % T(10));
-                    ++iter;
-                    v /= T(10);
+                    chunk[pos] = table[in[i + k] * 2U];
+                    chunk[pos+1] = table[(in[i + k] * 2U) + 1U];
+                    pos += 2U;
                 }
-                while((v > 0) && (iter != buf.rend()));
 
-                break;
+                i += n;
+                run -= n;
 
-            case Base::k16:
+                if((run == 0U) && (i < size)){
+
+                    if(pos == sizeof(chunk)){
 
-                do{
+                        (void)s.write(chunk, pos);
+                        pos = 0;
+                    }
 
-                    *iter = nibble_to_hex(uint8_t(v));
-                    v >>= 4;
-                    ++iter;
+                    chunk[pos] = separator;
+                    pos++;
+                    run = group;
                 }
-                while((v > 0) && (iter != buf.rend()));
 
-                (void)put_string("0x");
+                if((sizeof(chunk) - pos) < 2U){
 
-                break;
+                    (void)s.write(chunk, pos);
+                    pos = 0;
+                }
             }
 
-            auto num_digits = iter - buf.rbegin();
+            if(pos > 0U){
 
-            (void)s.write(&(iter[-1]), num_digits);
+                (void)s.write(chunk, pos);
+            }
 
             return *this;
         }
 
-        static char nibble_to_hex(uint8_t value)
+        template<typename T>
+        Encoder& uint_to_s(T value, Base base)
         {
-            static const char table[] = {
-                '0',
-                '1',
-                '2',
-                '3',
-                '4',
-                '5',
-                '6',
-                '7',
-                '8',
-                '9',
-                'a',
-                'b',
-                'c',
-                'd',
-                'e',
-                'f'
-            };
+            // "0x" and at most 16 digits, or at most 20 digits
+            char buf[IntegerFormat::max_chars];
+            char *end;
+
+            switch(base){
+            default:
+            case Base::k10:
+
+                end = IntegerFormat::to_chars(buf, buf + sizeof(buf), value);
+                break;
+
+            case Base::k16:
+
+                buf[0] = '0';
+                buf[1] = 'x';
+                end = IntegerFormat::to_hex_chars(&buf[2], buf + sizeof(buf), value);
+                break;
+            }
+
+            (void)s.write(buf, size_t(end - buf));
+
+            return *this;
+        }
+
+        template<typename T, typename TU>
+        Encoder& int_to_s(T value, Base base)
+        {
+            if(base == Base::k10){
+
+                char buf[IntegerFormat::max_chars];
+
+                (void)s.write(buf, size_t(IntegerFormat::to_chars(buf, buf + sizeof(buf), value) - buf));
+            }
+            else{
+
+                // two's complement
+                (void)uint_to_s<TU>(TU(value), base);
+            }
+
+            return *this;
+        }
 
-            return table[value & 0xf];
+        // two digit representation of each byte value
+        static const char *hex_pairs_lower()
+        {
+            static const char table[] =
+                "000102030405060708090a0b0c0d0e0f"
+                "101112131415161718191a1b1c1d1e1f"
+                "202122232425262728292a2b2c2d2e2f"
+                "303132333435363738393a3b3c3d3e3f"
+                "404142434445464748494a4b4c4d4e4f"
+                "505152535455565758595a5b5c5d5e5f"
+                "606162636465666768696a6b6c6d6e6f"
+                "707172737475767778797a7b7c7d7e7f"
+                "808182838485868788898a8b8c8d8e8f"
+                "909192939495969798999a9b9c9d9e9f"
+                "a0a1a2a3a4a5a6a7a8a9aaabacadaeaf"
+                "b0b1b2b3b4b5b6b7b8b9babbbcbdbebf"
+                "c0c1c2c3c4c5c6c7c8c9cacbcccdcecf"
+                "d0d1d2d3d4d5d6d7d8d9dadbdcdddedf"
+                "e0e1e2e3e4e5e6e7e8e9eaebecedeeef"
+                "f0f1f2f3f4f5f6f7f8f9fafbfcfdfeff";
+
+            return table;
+        }
+
+        static const char *hex_pairs_upper()
+        {
+            static const char table[] =
+                "000102030405060708090A0B0C0D0E0F"
+                "101112131415161718191A1B1C1D1E1F"
+                "202122232425262728292A2B2C2D2E2F"
+                "303132333435363738393A3B3C3D3E3F"
+                "404142434445464748494A4B4C4D4E4F"
+                "505152535455565758595A5B5C5D5E5F"
+                "606162636465666768696A6B6C6D6E6F"
+                "707172737475767778797A7B7C7D7E7F"
+                "808182838485868788898A8B8C8D8E8F"
+                "909192939495969798999A9B9C9D9E9F"
+                "A0A1A2A3A4A5A6A7A8A9AAABACADAEAF"
+                "B0B1B2B3B4B5B6B7B8B9BABBBCBDBEBF"
+                "C0C1C2C3C4C5C6C7C8C9CACBCCCDCECF"
+                "D0D1D2D3D4D5D6D7D8D9DADBDCDDDEDF"
+                "E0E1E2E3E4E5E6E7E8E9EAEBECEDEEEF"
+                "F0F1F2F3F4F5F6F7F8F9FAFBFCFDFEFF";
+
+            return table;
         }
 
         static char byte_to_b64(uint8_t value)
@@ -0,0 +1,73 @@
+/* Copyright (c) 2024 Cameron Harper
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ *
+ */
+
+#ifndef BRAMBLE_EVENT_QUEUE_H_INCLUDED
+#define BRAMBLE_EVENT_QUEUE_H_INCLUDED
+
+#include "bramble_server.hpp"
+
+#include <cstddef>
+#include <atomic>
+
+namespace Bramble {
+
+    /** A Server::Events queue with storage for a fixed number of lines
+     *
+     * @code
+     * Bramble::EventQueue<16> events;
+     *
+     * server.set_events(&events);
+     *
+     * // from an interrupt or another thread
+     * if(!events.event("rx_done", [&](Bramble::Stream& s){ Bramble::Encoder(s).put_uint16(size); })){
+     *
+     *     // dropped, see events.dropped()
+     * }
+     * @endcode
+     *
+     * @tparam Depth    number of lines (a power of two, at least 2)
+     * @tparam MaxLine  largest line (excluding line ending) that can be queued
+     *
+     * */
+    template<size_t Depth, size_t MaxLine = 128>
+    class EventQueue : public Server::Events {
+    public:
+
+        // a slot's full and free sequence numbers coincide when there is only one
+        static_assert((Depth > 1) && ((Depth & (Depth - 1U)) == 0), "depth must be a power of two greater than one");
+
+        EventQueue()
+            :
+            Events(sequence, sizes, &storage[0][0], Depth, MaxLine)
+        {
+            init();
+        }
+
+    private:
+
+        std::atomic<size_t> sequence[Depth];
+        size_t sizes[Depth];
+        char storage[Depth][MaxLine + 1];
+    };
+};
+
+#endif
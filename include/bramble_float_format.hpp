@@ -0,0 +1,909 @@
+/* Copyright (c) 2024 Cameron Harper
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ *
+ */
+
+#ifndef BRAMBLE_FLOAT_FORMAT_H_INCLUDED
+#define BRAMBLE_FLOAT_FORMAT_H_INCLUDED
+
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <cmath>
+#include <limits>
+
+namespace Bramble {
+
+    /** Floating point to text conversion and back without heap, locale or stdio
+     *
+     * to_chars() puts the shortest digits that read back as the same value
+     * (Grisu2), using plain notation for moderate exponents and "1.5e-7"
+     * notation otherwise. NaN and infinity are put as "nan", "inf" and "-inf".
+     *
+     * from_chars() reads `[-]digits[.digits][(e|E)[+|-]digits]`, "inf" and
+     * "nan". The result is correctly rounded when there are no more than 19
+     * significant digits, otherwise it is within one unit in the last place.
+     *
+     * */
+    class FloatFormat {
+    public:
+
+        /** characters needed for the longest representation of a double */
+        static const size_t max_chars = 32;
+
+        /** write value using the shortest representation that reads back as value
+         *
+         * @param[in] first     start of buffer
+         * @param[in] last      one past the end of buffer
+         * @param[in] value
+         *
+         * @return one past the last character written (nullptr if value does not fit)
+         *
+         * */
+        static char *to_chars(char *first, char *last, double value)
+        {
+            return put_shortest<double>(first, last, value);
+        }
+
+        /// @copydoc to_chars(char *, char *, double)
+        static char *to_chars(char *first, char *last, float value)
+        {
+            return put_shortest<float>(first, last, value);
+        }
+
+        /** read a number
+         *
+         * @param[in] first     start of text
+         * @param[in] last      one past the end of text
+         * @param[out] value
+         *
+         * @return one past the last character read (nullptr if there is no number or it is out of range)
+         *
+         * */
+        static const char *from_chars(const char *first, const char *last, double& value)
+        {
+            return get_nearest<double>(first, last, value);
+        }
+
+        /// @copydoc from_chars(const char *, const char *, double&)
+        static const char *from_chars(const char *first, const char *last, float& value)
+        {
+            return get_nearest<float>(first, last, value);
+        }
+
+    protected:
+
+        // f * 2^e
+        struct DiyFp {
+
+            uint64_t f;
+            int e;
+        };
+
+        struct CachedPower {
+
+            uint64_t f;
+            int e;
+            int k;
+        };
+
+        static const int cached_powers_min_dec_exp = -348;
+        static const int cached_powers_dec_step = 8;
+
+        // 10^k = f * 2^e for k in [-348, 340] step 8, f rounded to nearest
+        static const CachedPower& cached_power(size_t index)
+        {
+            static const CachedPower table[] = {
+                {0xFA8FD5A0081C0288ULL, -1220, -348},
+                {0xBAAEE17FA23EBF76ULL, -1193, -340},
+                {0x8B16FB203055AC76ULL, -1166, -332},
+                {0xCF42894A5DCE35EAULL, -1140, -324},
+                {0x9A6BB0AA55653B2DULL, -1113, -316},
+                {0xE61ACF033D1A45DFULL, -1087, -308},
+                {0xAB70FE17C79AC6CAULL, -1060, -300},
+                {0xFF77B1FCBEBCDC4FULL, -1034, -292},
+                {0xBE5691EF416BD60CULL, -1007, -284},
+                {0x8DD01FAD907FFC3CULL, -980, -276},
+                {0xD3515C2831559A83ULL, -954, -268},
+                {0x9D71AC8FADA6C9B5ULL, -927, -260},
+                {0xEA9C227723EE8BCBULL, -901, -252},
+                {0xAECC49914078536DULL, -874, -244},
+                {0x823C12795DB6CE57ULL, -847, -236},
+                {0xC21094364DFB5637ULL, -821, -228},
+                {0x9096EA6F3848984FULL, -794, -220},
+                {0xD77485CB25823AC7ULL, -768, -212},
+                {0xA086CFCD97BF97F4ULL, -741, -204},
+                {0xEF340A98172AACE5ULL, -715, -196},
+                {0xB23867FB2A35B28EULL, -688, -188},
+                {0x84C8D4DFD2C63F3BULL, -661, -180},
+                {0xC5DD44271AD3CDBAULL, -635, -172},
+                {0x936B9FCEBB25C996ULL, -608, -164},
+                {0xDBAC6C247D62A584ULL, -582, -156},
+                {0xA3AB66580D5FDAF6ULL, -555, -148},
+                {0xF3E2F893DEC3F126ULL, -529, -140},
+                {0xB5B5ADA8AAFF80B8ULL, -502, -132},
+                {0x87625F056C7C4A8BULL, -475, -124},
+                {0xC9BCFF6034C13053ULL, -449, -116},
+                {0x964E858C91BA2655ULL, -422, -108},
+                {0xDFF9772470297EBDULL, -396, -100},
+                {0xA6DFBD9FB8E5B88FULL, -369, -92},
+                {0xF8A95FCF88747D94ULL, -343, -84},
+                {0xB94470938FA89BCFULL, -316, -76},
+                {0x8A08F0F8BF0F156BULL, -289, -68},
+                {0xCDB02555653131B6ULL, -263, -60},
+                {0x993FE2C6D07B7FACULL, -236, -52},
+                {0xE45C10C42A2B3B06ULL, -210, -44},
+                {0xAA242499697392D3ULL, -183, -36},
+                {0xFD87B5F28300CA0EULL, -157, -28},
+                {0xBCE5086492111AEBULL, -130, -20},
+                {0x8CBCCC096F5088CCULL, -103, -12},
+                {0xD1B71758E219652CULL, -77, -4},
+                {0x9C40000000000000ULL, -50, 4},
+                {0xE8D4A51000000000ULL, -24, 12},
+                {0xAD78EBC5AC620000ULL, 3, 20},
+                {0x813F3978F8940984ULL, 30, 28},
+                {0xC097CE7BC90715B3ULL, 56, 36},
+                {0x8F7E32CE7BEA5C70ULL, 83, 44},
+                {0xD5D238A4ABE98068ULL, 109, 52},
+                {0x9F4F2726179A2245ULL, 136, 60},
+                {0xED63A231D4C4FB27ULL, 162, 68},
+                {0xB0DE65388CC8ADA8ULL, 189, 76},
+                {0x83C7088E1AAB65DBULL, 216, 84},
+                {0xC45D1DF942711D9AULL, 242, 92},
+                {0x924D692CA61BE758ULL, 269, 100},
+                {0xDA01EE641A708DEAULL, 295, 108},
+                {0xA26DA3999AEF774AULL, 322, 116},
+                {0xF209787BB47D6B85ULL, 348, 124},
+                {0xB454E4A179DD1877ULL, 375, 132},
+                {0x865B86925B9BC5C2ULL, 402, 140},
+                {0xC83553C5C8965D3DULL, 428, 148},
+                {0x952AB45CFA97A0B3ULL, 455, 156},
+                {0xDE469FBD99A05FE3ULL, 481, 164},
+                {0xA59BC234DB398C25ULL, 508, 172},
+                {0xF6C69A72A3989F5CULL, 534, 180},
+                {0xB7DCBF5354E9BECEULL, 561, 188},
+                {0x88FCF317F22241E2ULL, 588, 196},
+                {0xCC20CE9BD35C78A5ULL, 614, 204},
+                {0x98165AF37B2153DFULL, 641, 212},
+                {0xE2A0B5DC971F303AULL, 667, 220},
+                {0xA8D9D1535CE3B396ULL, 694, 228},
+                {0xFB9B7CD9A4A7443CULL, 720, 236},
+                {0xBB764C4CA7A44410ULL, 747, 244},
+                {0x8BAB8EEFB6409C1AULL, 774, 252},
+                {0xD01FEF10A657842CULL, 800, 260},
+                {0x9B10A4E5E9913129ULL, 827, 268},
+                {0xE7109BFBA19C0C9DULL, 853, 276},
+                {0xAC2820D9623BF429ULL, 880, 284},
+                {0x80444B5E7AA7CF85ULL, 907, 292},
+                {0xBF21E44003ACDD2DULL, 933, 300},
+                {0x8E679C2F5E44FF8FULL, 960, 308},
+                {0xD433179D9C8CB841ULL, 986, 316},
+                {0x9E19DB92B4E31BA9ULL, 1013, 324},
+                {0xEB96BF6EBADF77D9ULL, 1039, 332},
+                {0xAF87023B9BF0EE6BULL, 1066, 340},
+            };
+
+            return table[index];
+        }
+
+        // floating point types differ only in these parameters
+        template<typename T>
+        struct Traits;
+
+        static DiyFp mul(DiyFp x, DiyFp y)
+        {
+            uint64_t u_lo = x.f & 0xffffffffU, u_hi = x.f >> 32;
+            uint64_t v_lo = y.f & 0xffffffffU, v_hi = y.f >> 32;
+
+            uint64_t p0 = u_lo * v_lo;
+            uint64_t p1 = u_lo * v_hi;
+            uint64_t p2 = u_hi * v_lo;
+            uint64_t p3 = u_hi * v_hi;
+
+            // round the discarded half
+            uint64_t q = (p0 >> 32) + (p1 & 0xffffffffU) + (p2 & 0xffffffffU) + (uint64_t(1) << 31);
+
+            return DiyFp{p3 + (p2 >> 32) + (p1 >> 32) + (q >> 32), x.e + y.e + 64};
+        }
+
+        static DiyFp normalize(DiyFp x)
+        {
+            while((x.f >> 63) == 0U){
+
+                x.f <<= 1;
+                x.e--;
+            }
+
+            return x;
+        }
+
+        /* Grisu2 (Loitsch, "Printing Floating-Point Numbers Quickly and
+         * Accurately with Integers") following the presentation in
+         * nlohmann/json */
+
+        template<typename T>
+        static void compute_boundaries(T value, DiyFp& w, DiyFp& minus, DiyFp& plus)
+        {
+            typedef typename Traits<T>::Bits Bits;
+
+            const int precision = std::numeric_limits<T>::digits;
+            const int bias = std::numeric_limits<T>::max_exponent - 1 + (precision - 1);
+            const uint64_t hidden = uint64_t(1) << (precision - 1);
+
+            Bits bits;
+
+            (void)memcpy(&bits, &value, sizeof(bits));
+
+            uint64_t e = uint64_t(bits) >> (precision - 1);
+            uint64_t f = uint64_t(bits) & (hidden - 1U);
+
+            DiyFp v = (e == 0U) ? DiyFp{f, 1 - bias} : DiyFp{f + hidden, int(e) - bias};
+
+            bool lower_is_closer = (f == 0U) && (e > 1U);
+
+            plus = normalize(DiyFp{(2U * v.f) + 1U, v.e - 1});
+            minus = lower_is_closer ? DiyFp{(4U * v.f) - 1U, v.e - 2} : DiyFp{(2U * v.f) - 1U, v.e - 1};
+            minus.f <<= (minus.e - plus.e);
+            minus.e = plus.e;
+            w = normalize(v);
+        }
+
+        static int largest_pow10(uint32_t n, uint32_t& pow10)
+        {
+            static const uint32_t table[] = {
+                1UL, 10UL, 100UL, 1000UL, 10000UL, 100000UL, 1000000UL, 10000000UL, 100000000UL, 1000000000UL
+            };
+
+            int retval = 10;
+
+            while((retval > 1) && (n < table[retval - 1])){
+
+                retval--;
+            }
+
+            pow10 = table[retval - 1];
+
+            return retval;
+        }
+
+        static void grisu2_round(char *buf, int len, uint64_t dist, uint64_t delta, uint64_t rest, uint64_t ten_k)
+        {
+            while((rest < dist) && ((delta - rest) >= ten_k) && (((rest + ten_k) < dist) || ((dist - rest) > (rest + ten_k - dist)))){
+
+                buf[len - 1]--;
+                rest += ten_k;
+            }
+        }
+
+        static void grisu2_digit_gen(char *buf, int& len, int& exp10, DiyFp m_minus, DiyFp w, DiyFp m_plus)
+        {
+            uint64_t delta = m_plus.f - m_minus.f;
+            uint64_t dist = m_plus.f - w.f;
+
+            DiyFp one{uint64_t(1) << -m_plus.e, m_plus.e};
+
+            uint32_t p1 = uint32_t(m_plus.f >> -one.e);
+            uint64_t p2 = m_plus.f & (one.f - 1U);
+
+            uint32_t pow10;
+            int n = largest_pow10(p1, pow10);
+            bool done = false;
+
+            // integral digits
+            while((n > 0) && !done){
+
+                uint32_t d = p1 / pow10;
+
+                p1 %= pow10;
+                buf[len++] = char('0' + d);
+                n--;
+
+                uint64_t rest = (uint64_t(p1) << -one.e) + p2;
+
+                if(rest <= delta){
+
+                    exp10 += n;
+                    grisu2_round(buf, len, dist, delta, rest, uint64_t(pow10) << -one.e);
+                    done = true;
+                }
+
+                pow10 /= 10U;
+            }
+
+            // fractional digits
+            if(!done){
+
+                int m = 0;
+
+                do{
+
+                    p2 *= 10U;
+                    buf[len++] = char('0' + (p2 >> -one.e));
+                    p2 &= (one.f - 1U);
+                    m++;
+                    delta *= 10U;
+                    dist *= 10U;
+                }
+                while(p2 > delta);
+
+                exp10 -= m;
+                grisu2_round(buf, len, dist, delta, p2, one.f);
+            }
+        }
+
+        // shortest digits and exponent such that value == digits * 10^exp10 (value > 0)
+        template<typename T>
+        static void grisu2(char *buf, int& len, int& exp10, T value)
+        {
+            const int alpha = -60;
+
+            DiyFp w, minus, plus;
+
+            compute_boundaries<T>(value, w, minus, plus);
+
+            // cached power c such that the product exponent is in [alpha, gamma]
+            int f = alpha - plus.e - 1;
+            int k = ((f * 78913) / (1 << 18)) + ((f > 0) ? 1 : 0);
+            size_t index = size_t(-cached_powers_min_dec_exp + k + (cached_powers_dec_step - 1)) / size_t(cached_powers_dec_step);
+
+            const CachedPower& cached = cached_power(index);
+            DiyFp c{cached.f, cached.e};
+
+            DiyFp w_minus = mul(minus, c);
+            DiyFp w_plus = mul(plus, c);
+
+            len = 0;
+            exp10 = -cached.k;
+
+            grisu2_digit_gen(buf, len, exp10, DiyFp{w_minus.f + 1U, w_minus.e}, mul(w, c), DiyFp{w_plus.f - 1U, w_plus.e});
+        }
+
+        template<typename T>
+        static char *put_shortest(char *first, char *last, T value)
+        {
+            char buf[max_chars];
+            char *p = buf;
+
+            if(std::signbit(value) && !std::isnan(value)){
+
+                *p = '-';
+                p++;
+                value = -value;
+            }
+
+            if(std::isnan(value)){
+
+                (void)memcpy(p, "nan", 3);
+                p += 3;
+            }
+            else if(std::isinf(value)){
+
+                (void)memcpy(p, "inf", 3);
+                p += 3;
+            }
+            else if(value == T(0)){
+
+                *p = '0';
+                p++;
+            }
+            else{
+
+                int len, exp10;
+
+                grisu2<T>(p, len, exp10, value);
+
+                p = format_digits(p, len, exp10);
+            }
+
+            char *retval = nullptr;
+            size_t n = size_t(p - buf);
+
+            if((last - first) >= ptrdiff_t(n)){
+
+                (void)memcpy(first, buf, n);
+                retval = first + n;
+            }
+
+            return retval;
+        }
+
+        // lay out digits * 10^exp10 in place and return the end
+        static char *format_digits(char *buf, int k, int exp10)
+        {
+            const int min_exp = -4;
+            const int max_exp = 15;
+
+            // position of the decimal point relative to buf
+            int n = k + exp10;
+
+            char *retval;
+
+            if((k <= n) && (n <= max_exp)){
+
+                // digits000
+                (void)memset(buf + k, '0', size_t(n - k));
+                retval = buf + n;
+            }
+            else if((0 < n) && (n <= max_exp)){
+
+                // dig.its
+                (void)memmove(buf + n + 1, buf + n, size_t(k - n));
+                buf[n] = '.';
+                retval = buf + k + 1;
+            }
+            else if((min_exp < n) && (n <= 0)){
+
+                // 0.000digits
+                (void)memmove(buf + 2 + (-n), buf, size_t(k));
+                buf[0] = '0';
+                buf[1] = '.';
+                (void)memset(buf + 2, '0', size_t(-n));
+                retval = buf + 2 + (-n) + k;
+            }
+            else{
+
+                // d.igitse-7
+                if(k > 1){
+
+                    (void)memmove(buf + 2, buf + 1, size_t(k - 1));
+                    buf[1] = '.';
+                    retval = buf + k + 1;
+                }
+                else{
+
+                    retval = buf + 1;
+                }
+
+                int e = n - 1;
+
+                *retval = 'e';
+                retval++;
+
+                if(e < 0){
+
+                    *retval = '-';
+                    retval++;
+                    e = -e;
+                }
+
+                if(e >= 100){
+
+                    *retval = char('0' + (e / 100));
+                    retval++;
+                    e %= 100;
+                    *retval = char('0' + (e / 10));
+                    retval++;
+                }
+                else if(e >= 10){
+
+                    *retval = char('0' + (e / 10));
+                    retval++;
+                }
+
+                *retval = char('0' + (e % 10));
+                retval++;
+            }
+
+            return retval;
+        }
+
+        /* Parsing */
+
+        // fixed size unsigned integer, enough for the exact comparisons made by nearest()
+        class BigInt {
+        public:
+
+            static const size_t words = 40;
+
+            BigInt(uint64_t value)
+                :
+                size(0)
+            {
+                while(value > 0U){
+
+                    word[size] = uint32_t(value);
+                    size++;
+                    value >>= 32;
+                }
+            }
+
+            void mul(uint32_t m)
+            {
+                uint64_t carry = 0;
+
+                for(size_t i = 0; i < size; i++){
+
+                    uint64_t p = (uint64_t(word[i]) * m) + carry;
+
+                    word[i] = uint32_t(p);
+                    carry = p >> 32;
+                }
+
+                if((carry > 0U) && (size < words)){
+
+                    word[size] = uint32_t(carry);
+                    size++;
+                }
+            }
+
+            void mul_pow10(int n)
+            {
+                for(; n >= 9; n -= 9){
+
+                    mul(1000000000UL);
+                }
+
+                static const uint32_t pow10[] = {1UL, 10UL, 100UL, 1000UL, 10000UL, 100000UL, 1000000UL, 10000000UL, 100000000UL};
+
+                mul(pow10[n]);
+            }
+
+            void shl(int n)
+            {
+                if((size > 0U) && (n > 0)){
+
+                    size_t w = size_t(n) / 32U;
+                    int b = n % 32;
+
+                    size_t top = (size + w < words) ? (size + w) : (words - 1U);
+
+                    word[top] = 0;
+
+                    for(size_t i = top; i > w; i--){
+
+                        uint64_t v = (uint64_t(word[i - w - 1U]) << b);
+
+                        word[i] |= uint32_t(v >> 32);
+                        word[i - 1U] = uint32_t(v);
+                    }
+
+                    for(size_t i = 0; i < w; i++){
+
+                        word[i] = 0;
+                    }
+
+                    size = top + ((word[top] != 0U) ? 1U : 0U);
+                }
+            }
+
+            int compare(const BigInt& other) const
+            {
+                int retval = 0;
+
+                if(size != other.size){
+
+                    retval = (size < other.size) ? -1 : 1;
+                }
+                else{
+
+                    for(size_t i = size; (i > 0U) && (retval == 0); i--){
+
+                        if(word[i - 1U] != other.word[i - 1U]){
+
+                            retval = (word[i - 1U] < other.word[i - 1U]) ? -1 : 1;
+                        }
+                    }
+                }
+
+                return retval;
+            }
+
+        private:
+
+            uint32_t word[words];
+            size_t size;
+        };
+
+        // round w * 10^exp10 to the nearest T, exact says w holds every significant digit
+        template<typename T>
+        static bool nearest(uint64_t w, int exp10, bool exact, T& value)
+        {
+            typedef Traits<T> Tr;
+
+            static const double pow10[] = {
+                1e0, 1e1, 1e2, 1e3, 1e4, 1e5, 1e6, 1e7, 1e8, 1e9, 1e10, 1e11,
+                1e12, 1e13, 1e14, 1e15, 1e16, 1e17, 1e18, 1e19, 1e20, 1e21, 1e22
+            };
+
+            bool retval = true;
+
+            if(w == 0U){
+
+                value = T(0);
+            }
+            // exact operands give a correctly rounded result (Clinger)
+            else if(exact && (w <= (uint64_t(1) << Tr::mantissa)) && (exp10 >= -Tr::max_pow10) && (exp10 <= Tr::max_pow10)){
+
+                T x = T(w);
+
+                value = (exp10 < 0) ? T(x / T(pow10[-exp10])) : T(x * T(pow10[exp10]));
+            }
+            // too small even for 2^64 * 10^exp10 to reach half the smallest subnormal
+            else if(exp10 < (cached_powers_min_dec_exp + 5)){
+
+                value = T(0);
+            }
+            else if(exp10 > 308){
+
+                retval = false;
+            }
+            else{
+
+                // approximate w * 10^exp10 to within a few units of 64 bits
+                size_t index = size_t(exp10 - cached_powers_min_dec_exp) / size_t(cached_powers_dec_step);
+                int r = exp10 - (cached_powers_min_dec_exp + (int(index) * cached_powers_dec_step));
+
+                const CachedPower& cached = cached_power(index);
+
+                DiyFp x = mul(normalize(DiyFp{w, 0}), DiyFp{cached.f, cached.e});
+
+                if(r > 0){
+
+                    static const uint64_t small[] = {1ULL, 10ULL, 100ULL, 1000ULL, 10000ULL, 100000ULL, 1000000ULL, 10000000ULL};
+
+                    x = mul(normalize(x), normalize(DiyFp{small[r], 0}));
+                }
+
+                x = normalize(x);
+
+                // exponent of the unit in the last place of the result
+                int q = x.e + 64 - Tr::mantissa;
+
+                if(q < Tr::min_q){
+
+                    q = Tr::min_q;
+                }
+
+                int shift = q - x.e;
+                uint64_t m;
+                bool up;
+
+                if(shift > 64){
+
+                    m = 0;
+                    up = false;
+                }
+                else{
+
+                    uint64_t rem, half;
+
+                    if(shift == 64){
+
+                        m = 0;
+                        rem = x.f;
+                        half = uint64_t(1) << 63;
+                    }
+                    else{
+
+                        m = x.f >> shift;
+                        rem = x.f & ((uint64_t(1) << shift) - 1U);
+                        half = uint64_t(1) << (shift - 1);
+                    }
+
+                    uint64_t margin = exact ? 8U : 0U;
+
+                    if(((rem + margin) < half) || (rem > (half + margin))){
+
+                        up = (rem > half);
+                    }
+                    else{
+
+                        // too close to the midpoint to tell, compare exactly with (2m + 1) * 2^(q - 1)
+                        BigInt d(w);
+                        BigInt mid((2U * m) + 1U);
+
+                        if(exp10 >= 0){
+
+                            d.mul_pow10(exp10);
+                        }
+                        else{
+
+                            mid.mul_pow10(-exp10);
+                        }
+
+                        if((q - 1) >= 0){
+
+                            mid.shl(q - 1);
+                        }
+                        else{
+
+                            d.shl(1 - q);
+                        }
+
+                        int c = d.compare(mid);
+
+                        up = (c > 0) || ((c == 0) && ((m & 1U) != 0U));
+                    }
+                }
+
+                if(up){
+
+                    m++;
+                }
+
+                value = std::ldexp(T(m), q);
+
+                retval = !std::isinf(value);
+            }
+
+            return retval;
+        }
+
+        template<typename T>
+        static const char *get_nearest(const char *first, const char *last, T& value)
+        {
+            const char *retval = nullptr;
+            const char *p = first;
+            bool negative = false;
+
+            if((p != last) && ((*p == '-') || (*p == '+'))){
+
+                negative = (*p == '-');
+                p++;
+            }
+
+            if(((last - p) >= 3) && ((p[0] | 0x20) == 'i') && ((p[1] | 0x20) == 'n') && ((p[2] | 0x20) == 'f')){
+
+                value = negative ? -std::numeric_limits<T>::infinity() : std::numeric_limits<T>::infinity();
+                retval = p + 3;
+            }
+            else if(((last - p) >= 3) && ((p[0] | 0x20) == 'n') && ((p[1] | 0x20) == 'a') && ((p[2] | 0x20) == 'n')){
+
+                value = std::numeric_limits<T>::quiet_NaN();
+                retval = p + 3;
+            }
+            else{
+
+                uint64_t w = 0;
+                int digits = 0;
+                int dropped = 0;
+                int exp10 = 0;
+                bool exact = true;
+                bool any = false;
+
+                // leading zeros are insignificant
+                for(; (p != last) && (*p == '0'); p++){
+
+                    any = true;
+                }
+
+                for(; (p != last) && (*p >= '0') && (*p <= '9'); p++){
+
+                    any = true;
+
+                    if(digits < 19){
+
+                        w = (w * 10U) + uint64_t(*p - '0');
+                        digits++;
+                    }
+                    else{
+
+                        exact = exact && (*p == '0');
+                        dropped++;
+                    }
+                }
+
+                if((p != last) && (*p == '.')){
+
+                    p++;
+
+                    if(digits == 0){
+
+                        for(; (p != last) && (*p == '0'); p++){
+
+                            any = true;
+                            exp10--;
+                        }
+                    }
+
+                    for(; (p != last) && (*p >= '0') && (*p <= '9'); p++){
+
+                        any = true;
+
+                        if(digits < 19){
+
+                            w = (w * 10U) + uint64_t(*p - '0');
+                            digits++;
+                            exp10--;
+                        }
+                        else{
+
+                            exact = exact && (*p == '0');
+                        }
+                    }
+                }
+
+                exp10 += dropped;
+
+                if(any){
+
+                    const char *mark = p;
+
+                    if((p != last) && ((*p | 0x20) == 'e')){
+
+                        p++;
+
+                        bool exp_negative = false;
+                        int e = 0;
+
+                        if((p != last) && ((*p == '-') || (*p == '+'))){
+
+                            exp_negative = (*p == '-');
+                            p++;
+                        }
+
+                        if((p != last) && (*p >= '0') && (*p <= '9')){
+
+                            for(; (p != last) && (*p >= '0') && (*p <= '9'); p++){
+
+                                // saturate, anything this large is zero or out of range
+                                if(e < 100000){
+
+                                    e = (e * 10) + (*p - '0');
+                                }
+                            }
+
+                            exp10 += exp_negative ? -e : e;
+                        }
+                        else{
+
+                            // not an exponent
+                            p = mark;
+                        }
+                    }
+
+                    T v;
+
+                    if(nearest<T>(w, exp10, exact, v)){
+
+                        value = negative ? -v : v;
+                        retval = p;
+                    }
+                }
+            }
+
+            return retval;
+        }
+    };
+
+    /// @private
+    template<>
+    struct FloatFormat::Traits<double> {
+
+        typedef uint64_t Bits;
+
+        static const int mantissa = 53;         // significand bits
+        static const int min_q = -1074;         // exponent of the smallest subnormal
+        static const int max_pow10 = 22;        // largest exactly representable power of ten
+    };
+
+    /// @private
+    template<>
+    struct FloatFormat::Traits<float> {
+
+        typedef uint32_t Bits;
+
+        static const int mantissa = 24;
+        static const int min_q = -149;
+        static const int max_pow10 = 10;
+    };
+};
+
+#endif
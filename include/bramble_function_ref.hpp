@@ -0,0 +1,107 @@
+/* Copyright (c) 2024 Cameron Harper
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ *
+ */
+
+#ifndef BRAMBLE_FUNCTION_REF_H_INCLUDED
+#define BRAMBLE_FUNCTION_REF_H_INCLUDED
+
+#include <memory>
+#include <type_traits>
+#include <utility>
+
+namespace Bramble {
+
+    /// @private
+    template<typename Fn>
+    class FunctionRef;
+
+    /** A non-owning reference to a callable
+     *
+     * Unlike std::function this never allocates. The callable must outlive the
+     * reference, which is always the case when a FunctionRef is only used as a
+     * parameter.
+     *
+     * @tparam R        return type
+     * @tparam Args     argument types
+     *
+     * */
+    template<typename R, typename... Args>
+    class FunctionRef<R(Args...)> {
+    public:
+
+        /** Refer to a callable object
+         *
+         * @param[in] f     callable (must outlive this instance)
+         *
+         * */
+        template<typename F, typename = typename std::enable_if<!std::is_same<typename std::decay<F>::type, FunctionRef>::value>::type>
+        FunctionRef(F&& f)
+            :
+            fn(call<typename std::remove_reference<F>::type>)
+        {
+            target.obj = const_cast<void *>(static_cast<const void *>(std::addressof(f)));
+        }
+
+        /** Refer to a function
+         *
+         * @param[in] f     function
+         *
+         * */
+        FunctionRef(R (*f)(Args...))
+            :
+            fn(call_ptr)
+        {
+            target.ptr = f;
+        }
+
+        /** Call the referenced callable
+         *
+         * */
+        R operator()(Args... args) const
+        {
+            return fn(target, std::forward<Args>(args)...);
+        }
+
+    private:
+
+        union Target {
+
+            void *obj;
+            R (*ptr)(Args...);
+        };
+
+        Target target;
+        R (*fn)(Target, Args...);
+
+        template<typename F>
+        static R call(Target target, Args... args)
+        {
+            return (*static_cast<F *>(target.obj))(std::forward<Args>(args)...);
+        }
+
+        static R call_ptr(Target target, Args... args)
+        {
+            return target.ptr(std::forward<Args>(args)...);
+        }
+    };
+};
+
+#endif
@@ -25,6 +25,7 @@
 
 #include "bramble_string_view.hpp"
 #include "bramble_argument.hpp"
+#include "bramble_hash.hpp"
 
 #include <cstdint>
 #include <cstddef>
@@ -62,6 +63,77 @@ namespace Bramble {
             void (*handler)(GetOpt& self);
         };
 
+        /** An index over a static table of options
+         *
+         * Short options are found through a direct table and long options through a hash
+         * index. Both are built at compile time if the option table is constexpr:
+         *
+         * @code
+         * static constexpr Bramble::GetOpt::Option options[] = {
+         *     {"freq", 'f', Bramble::GetOpt::Value::Required, on_freq},
+         *     {"verbose", 'v', Bramble::GetOpt::Value::None, on_verbose}
+         * };
+         *
+         * static constexpr Bramble::GetOpt::Index<2> index(options);
+         *
+         * Bramble::GetOpt parser(args.begin(), args.end(), index);
+         * @endcode
+         *
+         * @tparam N    number of options in table
+         *
+         * */
+        template<size_t N>
+        class Index {
+        public:
+
+            static_assert(N < UINT8_MAX, "table is too large");
+
+            /** Index a table of options
+             *
+             * @param[in] options   table (must outlive this instance)
+             *
+             * */
+            constexpr Index(const Option (&options)[N])
+                :
+                Index(options, typename MakeSequence<256>::type())
+            {
+            }
+
+        private:
+
+            friend class GetOpt;
+
+            HashIndex<Option, N, &Option::s> long_index;
+            uint8_t short_index[256];
+
+            template<size_t... C>
+            constexpr Index(const Option (&options)[N], Sequence<C...>)
+                :
+                long_index(options),
+                short_index{uint8_t(first(options, char(C), 0, N))...}
+            {
+            }
+
+            static constexpr size_t lowest(size_t a, size_t b)
+            {
+                return (a < b) ? a : b;
+            }
+
+            // lowest index in [lo, hi) with short name c, otherwise N
+            static constexpr size_t first(const Option *options, char c, size_t lo, size_t hi)
+            {
+                return (hi <= lo)
+                    ?
+                    N
+                    :
+                    (hi - lo == 1)
+                        ?
+                        (((c != 0) && (options[lo].c == c)) ? lo : N)
+                        :
+                        lowest(first(options, c, lo, lo + (hi - lo)/2), first(options, c, lo + (hi - lo)/2, hi));
+            }
+        };
+
         /** Create an option parser instance
          *
          * @param[in] begin     iterator to first token
@@ -80,10 +152,27 @@ namespace Bramble {
             opt(nullptr),
             ctx(nullptr),
             status(Status::Active),
-            state(&Next::instance())
+            state(&Next::instance()),
+            short_index(nullptr)
         {
         }
 
+        /** Create an option parser instance that uses an index
+         *
+         * @param[in] begin     iterator to first token
+         * @param[in] end       iterator to end of tokens
+         * @param[in] index     index over a table of options
+         *
+         * */
+        template<size_t N>
+        GetOpt(Argument::iterator begin, Argument::iterator end, const Index<N>& index)
+            :
+            GetOpt(begin, end, index.long_index.data(), N)
+        {
+            short_index = index.short_index;
+            long_index = index.long_index.view();
+        }
+
         /** call to stop parsing now
          *
          * */
@@ -366,7 +455,7 @@ namespace Bramble {
 
                     self.n = self.a->substr(offset, 1);
 
-                    if(!self.lookup_short_option(self.n.front(), &self.opt)){
+                    if(!self.lookup_short_option(*self.n_iter, &self.opt)){
 
                         finish(self, Status::Unknown);
                     }
@@ -455,6 +544,9 @@ namespace Bramble {
 
         const State *state;
 
+        const uint8_t *short_index;
+        HashView<Option, &Option::s> long_index;
+
         void set_state(const State& value)
         {
             state->after(*this);
@@ -466,13 +558,26 @@ namespace Bramble {
         {
             bool retval = false;
 
-            for(auto iter = options_begin; iter != options_end; ++iter){
+            if(short_index != nullptr){
 
-                if(iter->c == c){
+                auto i = short_index[uint8_t(c)];
 
-                    *output = iter;
+                if(i < (options_end - options_begin)){
+
+                    *output = options_begin + i;
                     retval = true;
-                    break;
+                }
+            }
+            else{
+
+                for(auto iter = options_begin; iter != options_end; ++iter){
+
+                    if(iter->c == c){
+
+                        *output = iter;
+                        retval = true;
+                        break;
+                    }
                 }
             }
 
@@ -483,13 +588,21 @@ namespace Bramble {
         {
             bool retval = false;
 
-            for(auto iter = options_begin; iter != options_end; ++iter){
+            if(!long_index.empty()){
 
-                if(s.compare(iter->s) == 0){
+                *output = long_index.find(s);
+                retval = (*output != nullptr);
+            }
+            else{
 
-                    *output = iter;
-                    retval = true;
-                    break;
+                for(auto iter = options_begin; iter != options_end; ++iter){
+
+                    if((iter->s != nullptr) && (s.compare(iter->s) == 0)){
+
+                        *output = iter;
+                        retval = true;
+                        break;
+                    }
                 }
             }
 
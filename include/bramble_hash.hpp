@@ -0,0 +1,316 @@
+/* Copyright (c) 2024 Cameron Harper
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ *
+ */
+
+#ifndef BRAMBLE_HASH_H_INCLUDED
+#define BRAMBLE_HASH_H_INCLUDED
+
+#include "bramble_string_view.hpp"
+
+#include <cstddef>
+#include <cstdint>
+
+namespace Bramble {
+
+    /** FNV-1a string hash
+     *
+     * The null-terminated variant can be evaluated at compile time.
+     *
+     * */
+    class Hash {
+    public:
+
+        /** hash a null-terminated string
+         *
+         * @param[in] s     null-terminated string
+         * @param[in] h     initial value
+         *
+         * @return hash
+         *
+         * */
+        static constexpr uint32_t fnv1a(const char *s, uint32_t h = 2166136261UL)
+        {
+            return (*s == 0) ? h : fnv1a(s + 1, uint32_t((h ^ uint8_t(*s)) * 16777619UL));
+        }
+
+        /** hash a string view
+         *
+         * @param[in] v     string view
+         *
+         * @return hash
+         *
+         * */
+        static uint32_t fnv1a(const StringView& v)
+        {
+            uint32_t h = 2166136261UL;
+
+            for(auto iter = v.begin(); iter != v.end(); ++iter){
+
+                h = uint32_t((h ^ uint8_t(*iter)) * 16777619UL);
+            }
+
+            return h;
+        }
+    };
+
+    /// @private
+    template<size_t... I>
+    struct Sequence {
+    };
+
+    /// @private
+    template<typename A, typename B>
+    struct ConcatSequence;
+
+    /// @private
+    template<size_t... A, size_t... B>
+    struct ConcatSequence<Sequence<A...>, Sequence<B...>> {
+
+        using type = Sequence<A..., (sizeof...(A) + B)...>;
+    };
+
+    /// @private
+    template<size_t N>
+    struct MakeSequence {
+
+        using type = typename ConcatSequence<typename MakeSequence<N/2>::type, typename MakeSequence<N - N/2>::type>::type;
+    };
+
+    /// @private
+    template<>
+    struct MakeSequence<0> {
+
+        using type = Sequence<>;
+    };
+
+    /// @private
+    template<>
+    struct MakeSequence<1> {
+
+        using type = Sequence<0>;
+    };
+
+    /** A view of a HashIndex that does not depend on the size of the table
+     *
+     * @tparam T    table entry type
+     * @tparam Key  pointer to the name member of T
+     *
+     * */
+    template<typename T, const char * T::*Key>
+    class HashView {
+    public:
+
+        /** Create an empty view
+         *
+         * */
+        HashView()
+            :
+            table(nullptr),
+            size(0),
+            bucket(nullptr),
+            buckets(0),
+            next(nullptr)
+        {
+        }
+
+        /// @private
+        HashView(const T *table, size_t size, const uint16_t *bucket, size_t buckets, const uint16_t *next)
+            :
+            table(table),
+            size(size),
+            bucket(bucket),
+            buckets(buckets),
+            next(next)
+        {
+        }
+
+        /** Find an entry by name
+         *
+         * @param[in] name  name to find
+         *
+         * @return pointer to entry or nullptr if not found
+         *
+         * */
+        const T *find(const StringView& name) const
+        {
+            const T *retval = nullptr;
+
+            if(!empty()){
+
+                for(size_t i = bucket[Hash::fnv1a(name) & (buckets - 1)]; i != size; i = next[i]){
+
+                    if(name.compare(table[i].*Key) == 0){
+
+                        retval = &table[i];
+                        break;
+                    }
+                }
+            }
+
+            return retval;
+        }
+
+        /** Return true if this view is not attached to an index
+         *
+         * */
+        bool empty() const
+        {
+            return table == nullptr;
+        }
+
+    private:
+
+        const T *table;
+        size_t size;
+        const uint16_t *bucket;
+        size_t buckets;
+        const uint16_t *next;
+    };
+
+    /// @private
+    constexpr size_t hash_buckets(size_t n, size_t p = 1)
+    {
+        return (p >= n) ? p : hash_buckets(n, p * 2);
+    }
+
+    /** A hash index over a static table
+     *
+     * The index is built from a table of T where each entry is named by a null-terminated
+     * string member (Key). Construction can be done at compile time, lookup
+     * does not allocate and visits only the entries that share a bucket.
+     *
+     * Entries with a null name are not indexed. If more than one entry has the
+     * same name the first one wins.
+     *
+     * @tparam T    table entry type
+     * @tparam N    number of entries in table
+     * @tparam Key  pointer to the name member of T
+     *
+     * */
+    template<typename T, size_t N, const char * T::*Key>
+    class HashIndex {
+    public:
+
+        static_assert(N > 0, "table must not be empty");
+        static_assert(N < UINT16_MAX, "table is too large");
+
+        /** number of buckets (a power of two, at least N) */
+        static constexpr size_t buckets = hash_buckets(N);
+
+        /** Create an index
+         *
+         * @param[in] table     table to index (must outlive the index)
+         *
+         * */
+        constexpr HashIndex(const T (&table)[N])
+            :
+            HashIndex(table, slots(table, typename MakeSequence<N>::type()), typename MakeSequence<buckets>::type(), typename MakeSequence<N>::type())
+        {
+        }
+
+        /** Find an entry by name
+         *
+         * @param[in] name  name to find
+         *
+         * @return pointer to entry or nullptr if not found
+         *
+         * */
+        const T *find(const StringView& name) const
+        {
+            return view().find(name);
+        }
+
+        /** Get a view of this index
+         *
+         * */
+        HashView<T, Key> view() const
+        {
+            return HashView<T, Key>(table, N, bucket, buckets, next);
+        }
+
+        /** the indexed table
+         *
+         * */
+        constexpr const T *data() const
+        {
+            return table;
+        }
+
+        /** number of entries in the indexed table
+         *
+         * */
+        constexpr size_t size() const
+        {
+            return N;
+        }
+
+    private:
+
+        const T *table;
+        uint16_t bucket[buckets];
+        uint16_t next[N];
+
+        // bucket of each entry (buckets if entry is not indexed)
+        struct Slots {
+
+            size_t value[N];
+        };
+
+        template<size_t... K, size_t... I>
+        constexpr HashIndex(const T (&table)[N], const Slots& s, Sequence<K...>, Sequence<I...>)
+            :
+            table(table),
+            bucket{uint16_t(first(s, K, 0, N))...},
+            next{uint16_t((s.value[I] == buckets) ? N : first(s, s.value[I], I + 1, N))...}
+        {
+        }
+
+        template<size_t... I>
+        static constexpr Slots slots(const T *table, Sequence<I...>)
+        {
+            return Slots{{((table[I].*Key == nullptr) ? buckets : (Hash::fnv1a(table[I].*Key) & (buckets - 1)))...}};
+        }
+
+        static constexpr size_t lowest(size_t a, size_t b)
+        {
+            return (a < b) ? a : b;
+        }
+
+        // lowest index in [lo, hi) that belongs to bucket k, otherwise N
+        static constexpr size_t first(const Slots& s, size_t k, size_t lo, size_t hi)
+        {
+            return (hi <= lo)
+                ?
+                N
+                :
+                (hi - lo == 1)
+                    ?
+                    ((s.value[lo] == k) ? lo : N)
+                    :
+                    lowest(first(s, k, lo, lo + (hi - lo)/2), first(s, k, lo + (hi - lo)/2, hi));
+        }
+    };
+
+    template<typename T, size_t N, const char * T::*Key>
+    constexpr size_t HashIndex<T, N, Key>::buckets;
+};
+
+#endif
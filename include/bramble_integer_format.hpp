@@ -0,0 +1,273 @@
+/* Copyright (c) 2024 Cameron Harper
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ *
+ */
+
+#ifndef BRAMBLE_INTEGER_FORMAT_H_INCLUDED
+#define BRAMBLE_INTEGER_FORMAT_H_INCLUDED
+
+#include <cstddef>
+#include <cstdint>
+
+namespace Bramble {
+
+    /** Integer to text conversion into caller provided buffers
+     *
+     * Each to_chars() writes the representation to [first, last) without
+     * a null terminator and returns one past the last character written.
+     * If the representation does not fit nothing is written and nullptr is
+     * returned.
+     *
+     * The size of the representation is known before writing: the number of
+     * decimal digits comes from the bit length of the value, and digits are
+     * then written two at a time from a table.
+     *
+     * */
+    class IntegerFormat {
+    public:
+
+        /** characters needed for the longest decimal representation of a 64 bit integer (including sign) */
+        static const size_t max_chars = 20;
+
+        /** count decimal digits
+         *
+         * @param[in] value
+         *
+         * @return number of digits (at least 1)
+         *
+         * */
+        static size_t count_digits(uint32_t value)
+        {
+            static const uint32_t pow10[] = {
+                1UL, 10UL, 100UL, 1000UL, 10000UL, 100000UL, 1000000UL, 10000000UL, 100000000UL, 1000000000UL
+            };
+
+            uint32_t v = value | 1U;
+            size_t t = (bit_length(v) * 1233U) >> 12;
+
+            return t + ((v >= pow10[t]) ? 1U : 0U);
+        }
+
+        /// @copydoc count_digits(uint32_t)
+        static size_t count_digits(uint64_t value)
+        {
+            static const uint64_t pow10[] = {
+                1ULL, 10ULL, 100ULL, 1000ULL, 10000ULL, 100000ULL, 1000000ULL, 10000000ULL, 100000000ULL, 1000000000ULL,
+                10000000000ULL, 100000000000ULL, 1000000000000ULL, 10000000000000ULL, 100000000000000ULL,
+                1000000000000000ULL, 10000000000000000ULL, 100000000000000000ULL, 1000000000000000000ULL,
+                10000000000000000000ULL
+            };
+
+            uint64_t v = value | 1U;
+            size_t t = (bit_length(v) * 1233U) >> 12;
+
+            return t + ((v >= pow10[t]) ? 1U : 0U);
+        }
+
+        /** count hexadecimal digits
+         *
+         * @param[in] value
+         *
+         * @return number of digits (at least 1)
+         *
+         * */
+        static size_t count_hex_digits(uint64_t value)
+        {
+            return (bit_length(value | 1U) + 3U) / 4U;
+        }
+
+        /** write value as decimal
+         *
+         * @param[in] first     start of buffer
+         * @param[in] last      one past the end of buffer
+         * @param[in] value
+         *
+         * @return one past the last character written (nullptr if value does not fit)
+         *
+         * */
+        static char *to_chars(char *first, char *last, uint32_t value)
+        {
+            return put_digits<uint32_t>(first, last, value, false);
+        }
+
+        /// @copydoc to_chars(char *, char *, uint32_t)
+        static char *to_chars(char *first, char *last, uint64_t value)
+        {
+            return put_digits<uint64_t>(first, last, value, false);
+        }
+
+        /// @copydoc to_chars(char *, char *, uint32_t)
+        static char *to_chars(char *first, char *last, int32_t value)
+        {
+            // negate in unsigned arithmetic so that INT32_MIN is defined
+            return put_digits<uint32_t>(first, last, (value < 0) ? (uint32_t(0) - uint32_t(value)) : uint32_t(value), value < 0);
+        }
+
+        /// @copydoc to_chars(char *, char *, uint32_t)
+        static char *to_chars(char *first, char *last, int64_t value)
+        {
+            return put_digits<uint64_t>(first, last, (value < 0) ? (uint64_t(0) - uint64_t(value)) : uint64_t(value), value < 0);
+        }
+
+        /** write value as lower case hexadecimal (without prefix)
+         *
+         * @param[in] first     start of buffer
+         * @param[in] last      one past the end of buffer
+         * @param[in] value
+         *
+         * @return one past the last character written (nullptr if value does not fit)
+         *
+         * */
+        static char *to_hex_chars(char *first, char *last, uint64_t value)
+        {
+            static const char digits[] = "0123456789abcdef";
+
+            char *retval = nullptr;
+            size_t n = count_hex_digits(value);
+
+            if((last - first) >= ptrdiff_t(n)){
+
+                retval = first + n;
+
+                for(char *p = retval; p != first; value >>= 4){
+
+                    --p;
+                    *p = digits[value & 0xfU];
+                }
+            }
+
+            return retval;
+        }
+
+    protected:
+
+        template<typename T>
+        static char *put_digits(char *first, char *last, T value, bool negative)
+        {
+            char *retval = nullptr;
+            size_t n = count_digits(value) + (negative ? 1U : 0U);
+
+            if((last - first) >= ptrdiff_t(n)){
+
+                const char *pairs = digit_pairs();
+                char *p = first + n;
+                T v = value;
+
+                retval = p;
+
+                // peel eight digits at a time so the rest is done in 32 bit arithmetic
+                while(v > T(UINT32_MAX)){
+
+                    uint32_t low = uint32_t(v % T(100000000UL));
+
+                    v /= T(100000000UL);
+                    p -= 8;
+
+                    for(size_t k = 8; k > 0; k -= 2){
+
+                        size_t i = size_t(low % 100U) * 2U;
+
+                        low /= 100U;
+                        p[k - 2U] = pairs[i];
+                        p[k - 1U] = pairs[i + 1U];
+                    }
+                }
+
+                uint32_t w = uint32_t(v);
+
+                while(w >= 100U){
+
+                    size_t i = size_t(w % 100U) * 2U;
+
+                    w /= 100U;
+                    p -= 2;
+                    p[0] = pairs[i];
+                    p[1] = pairs[i + 1U];
+                }
+
+                if(w >= 10U){
+
+                    size_t i = size_t(w) * 2U;
+
+                    p -= 2;
+                    p[0] = pairs[i];
+                    p[1] = pairs[i + 1U];
+                }
+                else{
+
+                    --p;
+                    *p = char('0' + char(w));
+                }
+
+                if(negative){
+
+                    *first = '-';
+                }
+            }
+
+            return retval;
+        }
+
+        // number of significant bits (value must not be zero)
+        static size_t bit_length(uint32_t value)
+        {
+#if defined(__GNUC__)
+            return 32U - size_t(__builtin_clz(value));
+#else
+            return bit_length(uint64_t(value));
+#endif
+        }
+
+        static size_t bit_length(uint64_t value)
+        {
+#if defined(__GNUC__)
+            return 64U - size_t(__builtin_clzll(value));
+#else
+            size_t retval = 0;
+
+            for(; value != 0U; value >>= 1){
+
+                retval++;
+            }
+
+            return retval;
+#endif
+        }
+
+        static const char *digit_pairs()
+        {
+            static const char table[] =
+                "00010203040506070809"
+                "10111213141516171819"
+                "20212223242526272829"
+                "30313233343536373839"
+                "40414243444546474849"
+                "50515253545556575859"
+                "60616263646566676869"
+                "70717273747576777879"
+                "80818283848586878889"
+                "90919293949596979899";
+
+            return table;
+        }
+    };
+};
+
+#endif
@@ -0,0 +1,74 @@
+/* Copyright (c) 2024 Cameron Harper
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ *
+ */
+
+#ifndef BRAMBLE_LINE_QUEUE_H_INCLUDED
+#define BRAMBLE_LINE_QUEUE_H_INCLUDED
+
+#include "bramble_server.hpp"
+
+#include <cstddef>
+
+namespace Bramble {
+
+    /** A Server::Queue with storage for a fixed number of lines
+     *
+     * @code
+     * Bramble::LineQueue<8> queue;
+     *
+     * server.set_queue(&queue);
+     *
+     * for(;;){
+     *
+     *     server.process();
+     *
+     *     while(server.step());
+     * }
+     * @endcode
+     *
+     * @tparam Depth    number of lines
+     * @tparam MaxLine  largest line that can be queued
+     *
+     * */
+    template<size_t Depth, size_t MaxLine = 1024>
+    class LineQueue : public Server::Queue {
+    public:
+
+        static_assert(Depth > 0, "queue must hold at least one line");
+
+        /** Create a queue
+         *
+         * @param[in] overflow  overflow policy
+         *
+         * */
+        LineQueue(Overflow overflow = Overflow::Reject)
+            :
+            Queue(&storage[0][0], Depth, MaxLine, overflow)
+        {
+        }
+
+    private:
+
+        char storage[Depth][MaxLine + 1];
+    };
+};
+
+#endif
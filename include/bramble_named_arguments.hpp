@@ -0,0 +1,394 @@
+/* Copyright (c) 2024 Cameron Harper
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ *
+ */
+
+#ifndef BRAMBLE_NAMED_ARGUMENTS_H_INCLUDED
+#define BRAMBLE_NAMED_ARGUMENTS_H_INCLUDED
+
+#include "bramble_argument.hpp"
+#include "bramble_decoder.hpp"
+#include "bramble_string_view.hpp"
+
+#include <cstddef>
+
+namespace Bramble {
+
+    /** An index of the named arguments (name=value) in an Argument container
+     *
+     * The index is built in one pass over the tokens and kept sorted by name,
+     * so each lookup is a binary search rather than a scan of every token.
+     * Storage is inline, so an index can live on the stack of a command handler.
+     *
+     * Lookups mark entries as consumed, which makes it possible to reject
+     * names the handler did not ask for:
+     *
+     * @code
+     * bool YourHost::call(Bramble::Server::Command& cmd, const Bramble::Argument& args)
+     * {
+     *     Bramble::NamedArguments<8> named(args);
+     *     Bramble::Decoder value;
+     *     uint32_t freq;
+     *
+     *     if(named.overflow() || named.has_duplicate()){
+     *
+     *         cmd.nak("bad_argument");
+     *     }
+     *     else if(!named.get("freq", value) || !value.get_uint32(freq)){
+     *
+     *         cmd.nak("freq");
+     *     }
+     *     else if(named.unconsumed() != nullptr){
+     *
+     *         cmd.nak("unknown_argument");
+     *     }
+     *     else{
+     *
+     *         cmd.ack();
+     *     }
+     *
+     *     return true;
+     * }
+     * @endcode
+     *
+     * Tokens without '=' are not indexed.
+     *
+     * @tparam N    maximum number of named arguments to index
+     *
+     * */
+    template<size_t N>
+    class NamedArguments {
+    public:
+
+        static_assert(N > 0, "index must have at least one entry");
+
+        /** An indexed named argument
+         *
+         * */
+        class Entry {
+        public:
+
+            Entry()
+                :
+                used(false)
+            {
+            }
+
+            /** Get the name
+             *
+             * @return StringView
+             *
+             * */
+            StringView name() const
+            {
+                return n;
+            }
+
+            /** Get the value as-is (everything after the first '=')
+             *
+             * @return StringView
+             *
+             * */
+            StringView value() const
+            {
+                return v;
+            }
+
+            /** Test if this entry has been looked up with find() or get()
+             *
+             * @retval true     consumed
+             * @retval false    not consumed
+             *
+             * */
+            bool consumed() const
+            {
+                return used;
+            }
+
+        private:
+
+            friend class NamedArguments;
+
+            StringView n;
+            StringView v;
+            bool used;
+        };
+
+        typedef const Entry *const_iterator;
+
+        /** Index the named arguments in args
+         *
+         * @param[in] args  argument container
+         *
+         * */
+        NamedArguments(const Argument& args)
+            :
+            count(0),
+            dropped(false),
+            duplicated(false)
+        {
+            for(auto token : args){
+
+                auto eq = token.find_first_of('=');
+
+                if(eq != token.npos){
+
+                    auto name = Decoder::strip(token);
+
+                    insert(name.substr(0, name.find_first_of('=')), token.substr(eq+1));
+                }
+            }
+        }
+
+        NamedArguments(const NamedArguments&) = delete;
+        NamedArguments& operator=(const NamedArguments&) = delete;
+
+        /** Number of indexed names
+         *
+         * */
+        size_t size() const
+        {
+            return count;
+        }
+
+        /** Test if no names are indexed
+         *
+         * */
+        bool empty() const
+        {
+            return count == 0;
+        }
+
+        /** Test if there were more distinct names than the index can hold
+         *
+         * Names that did not fit are not indexed.
+         *
+         * @retval true     some names were not indexed
+         * @retval false    all names were indexed
+         *
+         * */
+        bool overflow() const
+        {
+            return dropped;
+        }
+
+        /** Test if any name appeared more than once
+         *
+         * Only the first occurrence of a name is indexed.
+         *
+         * @retval true     a name was repeated
+         * @retval false    every name is unique
+         *
+         * */
+        bool has_duplicate() const
+        {
+            return duplicated;
+        }
+
+        /** Get the first name that was repeated
+         *
+         * @return StringView (empty if has_duplicate() is false)
+         *
+         * */
+        StringView duplicate() const
+        {
+            return repeated;
+        }
+
+        /** Test if name is indexed without consuming it
+         *
+         * @param[in] name
+         *
+         * @retval true     indexed
+         * @retval false    not indexed
+         *
+         * */
+        bool contains(const StringView& name) const
+        {
+            return search(name) != nullptr;
+        }
+
+        /// @copydoc contains(const StringView&) const
+        bool contains(const char *name) const
+        {
+            return contains(StringView(name));
+        }
+
+        /** Find a name and mark it as consumed
+         *
+         * @param[in] name
+         *
+         * @return entry or nullptr if name is not indexed
+         *
+         * */
+        const Entry *find(const StringView& name)
+        {
+            auto retval = search(name);
+
+            if(retval != nullptr){
+
+                retval->used = true;
+            }
+
+            return retval;
+        }
+
+        /// @copydoc find(const StringView&)
+        const Entry *find(const char *name)
+        {
+            return find(StringView(name));
+        }
+
+        /** Find a name, mark it as consumed, and get a Decoder for its value
+         *
+         * @param[in] name
+         * @param[out] value    decoder for the value
+         *
+         * @retval true     found
+         * @retval false    not found
+         *
+         * */
+        bool get(const StringView& name, Decoder& value)
+        {
+            auto entry = find(name);
+
+            if(entry != nullptr){
+
+                value = Decoder(entry->value());
+            }
+
+            return entry != nullptr;
+        }
+
+        /// @copydoc get(const StringView&, Decoder&)
+        bool get(const char *name, Decoder& value)
+        {
+            return get(StringView(name), value);
+        }
+
+        /** Get the first (in name order) entry that has not been consumed
+         *
+         * @return entry or nullptr if every entry has been consumed
+         *
+         * */
+        const Entry *unconsumed() const
+        {
+            const Entry *retval = nullptr;
+
+            for(auto iter = begin(); iter != end(); ++iter){
+
+                if(!iter->used){
+
+                    retval = iter;
+                    break;
+                }
+            }
+
+            return retval;
+        }
+
+        /** Returns an iterator to the first entry (in name order)
+         *
+         * */
+        const_iterator begin() const
+        {
+            return entries;
+        }
+
+        /** Returns an iterator to the end
+         *
+         * */
+        const_iterator end() const
+        {
+            return entries + count;
+        }
+
+    private:
+
+        Entry entries[N];
+        size_t count;
+        bool dropped;
+        bool duplicated;
+        StringView repeated;
+
+        // index of the first entry not less than name
+        size_t lower_bound(const StringView& name) const
+        {
+            size_t first = 0;
+            size_t n = count;
+
+            while(n > 0){
+
+                auto half = n / 2;
+
+                if(entries[first + half].n.compare(name) < 0){
+
+                    first += half + 1;
+                    n -= half + 1;
+                }
+                else{
+
+                    n = half;
+                }
+            }
+
+            return first;
+        }
+
+        Entry *search(const StringView& name) const
+        {
+            auto i = lower_bound(name);
+
+            return ((i < count) && (entries[i].n.compare(name) == 0)) ? const_cast<Entry *>(&entries[i]) : nullptr;
+        }
+
+        void insert(const StringView& name, const StringView& value)
+        {
+            auto i = lower_bound(name);
+
+            if((i < count) && (entries[i].n.compare(name) == 0)){
+
+                if(!duplicated){
+
+                    repeated = entries[i].n;
+                    duplicated = true;
+                }
+            }
+            else if(count == N){
+
+                dropped = true;
+            }
+            else{
+
+                for(auto j = count; j > i; j--){
+
+                    entries[j] = entries[j-1];
+                }
+
+                entries[i].n = name;
+                entries[i].v = value;
+                entries[i].used = false;
+                count++;
+            }
+        }
+    };
+};
+
+#endif
@@ -0,0 +1,154 @@
+/* Copyright (c) 2024 Cameron Harper
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ *
+ */
+
+#ifndef BRAMBLE_REGISTRY_H_INCLUDED
+#define BRAMBLE_REGISTRY_H_INCLUDED
+
+#include "bramble_server.hpp"
+#include "bramble_hash.hpp"
+#include "bramble_argument.hpp"
+#include "bramble_string_view.hpp"
+
+#include <cstddef>
+
+namespace Bramble {
+
+    /** A table of command handlers
+     *
+     * The table is indexed by command name at compile time so that a Server::Host can
+     * dispatch in O(1) without allocating:
+     *
+     * @code
+     * static constexpr Bramble::Registry::Entry commands[] = {
+     *     {"generate_cw", generate_cw},
+     *     {"send_lora", send_lora}
+     * };
+     *
+     * static constexpr auto registry = Bramble::Registry::make(commands);
+     *
+     * bool YourHost::call(Bramble::Server::Command& cmd, const Bramble::Argument& args)
+     * {
+     *     return registry.call(cmd, args);
+     * }
+     * @endcode
+     *
+     * */
+    class Registry {
+    public:
+
+        /** A command handler
+         *
+         * @param[in] cmd       the command being handled
+         * @param[in] args      arguments
+         *
+         * */
+        using Handler = void (*)(Server::Command& cmd, const Argument& args);
+
+        /** A registry entry */
+        struct Entry {
+
+            const char *name;       ///< command name
+            Handler handler;        ///< handler (nullptr to accept without doing anything)
+        };
+
+        /** An indexed table of entries
+         *
+         * @tparam N    number of entries
+         *
+         * */
+        template<size_t N>
+        class Table {
+        public:
+
+            /** Index a table of entries
+             *
+             * @param[in] entries   table (must outlive this instance)
+             *
+             * */
+            constexpr Table(const Entry (&entries)[N])
+                :
+                index(entries)
+            {
+            }
+
+            /** Find an entry by command name
+             *
+             * @param[in] name  command name
+             *
+             * @return pointer to entry or nullptr if not found
+             *
+             * */
+            const Entry *lookup(const StringView& name) const
+            {
+                return index.find(name);
+            }
+
+            /** Lookup and execute a command handler by Server::Command::name()
+             *
+             * @param[in] cmd       the command being handled
+             * @param[in] args      arguments
+             *
+             * @retval true         handler exists and was called
+             * @retval false        no handler exists for command name
+             *
+             * */
+            bool call(Server::Command& cmd, const Argument& args) const
+            {
+                auto entry = lookup(cmd.name());
+
+                if((entry != nullptr) && (entry->handler != nullptr)){
+
+                    entry->handler(cmd, args);
+                }
+
+                return entry != nullptr;
+            }
+
+            /** number of entries
+             *
+             * */
+            constexpr size_t size() const
+            {
+                return N;
+            }
+
+        private:
+
+            HashIndex<Entry, N, &Entry::name> index;
+        };
+
+        /** Create an indexed table of entries
+         *
+         * @param[in] entries   table (must outlive the result)
+         *
+         * @return Table
+         *
+         * */
+        template<size_t N>
+        static constexpr Table<N> make(const Entry (&entries)[N])
+        {
+            return Table<N>(entries);
+        }
+    };
+};
+
+#endif
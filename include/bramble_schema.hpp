@@ -0,0 +1,522 @@
+/* Copyright (c) 2024 Cameron Harper
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ *
+ */
+
+#ifndef BRAMBLE_SCHEMA_H_INCLUDED
+#define BRAMBLE_SCHEMA_H_INCLUDED
+
+#include "bramble_server.hpp"
+#include "bramble_hash.hpp"
+#include "bramble_argument.hpp"
+#include "bramble_decoder.hpp"
+#include "bramble_buffer_stream.hpp"
+#include "bramble_encoder.hpp"
+#include "bramble_string_view.hpp"
+
+#include <cstddef>
+#include <cstdint>
+
+namespace Bramble {
+
+    /** An inclusive range of accepted values for a Schema field
+     *
+     * @tparam V    value type (an integer type)
+     * @tparam Min  smallest accepted value
+     * @tparam Max  largest accepted value
+     *
+     * */
+    template<typename V, V Min, V Max>
+    struct Range {
+
+        static_assert(Min <= Max, "range is empty");
+
+        using type = V;
+
+        /// @private
+        static bool contains(const V& value)
+        {
+            return (value >= Min) && (value <= Max);
+        }
+    };
+
+    /// @private
+    template<typename R>
+    struct SchemaRange {
+
+        using type = R;
+
+        static bool contains(const R&)
+        {
+            return true;
+        }
+    };
+
+    /// @private
+    template<typename V, V Min, V Max>
+    struct SchemaRange<Range<V, Min, Max>> : Range<V, Min, Max> {
+    };
+
+    /** Binds the named arguments (name=value) of a command to the members of a struct
+     *
+     * Fields are declared in a table that is indexed by name at compile time,
+     * so binding is one walk over the tokens with one hash and one name
+     * compare per token:
+     *
+     * @code
+     * struct Transmit {
+     *     uint32_t freq;
+     *     int8_t dbm;
+     *     bool confirmed;
+     * };
+     *
+     * using TransmitSchema = Bramble::Schema<Transmit>;
+     *
+     * static constexpr TransmitSchema::Field transmit_fields[] = {
+     *     TransmitSchema::required<Bramble::Range<uint32_t, 863000000, 870000000>, &Transmit::freq>("freq"),
+     *     TransmitSchema::optional<Bramble::Range<int8_t, -10, 20>, &Transmit::dbm>("dbm"),
+     *     TransmitSchema::optional<bool, &Transmit::confirmed>("confirmed")
+     * };
+     *
+     * static constexpr auto transmit_schema = TransmitSchema::make(transmit_fields);
+     *
+     * void transmit(Bramble::Server::Command& cmd, const Bramble::Argument& args)
+     * {
+     *     Transmit t = {0, 14, false};
+     *
+     *     // NAKs with a reason like "out_of_range:freq" on failure
+     *     if(transmit_schema.bind(cmd, args, t)){
+     *
+     *         ...
+     *     }
+     * }
+     * @endcode
+     *
+     * A member is only written when its value decodes and is within range, so optional
+     * members keep whatever default the caller gave them. Tokens without '=' (such as
+     * the command name) are ignored. Names that are not in the table are rejected.
+     *
+     * Members can be bool, any of the fixed width integer types, float, double or
+     * StringView (the value as-is, pointing into the argument buffer).
+     *
+     * @tparam T    struct to bind into
+     *
+     * */
+    template<typename T>
+    class Schema {
+    public:
+
+        /** outcome of binding */
+        enum class Status {
+
+            Ok,             ///< all required fields were bound
+            Missing,        ///< a required field was not given
+            Invalid,        ///< a value could not be decoded as the member type
+            OutOfRange,     ///< a value was outside the field Range
+            Unknown,        ///< a name is not in the table
+            Duplicate       ///< a name was given more than once
+        };
+
+        /// @private
+        using Setter = Status (*)(T& obj, const StringView& value);
+
+        /** A field definition (create with required() or optional()) */
+        struct Field {
+
+            const char *name;       ///< argument name
+            Setter set;             ///< decodes value into the member
+            bool required;          ///< fail if not given
+        };
+
+        /** Result of binding
+         *
+         * */
+        class Result {
+        public:
+
+            /// @private
+            Result(Status status, const StringView& name)
+                :
+                s(status),
+                n(name)
+            {
+            }
+
+            /** Outcome
+             *
+             * */
+            Status status() const
+            {
+                return s;
+            }
+
+            /** Name of the field or argument that caused the failure
+             *
+             * @return StringView (empty on success)
+             *
+             * */
+            StringView name() const
+            {
+                return n;
+            }
+
+            /** A NAK reason token for status()
+             *
+             * @return null-terminated string ("ok" on success)
+             *
+             * */
+            const char *reason() const
+            {
+                return Schema::reason(s);
+            }
+
+            /** Test if binding succeeded
+             *
+             * */
+            bool ok() const
+            {
+                return s == Status::Ok;
+            }
+
+        private:
+
+            Status s;
+            StringView n;
+        };
+
+        /** Define a field that must be given
+         *
+         * @tparam R        member type or a Range of the member type
+         * @tparam Member   pointer to member
+         *
+         * @param[in] name  argument name
+         *
+         * @return Field
+         *
+         * */
+        template<typename R, typename SchemaRange<R>::type T::*Member>
+        static constexpr Field required(const char *name)
+        {
+            return Field{name, &assign<R, Member>, true};
+        }
+
+        /** Define a field that may be omitted
+         *
+         * @tparam R        member type or a Range of the member type
+         * @tparam Member   pointer to member
+         *
+         * @param[in] name  argument name
+         *
+         * @return Field
+         *
+         * */
+        template<typename R, typename SchemaRange<R>::type T::*Member>
+        static constexpr Field optional(const char *name)
+        {
+            return Field{name, &assign<R, Member>, false};
+        }
+
+        /** An indexed table of fields
+         *
+         * @tparam N    number of fields
+         *
+         * */
+        template<size_t N>
+        class Table {
+        public:
+
+            static_assert(N <= 64, "too many fields");
+
+            /** largest NAK reason put by bind(Server::Command&, const Argument&, T&) const
+             * (longer names are truncated) */
+            static const size_t max_reason = 64;
+
+            /** Index a table of fields
+             *
+             * @param[in] fields    table (must outlive this instance)
+             *
+             * */
+            constexpr Table(const Field (&fields)[N])
+                :
+                index(fields)
+            {
+            }
+
+            /** Bind args into obj
+             *
+             * Stops at the first failure.
+             *
+             * @param[in] args  arguments
+             * @param[out] obj  struct to bind into
+             *
+             * @return Result
+             *
+             * */
+            Result bind(const Argument& args, T& obj) const
+            {
+                uint64_t seen = 0;
+                Status status = Status::Ok;
+                StringView name;
+
+                for(auto iter = args.begin(); (status == Status::Ok) && (iter != args.end()); ++iter){
+
+                    auto token = *iter;
+                    auto eq = token.find_first_of('=');
+
+                    if(eq != token.npos){
+
+                        name = Decoder::strip(token);
+                        name = name.substr(0, name.find_first_of('='));
+
+                        auto field = index.find(name);
+
+                        if(field == nullptr){
+
+                            status = Status::Unknown;
+                        }
+                        else{
+
+                            auto bit = uint64_t(1) << size_t(field - index.data());
+
+                            if((seen & bit) != 0){
+
+                                status = Status::Duplicate;
+                            }
+                            else{
+
+                                seen |= bit;
+                                status = field->set(obj, token.substr(eq+1));
+                            }
+                        }
+                    }
+                }
+
+                for(size_t i = 0; (status == Status::Ok) && (i < N); i++){
+
+                    if(index.data()[i].required && ((seen & (uint64_t(1) << i)) == 0)){
+
+                        status = Status::Missing;
+                        name = StringView(index.data()[i].name);
+                    }
+                }
+
+                return Result(status, (status == Status::Ok) ? StringView() : name);
+            }
+
+            /** Bind args into obj and NAK cmd on failure
+             *
+             * The NAK reason is Result::reason() and the name joined by ':'
+             * (e.g. "missing_argument:freq"). The name comes from the client, so
+             * characters other than [A-Za-z0-9_-] are replaced with '_' to keep
+             * the reason a single token.
+             *
+             * @param[in] cmd   command to NAK
+             * @param[in] args  arguments
+             * @param[out] obj  struct to bind into
+             *
+             * @retval true     bound (cmd is untouched)
+             * @retval false    not bound (cmd has been NAKed)
+             *
+             * */
+            bool bind(Server::Command& cmd, const Argument& args, T& obj) const
+            {
+                auto result = bind(args, obj);
+
+                if(!result.ok()){
+
+                    char reason[max_reason];
+                    BufferStream s(reason, sizeof(reason) - 1U);
+
+                    Encoder e(s);
+
+                    e.put_string(result.reason()).put_char(':');
+
+                    for(auto c : result.name()){
+
+                        e.put_char(is_name_char(c) ? c : '_');
+                    }
+
+                    reason[s.tell()] = 0;
+
+                    cmd.nak(reason);
+                }
+
+                return result.ok();
+            }
+
+            /** number of fields
+             *
+             * */
+            constexpr size_t size() const
+            {
+                return N;
+            }
+
+        private:
+
+            HashIndex<Field, N, &Field::name> index;
+
+            static bool is_name_char(char c)
+            {
+                return ((c >= 'a') && (c <= 'z'))
+                    || ((c >= 'A') && (c <= 'Z'))
+                    || ((c >= '0') && (c <= '9'))
+                    || (c == '_')
+                    || (c == '-');
+            }
+        };
+
+        /** Create an indexed table of fields
+         *
+         * @param[in] fields    table (must outlive the result)
+         *
+         * @return Table
+         *
+         * */
+        template<size_t N>
+        static constexpr Table<N> make(const Field (&fields)[N])
+        {
+            return Table<N>(fields);
+        }
+
+        /** NAK reason token for a status
+         *
+         * @param[in] status
+         *
+         * @return null-terminated string
+         *
+         * */
+        static const char *reason(Status status)
+        {
+            const char *retval;
+
+            switch(status){
+            default:
+            case Status::Ok:
+                retval = "ok";
+                break;
+            case Status::Missing:
+                retval = "missing_argument";
+                break;
+            case Status::Invalid:
+                retval = "invalid_argument";
+                break;
+            case Status::OutOfRange:
+                retval = "out_of_range";
+                break;
+            case Status::Unknown:
+                retval = "unknown_argument";
+                break;
+            case Status::Duplicate:
+                retval = "duplicate_argument";
+                break;
+            }
+
+            return retval;
+        }
+
+    private:
+
+        template<typename R, typename SchemaRange<R>::type T::*Member>
+        static Status assign(T& obj, const StringView& value)
+        {
+            Status retval = Status::Invalid;
+            typename SchemaRange<R>::type v;
+
+            if(decode(Decoder(value), v)){
+
+                if(SchemaRange<R>::contains(v)){
+
+                    obj.*Member = v;
+                    retval = Status::Ok;
+                }
+                else{
+
+                    retval = Status::OutOfRange;
+                }
+            }
+
+            return retval;
+        }
+
+        static bool decode(const Decoder& d, bool& v)
+        {
+            return d.get_bool(v);
+        }
+
+        static bool decode(const Decoder& d, uint8_t& v)
+        {
+            return d.get_uint8(v);
+        }
+
+        static bool decode(const Decoder& d, uint16_t& v)
+        {
+            return d.get_uint16(v);
+        }
+
+        static bool decode(const Decoder& d, uint32_t& v)
+        {
+            return d.get_uint32(v);
+        }
+
+        static bool decode(const Decoder& d, uint64_t& v)
+        {
+            return d.get_uint64(v);
+        }
+
+        static bool decode(const Decoder& d, int8_t& v)
+        {
+            return d.get_int8(v);
+        }
+
+        static bool decode(const Decoder& d, int16_t& v)
+        {
+            return d.get_int16(v);
+        }
+
+        static bool decode(const Decoder& d, int32_t& v)
+        {
+            return d.get_int32(v);
+        }
+
+        static bool decode(const Decoder& d, int64_t& v)
+        {
+            return d.get_int64(v);
+        }
+
+        static bool decode(const Decoder& d, float& v)
+        {
+            return d.get_float(v);
+        }
+
+        static bool decode(const Decoder& d, double& v)
+        {
+            return d.get_double(v);
+        }
+
+        static bool decode(const Decoder& d, StringView& v)
+        {
+            v = d.value();
+            return true;
+        }
+    };
+};
+
+#endif
@@ -29,12 +29,18 @@
 #include "bramble_decoder.hpp"
 #include "bramble_argument.hpp"
 #include "bramble_string_view.hpp"
+#include "bramble_buffer_stream.hpp"
+#include "bramble_function_ref.hpp"
+#include "bramble_emit.hpp"
 
 #include <cstddef>
 #include <cstdint>
 #include <cstring>
-#include <functional>
+#include <array>
 #include <cctype>
+#include <algorithm>
+#include <atomic>
+#include <type_traits>
 
 namespace Bramble {
 
@@ -42,8 +48,210 @@ namespace Bramble {
      *
      * */
     class Server {
+    private:
+
+        class Output;
+
     public:
 
+        /** Writes additional arguments to a stream */
+        using ArgumentClosure = FunctionRef<void(Bramble::Stream&)>;
+
+        /** A command that will be completed after its handler has returned
+         *
+         * Obtained from Command::defer(). The ACK or NAK is sent when
+         * ack() or nak() is called, correlated with the command by its full
+         * name (including invocation id).
+         *
+         * If an Events queue is attached (see set_events()) the response is
+         * posted to it and written by process() or step() between lines, so
+         * completion may happen from another thread or interrupt provided that
+         * the server outlives the Deferred instance. If the response cannot be
+         * queued the Deferred remains pending and completion can be retried.
+         *
+         * Without an Events queue the response is written straight to the host,
+         * so ack() and nak() must be called from the same context as process()
+         * and not while the server is writing (e.g. from within Host::write()).
+         *
+         * A Deferred that is destroyed without being completed sends nothing.
+         *
+         * */
+        class Deferred {
+        public:
+
+            /** longest command name (including invocation id) that can be deferred */
+            static const size_t max_name = 64;
+
+            /** Create a Deferred that is not attached to a command
+             *
+             * */
+            Deferred()
+                :
+                server(nullptr),
+                size(0)
+            {
+            }
+
+            /// @private
+            Deferred(Server& server, const StringView& full_name)
+                :
+                server(&server),
+                size(full_name.size())
+            {
+                (void)memcpy(name.data(), full_name.data(), size);
+            }
+
+            Deferred(Deferred&& other)
+                :
+                server(other.server),
+                name(other.name),
+                size(other.size)
+            {
+                other.server = nullptr;
+            }
+
+            Deferred& operator=(Deferred&& other)
+            {
+                if(this != &other){
+
+                    server = other.server;
+                    name = other.name;
+                    size = other.size;
+
+                    other.server = nullptr;
+                }
+
+                return *this;
+            }
+
+            Deferred(const Deferred&) = delete;
+            Deferred& operator=(const Deferred&) = delete;
+
+            /** Check if this command is still waiting to be completed
+             *
+             * @retval true     ack() or nak() will send a response
+             *
+             * */
+            bool pending() const
+            {
+                return server != nullptr;
+            }
+
+            /** Command name (including invocation id)
+             *
+             * */
+            StringView full_name() const
+            {
+                return StringView(name.data(), size);
+            }
+
+            /** Complete with an ACK
+             *
+             * @retval true     response sent or queued
+             * @retval false    not pending, or could not be queued (still pending)
+             *
+             * */
+            bool ack()
+            {
+                return complete("ACK:", nullptr);
+            }
+
+            /** Complete with an ACK followed by arguments
+             *
+             * @param[in] fn    closure for arguments
+             *
+             * @retval true     response sent or queued
+             * @retval false    not pending, or could not be queued (still pending)
+             *
+             * */
+            bool ack(const ArgumentClosure& fn)
+            {
+                return complete("ACK:", &fn);
+            }
+
+            /** Complete with an ACK followed by arguments
+             *
+             * @param[in] args  arguments (see is_argument)
+             *
+             * @retval true     response sent or queued
+             * @retval false    not pending, or could not be queued (still pending)
+             *
+             * */
+            template<typename... Args>
+            typename std::enable_if<(sizeof...(Args) > 0) && are_arguments<Args...>::value, bool>::type
+            ack(const Args&... args)
+            {
+                auto fn = [&](Stream& out){ Encoder e(out); put_arguments(e, args...); };
+
+                return complete("ACK:", &fn);
+            }
+
+            /** Complete with a NAK
+             *
+             * @param[in] reason    reason for NAK
+             *
+             * @retval true     response sent or queued
+             * @retval false    not pending, or could not be queued (still pending)
+             *
+             * */
+            bool nak(const char *reason)
+            {
+                auto fn = [reason](Stream& out){ Encoder(out).put_string(reason); };
+
+                return complete("NAK:", &fn);
+            }
+
+        private:
+
+            Server *server;
+
+            std::array<char, max_name> name;
+            size_t size;
+
+            // queued through the events queue when one is attached, otherwise
+            // written straight to the host
+            template<typename Fn>
+            bool complete(const char *prefix, const Fn& fn)
+            {
+                bool retval = false;
+
+                if(server != nullptr){
+
+                    if(server->events != nullptr){
+
+                        retval = server->events->post(prefix, full_name(), fn);
+                    }
+                    else{
+
+                        Output output(*server);
+                        Encoder e(output);
+
+                        e.put_string(prefix).put_string(full_name());
+
+                        if(fn != nullptr){
+
+                            e.space();
+                            Events::put_args(output, fn);
+                        }
+
+                        e.put_string("\r\n");
+
+                        output.line_complete();
+                        output.flush();
+
+                        retval = true;
+                    }
+
+                    if(retval){
+
+                        server = nullptr;
+                    }
+                }
+
+                return retval;
+            }
+        };
+
         /** Represents the command that is being handled
          *
          * */
@@ -84,6 +292,24 @@ namespace Bramble {
                 return Encoder(server.state->ack(server)).space().s;
             }
 
+            /** Initiate an ACK followed by arguments
+             *
+             * @code
+             * cmd.ack(Bramble::kv("freq", freq), Bramble::hex(id, sizeof(id)));
+             * @endcode
+             *
+             * @param[in] args  arguments (see is_argument)
+             *
+             * */
+            template<typename... Args>
+            typename std::enable_if<(sizeof...(Args) > 0) && are_arguments<Args...>::value>::type
+            ack(const Args&... args)
+            {
+                Encoder e(ack_with_arg());
+
+                put_arguments(e, args...);
+            }
+
             /** Initiate a NAK
              *
              * @param[in] reason    reason for NAK
@@ -103,6 +329,24 @@ namespace Bramble {
                 server.state->end(server);
             }
 
+            /** Detach this command from its handler so that it can be completed later
+             *
+             * The server will not send the default ACK when the handler returns and
+             * will go on to process the next line. Further responses through this
+             * Command are ignored.
+             *
+             * Cannot defer if the handler has already responded or if
+             * the command name is longer than Deferred::max_name. In that case the returned
+             * Deferred is not pending and the command completes as usual.
+             *
+             * @return Deferred
+             *
+             * */
+            Deferred defer()
+            {
+                return server.state->defer(server);
+            }
+
             /** Get the user pointer that was attached to server instance
              *
              * */
@@ -111,6 +355,18 @@ namespace Bramble {
                 return server.get_ctx();
             }
 
+            /** Get the session that issued this command
+             *
+             * @return session id
+             *
+             * @see Server::session()
+             *
+             * */
+            size_t session() const
+            {
+                return server.session();
+            }
+
             /** The server instance */
             Server& server;
         };
@@ -131,7 +387,7 @@ namespace Bramble {
             virtual void line_was_rx()
             {}
 
-            /// called everytime a line is sent
+            /// called everytime a line is sent, after it has been passed to write()
             virtual void line_was_tx()
             {}
 
@@ -142,109 +398,621 @@ namespace Bramble {
                 Error
             };
 
-            /** put a character to the transport layer
-             *
-             * @param[in] c     character
-             *
-             * */
-            virtual void put_char(char c)
+            /** put a character to the transport layer
+             *
+             * @param[in] c     character
+             *
+             * */
+            virtual void put_char(char c)
+            {
+                (void)c;
+            };
+
+            /** put a block of characters to the transport layer
+             *
+             * Server calls this with as much of a transaction as it can
+             * gather at once. The default implementation calls put_char() for
+             * each character.
+             *
+             * @param[in] buffer    characters
+             * @param[in] size      number of characters
+             *
+             * */
+            virtual void write(const char *buffer, size_t size)
+            {
+                for(auto iter = buffer; iter != (buffer + size); ++iter){
+
+                    put_char(*iter);
+                }
+            }
+
+            /** block until output buffer has been emptied */
+            virtual void drain()
+            {};
+
+            /** get a character from the transport layer
+             *
+             * @param[out] c        output character
+             *
+             * @retval GetCharStatus::Ok
+             * @retval GetCharStatus::Error
+             * @retval GetCharStatus::Blocked
+             *
+             * */
+            virtual GetCharStatus get_char(char& c)
+            {
+                (void)c;
+                return GetCharStatus::Blocked;
+            };
+
+            /** get a block of characters from the transport layer
+             *
+             * Override this if the transport already holds received characters in
+             * bulk (e.g. a FIFO, DMA buffer or socket). The default implementation
+             * calls get_char() until it stops returning GetCharStatus::Ok or
+             * the buffer is full.
+             *
+             * @param[out] buffer   output buffer
+             * @param[in] max       size of buffer
+             *
+             * @return number of characters written to buffer (0 if none available)
+             *
+             * */
+            virtual size_t read(char *buffer, size_t max)
+            {
+                size_t retval = 0;
+
+                while((retval < max) && get_char_status_ok(get_char(buffer[retval]))){
+
+                    retval++;
+                }
+
+                return retval;
+            }
+
+            /** call to evaluate the status code
+             *
+             * @param[in] status
+             *
+             * @retval true     character is valid
+             *
+             * */
+            static bool get_char_status_ok(GetCharStatus status)
+            {
+                return (status == GetCharStatus::Ok);
+            }
+
+            /** Lookup and execute a command handler by name
+             *
+             * @note The command name is accessible from Command::name()
+             *
+             * @param[in] cmd       the command being handled
+             * @param[in] args      arguments
+             *
+             * @retval true         handler exists and was called
+             * @retval false        no handler exists for command name
+             *
+             * */
+            virtual bool call(Command& cmd, const Argument& args)
+            {
+                (void)cmd;
+                (void)args;
+                return false;
+            }
+        };
+
+        /** A fixed capacity queue of received lines
+         *
+         * When a queue is attached to a server (see set_queue()) complete lines are
+         * queued as they are received and then dispatched one at a time by step().
+         * This lets the transport be drained while a handler is running elsewhere in the
+         * main loop, and lets clients send several commands without waiting for each
+         * response.
+         *
+         * Lines are tokenized when they are dispatched.
+         *
+         * Storage is provided by a subclass, see LineQueue.
+         *
+         * @note a queue is not thread safe; process() and step() must be
+         * called from the same context and not from within a handler
+         *
+         * */
+        class Queue {
+        public:
+
+            /** what to do with a line that arrives when the queue is full */
+            enum class Overflow {
+
+                Reject,     ///< NAK the command with reason "queue_full"
+                DropNewest, ///< NAK the line that was queued most recently with reason "dropped" and queue the line that just arrived
+                DropOldest  ///< NAK the line that has been queued the longest with reason "dropped" and queue the line that just arrived
+            };
+
+            /** number of lines waiting to be dispatched
+             *
+             * */
+            size_t size() const
+            {
+                return count;
+            }
+
+            /** maximum number of lines that can be queued
+             *
+             * */
+            size_t capacity() const
+            {
+                return depth;
+            }
+
+            /** number of lines that have been rejected or dropped
+             *
+             * Every rejected or dropped line is NAKed.
+             *
+             * */
+            size_t dropped() const
+            {
+                return drop_count;
+            }
+
+            /** largest line that can be queued
+             *
+             * */
+            size_t max_line_size() const
+            {
+                return line_size - 1U;
+            }
+
+        protected:
+
+            /** Create a queue
+             *
+             * @param[in] storage       depth * (max_line + 1) characters
+             * @param[in] depth         number of lines
+             * @param[in] max_line      largest line that can be queued
+             * @param[in] overflow      overflow policy
+             *
+             * */
+            Queue(char *storage, size_t depth, size_t max_line, Overflow overflow)
+                :
+                storage(storage),
+                depth(depth),
+                line_size(max_line + 1U),
+                overflow(overflow),
+                head(0),
+                count(0),
+                drop_count(0)
+            {
+            }
+
+            Queue(const Queue&) = delete;
+            Queue& operator=(const Queue&) = delete;
+
+        private:
+
+            friend class Server;
+
+            char *storage;
+            const size_t depth;
+            const size_t line_size;
+            const Overflow overflow;
+
+            size_t head;
+            size_t count;
+            size_t drop_count;
+
+            char *slot(size_t i)
+            {
+                return &storage[((head + i) % depth) * line_size];
+            }
+
+            bool full() const
+            {
+                return count == depth;
+            }
+
+            // queue must not be full
+            void push(const char *line, size_t size)
+            {
+                auto s = slot(count);
+
+                (void)memcpy(s, line, size);
+                s[size] = 0;
+                count++;
+            }
+
+            char *front()
+            {
+                return slot(0);
+            }
+
+            char *back()
+            {
+                return slot(count - 1U);
+            }
+
+            void pop()
+            {
+                head = (head + 1U) % depth;
+                count--;
+            }
+
+            void pop_back()
+            {
+                count--;
+            }
+        };
+
+        /** A bounded queue of event and log lines raised outside of the server's context
+         *
+         * Server::event() and Server::log() write straight to the output and so
+         * cannot be called while another context may be writing a response. Events
+         * raised through an attached queue (see set_events()) are formatted by the
+         * producer into a free slot and written by process() between
+         * transactions.
+         *
+         * Any number of producers (threads or interrupts) may post concurrently with
+         * each other and with the server. Producers never block: if the queue is full,
+         * or the line does not fit in a slot, the line is dropped and counted.
+         *
+         * Storage is provided by a subclass, see EventQueue.
+         *
+         * @note relies on std::atomic<size_t> being lock-free on your target
+         *
+         * */
+        class Events {
+        public:
+
+            /** Post an event
+             *
+             * @param[in] name     event name
+             *
+             * @retval true     event queued
+             * @retval false    event dropped
+             *
+             * */
+            bool event(const char *name)
+            {
+                return post("EVT: ", name, nullptr);
+            }
+
+            /** @copydoc event(const char *)
+             *
+             * @param[in] fn    callable taking a Stream& for additional arguments
+             *
+             *  */
+            template<typename Fn>
+            typename std::enable_if<!is_argument<Fn>::value, bool>::type
+            event(const char *name, const Fn& fn)
+            {
+                return post("EVT: ", name, &fn);
+            }
+
+            /** @copydoc event(const char *)
+             *
+             * @param[in] args  arguments (see is_argument)
+             *
+             *  */
+            template<typename... Args>
+            typename std::enable_if<(sizeof...(Args) > 0) && are_arguments<Args...>::value, bool>::type
+            event(const char *name, const Args&... args)
+            {
+                auto fn = [&](Stream& out){ Encoder e(out); put_arguments(e, args...); };
+
+                return post("EVT: ", name, &fn);
+            }
+
+            /** Post a log message
+             *
+             * @param[in] s     message
+             *
+             * @retval true     message queued
+             * @retval false    message dropped
+             *
+             * */
+            bool log(const char *s)
+            {
+                return post("LOG: ", s, nullptr);
+            }
+
+            /** @copydoc log(const char *)
+             *
+             * @param[in] fn    callable taking a Stream& for additional arguments
+             *
+             * */
+            template<typename Fn>
+            typename std::enable_if<!is_argument<Fn>::value, bool>::type
+            log(const char *s, const Fn& fn)
+            {
+                return post("LOG: ", s, &fn);
+            }
+
+            /** @copydoc log(const char *)
+             *
+             * @param[in] args  arguments (see is_argument)
+             *
+             * */
+            template<typename... Args>
+            typename std::enable_if<(sizeof...(Args) > 0) && are_arguments<Args...>::value, bool>::type
+            log(const char *s, const Args&... args)
+            {
+                auto fn = [&](Stream& out){ Encoder e(out); put_arguments(e, args...); };
+
+                return post("LOG: ", s, &fn);
+            }
+
+            /** number of lines that have been dropped
+             *
+             * */
+            size_t dropped() const
+            {
+                return drop_count.load(std::memory_order_relaxed);
+            }
+
+            /** maximum number of lines that can be queued
+             *
+             * */
+            size_t capacity() const
+            {
+                return depth;
+            }
+
+            /** largest line (excluding line ending) that can be queued
+             *
+             * */
+            size_t max_line_size() const
+            {
+                return line_size - 1U;
+            }
+
+        protected:
+
+            /** Create a queue
+             *
+             * @param[in] sequence  depth sequence numbers
+             * @param[in] sizes     depth line sizes
+             * @param[in] storage   depth * (max_line + 1) characters
+             * @param[in] depth     number of lines (a power of two, at least 2)
+             * @param[in] max_line  largest line that can be queued
+             *
+             * @note call init() once storage has been constructed
+             *
+             * */
+            Events(std::atomic<size_t> *sequence, size_t *sizes, char *storage, size_t depth, size_t max_line)
+                :
+                sequence(sequence),
+                sizes(sizes),
+                storage(storage),
+                depth(depth),
+                line_size(max_line + 1U),
+                tail(0),
+                head(0),
+                drop_count(0)
+            {
+            }
+
+            Events(const Events&) = delete;
+            Events& operator=(const Events&) = delete;
+
+            /** Mark every slot as free
+             *
+             * */
+            void init()
+            {
+                for(size_t i = 0; i < depth; i++){
+
+                    sequence[i].store(i, std::memory_order_relaxed);
+                }
+            }
+
+        private:
+
+            friend class Server;
+
+            // Each slot has a sequence number that says whose turn it is: equal to
+            // the position when free for a producer, position + 1 when full for
+            // the consumer.
+            std::atomic<size_t> *sequence;
+            size_t *sizes;
+            char *storage;
+            const size_t depth;
+            const size_t line_size;
+
+            std::atomic<size_t> tail;
+            size_t head;
+            std::atomic<size_t> drop_count;
+
+            template<typename Fn>
+            static void put_args(Stream& s, const Fn *fn)
+            {
+                (*fn)(s);
+            }
+
+            static void put_args(Stream&, std::nullptr_t)
+            {
+            }
+
+            template<typename Fn>
+            bool post(const char *prefix, const StringView& s, const Fn& fn)
+            {
+                bool retval = false;
+                size_t pos = tail.load(std::memory_order_relaxed);
+
+                for(;;){
+
+                    auto seq = sequence[pos & (depth - 1U)].load(std::memory_order_acquire);
+                    auto diff = intptr_t(seq) - intptr_t(pos);
+
+                    if(diff == 0){
+
+                        if(tail.compare_exchange_weak(pos, pos + 1U, std::memory_order_relaxed)){
+
+                            retval = true;
+                            break;
+                        }
+                    }
+                    else if(diff < 0){
+
+                        // full
+                        break;
+                    }
+                    else{
+
+                        pos = tail.load(std::memory_order_relaxed);
+                    }
+                }
+
+                if(retval){
+
+                    auto i = pos & (depth - 1U);
+                    BufferStream line(&storage[i * line_size], line_size);
+
+                    Encoder(line).put_string(prefix).put_string(s);
+
+                    if(fn != nullptr){
+
+                        Encoder(line).space();
+                        put_args(line, fn);
+                    }
+
+                    if(line.eof()){
+
+                        // slot is already claimed so publish it as empty
+                        sizes[i] = 0;
+                        retval = false;
+                    }
+                    else{
+
+                        sizes[i] = line.tell();
+                    }
+
+                    sequence[i].store(pos + 1U, std::memory_order_release);
+                }
+
+                if(!retval){
+
+                    drop_count.fetch_add(1U, std::memory_order_relaxed);
+                }
+
+                return retval;
+            }
+
+            // single consumer
+            bool front(StringView& line)
             {
-                (void)c;
-            };
+                auto i = head & (depth - 1U);
+                bool retval = (sequence[i].load(std::memory_order_acquire) == (head + 1U));
 
-            /** block until output buffer has been emptied */
-            virtual void drain()
-            {};
+                if(retval){
 
-            /** get a character from the transport layer
-             *
-             * @param[out] c        output character
-             *
-             * @retval GetCharStatus::Ok
-             * @retval GetCharStatus::Error
-             * @retval GetCharStatus::Blocked
-             *
-             * */
-            virtual GetCharStatus get_char(char& c)
-            {
-                (void)c;
-                return GetCharStatus::Blocked;
-            };
+                    line = StringView(&storage[i * line_size], sizes[i]);
+                }
 
-            /** call to evaluate the status code
-             *
-             * @param[in] status
-             *
-             * @retval true     character is valid
-             *
-             * */
-            static bool get_char_status_ok(GetCharStatus status)
-            {
-                return (status == GetCharStatus::Ok);
+                return retval;
             }
 
-            /** Lookup and execute a command handler by name
-             *
-             * @note The command name is accessible from Command::name()
-             *
-             * @param[in] cmd       the command being handled
-             * @param[in] args      arguments
-             *
-             * @retval true         handler exists and was called
-             * @retval false        no handler exists for command name
-             *
-             * */
-            virtual bool call(Command& cmd, const Argument& args)
+            void pop()
             {
-                (void)cmd;
-                (void)args;
-                return false;
+                sequence[head & (depth - 1U)].store(head + depth, std::memory_order_release);
+                head++;
             }
         };
 
         /** Create a new server instance
+         *
+         * Lines with more than max_args tokens are still handled but argument access
+         * is no longer O(1).
          *
          * @param[in] host      host interface
          * @param[in] max_line  largest line server can receive
+         * @param[in] max_args  number of tokens to index per line
          *
          * */
-        Server(Host& host, size_t max_line = 1024)
+        Server(Host& host, size_t max_line = 1024, size_t max_args = 32)
             :
             host(host),
             output(*this),
             state(&Idle::instance()),
+            ctx(nullptr),
             size(0),
-            end_offset(max_line)
+            end_offset(max_line),
+            index_max(max_args),
+            owned(true),
+            id(0),
+            queue(nullptr),
+            events(nullptr)
         {
             buffer = new char[max_line+1];
+            index = (max_args > 0) ? new StringView[max_args] : nullptr;
+
+            (void)memset(buffer, 0, max_line+1);
+        }
 
+        /** Create a new server instance that uses storage provided by the caller
+         *
+         * The storage must outlive the server and is not released by it.
+         *
+         * @param[in] host      host interface
+         * @param[in] buffer    line buffer (must be at least max_line + 1 characters)
+         * @param[in] max_line  largest line server can receive
+         * @param[in] index     token index (may be nullptr if max_args is 0)
+         * @param[in] max_args  number of tokens to index per line
+         * @param[in] session   session id (available from Command::session())
+         *
+         * */
+        Server(Host& host, char *buffer, size_t max_line, StringView *index, size_t max_args, size_t session = 0)
+            :
+            host(host),
+            output(*this),
+            state(&Idle::instance()),
+            ctx(nullptr),
+            buffer(buffer),
+            size(0),
+            end_offset(max_line),
+            index(index),
+            index_max((index != nullptr) ? max_args : 0),
+            owned(false),
+            id(session),
+            queue(nullptr),
+            events(nullptr)
+        {
             (void)memset(buffer, 0, max_line+1);
         }
 
+        Server(const Server&) = delete;
+        Server& operator=(const Server&) = delete;
+
         /** Destroy this server
          *
          * */
         ~Server()
         {
-            delete buffer;
+            if(owned){
+
+                delete[] buffer;
+                delete[] index;
+            }
         }
 
-        /** Process input characters from HostInterface::get_char()
+        /** Process input characters from Host::read()
          *
          * Most useful if your transport layer has a queue that needs to be polled for
-         * updates.
+         * updates. Characters are read in chunks until Host::read() returns zero.
          *
          * @see process(const char*,size_t) if your server receives strings directly
          *
          * */
         void process()
         {
-            char c;
+            std::array<char, 64> chunk;
+            size_t n;
+
+            do{
 
-            while(host.get_char_status_ok(host.get_char(c))){
+                n = host.read(chunk.data(), chunk.size());
 
-                state->input(*this, c);
+                process(chunk.data(), n);
             }
+            while(n > 0);
         }
 
         /** Process input characters direct from buffer
@@ -256,10 +1024,71 @@ namespace Bramble {
          * */
         void process(const char *buffer, size_t size)
         {
-            for(auto iter = buffer; iter != (buffer + size); ++iter){
+            auto end = buffer + size;
+
+            put_events();
+
+            for(auto iter = buffer; iter != end;){
+
+                iter = state->input(*this, iter, end);
+            }
+        }
+
+        /** Write event and log lines raised through an Events queue
+         *
+         * @param[in] events    queue to drain from process() (nullptr to detach)
+         *
+         * */
+        void set_events(Events *events)
+        {
+            this->events = events;
+        }
+
+        /** Queue received lines instead of dispatching them from process()
+         *
+         * Lines that are already queued remain in the previous queue.
+         *
+         * @param[in] queue     queue to use (nullptr to dispatch from process())
+         *
+         * @retval true     queue attached
+         * @retval false    queue cannot hold lines of max_line_size()
+         *
+         * */
+        bool set_queue(Queue *queue)
+        {
+            bool retval = false;
+
+            if((queue == nullptr) || (queue->max_line_size() >= end_offset)){
+
+                this->queue = queue;
+                retval = true;
+            }
+
+            return retval;
+        }
+
+        /** Dispatch the oldest queued line
+         *
+         * @retval true     a line was dispatched
+         * @retval false    queue is empty or not attached
+         *
+         * */
+        bool step()
+        {
+            bool retval = false;
 
-                state->input(*this, *iter);
+            if((queue != nullptr) && (queue->size() > 0U)){
+
+                Handle::dispatch(*this, queue->front(), nullptr);
+                queue->pop();
+                retval = true;
+            }
+            else{
+
+                put_events();
             }
+
+            return retval;
         }
 
         /** Block until output buffer becomes empty */
@@ -276,8 +1105,6 @@ namespace Bramble {
             this->ctx = ctx;
         }
 
-        using ArgumentClosure = std::function<void(Bramble::Stream&)>;
-
         /** send an event
          *
          * @param[in] name     event name
@@ -287,6 +1114,7 @@ namespace Bramble {
         {
             Encoder(output).put_string("EVT: ").put_string(name);
             put_line_end();
+            output.flush();
         }
 
         /** @copydoc event(const char *)
@@ -299,6 +1127,31 @@ namespace Bramble {
             Encoder(output).put_string("EVT: ").put_string(name).space();
             fn(output);
             put_line_end();
+            output.flush();
+        }
+
+        /** @copydoc event(const char *)
+         *
+         * Each argument is formatted according to its type and the line is
+         * passed to the host in as few writes as possible:
+         *
+         * @code
+         * server.event("rx_done", Bramble::kv("rssi", rssi), Bramble::kv("snr", snr), Bramble::hex(buf, n));
+         * @endcode
+         *
+         * @param[in] args  arguments (see is_argument)
+         *
+         *  */
+        template<typename... Args>
+        typename std::enable_if<(sizeof...(Args) > 0) && are_arguments<Args...>::value>::type
+        event(const char *name, const Args&... args)
+        {
+            Encoder e(output);
+
+            e.put_string("EVT: ").put_string(name).space();
+            put_arguments(e, args...);
+            put_line_end();
+            output.flush();
         }
 
         /** Send a log message
@@ -310,6 +1163,7 @@ namespace Bramble {
         {
             Encoder(output).put_string("LOG: ").put_string(s);
             put_line_end();
+            output.flush();
         }
 
         /** @copydoc log(const char *)
@@ -322,6 +1176,24 @@ namespace Bramble {
             Encoder(output).put_string("LOG: ").put_string(s).space();
             fn(output);
             put_line_end();
+            output.flush();
+        }
+
+        /** @copydoc log(const char *)
+         *
+         * @param[in] args  arguments (see is_argument)
+         *
+         * */
+        template<typename... Args>
+        typename std::enable_if<(sizeof...(Args) > 0) && are_arguments<Args...>::value>::type
+        log(const char *s, const Args&... args)
+        {
+            Encoder e(output);
+
+            e.put_string("LOG: ").put_string(s).space();
+            put_arguments(e, args...);
+            put_line_end();
+            output.flush();
         }
 
         /** Send without a prefix
@@ -333,6 +1205,7 @@ namespace Bramble {
         {
             Encoder(output).put_string(s);
             put_line_end();
+            output.flush();
         }
 
         /** @copydoc no_prefix(const char *)
@@ -345,6 +1218,7 @@ namespace Bramble {
             Encoder(output).put_string(s);
             fn(output);
             put_line_end();
+            output.flush();
         }
 
         /** Get the maximum line size server able to echo and acknowledge
@@ -357,6 +1231,18 @@ namespace Bramble {
             return end_offset;
         }
 
+        /** Get the session id of this server
+         *
+         * A server that was not given a session id is session 0.
+         *
+         * @return session id
+         *
+         * */
+        size_t session() const
+        {
+            return id;
+        }
+
     private:
 
         class State {
@@ -366,9 +1252,18 @@ namespace Bramble {
 
             virtual void input(Server&, char) const {}
 
+            // consume as much of [begin, end) as this state can, returning where it stopped
+            virtual const char *input(Server& self, const char *begin, const char *end) const
+            {
+                (void)end;
+                input(self, *begin);
+                return begin + 1;
+            }
+
             virtual Stream& ack(Server& self) const { return self.output; }
             virtual void nak(Server&, const char *) const {}
             virtual void end(Server&) const {}
+            virtual Deferred defer(Server&) const { return Deferred(); }
         };
 
         class Idle : public State {
@@ -403,13 +1298,70 @@ namespace Bramble {
                 }
                 else if((c == '\r') && (self.size > 0U)){
 
-                    self.set_state(Handle::instance());
+                    if(self.queue == nullptr){
+
+                        Handle::dispatch(self, self.buffer, nullptr);
+                    }
+                    else{
+
+                        // dispatched by step()
+                        self.enqueue(self.buffer, self.size);
+                    }
+
+                    self.set_state(Idle::instance());
                 }
                 else{
 
                     // keep listening
                 }
             }
+
+            const char *input(Server& self, const char *begin, const char *end) const
+            {
+                auto eol = static_cast<const char *>(memchr(begin, '\r', end - begin));
+                auto run_end = (eol != nullptr) ? eol : end;
+                auto retval = run_end;
+
+                for(auto iter = begin; iter != run_end;){
+
+                    auto run = iter;
+
+                    while((run != run_end) && std::isprint(*run)){
+
+                        ++run;
+                    }
+
+                    auto n = std::min(size_t(run - iter), self.end_offset - self.size);
+
+                    (void)memcpy(&self.buffer[self.size], iter, n);
+                    self.size += n;
+                    self.buffer[self.size] = 0;
+
+                    if((iter + n) != run){
+
+                        // the character that didn't fit is consumed by the transition
+                        self.set_state(TooLong::instance());
+                        retval = iter + n + 1;
+                        eol = nullptr;
+                        break;
+                    }
+
+                    while((run != run_end) && !std::isprint(*run)){
+
+                        ++run;
+                    }
+
+                    iter = run;
+                }
+
+                if(eol != nullptr){
+
+                    input(self, *eol);
+                    retval++;
+                }
+
+                return retval;
+            }
         };
 
         class Handle : public State {
@@ -482,28 +1434,40 @@ namespace Bramble {
                 return inst;
             }
 
-            void before(Server& self) const
+            // handle a complete line
+            //
+            // The receiving state is put aside while the handler runs so that a
+            // line can be dispatched from the queue without disturbing a line
+            // that is still being received. If reject is not nullptr the command
+            // is NAKed with that reason instead of being passed to the host.
+            static void dispatch(Server& self, char *line, const char *reject)
             {
-                self.host.line_was_rx();
+                auto resume = self.state;
 
-                self.put_cmd();
-                self.put_line_end();
+                self.state = &Handle::instance();
 
-                self.host.line_was_tx();
+                self.host.line_was_rx();
+
+                self.put_cmd(line);
+                self.put_tx_line_end();
 
-                // will mutate contents of self.buffer into sequence of null-terminated strings
-                Argument args(self.buffer, self.buffer, self.end_offset);
+                // will mutate contents of line into sequence of null-terminated strings
+                Argument args(line, line, self.end_offset, self.index, self.index_max);
                 Command cmd(self);
 
                 if(!args.empty()){
 
                     detect_command_name(self, args);
 
-                    if(!self.host.call(cmd, args)){
+                    if(reject != nullptr){
+
+                        self.put_nak(reject);
+                        self.put_tx_line_end();
+                    }
+                    else if(!self.host.call(cmd, args)){
 
                         self.put_nak("unknown_command");
-                        self.put_line_end();
-                        self.host.line_was_tx();
+                        self.put_tx_line_end();
                     }
                     else{
 
@@ -511,13 +1475,16 @@ namespace Bramble {
                         if(self.state == &Handle::instance()){
 
                             self.put_ack();
-                            self.put_line_end();
-                            self.host.line_was_tx();
+                            self.put_tx_line_end();
                         }
                     }
                 }
 
-                self.set_state(Idle::instance());
+                self.set_state(Done::instance());
+
+                self.state = resume;
+
+                self.put_events();
             }
 
             Stream& ack(Server& self) const
@@ -539,6 +1506,41 @@ namespace Bramble {
                 self.set_state(Responding::instance());
                 self.state->end(self);
             }
+
+            Deferred defer(Server& self) const
+            {
+                Deferred retval;
+
+                if(self.full_name.size() <= Deferred::max_name){
+
+                    self.set_state(Done::instance());
+                    retval = Deferred(self, self.full_name);
+                }
+
+                return retval;
+            }
+        };
+
+        // response has been sent or will be sent by a Deferred
+        class Done : public State {
+        public:
+            static State& instance()
+            {
+                static Done inst;
+                return inst;
+            }
+
+            void before(Server& self) const
+            {
+                // end of transaction
+                self.output.flush();
+            }
+
+            Stream& ack(Server&) const
+            {
+                static Stream discard;
+                return discard;
+            }
         };
 
         class Responding : public State {
@@ -556,13 +1558,12 @@ namespace Bramble {
 
             void end(Server& self) const
             {
-                self.set_state(Idle::instance());
+                self.set_state(Done::instance());
             }
 
             void after(Server& self) const
             {
-                self.put_line_end();
-                self.host.line_was_tx();
+                self.put_tx_line_end();
             }
         };
 
@@ -582,21 +1583,45 @@ namespace Bramble {
                     self.set_state(Idle::instance());
                 }
             }
+
+            const char *input(Server& self, const char *begin, const char *end) const
+            {
+                auto retval = end;
+                auto eol = static_cast<const char *>(memchr(begin, '\r', end - begin));
+
+                if(eol != nullptr){
+
+                    input(self, *eol);
+                    retval = eol + 1;
+                }
+
+                return retval;
+            }
         };
 
         // server output stream
-        class Output : public Stream {
+        //
+        // Gathers output into a small buffer so that a transaction reaches
+        // the host in as few Host::write() calls as possible.
+        //
+        // Host::line_was_tx() is deferred until the lines it reports have
+        // been passed to Host::write().
+        class Output final : public Stream {
         public:
 
             Output(Server& server)
                 :
-                server(&server)
+                server(&server),
+                pos(0),
+                lines(0)
             {
             }
 
             Output()
                 :
-                server(nullptr)
+                server(nullptr),
+                pos(0),
+                lines(0)
             {
             }
 
@@ -604,22 +1629,54 @@ namespace Bramble {
             {
                 if(server != nullptr){
 
-                    auto begin = (const uint8_t *)buffer;
-                    auto end = begin + size;
+                    if(size > (pending.size() - pos)){
+
+                        flush();
+                    }
+
+                    if(size >= pending.size()){
 
-                    for(auto iter = begin; iter != end; ++iter){
+                        server->host.write((const char *)buffer, size);
+                    }
+                    else{
 
-                        server->host.put_char(*iter);
+                        (void)memcpy(&pending[pos], buffer, size);
+                        pos += size;
                     }
                 }
 
                 return size;
             }
 
+            void flush()
+            {
+                if(server != nullptr){
+
+                    if(pos > 0){
+
+                        server->host.write(pending.data(), pos);
+                        pos = 0;
+                    }
+
+                    while(lines > 0){
+
+                        lines--;
+                        server->host.line_was_tx();
+                    }
+                }
+            }
+
+            // a line has been completed and shall be reported on the next flush
+            void line_complete()
+            {
+                lines++;
+            }
+
             void drain()
             {
                 if(server != nullptr){
 
+                    flush();
                     server->host.drain();
                 }
             }
@@ -627,6 +1684,10 @@ namespace Bramble {
         private:
 
             Server *server;
+
+            std::array<char, 128> pending;
+            size_t pos;
+            size_t lines;
         };
 
         Host& host;
@@ -648,15 +1709,24 @@ namespace Bramble {
         size_t size;
         const size_t end_offset;
 
+        StringView *index;
+        const size_t index_max;
+
+        const bool owned;
+        const size_t id;
+
+        Queue *queue;
+        Events *events;
+
         StringView name;
         StringView full_name;
         StringView invoke_id;
 
-        void put_cmd()
+        void put_cmd(const char *line)
         {
             Encoder(output)
                 .put_string("CMD:")
-                .put_string(buffer);
+                .put_string(line);
         }
 
         void put_nak(const char *msg)
@@ -680,6 +1750,80 @@ namespace Bramble {
             Encoder(output).put_string("\r\n");
         }
 
+        // end a CMD/ACK/NAK line
+        void put_tx_line_end()
+        {
+            put_line_end();
+            output.line_complete();
+        }
+
+        // a line that cannot be queued is NAKed so that every line is answered
+        void enqueue(char *line, size_t size)
+        {
+            if(queue->full()){
+
+                queue->drop_count++;
+
+                switch(queue->overflow){
+                default:
+                case Queue::Overflow::Reject:
+                    Handle::dispatch(*this, line, "queue_full");
+                    break;
+                case Queue::Overflow::DropNewest:
+                    Handle::dispatch(*this, queue->back(), "dropped");
+                    queue->pop_back();
+                    queue->push(line, size);
+                    break;
+                case Queue::Overflow::DropOldest:
+                    Handle::dispatch(*this, queue->front(), "dropped");
+                    queue->pop();
+                    queue->push(line, size);
+                    break;
+                }
+            }
+            else{
+
+                queue->push(line, size);
+            }
+        }
+
+        static bool is_response(const StringView& line)
+        {
+            return (line.size() >= 4U) && ((memcmp(line.data(), "ACK:", 4) == 0) || (memcmp(line.data(), "NAK:", 4) == 0));
+        }
+
+        // only called between transactions
+        void put_events()
+        {
+            if(events != nullptr){
+
+                StringView line;
+
+                while(events->front(line)){
+
+                    if(line.empty()){
+
+                        // dropped
+                    }
+                    else if(is_response(line)){
+
+                        // completed by a Deferred
+                        Encoder(output).put_string(line);
+                        put_tx_line_end();
+                    }
+                    else{
+
+                        Encoder(output).put_string(line);
+                        put_line_end();
+                    }
+
+                    events->pop();
+                }
+
+                output.flush();
+            }
+        }
+
         void *get_ctx()
         {
             return ctx;
@@ -0,0 +1,178 @@
+/* Copyright (c) 2024 Cameron Harper
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ *
+ */
+
+#ifndef BRAMBLE_SESSION_POOL_H_INCLUDED
+#define BRAMBLE_SESSION_POOL_H_INCLUDED
+
+#include "bramble_server.hpp"
+#include "bramble_string_view.hpp"
+
+#include <cstddef>
+#include <new>
+#include <type_traits>
+
+namespace Bramble {
+
+    /** A fixed pool of Server sessions
+     *
+     * Each session is a Server with its own Host, line buffer, token index
+     * and output. All storage is reserved up front, so opening a session on a new
+     * connection does not allocate.
+     *
+     * Sessions share handlers by having each Host dispatch to the same
+     * immutable Registry:
+     *
+     * @code
+     * static constexpr auto registry = Bramble::Registry::make(commands);
+     *
+     * bool Connection::call(Bramble::Server::Command& cmd, const Bramble::Argument& args)
+     * {
+     *     // cmd.session() tells you which connection issued cmd
+     *     return registry.call(cmd, args);
+     * }
+     *
+     * Bramble::SessionPool<4> pool;
+     *
+     * Bramble::Server *session = pool.open(connection);
+     * @endcode
+     *
+     * @tparam Sessions     maximum number of open sessions
+     * @tparam MaxLine      largest line a session can receive
+     * @tparam MaxArgs      number of tokens to index per line
+     *
+     * */
+    template<size_t Sessions, size_t MaxLine = 1024, size_t MaxArgs = 32>
+    class SessionPool {
+    public:
+
+        static_assert(Sessions > 0, "pool must have at least one session");
+        static_assert(MaxLine > 0, "line must have at least one character");
+        static_assert(MaxArgs > 0, "index must have at least one token");
+
+        SessionPool()
+            :
+            count(0)
+        {
+            for(size_t i = 0; i < Sessions; i++){
+
+                used[i] = false;
+            }
+        }
+
+        SessionPool(const SessionPool&) = delete;
+        SessionPool& operator=(const SessionPool&) = delete;
+
+        /** Destroy this pool and any sessions that are still open
+         *
+         * */
+        ~SessionPool()
+        {
+            for(size_t i = 0; i < Sessions; i++){
+
+                if(used[i]){
+
+                    at(i)->~Server();
+                }
+            }
+        }
+
+        /** Open a session
+         *
+         * The session id (Server::session()) is the slot the session occupies
+         * and may be reused after the session is closed.
+         *
+         * @param[in] host  host interface for this session
+         *
+         * @return session or nullptr if the pool is full
+         *
+         * */
+        Server *open(Server::Host& host)
+        {
+            Server *retval = nullptr;
+
+            for(size_t i = 0; i < Sessions; i++){
+
+                if(!used[i]){
+
+                    retval = new(&slot[i]) Server(host, buffer[i], MaxLine, index[i], MaxArgs, i);
+                    used[i] = true;
+                    count++;
+                    break;
+                }
+            }
+
+            return retval;
+        }
+
+        /** Close a session
+         *
+         * Does nothing if session was not opened from this pool.
+         *
+         * @param[in] session   session to close
+         *
+         * */
+        void close(Server& session)
+        {
+            auto i = session.session();
+
+            if((i < Sessions) && used[i] && (at(i) == &session)){
+
+                session.~Server();
+                used[i] = false;
+                count--;
+            }
+        }
+
+        /** number of open sessions
+         *
+         * */
+        size_t size() const
+        {
+            return count;
+        }
+
+        /** maximum number of open sessions
+         *
+         * */
+        static constexpr size_t capacity()
+        {
+            return Sessions;
+        }
+
+    private:
+
+        typename std::aligned_storage<sizeof(Server), alignof(Server)>::type slot[Sessions];
+        bool used[Sessions];
+
+        char buffer[Sessions][MaxLine + 1];
+        StringView index[Sessions][MaxArgs];
+
+        size_t count;
+
+        Server *at(size_t i)
+        {
+            return reinterpret_cast<Server *>(&slot[i]);
+        }
+    };
+};
+
+#endif
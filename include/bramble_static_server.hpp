@@ -0,0 +1,87 @@
+/* Copyright (c) 2024 Cameron Harper
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ *
+ */
+
+#ifndef BRAMBLE_STATIC_SERVER_H_INCLUDED
+#define BRAMBLE_STATIC_SERVER_H_INCLUDED
+
+#include "bramble_server.hpp"
+#include "bramble_string_view.hpp"
+
+#include <cstddef>
+#include <array>
+
+namespace Bramble {
+
+    /// @private
+    template<size_t MaxLine, size_t MaxArgs>
+    class StaticServerStorage {
+    protected:
+
+        std::array<char, MaxLine + 1> buffer;
+        std::array<StringView, MaxArgs> index;
+
+        StringView *index_data()
+        {
+            return (MaxArgs > 0) ? index.data() : nullptr;
+        }
+    };
+
+    /** A Server with inline storage
+     *
+     * Equivalent to Server but the line buffer and token index are members rather than
+     * being allocated, so a StaticServer can be a global or live on the stack.
+     *
+     * @code
+     * static YourHost host;
+     * static Bramble::StaticServer<128, 8> server(host);
+     * @endcode
+     *
+     * @tparam MaxLine  largest line server can receive
+     * @tparam MaxArgs  number of tokens to index per line
+     *
+     * */
+    template<size_t MaxLine = 1024, size_t MaxArgs = 32>
+    class StaticServer : private StaticServerStorage<MaxLine, MaxArgs>, public Server {
+    private:
+
+        using Storage = StaticServerStorage<MaxLine, MaxArgs>;
+
+    public:
+
+        static_assert(MaxLine > 0, "line must have at least one character");
+
+        /** Create a new server instance
+         *
+         * @param[in] host      host interface
+         * @param[in] session   session id (available from Command::session())
+         *
+         * */
+        StaticServer(Host& host, size_t session = 0)
+            :
+            Storage(),
+            Server(host, Storage::buffer.data(), MaxLine, Storage::index_data(), MaxArgs, session)
+        {
+        }
+    };
+};
+
+#endif
@@ -0,0 +1,387 @@
+/* Copyright (c) 2024 Cameron Harper
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ *
+ */
+
+#ifndef BRAMBLE_TASK_H_INCLUDED
+#define BRAMBLE_TASK_H_INCLUDED
+
+#if defined(__cpp_impl_coroutine) && defined(__has_include)
+#if __has_include(<coroutine>)
+#define BRAMBLE_HAS_COROUTINE
+#endif
+#endif
+
+#ifdef BRAMBLE_HAS_COROUTINE
+
+#include "bramble_server.hpp"
+#include "bramble_argument.hpp"
+
+#include <coroutine>
+#include <exception>
+#include <functional>
+#include <utility>
+#include <vector>
+
+namespace Bramble {
+
+    /** A command handler written as a C++20 coroutine
+     *
+     * The coroutine runs as soon as it is called. If it finishes without
+     * suspending it behaves exactly like an ordinary handler. The first time it
+     * suspends, the command is deferred (see Server::Command::defer()) so that the
+     * server can go on processing input, and the ACK is sent when the coroutine
+     * finishes:
+     *
+     * @code
+     * Bramble::Loop loop;
+     *
+     * Bramble::Task calibrate(Bramble::Server::Command& cmd, const Bramble::Argument& args)
+     * {
+     *     auto steps = count(args);   // arguments are only valid until the first suspension
+     *
+     *     for(size_t i = 0; i < steps; i++){
+     *
+     *         start_step(i);
+     *
+     *         co_await loop.until([]{ return step_done(); });
+     *     }
+     *
+     *     if(!calibrated()){
+     *
+     *         (co_await Bramble::Task::deferred()).nak("failed");
+     *     }
+     * }
+     *
+     * bool YourHost::call(Bramble::Server::Command& cmd, const Bramble::Argument& args)
+     * {
+     *     calibrate(cmd, args);
+     *     return true;
+     * }
+     *
+     * // main loop
+     * for(;;){
+     *
+     *     server.process();
+     *     loop.poll();
+     * }
+     * @endcode
+     *
+     * The first parameter of the coroutine must be the Server::Command. The
+     * Command and Argument passed to the handler, and the strings the Argument refers
+     * to, are only valid until the first suspension. Copy anything needed after that.
+     *
+     * The coroutine frame is released when the coroutine finishes. The Task
+     * object itself does not need to be kept.
+     *
+     * */
+    class Task {
+    public:
+
+        /** Awaitable that defers the command (if not already deferred) and
+         * returns the Server::Deferred used to complete it
+         *
+         * */
+        struct DeferredAwaiter {
+
+            /// @private
+            bool await_ready() const noexcept
+            {
+                return false;
+            }
+
+            /// @private
+            template<typename Promise>
+            bool await_suspend(std::coroutine_handle<Promise> handle) noexcept
+            {
+                deferred = &handle.promise().detach();
+                return false;
+            }
+
+            /// @private
+            Server::Deferred& await_resume() const noexcept
+            {
+                return *deferred;
+            }
+
+            /// @private
+            Server::Deferred *deferred = nullptr;
+        };
+
+        /** Get the Server::Deferred for this command
+         *
+         * Use this to NAK, or to ACK with arguments, after suspending. If the command
+         * has already been completed the Deferred is not pending.
+         *
+         * @code
+         * (co_await Bramble::Task::deferred()).nak("timeout");
+         * @endcode
+         *
+         * */
+        static DeferredAwaiter deferred()
+        {
+            return DeferredAwaiter();
+        }
+
+        /// @private
+        class promise_type {
+        public:
+
+            template<typename... Args>
+            promise_type(Server::Command& cmd, Args&&...)
+                :
+                cmd(cmd),
+                detached(false)
+            {
+            }
+
+            Task get_return_object()
+            {
+                return Task();
+            }
+
+            std::suspend_never initial_suspend() noexcept
+            {
+                return {};
+            }
+
+            std::suspend_never final_suspend() noexcept
+            {
+                return {};
+            }
+
+            void return_void()
+            {
+                // default response is always ack
+                deferred.ack();
+            }
+
+            void unhandled_exception()
+            {
+                std::terminate();
+            }
+
+            template<typename Awaitable>
+            auto await_transform(Awaitable&& awaitable)
+            {
+                return Awaiter<Awaitable>(*this, std::forward<Awaitable>(awaitable));
+            }
+
+            DeferredAwaiter await_transform(DeferredAwaiter awaitable)
+            {
+                return awaitable;
+            }
+
+            Server::Deferred& detach()
+            {
+                if(!detached){
+
+                    // only ever reached before the handler returns
+                    deferred = cmd.defer();
+                    detached = true;
+                }
+
+                return deferred;
+            }
+
+        private:
+
+            Server::Command cmd;
+            Server::Deferred deferred;
+            bool detached;
+
+            // defers the command before the coroutine first suspends
+            template<typename Awaitable>
+            class Awaiter {
+            public:
+
+                Awaiter(promise_type& promise, Awaitable&& awaitable)
+                    :
+                    promise(promise),
+                    awaitable(std::forward<Awaitable>(awaitable))
+                {
+                }
+
+                bool await_ready()
+                {
+                    return awaitable.await_ready();
+                }
+
+                template<typename Handle>
+                auto await_suspend(Handle handle)
+                {
+                    (void)promise.detach();
+
+                    return awaitable.await_suspend(handle);
+                }
+
+                decltype(auto) await_resume()
+                {
+                    return awaitable.await_resume();
+                }
+
+            private:
+
+                promise_type& promise;
+                Awaitable awaitable;
+            };
+        };
+    };
+
+    /** A minimal scheduler for Task
+     *
+     * Coroutines wait on a condition and are resumed by poll() once it holds. Call
+     * poll() from the same loop that calls Server::process().
+     *
+     * */
+    class Loop {
+    public:
+
+        using Condition = std::function<bool()>;
+
+        /// @private
+        class Awaiter {
+        public:
+
+            Awaiter(Loop& loop, Condition condition)
+                :
+                loop(loop),
+                condition(std::move(condition))
+            {
+            }
+
+            bool await_ready()
+            {
+                return condition();
+            }
+
+            void await_suspend(std::coroutine_handle<> handle)
+            {
+                loop.waiting.push_back(Waiting{handle, std::move(condition)});
+            }
+
+            void await_resume()
+            {
+            }
+
+        private:
+
+            Loop& loop;
+            Condition condition;
+        };
+
+        Loop() = default;
+
+        /** Destroy every coroutine that is still waiting
+         *
+         * The coroutines are not resumed and their commands are not answered.
+         *
+         * */
+        ~Loop()
+        {
+            for(auto& w : waiting){
+
+                w.handle.destroy();
+            }
+        }
+
+        Loop(const Loop&) = delete;
+        Loop& operator=(const Loop&) = delete;
+
+        /** Suspend until condition is true
+         *
+         * Does not suspend if condition is already true.
+         *
+         * @param[in] condition     evaluated on every poll()
+         *
+         * */
+        Awaiter until(Condition condition)
+        {
+            return Awaiter(*this, std::move(condition));
+        }
+
+        /** Suspend until the next poll()
+         *
+         * */
+        Awaiter yield()
+        {
+            bool first = true;
+
+            return Awaiter(*this, [first]() mutable { return !std::exchange(first, false); });
+        }
+
+        /** Resume every coroutine whose condition is true
+         *
+         * Coroutines that suspend again while being resumed are not resumed
+         * again until the next poll().
+         *
+         * @return number of coroutines resumed
+         *
+         * */
+        size_t poll()
+        {
+            size_t retval = 0;
+            std::vector<Waiting> ready;
+
+            for(auto iter = waiting.begin(); iter != waiting.end();){
+
+                if(iter->condition()){
+
+                    ready.push_back(std::move(*iter));
+                    iter = waiting.erase(iter);
+                }
+                else{
+
+                    ++iter;
+                }
+            }
+
+            for(auto& w : ready){
+
+                w.handle.resume();
+                retval++;
+            }
+
+            return retval;
+        }
+
+        /** number of suspended coroutines
+         *
+         * */
+        size_t size() const
+        {
+            return waiting.size();
+        }
+
+    private:
+
+        struct Waiting {
+
+            std::coroutine_handle<> handle;
+            Condition condition;
+        };
+
+        std::vector<Waiting> waiting;
+    };
+};
+
+#endif
+
+#endif
@@ -895,8 +895,9 @@ namespace Bramble {
 
             if(write_ptr != nullptr){
 
+                // source may overlap when rewriting a buffer in place
                 retval = std::min(max - pos, size);
-                (void)memcpy(&write_ptr[pos], buffer, retval);
+                (void)memmove(&write_ptr[pos], buffer, retval);
                 pos += retval;
             }
 
@@ -936,6 +937,9 @@ namespace Bramble {
 #endif
 
 #include <cstddef>
+#include <cstring>
+#include <iterator>
+#include <algorithm>
 
 namespace Bramble {
 
@@ -956,67 +960,95 @@ namespace Bramble {
          * Consequence of a too-small working buffer is that not all tokens will accounted for
          * and accessible.
          *
+         * An optional index table can be supplied to record the position and size of each token
+         * as it is found. This makes random access and iteration O(1) per step. If there are more tokens
+         * than the index can hold, the container falls back to scanning the working buffer.
+         *
          * @param[in] s         null-terminated input buffer
          * @param[in] working   working buffer (can be same memory as s)
          * @param[in] max       maximum size of working buffer
+         * @param[in] index     index table (optional)
+         * @param[in] index_max number of entries in index table
          *
          * */
-        Argument(const char *s, char *working, size_t max)
+        Argument(const char *s, char *working, size_t max, StringView *index = nullptr, size_t index_max = 0)
             :
             buffer(working),
             max(0),
-            count(0)
+            count(0),
+            index(index),
+            index_max(index_max)
         {
-            StringView input(s);
             BufferStream output(working, max);
 
             size_t token_size = 0;
 
-            bool escape = false;
             bool quote = false;
 
-            char quote_char;
+            char quote_char = 0;
 
-            for(auto iter = input.begin(); iter != input.end(); ++iter){
+            auto iter = (s != nullptr) ? s : "";
 
-                if(escape){
+            while(*iter != 0){
 
-                    escape = false;
-                    put_char(output, *iter);
-                }
-                else if(quote){
+                if(quote){
 
-                    if(quote_char == *iter){
+                    auto close = strchr(iter, quote_char);
+                    auto n = (close != nullptr) ? size_t(close - iter) : strlen(iter);
 
-                        quote = false;
-                    }
-                    else{
+                    put_string(output, iter, n);
+                    token_size += n;
+                    iter += n;
 
-                        put_char(output, *iter);
-                        token_size++;
+                    if(close != nullptr){
+
+                        quote = false;
+                        iter++;
                     }
                 }
-                else if(*iter == '\\'){
+                else{
 
-                    escape = true;
-                }
-                else if(*iter == ' '){
+                    // copy everything up to the next character that needs a decision
+                    auto n = strcspn(iter, " \\'\"");
 
-                    if(token_size > 0){
+                    put_string(output, iter, n);
+                    token_size += n;
+                    iter += n;
 
-                        put_char(output, 0);
-                        token_size = 0;
-                    }
-                }
-                else if((*iter == '\'') || (*iter == '"')){
+                    switch(*iter){
+                    case '\\':
 
-                    quote_char = *iter;
-                    quote = true;
-                }
-                else{
+                        iter++;
 
-                    put_char(output, *iter);
-                    token_size++;
+                        if(*iter != 0){
+
+                            put_char(output, *iter);
+                            iter++;
+                        }
+                        break;
+
+                    case ' ':
+
+                        if(token_size > 0){
+
+                            put_char(output, 0);
+                            token_size = 0;
+                        }
+
+                        iter++;
+                        break;
+
+                    case '\'':
+                    case '"':
+
+                        quote_char = *iter;
+                        quote = true;
+                        iter++;
+                        break;
+
+                    default:
+                        break;
+                    }
                 }
             }
 
@@ -1040,13 +1072,17 @@ namespace Bramble {
          * @param[in] argv      buffer of tokens
          * @param[in] working   working buffer
          * @param[in] max       maximum size of working buffer
+         * @param[in] index     index table (optional)
+         * @param[in] index_max number of entries in index table
          *
          * */
-        Argument(size_t argc, const char **argv, char *working, size_t max)
+        Argument(size_t argc, const char **argv, char *working, size_t max, StringView *index = nullptr, size_t index_max = 0)
             :
             buffer(working),
             max(0),
-            count(argc)
+            count(0),
+            index(index),
+            index_max(index_max)
         {
             BufferStream output(working, max);
 
@@ -1071,23 +1107,33 @@ namespace Bramble {
         class iterator {
         public:
 
-            using iterator_category = std::forward_iterator_tag;
+            using iterator_category = std::random_access_iterator_tag;
             using difference_type   = std::ptrdiff_t;
             using value_type        = StringView;
             using pointer           = const StringView*;
             using reference         = const StringView&;
 
+            iterator()
+                :
+                arg(nullptr),
+                pos(0),
+                offset(0)
+            {
+            }
+
             iterator(const Argument& arg)
                 :
                 arg(&arg),
+                pos(0),
                 offset(0),
-                v(arg.buffer)
+                v((arg.indexed() && (arg.count > 0)) ? arg.index[0] : StringView(arg.buffer))
             {
             }
 
             iterator(const Argument& arg, bool)
                 :
                 arg(&arg),
+                pos(arg.count),
                 offset(arg.max),
                 v(arg.buffer, 0)
             {
@@ -1097,17 +1143,18 @@ namespace Bramble {
             {
                 if(offset < arg->max){
 
-                    offset += v.size();
-                    offset++;
-                }
+                    if(arg->indexed()){
 
-                if(offset < arg->max){
+                        seek(pos + 1);
+                    }
+                    else{
 
-                    v = StringView(arg->buffer + offset);
-                }
-                else{
+                        pos++;
+                        offset += v.size();
+                        offset++;
 
-                    v = StringView();
+                        v = (offset < arg->max) ? StringView(arg->buffer + offset) : StringView();
+                    }
                 }
 
                 return *this;
@@ -1120,18 +1167,67 @@ namespace Bramble {
                 return retval;
             }
 
-            iterator operator+(size_t n) const
+            iterator& operator--()
+            {
+                return *this -= 1;
+            }
+
+            iterator operator--(int)
             {
                 auto retval = *this;
+                --(*this);
+                return retval;
+            }
+
+            iterator& operator+=(difference_type n)
+            {
+                if(arg->indexed()){
+
+                    seek(pos + n);
+                }
+                else if(n >= 0){
+
+                    for(difference_type i=0; i < n; ++i){
+
+                        ++(*this);
+                    }
+                }
+                else{
 
-                for(size_t i=0; i < n; ++i){
+                    // no way to walk backwards without an index
+                    auto target = std::max(difference_type(pos) + n, difference_type(0));
 
-                    ++retval;
+                    *this = iterator(*arg);
+                    *this += target;
                 }
 
+                return *this;
+            }
+
+            iterator& operator-=(difference_type n)
+            {
+                return *this += -n;
+            }
+
+            iterator operator+(difference_type n) const
+            {
+                auto retval = *this;
+                retval += n;
+                return retval;
+            }
+
+            iterator operator-(difference_type n) const
+            {
+                auto retval = *this;
+                retval -= n;
                 return retval;
             }
 
+            difference_type operator-(const iterator& other) const
+            {
+                return difference_type(pos) - difference_type(other.pos);
+            }
+
             StringView operator*() const
             {
                 return v;
@@ -1142,23 +1238,63 @@ namespace Bramble {
                 return &v;
             }
 
+            StringView operator[](difference_type n) const
+            {
+                return *(*this + n);
+            }
+
             bool operator==(const iterator& other) const
             {
-                //return v == other.v;
                 return offset == other.offset;
             }
 
             bool operator!=(const iterator& other) const
             {
-                //return v != other.v;
                 return offset != other.offset;
             }
 
+            bool operator<(const iterator& other) const
+            {
+                return pos < other.pos;
+            }
+
+            bool operator>(const iterator& other) const
+            {
+                return pos > other.pos;
+            }
+
+            bool operator<=(const iterator& other) const
+            {
+                return pos <= other.pos;
+            }
+
+            bool operator>=(const iterator& other) const
+            {
+                return pos >= other.pos;
+            }
+
         private:
 
             const Argument *arg;
+            size_t pos;
             size_t offset;
             StringView v;
+
+            void seek(size_t n)
+            {
+                if(n < arg->count){
+
+                    pos = n;
+                    v = arg->index[n];
+                    offset = size_t(v.data() - arg->buffer);
+                }
+                else{
+
+                    pos = arg->count;
+                    offset = arg->max;
+                    v = StringView();
+                }
+            }
         };
 
         typedef iterator const_iterator;
@@ -1196,7 +1332,18 @@ namespace Bramble {
          * */
         StringView front() const
         {
-            return StringView(buffer);
+            return (indexed() && (count > 0)) ? index[0] : StringView(buffer);
+        }
+
+        /** Accesses the token at position n
+         *
+         * This is O(1) when the container was created with a large enough index table,
+         * otherwise the working buffer is scanned from the beginning.
+         *
+         * */
+        StringView operator[](size_t n) const
+        {
+            return *(begin() + n);
         }
 
         /** Removes the first token from the container
@@ -1212,6 +1359,12 @@ namespace Bramble {
             max -=  retval.size();
             max--;
 
+            if(indexed()){
+
+                index++;
+                index_max--;
+            }
+
             return retval;
         }
 
@@ -1243,12 +1396,38 @@ namespace Bramble {
         size_t max;
         size_t count;
 
+        StringView *index;
+        size_t index_max;
+
+        bool indexed() const
+        {
+            return index != nullptr;
+        }
+
+        void put_string(BufferStream& s, const char *value, size_t size)
+        {
+            (void)s.write(value, size);
+        }
+
         void put_char(BufferStream& s, char c)
         {
             auto n = s.write(&c, 1);
 
             if((c == 0) && (n > 0)){
 
+                if(indexed()){
+
+                    if(count < index_max){
+
+                        index[count] = StringView(buffer + max, s.tell() - max - 1);
+                    }
+                    else{
+
+                        // too many tokens to index
+                        index = nullptr;
+                    }
+                }
+
                 count++;
                 max = s.tell();
             }
@@ -1257,113 +1436,518 @@ namespace Bramble {
 };
 
 #endif
+/* #include "bramble_hash.hpp" */
+/* Copyright (c) 2024 Cameron Harper
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ *
+ */
+
+#ifndef BRAMBLE_HASH_H_INCLUDED
+#define BRAMBLE_HASH_H_INCLUDED
+
+/* #include "bramble_string_view.hpp" first included at line 231 */
 
-#include <cstdint>
 #include <cstddef>
-#include <cstring>
+#include <cstdint>
 
 namespace Bramble {
 
-    /** An option parser
+    /** FNV-1a string hash
      *
+     * The null-terminated variant can be evaluated at compile time.
      *
      * */
-    class GetOpt {
+    class Hash {
     public:
 
-        /** define whether or not an option can have a value */
-        enum class Value {
-
-            Optional,   ///< continue parsing with and without a value
-            None,       ///< fail parsing if option has a value
-            Required    ///< fail parsing if option does not have a value
-        };
-
-        /** definition of an option */
-        struct Option {
-
-            const char *s;                  ///< long format option name (nullptr if not used)
-            char c;                         ///< short format option name (0 if not used)
-            Value value;                    ///< instruct parser on how to handle an option value
-
-            /** Successful match handler
-             *
-             * @param[in] self      the GetOpt instance
-             *
-             * */
-            void (*handler)(GetOpt& self);
-        };
-
-        /** Create an option parser instance
+        /** hash a null-terminated string
          *
-         * @param[in] begin     iterator to first token
-         * @param[in] end       iterator to end of tokens
-         * @param[in] options   pointer to table of options
-         * @param[in] size      number of options in table
+         * @param[in] s     null-terminated string
+         * @param[in] h     initial value
+         *
+         * @return hash
          *
          * */
-        GetOpt(Argument::iterator begin, Argument::iterator end, const Option *options=nullptr, size_t size=0)
-            :
-            argv_begin(begin),
-            argv_end(end),
-            options_begin(options),
-            options_end(options + size),
-            a(begin),
-            opt(nullptr),
-            ctx(nullptr),
-            status(Status::Active),
-            state(&Next::instance())
+        static constexpr uint32_t fnv1a(const char *s, uint32_t h = 2166136261UL)
         {
+            return (*s == 0) ? h : fnv1a(s + 1, uint32_t((h ^ uint8_t(*s)) * 16777619UL));
         }
 
-        /** call to stop parsing now
+        /** hash a string view
+         *
+         * @param[in] v     string view
+         *
+         * @return hash
          *
          * */
-        void stop()
+        static uint32_t fnv1a(const StringView& v)
         {
-            state->finish(*this, Status::Ok);
-        }
+            uint32_t h = 2166136261UL;
 
-        /** handle the next option (if there is one) */
-        void next()
-        {
-            state->next(*this);
+            for(auto iter = v.begin(); iter != v.end(); ++iter){
+
+                h = uint32_t((h ^ uint8_t(*iter)) * 16777619UL);
+            }
+
+            return h;
         }
+    };
 
-        /** check if parser has finished
-         *
-         * A parser can finish successfully or unsuccessfully, the finished
-         * status simply means that further calls to next() will have no effect.
-         *
-         * @retval true     parser has finished
-         * @retval false    call next() to try to parse next option
+    /// @private
+    template<size_t... I>
+    struct Sequence {
+    };
+
+    /// @private
+    template<typename A, typename B>
+    struct ConcatSequence;
+
+    /// @private
+    template<size_t... A, size_t... B>
+    struct ConcatSequence<Sequence<A...>, Sequence<B...>> {
+
+        using type = Sequence<A..., (sizeof...(A) + B)...>;
+    };
+
+    /// @private
+    template<size_t N>
+    struct MakeSequence {
+
+        using type = typename ConcatSequence<typename MakeSequence<N/2>::type, typename MakeSequence<N - N/2>::type>::type;
+    };
+
+    /// @private
+    template<>
+    struct MakeSequence<0> {
+
+        using type = Sequence<>;
+    };
+
+    /// @private
+    template<>
+    struct MakeSequence<1> {
+
+        using type = Sequence<0>;
+    };
+
+    /** A view of a HashIndex that does not depend on the size of the table
+     *
+     * @tparam T    table entry type
+     * @tparam Key  pointer to the name member of T
+     *
+     * */
+    template<typename T, const char * T::*Key>
+    class HashView {
+    public:
+
+        /** Create an empty view
          *
-         *  */
-        bool finished() const
+         * */
+        HashView()
+            :
+            table(nullptr),
+            size(0),
+            bucket(nullptr),
+            buckets(0),
+            next(nullptr)
         {
-            return status != Status::Active;
         }
 
-        /** Check if parser finished on an unknown option
-         *
-         * @retval true     option is unknown
-         * @retval false
-         *
-         * */
-        bool unknown() const
+        /// @private
+        HashView(const T *table, size_t size, const uint16_t *bucket, size_t buckets, const uint16_t *next)
+            :
+            table(table),
+            size(size),
+            bucket(bucket),
+            buckets(buckets),
+            next(next)
         {
-            return status == Status::Unknown;
         }
 
-        /** Check if parser finished on a known option that is missing a required value
+        /** Find an entry by name
          *
-         * @retval true     option is missing a required value
+         * @param[in] name  name to find
+         *
+         * @return pointer to entry or nullptr if not found
          *
          * */
-        bool missing() const
+        const T *find(const StringView& name) const
         {
-            return status == Status::Missing;
-        }
+            const T *retval = nullptr;
+
+            if(!empty()){
+
+                for(size_t i = bucket[Hash::fnv1a(name) & (buckets - 1)]; i != size; i = next[i]){
+
+                    if(name.compare(table[i].*Key) == 0){
+
+                        retval = &table[i];
+                        break;
+                    }
+                }
+            }
+
+            return retval;
+        }
+
+        /** Return true if this view is not attached to an index
+         *
+         * */
+        bool empty() const
+        {
+            return table == nullptr;
+        }
+
+    private:
+
+        const T *table;
+        size_t size;
+        const uint16_t *bucket;
+        size_t buckets;
+        const uint16_t *next;
+    };
+
+    /// @private
+    constexpr size_t hash_buckets(size_t n, size_t p = 1)
+    {
+        return (p >= n) ? p : hash_buckets(n, p * 2);
+    }
+
+    /** A hash index over a static table
+     *
+     * The index is built from a table of T where each entry is named by a null-terminated
+     * string member (Key). Construction can be done at compile time, lookup
+     * does not allocate and visits only the entries that share a bucket.
+     *
+     * Entries with a null name are not indexed. If more than one entry has the
+     * same name the first one wins.
+     *
+     * @tparam T    table entry type
+     * @tparam N    number of entries in table
+     * @tparam Key  pointer to the name member of T
+     *
+     * */
+    template<typename T, size_t N, const char * T::*Key>
+    class HashIndex {
+    public:
+
+        static_assert(N > 0, "table must not be empty");
+        static_assert(N < UINT16_MAX, "table is too large");
+
+        /** number of buckets (a power of two, at least N) */
+        static constexpr size_t buckets = hash_buckets(N);
+
+        /** Create an index
+         *
+         * @param[in] table     table to index (must outlive the index)
+         *
+         * */
+        constexpr HashIndex(const T (&table)[N])
+            :
+            HashIndex(table, slots(table, typename MakeSequence<N>::type()), typename MakeSequence<buckets>::type(), typename MakeSequence<N>::type())
+        {
+        }
+
+        /** Find an entry by name
+         *
+         * @param[in] name  name to find
+         *
+         * @return pointer to entry or nullptr if not found
+         *
+         * */
+        const T *find(const StringView& name) const
+        {
+            return view().find(name);
+        }
+
+        /** Get a view of this index
+         *
+         * */
+        HashView<T, Key> view() const
+        {
+            return HashView<T, Key>(table, N, bucket, buckets, next);
+        }
+
+        /** the indexed table
+         *
+         * */
+        constexpr const T *data() const
+        {
+            return table;
+        }
+
+        /** number of entries in the indexed table
+         *
+         * */
+        constexpr size_t size() const
+        {
+            return N;
+        }
+
+    private:
+
+        const T *table;
+        uint16_t bucket[buckets];
+        uint16_t next[N];
+
+        // bucket of each entry (buckets if entry is not indexed)
+        struct Slots {
+
+            size_t value[N];
+        };
+
+        template<size_t... K, size_t... I>
+        constexpr HashIndex(const T (&table)[N], const Slots& s, Sequence<K...>, Sequence<I...>)
+            :
+            table(table),
+            bucket{uint16_t(first(s, K, 0, N))...},
+            next{uint16_t((s.value[I] == buckets) ? N : first(s, s.value[I], I + 1, N))...}
+        {
+        }
+
+        template<size_t... I>
+        static constexpr Slots slots(const T *table, Sequence<I...>)
+        {
+            return Slots{{((table[I].*Key == nullptr) ? buckets : (Hash::fnv1a(table[I].*Key) & (buckets - 1)))...}};
+        }
+
+        static constexpr size_t lowest(size_t a, size_t b)
+        {
+            return (a < b) ? a : b;
+        }
+
+        // lowest index in [lo, hi) that belongs to bucket k, otherwise N
+        static constexpr size_t first(const Slots& s, size_t k, size_t lo, size_t hi)
+        {
+            return (hi <= lo)
+                ?
+                N
+                :
+                (hi - lo == 1)
+                    ?
+                    ((s.value[lo] == k) ? lo : N)
+                    :
+                    lowest(first(s, k, lo, lo + (hi - lo)/2), first(s, k, lo + (hi - lo)/2, hi));
+        }
+    };
+
+    template<typename T, size_t N, const char * T::*Key>
+    constexpr size_t HashIndex<T, N, Key>::buckets;
+};
+
+#endif
+
+#include <cstdint>
+#include <cstddef>
+#include <cstring>
+
+namespace Bramble {
+
+    /** An option parser
+     *
+     *
+     * */
+    class GetOpt {
+    public:
+
+        /** define whether or not an option can have a value */
+        enum class Value {
+
+            Optional,   ///< continue parsing with and without a value
+            None,       ///< fail parsing if option has a value
+            Required    ///< fail parsing if option does not have a value
+        };
+
+        /** definition of an option */
+        struct Option {
+
+            const char *s;                  ///< long format option name (nullptr if not used)
+            char c;                         ///< short format option name (0 if not used)
+            Value value;                    ///< instruct parser on how to handle an option value
+
+            /** Successful match handler
+             *
+             * @param[in] self      the GetOpt instance
+             *
+             * */
+            void (*handler)(GetOpt& self);
+        };
+
+        /** An index over a static table of options
+         *
+         * Short options are found through a direct table and long options through a hash
+         * index. Both are built at compile time if the option table is constexpr:
+         *
+         * @code
+         * static constexpr Bramble::GetOpt::Option options[] = {
+         *     {"freq", 'f', Bramble::GetOpt::Value::Required, on_freq},
+         *     {"verbose", 'v', Bramble::GetOpt::Value::None, on_verbose}
+         * };
+         *
+         * static constexpr Bramble::GetOpt::Index<2> index(options);
+         *
+         * Bramble::GetOpt parser(args.begin(), args.end(), index);
+         * @endcode
+         *
+         * @tparam N    number of options in table
+         *
+         * */
+        template<size_t N>
+        class Index {
+        public:
+
+            static_assert(N < UINT8_MAX, "table is too large");
+
+            /** Index a table of options
+             *
+             * @param[in] options   table (must outlive this instance)
+             *
+             * */
+            constexpr Index(const Option (&options)[N])
+                :
+                Index(options, typename MakeSequence<256>::type())
+            {
+            }
+
+        private:
+
+            friend class GetOpt;
+
+            HashIndex<Option, N, &Option::s> long_index;
+            uint8_t short_index[256];
+
+            template<size_t... C>
+            constexpr Index(const Option (&options)[N], Sequence<C...>)
+                :
+                long_index(options),
+                short_index{uint8_t(first(options, char(C), 0, N))...}
+            {
+            }
+
+            static constexpr size_t lowest(size_t a, size_t b)
+            {
+                return (a < b) ? a : b;
+            }
+
+            // lowest index in [lo, hi) with short name c, otherwise N
+            static constexpr size_t first(const Option *options, char c, size_t lo, size_t hi)
+            {
+                return (hi <= lo)
+                    ?
+                    N
+                    :
+                    (hi - lo == 1)
+                        ?
+                        (((c != 0) && (options[lo].c == c)) ? lo : N)
+                        :
+                        lowest(first(options, c, lo, lo + (hi - lo)/2), first(options, c, lo + (hi - lo)/2, hi));
+            }
+        };
+
+        /** Create an option parser instance
+         *
+         * @param[in] begin     iterator to first token
+         * @param[in] end       iterator to end of tokens
+         * @param[in] options   pointer to table of options
+         * @param[in] size      number of options in table
+         *
+         * */
+        GetOpt(Argument::iterator begin, Argument::iterator end, const Option *options=nullptr, size_t size=0)
+            :
+            argv_begin(begin),
+            argv_end(end),
+            options_begin(options),
+            options_end(options + size),
+            a(begin),
+            opt(nullptr),
+            ctx(nullptr),
+            status(Status::Active),
+            state(&Next::instance()),
+            short_index(nullptr)
+        {
+        }
+
+        /** Create an option parser instance that uses an index
+         *
+         * @param[in] begin     iterator to first token
+         * @param[in] end       iterator to end of tokens
+         * @param[in] index     index over a table of options
+         *
+         * */
+        template<size_t N>
+        GetOpt(Argument::iterator begin, Argument::iterator end, const Index<N>& index)
+            :
+            GetOpt(begin, end, index.long_index.data(), N)
+        {
+            short_index = index.short_index;
+            long_index = index.long_index.view();
+        }
+
+        /** call to stop parsing now
+         *
+         * */
+        void stop()
+        {
+            state->finish(*this, Status::Ok);
+        }
+
+        /** handle the next option (if there is one) */
+        void next()
+        {
+            state->next(*this);
+        }
+
+        /** check if parser has finished
+         *
+         * A parser can finish successfully or unsuccessfully, the finished
+         * status simply means that further calls to next() will have no effect.
+         *
+         * @retval true     parser has finished
+         * @retval false    call next() to try to parse next option
+         *
+         *  */
+        bool finished() const
+        {
+            return status != Status::Active;
+        }
+
+        /** Check if parser finished on an unknown option
+         *
+         * @retval true     option is unknown
+         * @retval false
+         *
+         * */
+        bool unknown() const
+        {
+            return status == Status::Unknown;
+        }
+
+        /** Check if parser finished on a known option that is missing a required value
+         *
+         * @retval true     option is missing a required value
+         *
+         * */
+        bool missing() const
+        {
+            return status == Status::Missing;
+        }
 
         /** Check if parser finished on a known option that is not supposed to have an associated value
          *
@@ -1598,7 +2182,7 @@ namespace Bramble {
 
                     self.n = self.a->substr(offset, 1);
 
-                    if(!self.lookup_short_option(self.n.front(), &self.opt)){
+                    if(!self.lookup_short_option(*self.n_iter, &self.opt)){
 
                         finish(self, Status::Unknown);
                     }
@@ -1687,6 +2271,9 @@ namespace Bramble {
 
         const State *state;
 
+        const uint8_t *short_index;
+        HashView<Option, &Option::s> long_index;
+
         void set_state(const State& value)
         {
             state->after(*this);
@@ -1698,13 +2285,26 @@ namespace Bramble {
         {
             bool retval = false;
 
-            for(auto iter = options_begin; iter != options_end; ++iter){
+            if(short_index != nullptr){
+
+                auto i = short_index[uint8_t(c)];
 
-                if(iter->c == c){
+                if(i < (options_end - options_begin)){
 
-                    *output = iter;
+                    *output = options_begin + i;
                     retval = true;
-                    break;
+                }
+            }
+            else{
+
+                for(auto iter = options_begin; iter != options_end; ++iter){
+
+                    if(iter->c == c){
+
+                        *output = iter;
+                        retval = true;
+                        break;
+                    }
                 }
             }
 
@@ -1715,14 +2315,22 @@ namespace Bramble {
         {
             bool retval = false;
 
-            for(auto iter = options_begin; iter != options_end; ++iter){
-
-                if(s.compare(iter->s) == 0){
+            if(!long_index.empty()){
 
-                    *output = iter;
-                    retval = true;
-                    break;
-                }
+                *output = long_index.find(s);
+                retval = (*output != nullptr);
+            }
+            else{
+
+                for(auto iter = options_begin; iter != options_end; ++iter){
+
+                    if((iter->s != nullptr) && (s.compare(iter->s) == 0)){
+
+                        *output = iter;
+                        retval = true;
+                        break;
+                    }
+                }
             }
 
             return retval;
@@ -1767,2018 +2375,7447 @@ namespace Bramble {
 
 /* #include "bramble_stream.hpp" first included at line 139 */
 /* #include "bramble_string_view.hpp" first included at line 231 */
+/* #include "bramble_integer_format.hpp" */
+/* Copyright (c) 2024 Cameron Harper
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ *
+ */
+
+#ifndef BRAMBLE_INTEGER_FORMAT_H_INCLUDED
+#define BRAMBLE_INTEGER_FORMAT_H_INCLUDED
 
-#include <cstdint>
 #include <cstddef>
-#include <array>
-#include <algorithm>
+#include <cstdint>
 
 namespace Bramble {
 
-    /** Encoder is intended to be used to add arguments to a Request or an ACK response.
+    /** Integer to text conversion into caller provided buffers
      *
-     * Encoder instances write to Stream and representations are optimised for Bramble protocol.
+     * Each to_chars() writes the representation to [first, last) without
+     * a null terminator and returns one past the last character written.
+     * If the representation does not fit nothing is written and nullptr is
+     * returned.
+     *
+     * The size of the representation is known before writing: the number of
+     * decimal digits comes from the bit length of the value, and digits are
+     * then written two at a time from a table.
      *
      * */
-    class Encoder {
+    class IntegerFormat {
     public:
 
-        /** integer base */
-        enum class Base {
-
-            k10,    ///< decimal
-            k16     ///< hexadecimal
-        };
-
-        /** Create an Encoder
-         *
-         * @param[in] s output stream
-         *
-         * */
-        Encoder(Stream& s)
-            :
-            s(s)
-        {}
-
-        virtual ~Encoder()
-        {}
-
-        /** the output stream */
-        Stream& s;
+        /** characters needed for the longest decimal representation of a 64 bit integer (including sign) */
+        static const size_t max_chars = 20;
 
-        /** put a deliminter character (a single whitespace)
+        /** count decimal digits
          *
-         * Delimiters separate tokens in Bramble protocol.
+         * @param[in] value
          *
-         * @return Encoder&
+         * @return number of digits (at least 1)
          *
          * */
-        Encoder& put_space()
+        static size_t count_digits(uint32_t value)
         {
-            return put_char(' ');
+            static const uint32_t pow10[] = {
+                1UL, 10UL, 100UL, 1000UL, 10000UL, 100000UL, 1000000UL, 10000000UL, 100000000UL, 1000000000UL
+            };
+
+            uint32_t v = value | 1U;
+            size_t t = (bit_length(v) * 1233U) >> 12;
+
+            return t + ((v >= pow10[t]) ? 1U : 0U);
         }
 
-        /// @copydoc put_space()
-        Encoder& space()
+        /// @copydoc count_digits(uint32_t)
+        static size_t count_digits(uint64_t value)
         {
-            return put_space();
+            static const uint64_t pow10[] = {
+                1ULL, 10ULL, 100ULL, 1000ULL, 10000ULL, 100000ULL, 1000000ULL, 10000000ULL, 100000000ULL, 1000000000ULL,
+                10000000000ULL, 100000000000ULL, 1000000000000ULL, 10000000000000ULL, 100000000000000ULL,
+                1000000000000000ULL, 10000000000000000ULL, 100000000000000000ULL, 1000000000000000000ULL,
+                10000000000000000000ULL
+            };
+
+            uint64_t v = value | 1U;
+            size_t t = (bit_length(v) * 1233U) >> 12;
+
+            return t + ((v >= pow10[t]) ? 1U : 0U);
         }
 
-        /** put visible string
+        /** count hexadecimal digits
          *
-         * @param[in] value     input buffer
-         * @param[in] size      size of input buffer
+         * @param[in] value
          *
-         * @return Encoder&
+         * @return number of digits (at least 1)
          *
          * */
-        Encoder& put_string(const char *value, size_t size)
+        static size_t count_hex_digits(uint64_t value)
         {
-            (void)s.write(value, size);
-            return *this;
+            return (bit_length(value | 1U) + 3U) / 4U;
         }
 
-        /** put null terminated visible string
+        /** write value as decimal
          *
-         * @param[in] value     input buffer
+         * @param[in] first     start of buffer
+         * @param[in] last      one past the end of buffer
+         * @param[in] value
          *
-         * @return Encoder&
+         * @return one past the last character written (nullptr if value does not fit)
          *
          * */
-        Encoder& put_string(const char *value)
+        static char *to_chars(char *first, char *last, uint32_t value)
         {
-            (void)s.write(value, strlen(value));
-            return *this;
+            return put_digits<uint32_t>(first, last, value, false);
         }
 
-        /** put a string view
-         *
-         * @param[in] value     input view
-         *
-         * @return Encoder&
-         *
-         * */
-        Encoder& put_string(const StringView& value)
+        /// @copydoc to_chars(char *, char *, uint32_t)
+        static char *to_chars(char *first, char *last, uint64_t value)
         {
-            (void)s.write(value.data(), value.size());
-            return *this;
+            return put_digits<uint64_t>(first, last, value, false);
         }
 
-        /** put a single character
-         *
-         * @param[in] value     single character
-         *
-         * @return Encoder&
-         *
-         * */
-        Encoder& put_char(char value)
+        /// @copydoc to_chars(char *, char *, uint32_t)
+        static char *to_chars(char *first, char *last, int32_t value)
         {
-            (void)s.write(&value, sizeof(value));
-            return *this;
+            // negate in unsigned arithmetic so that INT32_MIN is defined
+            return put_digits<uint32_t>(first, last, (value < 0) ? (uint32_t(0) - uint32_t(value)) : uint32_t(value), value < 0);
         }
 
-        /** put an integer
+        /// @copydoc to_chars(char *, char *, uint32_t)
+        static char *to_chars(char *first, char *last, int64_t value)
+        {
+            return put_digits<uint64_t>(first, last, (value < 0) ? (uint64_t(0) - uint64_t(value)) : uint64_t(value), value < 0);
+        }
+
+        /** write value as lower case hexadecimal (without prefix)
          *
-         * @param[in] value     integer
+         * @param[in] first     start of buffer
+         * @param[in] last      one past the end of buffer
+         * @param[in] value
          *
-         * @return Encoder&
+         * @return one past the last character written (nullptr if value does not fit)
          *
          * */
-        Encoder& put_int(uint8_t value, Base base=Base::k10)
+        static char *to_hex_chars(char *first, char *last, uint64_t value)
         {
-            return put_int(uint32_t(value), base);
-        }
+            static const char digits[] = "0123456789abcdef";
 
-        /// @copydoc put_int(uint8_t)
-        Encoder& put_int(uint16_t value, Base base=Base::k10)
-        {
-            return put_int(uint32_t(value), base);
-        }
+            char *retval = nullptr;
+            size_t n = count_hex_digits(value);
 
-        /// @copydoc put_int(uint8_t)
-        Encoder& put_int(uint32_t value, Base base=Base::k10)
-        {
-            return uint_to_s<uint32_t>(value, base);
-        }
+            if((last - first) >= ptrdiff_t(n)){
 
-        /// @copydoc put_int(uint8_t)
-        Encoder& put_int(uint64_t value, Base base=Base::k10)
-        {
-            return uint_to_s<uint64_t>(value, base);
+                retval = first + n;
+
+                for(char *p = retval; p != first; value >>= 4){
+
+                    --p;
+                    *p = digits[value & 0xfU];
+                }
+            }
+
+            return retval;
         }
 
-        /// @copydoc put_int(uint8_t)
-        Encoder& put_int(int8_t value, Base base=Base::k10)
+    protected:
+
+        template<typename T>
+        static char *put_digits(char *first, char *last, T value, bool negative)
         {
-            return put_int(int32_t(value), base);
+            char *retval = nullptr;
+            size_t n = count_digits(value) + (negative ? 1U : 0U);
+
+            if((last - first) >= ptrdiff_t(n)){
+
+                const char *pairs = digit_pairs();
+                char *p = first + n;
+                T v = value;
+
+                retval = p;
+
+                // peel eight digits at a time so the rest is done in 32 bit arithmetic
+                while(v > T(UINT32_MAX)){
+
+                    uint32_t low = uint32_t(v % T(100000000UL));
+
+                    v /= T(100000000UL);
+                    p -= 8;
+
+                    for(size_t k = 8; k > 0; k -= 2){
+
+                        size_t i = size_t(low % 100U) * 2U;
+
+                        low /= 100U;
+                        p[k - 2U] = pairs[i];
+                        p[k - 1U] = pairs[i + 1U];
+                    }
+                }
+
+                uint32_t w = uint32_t(v);
+
+                while(w >= 100U){
+
+                    size_t i = size_t(w % 100U) * 2U;
+
+                    w /= 100U;
+                    p -= 2;
+                    p[0] = pairs[i];
+                    p[1] = pairs[i + 1U];
+                }
+
+                if(w >= 10U){
+
+                    size_t i = size_t(w) * 2U;
+
+                    p -= 2;
+                    p[0] = pairs[i];
+                    p[1] = pairs[i + 1U];
+                }
+                else{
+
+                    --p;
+                    *p = char('0' + char(w));
+                }
+
+                if(negative){
+
+                    *first = '-';
+                }
+            }
+
+            return retval;
         }
 
-        /// @copydoc put_int(uint8_t)
-        Encoder& put_int(int16_t value, Base base=Base::k10)
+        // number of significant bits (value must not be zero)
+        static size_t bit_length(uint32_t value)
         {
-            return put_int(int32_t(value), base);
+#if defined(__GNUC__)
+            return 32U - size_t(__builtin_clz(value));
+#else
+            return bit_length(uint64_t(value));
+#endif
         }
 
-        /// @copydoc put_int(uint8_t)
-        Encoder& put_int(int32_t value, Base base=Base::k10)
+        static size_t bit_length(uint64_t value)
         {
-            if((base == Base::k10) && (value < 0)){
+#if defined(__GNUC__)
+            return 64U - size_t(__builtin_clzll(value));
+#else
+            size_t retval = 0;
+
+            for(; value != 0U; value >>= 1){
 
-                (void)put_char('-');
+                retval++;
             }
 
-            return put_int(uint32_t(std::abs(value)), base);
+            return retval;
+#endif
         }
 
-        /// @copydoc put_int(uint8_t)
-        Encoder& put_int(int64_t value, Base base=Base::k10)
+        static const char *digit_pairs()
         {
-            if((base == Base::k10) && (value < 0)){
-
-                (void)put_char('-');
-            }
+            static const char table[] =
+                "00010203040506070809"
+                "10111213141516171819"
+                "20212223242526272829"
+                "30313233343536373839"
+                "40414243444546474849"
+                "50515253545556575859"
+                "60616263646566676869"
+                "70717273747576777879"
+                "80818283848586878889"
+                "90919293949596979899";
 
-            return put_int(uint64_t(std::abs(value)), base);
+            return table;
         }
+    };
+};
 
-        /** put an unsigned integer
+#endif
+/* #include "bramble_float_format.hpp" */
+/* Copyright (c) 2024 Cameron Harper
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ *
+ */
+
+#ifndef BRAMBLE_FLOAT_FORMAT_H_INCLUDED
+#define BRAMBLE_FLOAT_FORMAT_H_INCLUDED
+
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <cmath>
+#include <limits>
+
+namespace Bramble {
+
+    /** Floating point to text conversion and back without heap, locale or stdio
+     *
+     * to_chars() puts the shortest digits that read back as the same value
+     * (Grisu2), using plain notation for moderate exponents and "1.5e-7"
+     * notation otherwise. NaN and infinity are put as "nan", "inf" and "-inf".
+     *
+     * from_chars() reads `[-]digits[.digits][(e|E)[+|-]digits]`, "inf" and
+     * "nan". The result is correctly rounded when there are no more than 19
+     * significant digits, otherwise it is within one unit in the last place.
+     *
+     * */
+    class FloatFormat {
+    public:
+
+        /** characters needed for the longest representation of a double */
+        static const size_t max_chars = 32;
+
+        /** write value using the shortest representation that reads back as value
          *
-         * @param[in] value     unsigned integer
+         * @param[in] first     start of buffer
+         * @param[in] last      one past the end of buffer
+         * @param[in] value
          *
-         * @return Encoder&
+         * @return one past the last character written (nullptr if value does not fit)
          *
          * */
-        Encoder& put_unsigned(uint8_t value, Base base=Base::k10)
+        static char *to_chars(char *first, char *last, double value)
         {
-            return put_int(value, base);
+            return put_shortest<double>(first, last, value);
         }
 
-        /// @copydoc put_unsigned(uint8_t)
-        Encoder& put_unsigned(uint16_t value, Base base=Base::k10)
+        /// @copydoc to_chars(char *, char *, double)
+        static char *to_chars(char *first, char *last, float value)
         {
-            return put_int(value, base);
+            return put_shortest<float>(first, last, value);
         }
 
-        /// @copydoc put_unsigned(uint8_t)
-        Encoder& put_unsigned(uint32_t value, Base base=Base::k10)
+        /** read a number
+         *
+         * @param[in] first     start of text
+         * @param[in] last      one past the end of text
+         * @param[out] value
+         *
+         * @return one past the last character read (nullptr if there is no number or it is out of range)
+         *
+         * */
+        static const char *from_chars(const char *first, const char *last, double& value)
         {
-            return put_int(value, base);
+            return get_nearest<double>(first, last, value);
         }
 
-        /// @copydoc put_unsigned(uint8_t)
-        Encoder& put_unsigned(uint64_t value, Base base=Base::k10)
+        /// @copydoc from_chars(const char *, const char *, double&)
+        static const char *from_chars(const char *first, const char *last, float& value)
         {
-            return put_int(value, base);
+            return get_nearest<float>(first, last, value);
         }
 
-        /// @copydoc put_unsigned(uint8_t)
-        Encoder& put_uint8(uint8_t value, Base base=Base::k10)
-        {
-            return put_int(value, base);
-        }
+    protected:
 
-        /// @copydoc put_unsigned(uint8_t)
-        Encoder& put_uint16(uint16_t value, Base base=Base::k10)
-        {
-            return put_int(value, base);
-        }
+        // f * 2^e
+        struct DiyFp {
 
-        /// @copydoc put_unsigned(uint8_t)
-        Encoder& put_uint32(uint32_t value, Base base=Base::k10)
-        {
-            return put_int(value, base);
-        }
+            uint64_t f;
+            int e;
+        };
 
-        /// @copydoc put_unsigned(uint8_t)
-        Encoder& put_uint64(uint64_t value, Base base=Base::k10)
-        {
-            return put_int(value, base);
+        struct CachedPower {
+
+            uint64_t f;
+            int e;
+            int k;
+        };
+
+        static const int cached_powers_min_dec_exp = -348;
+        static const int cached_powers_dec_step = 8;
+
+        // 10^k = f * 2^e for k in [-348, 340] step 8, f rounded to nearest
+        static const CachedPower& cached_power(size_t index)
+        {
+            static const CachedPower table[] = {
+                {0xFA8FD5A0081C0288ULL, -1220, -348},
+                {0xBAAEE17FA23EBF76ULL, -1193, -340},
+                {0x8B16FB203055AC76ULL, -1166, -332},
+                {0xCF42894A5DCE35EAULL, -1140, -324},
+                {0x9A6BB0AA55653B2DULL, -1113, -316},
+                {0xE61ACF033D1A45DFULL, -1087, -308},
+                {0xAB70FE17C79AC6CAULL, -1060, -300},
+                {0xFF77B1FCBEBCDC4FULL, -1034, -292},
+                {0xBE5691EF416BD60CULL, -1007, -284},
+                {0x8DD01FAD907FFC3CULL, -980, -276},
+                {0xD3515C2831559A83ULL, -954, -268},
+                {0x9D71AC8FADA6C9B5ULL, -927, -260},
+                {0xEA9C227723EE8BCBULL, -901, -252},
+                {0xAECC49914078536DULL, -874, -244},
+                {0x823C12795DB6CE57ULL, -847, -236},
+                {0xC21094364DFB5637ULL, -821, -228},
+                {0x9096EA6F3848984FULL, -794, -220},
+                {0xD77485CB25823AC7ULL, -768, -212},
+                {0xA086CFCD97BF97F4ULL, -741, -204},
+                {0xEF340A98172AACE5ULL, -715, -196},
+                {0xB23867FB2A35B28EULL, -688, -188},
+                {0x84C8D4DFD2C63F3BULL, -661, -180},
+                {0xC5DD44271AD3CDBAULL, -635, -172},
+                {0x936B9FCEBB25C996ULL, -608, -164},
+                {0xDBAC6C247D62A584ULL, -582, -156},
+                {0xA3AB66580D5FDAF6ULL, -555, -148},
+                {0xF3E2F893DEC3F126ULL, -529, -140},
+                {0xB5B5ADA8AAFF80B8ULL, -502, -132},
+                {0x87625F056C7C4A8BULL, -475, -124},
+                {0xC9BCFF6034C13053ULL, -449, -116},
+                {0x964E858C91BA2655ULL, -422, -108},
+                {0xDFF9772470297EBDULL, -396, -100},
+                {0xA6DFBD9FB8E5B88FULL, -369, -92},
+                {0xF8A95FCF88747D94ULL, -343, -84},
+                {0xB94470938FA89BCFULL, -316, -76},
+                {0x8A08F0F8BF0F156BULL, -289, -68},
+                {0xCDB02555653131B6ULL, -263, -60},
+                {0x993FE2C6D07B7FACULL, -236, -52},
+                {0xE45C10C42A2B3B06ULL, -210, -44},
+                {0xAA242499697392D3ULL, -183, -36},
+                {0xFD87B5F28300CA0EULL, -157, -28},
+                {0xBCE5086492111AEBULL, -130, -20},
+                {0x8CBCCC096F5088CCULL, -103, -12},
+                {0xD1B71758E219652CULL, -77, -4},
+                {0x9C40000000000000ULL, -50, 4},
+                {0xE8D4A51000000000ULL, -24, 12},
+                {0xAD78EBC5AC620000ULL, 3, 20},
+                {0x813F3978F8940984ULL, 30, 28},
+                {0xC097CE7BC90715B3ULL, 56, 36},
+                {0x8F7E32CE7BEA5C70ULL, 83, 44},
+                {0xD5D238A4ABE98068ULL, 109, 52},
+                {0x9F4F2726179A2245ULL, 136, 60},
+                {0xED63A231D4C4FB27ULL, 162, 68},
+                {0xB0DE65388CC8ADA8ULL, 189, 76},
+                {0x83C7088E1AAB65DBULL, 216, 84},
+                {0xC45D1DF942711D9AULL, 242, 92},
+                {0x924D692CA61BE758ULL, 269, 100},
+                {0xDA01EE641A708DEAULL, 295, 108},
+                {0xA26DA3999AEF774AULL, 322, 116},
+                {0xF209787BB47D6B85ULL, 348, 124},
+                {0xB454E4A179DD1877ULL, 375, 132},
+                {0x865B86925B9BC5C2ULL, 402, 140},
+                {0xC83553C5C8965D3DULL, 428, 148},
+                {0x952AB45CFA97A0B3ULL, 455, 156},
+                {0xDE469FBD99A05FE3ULL, 481, 164},
+                {0xA59BC234DB398C25ULL, 508, 172},
+                {0xF6C69A72A3989F5CULL, 534, 180},
+                {0xB7DCBF5354E9BECEULL, 561, 188},
+                {0x88FCF317F22241E2ULL, 588, 196},
+                {0xCC20CE9BD35C78A5ULL, 614, 204},
+                {0x98165AF37B2153DFULL, 641, 212},
+                {0xE2A0B5DC971F303AULL, 667, 220},
+                {0xA8D9D1535CE3B396ULL, 694, 228},
+                {0xFB9B7CD9A4A7443CULL, 720, 236},
+                {0xBB764C4CA7A44410ULL, 747, 244},
+                {0x8BAB8EEFB6409C1AULL, 774, 252},
+                {0xD01FEF10A657842CULL, 800, 260},
+                {0x9B10A4E5E9913129ULL, 827, 268},
+                {0xE7109BFBA19C0C9DULL, 853, 276},
+                {0xAC2820D9623BF429ULL, 880, 284},
+                {0x80444B5E7AA7CF85ULL, 907, 292},
+                {0xBF21E44003ACDD2DULL, 933, 300},
+                {0x8E679C2F5E44FF8FULL, 960, 308},
+                {0xD433179D9C8CB841ULL, 986, 316},
+                {0x9E19DB92B4E31BA9ULL, 1013, 324},
+                {0xEB96BF6EBADF77D9ULL, 1039, 332},
+                {0xAF87023B9BF0EE6BULL, 1066, 340},
+            };
+
+            return table[index];
         }
 
-        /// @copydoc put_int(uint8_t)
-        Encoder& put_int8(int8_t value, Base base=Base::k10)
+        // floating point types differ only in these parameters
+        template<typename T>
+        struct Traits;
+
+        static DiyFp mul(DiyFp x, DiyFp y)
         {
-            return put_int(value, base);
+            uint64_t u_lo = x.f & 0xffffffffU, u_hi = x.f >> 32;
+            uint64_t v_lo = y.f & 0xffffffffU, v_hi = y.f >> 32;
+
+            uint64_t p0 = u_lo * v_lo;
+            uint64_t p1 = u_lo * v_hi;
+            uint64_t p2 = u_hi * v_lo;
+            uint64_t p3 = u_hi * v_hi;
+
+            // round the discarded half
+            uint64_t q = (p0 >> 32) + (p1 & 0xffffffffU) + (p2 & 0xffffffffU) + (uint64_t(1) << 31);
+
+            return DiyFp{p3 + (p2 >> 32) + (p1 >> 32) + (q >> 32), x.e + y.e + 64};
         }
 
-        /// @copydoc put_int(uint8_t)
-        Encoder& put_int16(int16_t value, Base base=Base::k10)
+        static DiyFp normalize(DiyFp x)
         {
-            return put_int(value, base);
+            while((x.f >> 63) == 0U){
+
+                x.f <<= 1;
+                x.e--;
+            }
+
+            return x;
         }
 
-        /// @copydoc put_int(uint8_t)
-        Encoder& put_int32(int32_t value, Base base=Base::k10)
+        /* Grisu2 (Loitsch, "Printing Floating-Point Numbers Quickly and
+         * Accurately with Integers") following the presentation in
+         * nlohmann/json */
+
+        template<typename T>
+        static void compute_boundaries(T value, DiyFp& w, DiyFp& minus, DiyFp& plus)
         {
-            return put_int(value, base);
+            typedef typename Traits<T>::Bits Bits;
+
+            const int precision = std::numeric_limits<T>::digits;
+            const int bias = std::numeric_limits<T>::max_exponent - 1 + (precision - 1);
+            const uint64_t hidden = uint64_t(1) << (precision - 1);
+
+            Bits bits;
+
+            (void)memcpy(&bits, &value, sizeof(bits));
+
+            uint64_t e = uint64_t(bits) >> (precision - 1);
+            uint64_t f = uint64_t(bits) & (hidden - 1U);
+
+            DiyFp v = (e == 0U) ? DiyFp{f, 1 - bias} : DiyFp{f + hidden, int(e) - bias};
+
+            bool lower_is_closer = (f == 0U) && (e > 1U);
+
+            plus = normalize(DiyFp{(2U * v.f) + 1U, v.e - 1});
+            minus = lower_is_closer ? DiyFp{(4U * v.f) - 1U, v.e - 2} : DiyFp{(2U * v.f) - 1U, v.e - 1};
+            minus.f <<= (minus.e - plus.e);
+            minus.e = plus.e;
+            w = normalize(v);
         }
 
-        /// @copydoc put_int(uint8_t)
-        Encoder& put_int64(int64_t value, Base base=Base::k10)
+        static int largest_pow10(uint32_t n, uint32_t& pow10)
         {
-            return put_int(value, base);
+            static const uint32_t table[] = {
+                1UL, 10UL, 100UL, 1000UL, 10000UL, 100000UL, 1000000UL, 10000000UL, 100000000UL, 1000000000UL
+            };
+
+            int retval = 10;
+
+            while((retval > 1) && (n < table[retval - 1])){
+
+                retval--;
+            }
+
+            pow10 = table[retval - 1];
+
+            return retval;
         }
 
-        /** put a boolean value
-         *
-         * @param[in] value     boolean value
-         *
-         * @return Encoder&
-         *
-         * */
-        Encoder& put_bool(bool value)
+        static void grisu2_round(char *buf, int len, uint64_t dist, uint64_t delta, uint64_t rest, uint64_t ten_k)
         {
-            return put_string(value ? "true" : "false");
+            while((rest < dist) && ((delta - rest) >= ten_k) && (((rest + ten_k) < dist) || ((dist - rest) > (rest + ten_k - dist)))){
+
+                buf[len - 1]--;
+                rest += ten_k;
+            }
         }
 
-        /** put value as hexadecimal string
-         *
-         * @param[in] value     input buffer
-         * @param[in] size      size of input buffer
-         *
-         * @return Encoder&
-         *
-         * */
-        Encoder& put_hex_string(const void *value, size_t size)
+        static void grisu2_digit_gen(char *buf, int& len, int& exp10, DiyFp m_minus, DiyFp w, DiyFp m_plus)
         {
-            auto begin = (const uint8_t *)value;
-            auto end = begin + size;
+            uint64_t delta = m_plus.f - m_minus.f;
+            uint64_t dist = m_plus.f - w.f;
+
+            DiyFp one{uint64_t(1) << -m_plus.e, m_plus.e};
+
+            uint32_t p1 = uint32_t(m_plus.f >> -one.e);
+            uint64_t p2 = m_plus.f & (one.f - 1U);
+
+            uint32_t pow10;
+            int n = largest_pow10(p1, pow10);
+            bool done = false;
+
+            // integral digits
+            while((n > 0) && !done){
 
-            for(auto iter = begin; iter != end; ++iter){
+                uint32_t d = p1 / pow10;
 
-                (void)put_char(nibble_to_hex((*iter) >> 4));
-                (void)put_char(nibble_to_hex(*iter));
+                p1 %= pow10;
+                buf[len++] = char('0' + d);
+                n--;
+
+                uint64_t rest = (uint64_t(p1) << -one.e) + p2;
+
+                if(rest <= delta){
+
+                    exp10 += n;
+                    grisu2_round(buf, len, dist, delta, rest, uint64_t(pow10) << -one.e);
+                    done = true;
+                }
+
+                pow10 /= 10U;
             }
 
-            return *this;
+            // fractional digits
+            if(!done){
+
+                int m = 0;
+
+                do{
+
+                    p2 *= 10U;
+                    buf[len++] = char('0' + (p2 >> -one.e));
+                    p2 &= (one.f - 1U);
+                    m++;
+                    delta *= 10U;
+                    dist *= 10U;
+                }
+                while(p2 > delta);
+
+                exp10 -= m;
+                grisu2_round(buf, len, dist, delta, p2, one.f);
+            }
         }
 
-        /** put value as hexadecimal string
-         *
-         * @param[in] value     null terminated input buffer
-         *
-         * @return Encoder&
-         *
-         * */
-        Encoder& put_hex_string(const char *value)
+        // shortest digits and exponent such that value == digits * 10^exp10 (value > 0)
+        template<typename T>
+        static void grisu2(char *buf, int& len, int& exp10, T value)
         {
-            return put_hex_string(value, strlen(value));
+            const int alpha = -60;
+
+            DiyFp w, minus, plus;
+
+            compute_boundaries<T>(value, w, minus, plus);
+
+            // cached power c such that the product exponent is in [alpha, gamma]
+            int f = alpha - plus.e - 1;
+            int k = ((f * 78913) / (1 << 18)) + ((f > 0) ? 1 : 0);
+            size_t index = size_t(-cached_powers_min_dec_exp + k + (cached_powers_dec_step - 1)) / size_t(cached_powers_dec_step);
+
+            const CachedPower& cached = cached_power(index);
+            DiyFp c{cached.f, cached.e};
+
+            DiyFp w_minus = mul(minus, c);
+            DiyFp w_plus = mul(plus, c);
+
+            len = 0;
+            exp10 = -cached.k;
+
+            grisu2_digit_gen(buf, len, exp10, DiyFp{w_minus.f + 1U, w_minus.e}, mul(w, c), DiyFp{w_plus.f - 1U, w_plus.e});
         }
 
-        /** put value as hexadecimal string
-         *
-         * @param[in] value     input view
-         *
-         * @return Encoder&
-         *
-         * */
-        Encoder& put_hex_string(const StringView& value)
+        template<typename T>
+        static char *put_shortest(char *first, char *last, T value)
         {
-            return put_hex_string(value.data(), value.size());
+            char buf[max_chars];
+            char *p = buf;
+
+            if(std::signbit(value) && !std::isnan(value)){
+
+                *p = '-';
+                p++;
+                value = -value;
+            }
+
+            if(std::isnan(value)){
+
+                (void)memcpy(p, "nan", 3);
+                p += 3;
+            }
+            else if(std::isinf(value)){
+
+                (void)memcpy(p, "inf", 3);
+                p += 3;
+            }
+            else if(value == T(0)){
+
+                *p = '0';
+                p++;
+            }
+            else{
+
+                int len, exp10;
+
+                grisu2<T>(p, len, exp10, value);
+
+                p = format_digits(p, len, exp10);
+            }
+
+            char *retval = nullptr;
+            size_t n = size_t(p - buf);
+
+            if((last - first) >= ptrdiff_t(n)){
+
+                (void)memcpy(first, buf, n);
+                retval = first + n;
+            }
+
+            return retval;
         }
 
-        /** put value as base64 string
-         *
-         * @param[in] value     input buffer
-         * @param[in] size      size of input buffer
-         *
-         * @return Encoder&
-         *
-         * */
-        Encoder& put_b64_string(const void *value, size_t size)
+        // lay out digits * 10^exp10 in place and return the end
+        static char *format_digits(char *buf, int k, int exp10)
         {
-            auto begin = (const uint8_t *)value;
-            auto end = begin + size;
+            const int min_exp = -4;
+            const int max_exp = 15;
 
-            for(auto iter = begin; iter != end;){
+            // position of the decimal point relative to buf
+            int n = k + exp10;
 
-                switch(std::distance(iter, end)){
-                default:
+            char *retval;
 
-                    (void)put_char(byte_to_b64(iter[0] >> 2));
-                    (void)put_char(byte_to_b64((iter[1] >> 4) | (iter[0] << 4)));
-                    (void)put_char(byte_to_b64((iter[2] >> 6) | (iter[1] << 2)));
-                    (void)put_char(byte_to_b64(iter[2]));
+            if((k <= n) && (n <= max_exp)){
 
-                    ++iter;
-                    ++iter;
-                    ++iter;
-                    break;
+                // digits000
+                (void)memset(buf + k, '0', size_t(n - k));
+                retval = buf + n;
+            }
+            else if((0 < n) && (n <= max_exp)){
 
-                case 1:
+                // dig.its
+                (void)memmove(buf + n + 1, buf + n, size_t(k - n));
+                buf[n] = '.';
+                retval = buf + k + 1;
+            }
+            else if((min_exp < n) && (n <= 0)){
+
+                // 0.000digits
+                (void)memmove(buf + 2 + (-n), buf, size_t(k));
+                buf[0] = '0';
+                buf[1] = '.';
+                (void)memset(buf + 2, '0', size_t(-n));
+                retval = buf + 2 + (-n) + k;
+            }
+            else{
 
-                    (void)put_char(byte_to_b64(iter[0] >> 2));
-                    (void)put_char(byte_to_b64(iter[0] << 4));
-                    (void)put_char('=');
-                    (void)put_char('=');
+                // d.igitse-7
+                if(k > 1){
 
-                    ++iter;
-                    break;
+                    (void)memmove(buf + 2, buf + 1, size_t(k - 1));
+                    buf[1] = '.';
+                    retval = buf + k + 1;
+                }
+                else{
+
+                    retval = buf + 1;
+                }
 
-                case 2:
+                int e = n - 1;
 
-                    (void)put_char(byte_to_b64(iter[0] >> 2));
-                    (void)put_char(byte_to_b64((iter[1] >> 4) | (iter[0] << 4)));
-                    (void)put_char(byte_to_b64(iter[1] << 2));
-                    (void)put_char('=');
+                *retval = 'e';
+                retval++;
 
-                    ++iter;
-                    ++iter;
-                    break;
+                if(e < 0){
+
+                    *retval = '-';
+                    retval++;
+                    e = -e;
+                }
+
+                if(e >= 100){
+
+                    *retval = char('0' + (e / 100));
+                    retval++;
+                    e %= 100;
+                    *retval = char('0' + (e / 10));
+                    retval++;
+                }
+                else if(e >= 10){
+
+                    *retval = char('0' + (e / 10));
+                    retval++;
                 }
+
+                *retval = char('0' + (e % 10));
+                retval++;
             }
 
-            return *this;
+            return retval;
         }
 
-        /** put value as base64 string
-         *
-         * @param[in] value     null terminated input buffer
-         *
-         * @return Encoder&
-         *
-         * */
-        Encoder& put_b64_string(const char *value)
-        {
-            return put_b64_string(value, strlen(value));
-        }
+        /* Parsing */
 
-        /** put value as base64 string
-         *
-         * @param[in] value     input view
-         *
-         * @return Encoder&
-         *
-         * */
-        Encoder& put_b64_string(const StringView& value)
-        {
-            return put_b64_string(value.data(), value.size());
-        }
+        // fixed size unsigned integer, enough for the exact comparisons made by nearest()
+        class BigInt {
+        public:
 
-    protected:
+            static const size_t words = 40;
 
-        template<typename T>
-        Encoder& uint_to_s(T value, Base base)
-        {
-            T v = value;
+            BigInt(uint64_t value)
+                :
+                size(0)
+            {
+                while(value > 0U){
 
-            // at most 20 digits for 64bit
-            std::array<char,20> buf;
+                    word[size] = uint32_t(value);
+                    size++;
+                    value >>= 32;
+                }
+            }
 
-            auto iter = buf.rbegin();
+            void mul(uint32_t m)
+            {
+                uint64_t carry = 0;
 
-            switch(base){
-            default:
-            case Base::k10:
+                for(size_t i = 0; i < size; i++){
 
-                do{
+                    uint64_t p = (uint64_t(word[i]) * m) + carry;
 
-                    *iter = '0' + char(v % T(10));
-                    ++iter;
-                    v /= T(10);
+                    word[i] = uint32_t(p);
+                    carry = p >> 32;
                 }
-                while((v > 0) && (iter != buf.rend()));
 
-                break;
+                if((carry > 0U) && (size < words)){
 
-            case Base::k16:
+                    word[size] = uint32_t(carry);
+                    size++;
+                }
+            }
 
-                do{
+            void mul_pow10(int n)
+            {
+                for(; n >= 9; n -= 9){
 
-                    *iter = nibble_to_hex(uint8_t(v));
-                    v >>= 4;
-                    ++iter;
+                    mul(1000000000UL);
                 }
-                while((v > 0) && (iter != buf.rend()));
 
-                (void)put_string("0x");
+                static const uint32_t pow10[] = {1UL, 10UL, 100UL, 1000UL, 10000UL, 100000UL, 1000000UL, 10000000UL, 100000000UL};
 
-                break;
+                mul(pow10[n]);
             }
 
-            auto num_digits = iter - buf.rbegin();
+            void shl(int n)
+            {
+                if((size > 0U) && (n > 0)){
 
-            (void)s.write(&(iter[-1]), num_digits);
+                    size_t w = size_t(n) / 32U;
+                    int b = n % 32;
 
-            return *this;
-        }
+                    size_t top = (size + w < words) ? (size + w) : (words - 1U);
 
-        static char nibble_to_hex(uint8_t value)
-        {
-            static const char table[] = {
-                '0',
-                '1',
-                '2',
-                '3',
-                '4',
-                '5',
-                '6',
-                '7',
-                '8',
-                '9',
-                'a',
-                'b',
-                'c',
-                'd',
-                'e',
-                'f'
-            };
+                    word[top] = 0;
 
-            return table[value & 0xf];
-        }
+                    for(size_t i = top; i > w; i--){
 
-        static char byte_to_b64(uint8_t value)
-        {
-            static const char table[] = {
-                'A',
-                'B',
-                'C',
-                'D',
-                'E',
-                'F',
-                'G',
-                'H',
-                'I',
-                'J',
-                'K',
-                'L',
-                'M',
-                'N',
-                'O',
-                'P',
-                'Q',
-                'R',
-                'S',
-                'T',
-                'U',
-                'V',
-                'W',
-                'X',
-                'Y',
-                'Z',
-                'a',
-                'b',
-                'c',
-                'd',
-                'e',
-                'f',
-                'g',
-                'h',
-                'i',
-                'j',
-                'k',
-                'l',
-                'm',
-                'n',
-                'o',
-                'p',
-                'q',
-                'r',
-                's',
-                't',
-                'u',
-                'v',
-                'w',
-                'x',
-                'y',
-                'z',
-                '0',
-                '1',
-                '2',
-                '3',
-                '4',
-                '5',
-                '6',
-                '7',
-                '8',
-                '9',
-                '+',
-                '/'
-            };
+                        uint64_t v = (uint64_t(word[i - w - 1U]) << b);
 
-            return table[value & 0x3f];
-        }
-    };
-};
+                        word[i] |= uint32_t(v >> 32);
+                        word[i - 1U] = uint32_t(v);
+                    }
 
-#endif
-/* #include "bramble_decoder.hpp" */
-/* Copyright (c) 2024 Cameron Harper
- *
- * Permission is hereby granted, free of charge, to any person obtaining a copy
- * of this software and associated documentation files (the "Software"), to deal
- * in the Software without restriction, including without limitation the rights
- * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
- * copies of the Software, and to permit persons to whom the Software is
- * furnished to do so, subject to the following conditions:
- *
- * The above copyright notice and this permission notice shall be included in all
- * copies or substantial portions of the Software.
- *
- * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
- * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
- * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
- * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
- * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
- * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
- * SOFTWARE.
- *
- */
+                    for(size_t i = 0; i < w; i++){
 
-#ifndef BRAMBLE_DECODER_H_INCLUDED
-#define BRAMBLE_DECODER_H_INCLUDED
+                        word[i] = 0;
+                    }
 
-/* #include "bramble_string_view.hpp" first included at line 231 */
-/* #include "bramble_buffer_stream.hpp" first included at line 824 */
+                    size = top + ((word[top] != 0U) ? 1U : 0U);
+                }
+            }
 
-#include <cctype>
+            int compare(const BigInt& other) const
+            {
+                int retval = 0;
 
-namespace Bramble {
+                if(size != other.size){
 
-    /** A tool for pulling values out of strings
-     *
-     * */
-    class Decoder {
-    public:
+                    retval = (size < other.size) ? -1 : 1;
+                }
+                else{
 
-        Decoder()
+                    for(size_t i = size; (i > 0U) && (retval == 0); i--){
+
+                        if(word[i - 1U] != other.word[i - 1U]){
+
+                            retval = (word[i - 1U] < other.word[i - 1U]) ? -1 : 1;
+                        }
+                    }
+                }
+
+                return retval;
+            }
+
+        private:
+
+            uint32_t word[words];
+            size_t size;
+        };
+
+        // round w * 10^exp10 to the nearest T, exact says w holds every significant digit
+        template<typename T>
+        static bool nearest(uint64_t w, int exp10, bool exact, T& value)
         {
+            typedef Traits<T> Tr;
+
+            static const double pow10[] = {
+                1e0, 1e1, 1e2, 1e3, 1e4, 1e5, 1e6, 1e7, 1e8, 1e9, 1e10, 1e11,
+                1e12, 1e13, 1e14, 1e15, 1e16, 1e17, 1e18, 1e19, 1e20, 1e21, 1e22
+            };
+
+            bool retval = true;
+
+            if(w == 0U){
+
+                value = T(0);
+            }
+            // exact operands give a correctly rounded result (Clinger)
+            else if(exact && (w <= (uint64_t(1) << Tr::mantissa)) && (exp10 >= -Tr::max_pow10) && (exp10 <= Tr::max_pow10)){
+
+                T x = T(w);
+
+                value = (exp10 < 0) ? T(x / T(pow10[-exp10])) : T(x * T(pow10[exp10]));
+            }
+            // too small even for 2^64 * 10^exp10 to reach half the smallest subnormal
+            else if(exp10 < (cached_powers_min_dec_exp + 5)){
+
+                value = T(0);
+            }
+            else if(exp10 > 308){
+
+                retval = false;
+            }
+            else{
+
+                // approximate w * 10^exp10 to within a few units of 64 bits
+                size_t index = size_t(exp10 - cached_powers_min_dec_exp) / size_t(cached_powers_dec_step);
+                int r = exp10 - (cached_powers_min_dec_exp + (int(index) * cached_powers_dec_step));
+
+                const CachedPower& cached = cached_power(index);
+
+                DiyFp x = mul(normalize(DiyFp{w, 0}), DiyFp{cached.f, cached.e});
+
+                if(r > 0){
+
+                    static const uint64_t small[] = {1ULL, 10ULL, 100ULL, 1000ULL, 10000ULL, 100000ULL, 1000000ULL, 10000000ULL};
+
+                    x = mul(normalize(x), normalize(DiyFp{small[r], 0}));
+                }
+
+                x = normalize(x);
+
+                // exponent of the unit in the last place of the result
+                int q = x.e + 64 - Tr::mantissa;
+
+                if(q < Tr::min_q){
+
+                    q = Tr::min_q;
+                }
+
+                int shift = q - x.e;
+                uint64_t m;
+                bool up;
+
+                if(shift > 64){
+
+                    m = 0;
+                    up = false;
+                }
+                else{
+
+                    uint64_t rem, half;
+
+                    if(shift == 64){
+
+                        m = 0;
+                        rem = x.f;
+                        half = uint64_t(1) << 63;
+                    }
+                    else{
+
+                        m = x.f >> shift;
+                        rem = x.f & ((uint64_t(1) << shift) - 1U);
+                        half = uint64_t(1) << (shift - 1);
+                    }
+
+                    uint64_t margin = exact ? 8U : 0U;
+
+                    if(((rem + margin) < half) || (rem > (half + margin))){
+
+                        up = (rem > half);
+                    }
+                    else{
+
+                        // too close to the midpoint to tell, compare exactly with (2m + 1) * 2^(q - 1)
+                        BigInt d(w);
+                        BigInt mid((2U * m) + 1U);
+
+                        if(exp10 >= 0){
+
+                            d.mul_pow10(exp10);
+                        }
+                        else{
+
+                            mid.mul_pow10(-exp10);
+                        }
+
+                        if((q - 1) >= 0){
+
+                            mid.shl(q - 1);
+                        }
+                        else{
+
+                            d.shl(1 - q);
+                        }
+
+                        int c = d.compare(mid);
+
+                        up = (c > 0) || ((c == 0) && ((m & 1U) != 0U));
+                    }
+                }
+
+                if(up){
+
+                    m++;
+                }
+
+                value = std::ldexp(T(m), q);
+
+                retval = !std::isinf(value);
+            }
+
+            return retval;
         }
 
-        /** decode a null-terminated string
-         *
-         * @param[in] s     null-terminated string
-         *
-         * */
-        Decoder(const char *s)
-            :
-            input(s, strlen(s))
+        template<typename T>
+        static const char *get_nearest(const char *first, const char *last, T& value)
         {
-        }
+            const char *retval = nullptr;
+            const char *p = first;
+            bool negative = false;
+
+            if((p != last) && ((*p == '-') || (*p == '+'))){
+
+                negative = (*p == '-');
+                p++;
+            }
+
+            if(((last - p) >= 3) && ((p[0] | 0x20) == 'i') && ((p[1] | 0x20) == 'n') && ((p[2] | 0x20) == 'f')){
+
+                value = negative ? -std::numeric_limits<T>::infinity() : std::numeric_limits<T>::infinity();
+                retval = p + 3;
+            }
+            else if(((last - p) >= 3) && ((p[0] | 0x20) == 'n') && ((p[1] | 0x20) == 'a') && ((p[2] | 0x20) == 'n')){
+
+                value = std::numeric_limits<T>::quiet_NaN();
+                retval = p + 3;
+            }
+            else{
+
+                uint64_t w = 0;
+                int digits = 0;
+                int dropped = 0;
+                int exp10 = 0;
+                bool exact = true;
+                bool any = false;
+
+                // leading zeros are insignificant
+                for(; (p != last) && (*p == '0'); p++){
+
+                    any = true;
+                }
+
+                for(; (p != last) && (*p >= '0') && (*p <= '9'); p++){
+
+                    any = true;
+
+                    if(digits < 19){
+
+                        w = (w * 10U) + uint64_t(*p - '0');
+                        digits++;
+                    }
+                    else{
+
+                        exact = exact && (*p == '0');
+                        dropped++;
+                    }
+                }
+
+                if((p != last) && (*p == '.')){
+
+                    p++;
+
+                    if(digits == 0){
+
+                        for(; (p != last) && (*p == '0'); p++){
+
+                            any = true;
+                            exp10--;
+                        }
+                    }
+
+                    for(; (p != last) && (*p >= '0') && (*p <= '9'); p++){
+
+                        any = true;
+
+                        if(digits < 19){
+
+                            w = (w * 10U) + uint64_t(*p - '0');
+                            digits++;
+                            exp10--;
+                        }
+                        else{
+
+                            exact = exact && (*p == '0');
+                        }
+                    }
+                }
+
+                exp10 += dropped;
+
+                if(any){
+
+                    const char *mark = p;
+
+                    if((p != last) && ((*p | 0x20) == 'e')){
+
+                        p++;
+
+                        bool exp_negative = false;
+                        int e = 0;
+
+                        if((p != last) && ((*p == '-') || (*p == '+'))){
+
+                            exp_negative = (*p == '-');
+                            p++;
+                        }
+
+                        if((p != last) && (*p >= '0') && (*p <= '9')){
+
+                            for(; (p != last) && (*p >= '0') && (*p <= '9'); p++){
+
+                                // saturate, anything this large is zero or out of range
+                                if(e < 100000){
+
+                                    e = (e * 10) + (*p - '0');
+                                }
+                            }
+
+                            exp10 += exp_negative ? -e : e;
+                        }
+                        else{
+
+                            // not an exponent
+                            p = mark;
+                        }
+                    }
+
+                    T v;
+
+                    if(nearest<T>(w, exp10, exact, v)){
+
+                        value = negative ? -v : v;
+                        retval = p;
+                    }
+                }
+            }
+
+            return retval;
+        }
+    };
+
+    /// @private
+    template<>
+    struct FloatFormat::Traits<double> {
+
+        typedef uint64_t Bits;
+
+        static const int mantissa = 53;         // significand bits
+        static const int min_q = -1074;         // exponent of the smallest subnormal
+        static const int max_pow10 = 22;        // largest exactly representable power of ten
+    };
+
+    /// @private
+    template<>
+    struct FloatFormat::Traits<float> {
+
+        typedef uint32_t Bits;
+
+        static const int mantissa = 24;
+        static const int min_q = -149;
+        static const int max_pow10 = 10;
+    };
+};
+
+#endif
+
+#include <cstdint>
+#include <cstring>
+#include <cstddef>
+#include <array>
+#include <algorithm>
+
+namespace Bramble {
+
+    /** Encoder is intended to be used to add arguments to a Request or an ACK response.
+     *
+     * Encoder instances write to Stream and representations are optimised for Bramble protocol.
+     *
+     * */
+    class Encoder {
+    public:
+
+        /** integer base */
+        enum class Base {
+
+            k10,    ///< decimal
+            k16     ///< hexadecimal
+        };
+
+        /** letter case of hexadecimal digits */
+        enum class Case {
+
+            kLower,     ///< a-f
+            kUpper      ///< A-F
+        };
+
+        /** Create an Encoder
+         *
+         * @param[in] s output stream
+         *
+         * */
+        Encoder(Stream& s)
+            :
+            s(s)
+        {}
+
+        virtual ~Encoder()
+        {}
+
+        /** the output stream */
+        Stream& s;
+
+        /** put a deliminter character (a single whitespace)
+         *
+         * Delimiters separate tokens in Bramble protocol.
+         *
+         * @return Encoder&
+         *
+         * */
+        Encoder& put_space()
+        {
+            return put_char(' ');
+        }
+
+        /// @copydoc put_space()
+        Encoder& space()
+        {
+            return put_space();
+        }
+
+        /** put visible string
+         *
+         * @param[in] value     input buffer
+         * @param[in] size      size of input buffer
+         *
+         * @return Encoder&
+         *
+         * */
+        Encoder& put_string(const char *value, size_t size)
+        {
+            (void)s.write(value, size);
+            return *this;
+        }
+
+        /** put null terminated visible string
+         *
+         * @param[in] value     input buffer
+         *
+         * @return Encoder&
+         *
+         * */
+        Encoder& put_string(const char *value)
+        {
+            (void)s.write(value, strlen(value));
+            return *this;
+        }
+
+        /** put a string view
+         *
+         * @param[in] value     input view
+         *
+         * @return Encoder&
+         *
+         * */
+        Encoder& put_string(const StringView& value)
+        {
+            (void)s.write(value.data(), value.size());
+            return *this;
+        }
+
+        /** put a single character
+         *
+         * @param[in] value     single character
+         *
+         * @return Encoder&
+         *
+         * */
+        Encoder& put_char(char value)
+        {
+            (void)s.write(&value, sizeof(value));
+            return *this;
+        }
+
+        /** put an integer
+         *
+         * @param[in] value     integer
+         *
+         * @return Encoder&
+         *
+         * */
+        Encoder& put_int(uint8_t value, Base base=Base::k10)
+        {
+            return put_int(uint32_t(value), base);
+        }
+
+        /// @copydoc put_int(uint8_t)
+        Encoder& put_int(uint16_t value, Base base=Base::k10)
+        {
+            return put_int(uint32_t(value), base);
+        }
+
+        /// @copydoc put_int(uint8_t)
+        Encoder& put_int(uint32_t value, Base base=Base::k10)
+        {
+            return uint_to_s<uint32_t>(value, base);
+        }
+
+        /// @copydoc put_int(uint8_t)
+        Encoder& put_int(uint64_t value, Base base=Base::k10)
+        {
+            return uint_to_s<uint64_t>(value, base);
+        }
+
+        /// @copydoc put_int(uint8_t)
+        Encoder& put_int(int8_t value, Base base=Base::k10)
+        {
+            return put_int(int32_t(value), base);
+        }
+
+        /// @copydoc put_int(uint8_t)
+        Encoder& put_int(int16_t value, Base base=Base::k10)
+        {
+            return put_int(int32_t(value), base);
+        }
+
+        /// @copydoc put_int(uint8_t)
+        Encoder& put_int(int32_t value, Base base=Base::k10)
+        {
+            return int_to_s<int32_t, uint32_t>(value, base);
+        }
+
+        /// @copydoc put_int(uint8_t)
+        Encoder& put_int(int64_t value, Base base=Base::k10)
+        {
+            return int_to_s<int64_t, uint64_t>(value, base);
+        }
+
+        /** put an unsigned integer
+         *
+         * @param[in] value     unsigned integer
+         *
+         * @return Encoder&
+         *
+         * */
+        Encoder& put_unsigned(uint8_t value, Base base=Base::k10)
+        {
+            return put_int(value, base);
+        }
+
+        /// @copydoc put_unsigned(uint8_t)
+        Encoder& put_unsigned(uint16_t value, Base base=Base::k10)
+        {
+            return put_int(value, base);
+        }
+
+        /// @copydoc put_unsigned(uint8_t)
+        Encoder& put_unsigned(uint32_t value, Base base=Base::k10)
+        {
+            return put_int(value, base);
+        }
+
+        /// @copydoc put_unsigned(uint8_t)
+        Encoder& put_unsigned(uint64_t value, Base base=Base::k10)
+        {
+            return put_int(value, base);
+        }
+
+        /// @copydoc put_unsigned(uint8_t)
+        Encoder& put_uint8(uint8_t value, Base base=Base::k10)
+        {
+            return put_int(value, base);
+        }
+
+        /// @copydoc put_unsigned(uint8_t)
+        Encoder& put_uint16(uint16_t value, Base base=Base::k10)
+        {
+            return put_int(value, base);
+        }
+
+        /// @copydoc put_unsigned(uint8_t)
+        Encoder& put_uint32(uint32_t value, Base base=Base::k10)
+        {
+            return put_int(value, base);
+        }
+
+        /// @copydoc put_unsigned(uint8_t)
+        Encoder& put_uint64(uint64_t value, Base base=Base::k10)
+        {
+            return put_int(value, base);
+        }
+
+        /// @copydoc put_int(uint8_t)
+        Encoder& put_int8(int8_t value, Base base=Base::k10)
+        {
+            return put_int(value, base);
+        }
+
+        /// @copydoc put_int(uint8_t)
+        Encoder& put_int16(int16_t value, Base base=Base::k10)
+        {
+            return put_int(value, base);
+        }
+
+        /// @copydoc put_int(uint8_t)
+        Encoder& put_int32(int32_t value, Base base=Base::k10)
+        {
+            return put_int(value, base);
+        }
+
+        /// @copydoc put_int(uint8_t)
+        Encoder& put_int64(int64_t value, Base base=Base::k10)
+        {
+            return put_int(value, base);
+        }
+
+        /** put a floating point value
+         *
+         * The shortest representation that reads back as the same value is
+         * put, e.g. "868.1", "1e-7", "nan", "inf" or "-inf".
+         *
+         * @param[in] value     floating point value
+         *
+         * @return Encoder&
+         *
+         * */
+        Encoder& put_double(double value)
+        {
+            char buf[FloatFormat::max_chars];
+
+            (void)s.write(buf, size_t(FloatFormat::to_chars(buf, buf + sizeof(buf), value) - buf));
+
+            return *this;
+        }
+
+        /// @copydoc put_double(double)
+        Encoder& put_float(float value)
+        {
+            char buf[FloatFormat::max_chars];
+
+            (void)s.write(buf, size_t(FloatFormat::to_chars(buf, buf + sizeof(buf), value) - buf));
+
+            return *this;
+        }
+
+        /** put a fixed point decimal value
+         *
+         * e.g. put_fixed(868100, 3) puts "868.100"
+         *
+         * @param[in] value     value scaled by 10^decimals
+         * @param[in] decimals  number of digits after the decimal point (at most 18)
+         *
+         * @return Encoder&
+         *
+         * */
+        Encoder& put_fixed(int64_t value, unsigned decimals)
+        {
+            // sign, 19 integer digits, point and 18 decimals
+            char buf[40];
+            char *p = buf;
+
+            uint64_t scale = 1U;
+            uint64_t mag = (value < 0) ? (uint64_t(0) - uint64_t(value)) : uint64_t(value);
+
+            decimals = (decimals > 18U) ? 18U : decimals;
+
+            for(unsigned i = 0; i < decimals; i++){
+
+                scale *= 10U;
+            }
+
+            if(value < 0){
+
+                *p = '-';
+                p++;
+            }
+
+            p = IntegerFormat::to_chars(p, buf + sizeof(buf), uint64_t(mag / scale));
+
+            if(decimals > 0U){
+
+                char digits[IntegerFormat::max_chars];
+                uint64_t frac = mag % scale;
+                size_t n = size_t(IntegerFormat::to_chars(digits, digits + sizeof(digits), frac) - digits);
+
+                *p = '.';
+                p++;
+
+                (void)memset(p, '0', decimals - n);
+                p += decimals - n;
+
+                (void)memcpy(p, digits, n);
+                p += n;
+            }
+
+            (void)s.write(buf, size_t(p - buf));
+
+            return *this;
+        }
+
+        /** put a boolean value
+         *
+         * @param[in] value     boolean value
+         *
+         * @return Encoder&
+         *
+         * */
+        Encoder& put_bool(bool value)
+        {
+            return put_string(value ? "true" : "false");
+        }
+
+        /** put value as hexadecimal string
+         *
+         * @param[in] value     input buffer
+         * @param[in] size      size of input buffer
+         *
+         * @return Encoder&
+         *
+         * */
+        Encoder& put_hex_string(const void *value, size_t size)
+        {
+            return bytes_to_hex(static_cast<const uint8_t *>(value), size, 0, ' ', Case::kLower);
+        }
+
+        /** put value as hexadecimal string
+         *
+         * @param[in] value     input buffer
+         * @param[in] size      size of input buffer
+         * @param[in] letters   letter case of digits
+         *
+         * @return Encoder&
+         *
+         * */
+        Encoder& put_hex_string(const void *value, size_t size, Case letters)
+        {
+            return bytes_to_hex(static_cast<const uint8_t *>(value), size, 0, ' ', letters);
+        }
+
+        /** put value as groups of hexadecimal digits
+         *
+         * e.g. group=4 gives "00112233 44556677 8899"
+         *
+         * @note with the default separator each group is a separate token
+         *
+         * @param[in] value     input buffer
+         * @param[in] size      size of input buffer
+         * @param[in] group     bytes per group (0 for no grouping)
+         * @param[in] separator character put between groups
+         * @param[in] letters   letter case of digits
+         *
+         * @return Encoder&
+         *
+         * */
+        Encoder& put_hex_dump(const void *value, size_t size, size_t group, char separator = ' ', Case letters = Case::kLower)
+        {
+            return bytes_to_hex(static_cast<const uint8_t *>(value), size, group, separator, letters);
+        }
+
+        /** put value as hexadecimal string
+         *
+         * @param[in] value     null terminated input buffer
+         *
+         * @return Encoder&
+         *
+         * */
+        Encoder& put_hex_string(const char *value)
+        {
+            return put_hex_string(value, strlen(value));
+        }
+
+        /** put value as hexadecimal string
+         *
+         * @param[in] value     input view
+         *
+         * @return Encoder&
+         *
+         * */
+        Encoder& put_hex_string(const StringView& value)
+        {
+            return put_hex_string(value.data(), value.size());
+        }
+
+        /** put value as base64 string
+         *
+         * @param[in] value     input buffer
+         * @param[in] size      size of input buffer
+         *
+         * @return Encoder&
+         *
+         * */
+        Encoder& put_b64_string(const void *value, size_t size)
+        {
+            auto in = static_cast<const uint8_t *>(value);
+            char chunk[128];
+            size_t pos = 0;
+
+            // three input bytes become four characters, written to the stream a chunk at a time
+            for(; size >= 3U; in += 3U, size -= 3U){
+
+                uint32_t v = (uint32_t(in[0]) << 16) | (uint32_t(in[1]) << 8) | uint32_t(in[2]);
+
+                chunk[pos] = byte_to_b64(uint8_t(v >> 18));
+                chunk[pos+1] = byte_to_b64(uint8_t(v >> 12));
+                chunk[pos+2] = byte_to_b64(uint8_t(v >> 6));
+                chunk[pos+3] = byte_to_b64(uint8_t(v));
+
+                pos += 4U;
+
+                if(pos == sizeof(chunk)){
+
+                    (void)s.write(chunk, pos);
+                    pos = 0;
+                }
+            }
+
+            switch(size){
+            default:
+            case 0:
+                break;
+
+            case 1:
+
+                chunk[pos] = byte_to_b64(in[0] >> 2);
+                chunk[pos+1] = byte_to_b64(uint8_t(in[0] << 4));
+                chunk[pos+2] = '=';
+                chunk[pos+3] = '=';
+                pos += 4U;
+                break;
+
+            case 2:
+
+                chunk[pos] = byte_to_b64(in[0] >> 2);
+                chunk[pos+1] = byte_to_b64(uint8_t((in[1] >> 4) | (in[0] << 4)));
+                chunk[pos+2] = byte_to_b64(uint8_t(in[1] << 2));
+                chunk[pos+3] = '=';
+                pos += 4U;
+                break;
+            }
+
+            if(pos > 0U){
+
+                (void)s.write(chunk, pos);
+            }
+
+            return *this;
+        }
+
+        /** put value as base64 string
+         *
+         * @param[in] value     null terminated input buffer
+         *
+         * @return Encoder&
+         *
+         * */
+        Encoder& put_b64_string(const char *value)
+        {
+            return put_b64_string(value, strlen(value));
+        }
+
+        /** put value as base64 string
+         *
+         * @param[in] value     input view
+         *
+         * @return Encoder&
+         *
+         * */
+        Encoder& put_b64_string(const StringView& value)
+        {
+            return put_b64_string(value.data(), value.size());
+        }
+
+    protected:
+
+        Encoder& bytes_to_hex(const uint8_t *in, size_t size, size_t group, char separator, Case letters)
+        {
+            const char *table = (letters == Case::kUpper) ? hex_pairs_upper() : hex_pairs_lower();
+            char chunk[128];
+            size_t pos = 0;
+            size_t run = (group > 0U) ? group : size;
+
+            // expand into a local chunk two digits at a time, writing to the stream when the chunk is full
+            for(size_t i = 0; i < size;){
+
+                size_t n = std::min(std::min(run, size - i), (sizeof(chunk) - pos) / 2U);
+
+                for(size_t k = 0; k < n; k++){
+
+                    chunk[pos] = table[in[i + k] * 2U];
+                    chunk[pos+1] = table[(in[i + k] * 2U) + 1U];
+                    pos += 2U;
+                }
+
+                i += n;
+                run -= n;
+
+                if((run == 0U) && (i < size)){
+
+                    if(pos == sizeof(chunk)){
+
+                        (void)s.write(chunk, pos);
+                        pos = 0;
+                    }
+
+                    chunk[pos] = separator;
+                    pos++;
+                    run = group;
+                }
+
+                if((sizeof(chunk) - pos) < 2U){
+
+                    (void)s.write(chunk, pos);
+                    pos = 0;
+                }
+            }
+
+            if(pos > 0U){
+
+                (void)s.write(chunk, pos);
+            }
+
+            return *this;
+        }
+
+        template<typename T>
+        Encoder& uint_to_s(T value, Base base)
+        {
+            // "0x" and at most 16 digits, or at most 20 digits
+            char buf[IntegerFormat::max_chars];
+            char *end;
+
+            switch(base){
+            default:
+            case Base::k10:
+
+                end = IntegerFormat::to_chars(buf, buf + sizeof(buf), value);
+                break;
+
+            case Base::k16:
+
+                buf[0] = '0';
+                buf[1] = 'x';
+                end = IntegerFormat::to_hex_chars(&buf[2], buf + sizeof(buf), value);
+                break;
+            }
+
+            (void)s.write(buf, size_t(end - buf));
+
+            return *this;
+        }
+
+        template<typename T, typename TU>
+        Encoder& int_to_s(T value, Base base)
+        {
+            if(base == Base::k10){
+
+                char buf[IntegerFormat::max_chars];
+
+                (void)s.write(buf, size_t(IntegerFormat::to_chars(buf, buf + sizeof(buf), value) - buf));
+            }
+            else{
+
+                // two's complement
+                (void)uint_to_s<TU>(TU(value), base);
+            }
+
+            return *this;
+        }
+
+        // two digit representation of each byte value
+        static const char *hex_pairs_lower()
+        {
+            static const char table[] =
+                "000102030405060708090a0b0c0d0e0f"
+                "101112131415161718191a1b1c1d1e1f"
+                "202122232425262728292a2b2c2d2e2f"
+                "303132333435363738393a3b3c3d3e3f"
+                "404142434445464748494a4b4c4d4e4f"
+                "505152535455565758595a5b5c5d5e5f"
+                "606162636465666768696a6b6c6d6e6f"
+                "707172737475767778797a7b7c7d7e7f"
+                "808182838485868788898a8b8c8d8e8f"
+                "909192939495969798999a9b9c9d9e9f"
+                "a0a1a2a3a4a5a6a7a8a9aaabacadaeaf"
+                "b0b1b2b3b4b5b6b7b8b9babbbcbdbebf"
+                "c0c1c2c3c4c5c6c7c8c9cacbcccdcecf"
+                "d0d1d2d3d4d5d6d7d8d9dadbdcdddedf"
+                "e0e1e2e3e4e5e6e7e8e9eaebecedeeef"
+                "f0f1f2f3f4f5f6f7f8f9fafbfcfdfeff";
+
+            return table;
+        }
+
+        static const char *hex_pairs_upper()
+        {
+            static const char table[] =
+                "000102030405060708090A0B0C0D0E0F"
+                "101112131415161718191A1B1C1D1E1F"
+                "202122232425262728292A2B2C2D2E2F"
+                "303132333435363738393A3B3C3D3E3F"
+                "404142434445464748494A4B4C4D4E4F"
+                "505152535455565758595A5B5C5D5E5F"
+                "606162636465666768696A6B6C6D6E6F"
+                "707172737475767778797A7B7C7D7E7F"
+                "808182838485868788898A8B8C8D8E8F"
+                "909192939495969798999A9B9C9D9E9F"
+                "A0A1A2A3A4A5A6A7A8A9AAABACADAEAF"
+                "B0B1B2B3B4B5B6B7B8B9BABBBCBDBEBF"
+                "C0C1C2C3C4C5C6C7C8C9CACBCCCDCECF"
+                "D0D1D2D3D4D5D6D7D8D9DADBDCDDDEDF"
+                "E0E1E2E3E4E5E6E7E8E9EAEBECEDEEEF"
+                "F0F1F2F3F4F5F6F7F8F9FAFBFCFDFEFF";
+
+            return table;
+        }
+
+        static char byte_to_b64(uint8_t value)
+        {
+            static const char table[] = {
+                'A',
+                'B',
+                'C',
+                'D',
+                'E',
+                'F',
+                'G',
+                'H',
+                'I',
+                'J',
+                'K',
+                'L',
+                'M',
+                'N',
+                'O',
+                'P',
+                'Q',
+                'R',
+                'S',
+                'T',
+                'U',
+                'V',
+                'W',
+                'X',
+                'Y',
+                'Z',
+                'a',
+                'b',
+                'c',
+                'd',
+                'e',
+                'f',
+                'g',
+                'h',
+                'i',
+                'j',
+                'k',
+                'l',
+                'm',
+                'n',
+                'o',
+                'p',
+                'q',
+                'r',
+                's',
+                't',
+                'u',
+                'v',
+                'w',
+                'x',
+                'y',
+                'z',
+                '0',
+                '1',
+                '2',
+                '3',
+                '4',
+                '5',
+                '6',
+                '7',
+                '8',
+                '9',
+                '+',
+                '/'
+            };
+
+            return table[value & 0x3f];
+        }
+    };
+};
+
+#endif
+/* #include "bramble_decoder.hpp" */
+/* Copyright (c) 2024 Cameron Harper
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ *
+ */
+
+#ifndef BRAMBLE_DECODER_H_INCLUDED
+#define BRAMBLE_DECODER_H_INCLUDED
+
+/* #include "bramble_string_view.hpp" first included at line 231 */
+/* #include "bramble_buffer_stream.hpp" first included at line 824 */
+/* #include "bramble_float_format.hpp" first included at line 2652 */
+
+#include <cctype>
+#include <cstdint>
+#include <cstring>
+#include <limits>
+#include <algorithm>
+#include <utility>
+
+namespace Bramble {
+
+    /** A tool for pulling values out of strings
+     *
+     * */
+    class Decoder {
+    public:
+
+        Decoder()
+            :
+            eq(StringView::npos)
+        {
+        }
+
+        /** decode a null-terminated string
+         *
+         * @param[in] s     null-terminated string
+         *
+         * */
+        Decoder(const char *s)
+            :
+            input(s, strlen(s))
+        {
+            analyse();
+        }
+
+        /** decode a string
+         *
+         * @param[in] s     string
+         * @param[in] size  size of string
+         *
+         * */
+        Decoder(const char *s, size_t size)
+            :
+            input(s, size)
+        {
+            analyse();
+        }
+
+        /** decode a string view
+         *
+         * @param[in] v     string view
+         *
+         * */
+        Decoder(const StringView& v)
+            :
+            input(v)
+        {
+            analyse();
+        }
+
+        Decoder(const Decoder& other)
+            :
+            input(other.input),
+            stripped(other.stripped),
+            eq(other.eq)
+        {
+        }
+
+        const Decoder& operator=(const Decoder& other)
+        {
+            input = other.input;
+            stripped = other.stripped;
+            eq = other.eq;
+            return *this;
+        }
+
+        void swap(Decoder& other)
+        {
+            input.swap(other.input);
+            stripped.swap(other.stripped);
+            std::swap(eq, other.eq);
+        }
+
+        /** Test if input is a named argument
+         *
+         * @retval true     argument is named
+         * @retval false    argument is not named
+         *
+         * */
+        bool is_named() const
+        {
+            return eq_offset() != StringView::npos;
+        }
+
+        /** Get the name of a named argument
+         *
+         * @return StringView
+         *
+         * */
+        StringView name() const
+        {
+            return is_named() ? stripped.substr(0, eq_offset() - size_t(stripped.data() - input.data())) : StringView();
+        }
+
+        /** Get the value associated with name()
+         *
+         * @return StringView
+         *
+         * */
+        StringView named_value() const
+        {
+            return input.substr(eq_offset()+1);
+        }
+
+        /** Get the input value as-is
+         *
+         * @return StringView
+         *
+         * */
+        StringView value() const
+        {
+            return input;
+        }
+
+        /** Test named argument name
+         *
+         * @param[in] v     expected name
+         *
+         * @retval true     v == name()
+         * @retval false    v != name()
+         *
+         * */
+        bool name_eq(const char *v) const
+        {
+            return name_eq(StringView(v));
+        }
+
+        /// @copydoc name_eq(const char *) const
+        bool name_eq(const StringView v) const
+        {
+            return is_named() && (name().compare(v) == 0);
+        }
+
+        /** Test if value() is a boolean
+         *
+         * @retval true     value() is
+         * @retval false    value() is not
+         *
+         * */
+        bool is_bool() const
+        {
+            bool v;
+            return get_bool(v);
+        }
+
+        /** Test if value() is integer (signed or unsigned)
+         *
+         * @retval true     value() is
+         * @retval false    value() is not
+         *
+         * */
+        bool is_int() const
+        {
+            int64_t i;
+            uint64_t u;
+
+            return get_int64(i) || get_uint64(u);
+        }
+
+        /** Test if value() is unsigned integer
+         *
+         * @retval true     value() is
+         * @retval false    value() is not
+         *
+         * */
+        bool is_unsigned() const
+        {
+            uint64_t u;
+
+            return get_uint64(u);
+        }
+
+        /** Remove whitespace from before and after non-whitespace characters
+         *
+         * @param[in] v     input string
+         *
+         * @return StringView
+         *
+         * */
+        static StringView strip(const StringView& v)
+        {
+            StringView retval(v);
+
+            if(!retval.empty()){
+
+                for(auto iter=retval.begin(); (iter != retval.end()) && std::isspace(*iter); ++iter){
+
+                    retval.remove_prefix(1);
+                }
+
+                for(auto iter=retval.rbegin(); (iter != retval.rend()) && std::isspace(*iter); ++iter){
+
+                    retval.remove_suffix(1);
+                }
+            }
+
+            return retval;
+        }
+
+        /// @copydoc strip(const StringView&)
+        static StringView strip(const char *v)
+        {
+            StringView tmp(v);
+            return strip(tmp);
+        }
+
+        /** Test if value() is a string of hexadecimal characters
+         *
+         * @retval true     value() is
+         * @retval false    value() is not
+         *
+         * */
+        bool is_hex_string() const
+        {
+            return get_hex_string(nullptr, 0) > 0;
+        }
+
+        /** Test if value() is a valid b64 string
+         *
+         * @retval true     value() is
+         * @retval false    value() is not
+         *
+         * */
+        bool is_b64_string() const
+        {
+            return get_b64_string(nullptr, 0) > 0;
+        }
+
+        /** Flags returned by classify()
+         *
+         * */
+        enum Kind : unsigned {
+
+            Bool = 1U,          ///< get_bool() would succeed
+            Unsigned = 2U,      ///< get_uint64() would succeed
+            Signed = 4U,        ///< get_int64() would succeed
+            Float = 8U,         ///< get_double() would succeed
+            Hex = 16U,          ///< is_hex_string() is true
+            Base64 = 32U        ///< is_b64_string() is true
+        };
+
+        /** Classify value()
+         *
+         * Equivalent to testing each of the getters in Kind, but the characters
+         * are scanned once and a getter is only tried when every character could
+         * belong to it.
+         *
+         * @return Kind flags (0 if value() is none of these)
+         *
+         * */
+        unsigned classify() const
+        {
+            unsigned retval = 0U;
+            auto in = stripped.data();
+            auto size = stripped.size();
+
+            // character classes common to every character
+            uint8_t common = (size > 0U) ? 0xffU : 0U;
+            size_t pad = StringView::npos;
+            size_t pads = 0U;
+
+            for(size_t i = 0; i < size; i++){
+
+                common &= char_class(in[i]);
+
+                if(in[i] == '='){
+
+                    pad = std::min(pad, i);
+                    pads++;
+                }
+            }
+
+            if((size == 4U) || (size == 5U)){
+
+                bool b;
+
+                retval |= get_bool(b) ? unsigned(Bool) : 0U;
+            }
+
+            if((common & kClassHex) != 0U){
+
+                retval |= Hex;
+            }
+
+            if(((common & kClassB64) != 0U) && ((size % 4U) == 0U) && b64_padding_ok(in, size, pad, pads)){
+
+                retval |= Base64;
+            }
+
+            if((common & kClassDec) != 0U){
+
+                // digits only: no need to try every getter
+                uint64_t u;
+
+                if(digits_to_uint64(stripped, Base::Dec, u)){
+
+                    retval |= Unsigned | Float | ((u <= uint64_t(INT64_MAX)) ? unsigned(Signed) : 0U);
+                }
+                else{
+
+                    double d;
+
+                    retval |= get_double(d) ? unsigned(Float) : 0U;
+                }
+            }
+            else if((common & kClassNumber) != 0U){
+
+                uint64_t u;
+                int64_t i;
+                double d;
+
+                if(in[0] != '-'){
+
+                    // anything other than decimal that fits 64 bits fits as two's complement
+                    retval |= get_uint64(u) ? unsigned(Unsigned | Signed) : 0U;
+                }
+                else{
+
+                    retval |= get_int64(i) ? unsigned(Signed) : 0U;
+                }
+
+                retval |= get_double(d) ? unsigned(Float) : 0U;
+            }
+
+            return retval;
+        }
+
+        /** Get boolean from value()
+         *
+         * @param[out] v    output
+         *
+         * @retval true     success
+         * @retval false    failure
+         *
+         * */
+        bool get_bool(bool& v) const
+        {
+            bool retval = true;
+
+            const StringView v_true("true");
+            const StringView v_false("false");
+
+            auto vv = stripped;
+
+            if(case_insensitive_compare(v_true, vv)){
+
+                v = true;
+            }
+            else if(case_insensitive_compare(v_false, vv)){
+
+                v = false;
+            }
+            else{
+
+                retval = false;
+            }
+
+            return retval;
+        }
+
+        /** Get signed integer from value()
+         *
+         * @note value() may be decimal with an optional leading '-', or
+         * hexadecimal ("0x") or binary ("0b") giving the two's complement of
+         * the value widened to at least 32 bits (as put by Encoder::put_int())
+         *
+         * @param[out] v    output
+         *
+         * @retval true     success
+         * @retval false    failure
+         *
+         * */
+        bool get_int(int8_t& v) const
+        {
+            return get_int8(v);
+        }
+
+        /// @copydoc get_int(int8_t&) const
+        bool get_int(int16_t& v) const
+        {
+            return get_int16(v);
+        }
+
+        /// @copydoc get_int(int8_t&) const
+        bool get_int(int32_t& v) const
+        {
+            return get_int32(v);
+        }
+
+        /// @copydoc get_int(int8_t&) const
+        bool get_int(int64_t& v) const
+        {
+            return get_int64(v);
+        }
+
+        /** Get unsigned integer from value()
+         *
+         * @note value() may be decimal, hexadecimal ("0x") or binary ("0b")
+         *
+         * @param[out] v    output
+         *
+         * @retval true     success
+         * @retval false    failure
+         *
+         * */
+        bool get_unsigned(uint8_t& v) const
+        {
+            return get_uint8(v);
+        }
+
+        /// @copydoc get_unsigned(uint8_t&) const
+        bool get_unsigned(uint16_t& v) const
+        {
+            return get_uint16(v);
+        }
+
+        /// @copydoc get_unsigned(uint8_t&) const
+        bool get_unsigned(uint32_t& v) const
+        {
+            return get_uint32(v);
+        }
+
+        /// @copydoc get_unsigned(uint8_t&) const
+        bool get_unsigned(uint64_t& v) const
+        {
+            return get_uint64(v);
+        }
+
+        /** Get uint8_t from value()
+         *
+         * @param[out] v    output
+         *
+         * @retval true     success
+         * @retval false    failure
+         *
+         * */
+        bool get_uint8(uint8_t& v) const
+        {
+            return s_to_uint<uint8_t>(stripped, v);
+        }
+
+        /** Get uint16_t from value()
+         *
+         * @param[out] v    output
+         *
+         * @retval true     success
+         * @retval false    failure
+         *
+         * */
+        bool get_uint16(uint16_t& v) const
+        {
+            return s_to_uint<uint16_t>(stripped, v);
+        }
+
+        /** Get uint32_t from value()
+         *
+         * @param[out] v    output
+         *
+         * @retval true     success
+         * @retval false    failure
+         *
+         * */
+        bool get_uint32(uint32_t& v) const
+        {
+            return s_to_uint<uint32_t>(stripped, v);
+        }
+
+        /** Get uint64_t from value()
+         *
+         * @param[out] v    output
+         *
+         * @retval true     success
+         * @retval false    failure
+         *
+         * */
+        bool get_uint64(uint64_t& v) const
+        {
+            return s_to_uint<uint64_t>(stripped, v);
+        }
+
+        /** Get int8_t from value()
+         *
+         * @param[out] v    output
+         *
+         * @retval true     success
+         * @retval false    failure
+         *
+         * */
+        bool get_int8(int8_t& v) const
+        {
+            return s_to_int<int8_t>(stripped, v);
+        }
+
+        /** Get int16_t from value()
+         *
+         * @param[out] v    output
+         *
+         * @retval true     success
+         * @retval false    failure
+         *
+         * */
+        bool get_int16(int16_t& v) const
+        {
+            return s_to_int<int16_t>(stripped, v);
+        }
+
+        /** Get int32_t from value()
+         *
+         * @param[out] v    output
+         *
+         * @retval true     success
+         * @retval false    failure
+         *
+         * */
+        bool get_int32(int32_t& v) const
+        {
+            return s_to_int<int32_t>(stripped, v);
+        }
+
+        /** Get int64_t from value()
+         *
+         * @param[out] v    output
+         *
+         * @retval true     success
+         * @retval false    failure
+         *
+         * */
+        bool get_int64(int64_t& v) const
+        {
+            return s_to_int<int64_t>(stripped, v);
+        }
+
+        /** Get double from value()
+         *
+         * @note accepts [-]digits[.digits][(e|E)[+|-]digits], "inf" and "nan"
+         *
+         * @param[out] v    output
+         *
+         * @retval true     success
+         * @retval false    failure
+         *
+         * */
+        bool get_double(double& v) const
+        {
+            return s_to_float<double>(stripped, v);
+        }
+
+        /// @copydoc get_double(double&) const
+        bool get_float(float& v) const
+        {
+            return s_to_float<float>(stripped, v);
+        }
+
+        /** Get a fixed point decimal from value()
+         *
+         * e.g. "868.1" with decimals=3 gives 868100
+         *
+         * Fails if value() has more non-zero digits after the decimal point
+         * than decimals, or if the scaled value does not fit.
+         *
+         * @param[out] v        value scaled by 10^decimals
+         * @param[in] decimals  number of digits after the decimal point (at most 18)
+         *
+         * @retval true     success
+         * @retval false    failure
+         *
+         * */
+        bool get_fixed(int64_t& v, unsigned decimals) const
+        {
+            bool retval = false;
+            auto tmp = stripped;
+            auto iter = tmp.begin();
+            bool negative = (iter != tmp.end()) && (*iter == '-');
+            bool any = false;
+            uint64_t mag = 0;
+
+            if(negative){
+
+                ++iter;
+            }
+
+            retval = (decimals <= 18U);
+
+            // integer part
+            for(; retval && (iter != tmp.end()) && (*iter != '.'); ++iter){
+
+                retval = digit_into(*iter, mag);
+                any = true;
+            }
+
+            // fraction part
+            if(retval && (iter != tmp.end())){
+
+                ++iter;
+            }
+
+            for(unsigned i = 0; i < decimals; i++){
+
+                if(retval && (iter != tmp.end())){
+
+                    retval = digit_into(*iter, mag);
+                    any = true;
+                    ++iter;
+                }
+                else{
+
+                    retval = retval && digit_into('0', mag);
+                }
+            }
+
+            // more decimals than fit must be zero
+            for(; retval && (iter != tmp.end()); ++iter){
+
+                retval = (*iter == '0');
+                any = true;
+            }
+
+            retval = retval && any && (mag <= (uint64_t(INT64_MAX) + (negative ? 1U : 0U)));
+
+            if(retval){
+
+                v = negative ? ((mag == 0U) ? 0 : (-int64_t(mag - 1U) - 1)) : int64_t(mag);
+            }
+
+            return retval;
+        }
+
+        /** Interpret value() as hex encoded memory
+         *
+         * @note use is_hex_string() to test if all characters in value() appear to be a hex string
+         *
+         * @param[out] buffer   output
+         * @param[out] max      maximum size of buffer
+         *
+         * @retval bytes written to buffer
+         *
+         * */
+        size_t get_hex_string(void *buffer, size_t max) const
+        {
+            size_t error;
+
+            return get_hex_string(buffer, max, error);
+        }
+
+        /** Interpret value() as hex encoded memory and report where decoding failed
+         *
+         * Validation and decoding happen in a single pass. If buffer is too small
+         * the remaining input is still validated.
+         *
+         * @param[out] buffer   output (may be nullptr to only validate)
+         * @param[out] max      maximum size of buffer
+         * @param[out] error    offset of first non-hex character in the stripped value (StringView::npos if none)
+         *
+         * @retval bytes decoded (0 if value() is not a hex string)
+         *
+         * */
+        size_t get_hex_string(void *buffer, size_t max, size_t& error) const
+        {
+            auto tmp = stripped;
+            auto in = tmp.data();
+            auto end = in + tmp.size();
+            auto out = static_cast<uint8_t *>(buffer);
+
+            size_t pairs = tmp.size() / 2U;
+            size_t stored = (buffer != nullptr) ? std::min(max, pairs) : 0U;
+            size_t i;
+
+            error = StringView::npos;
+
+            // decode into buffer four bytes at a time
+            for(i = 0; ((i + 4U) <= stored); i += 4U){
+
+                auto p = &in[i * 2U];
+
+                uint8_t h0 = hex_table(p[0]), l0 = hex_table(p[1]);
+                uint8_t h1 = hex_table(p[2]), l1 = hex_table(p[3]);
+                uint8_t h2 = hex_table(p[4]), l2 = hex_table(p[5]);
+                uint8_t h3 = hex_table(p[6]), l3 = hex_table(p[7]);
+
+                if((h0 | l0 | h1 | l1 | h2 | l2 | h3 | l3) > 0xfU){
+
+                    break;
+                }
+
+                out[i] = uint8_t(h0 << 4) | l0;
+                out[i+1] = uint8_t(h1 << 4) | l1;
+                out[i+2] = uint8_t(h2 << 4) | l2;
+                out[i+3] = uint8_t(h3 << 4) | l3;
+            }
+
+            for(; i < stored; i++){
+
+                uint8_t h = hex_table(in[i * 2U]), l = hex_table(in[(i * 2U) + 1U]);
+
+                if((h | l) > 0xfU){
+
+                    break;
+                }
+
+                out[i] = uint8_t(h << 4) | l;
+            }
+
+            // validate what doesn't fit in buffer
+            if(i == stored){
+
+                auto pos = find_non_hex(&in[i * 2U], end);
+
+                if(pos != end){
+
+                    error = size_t(pos - in);
+                }
+                else if((tmp.size() & 1U) && (out != nullptr) && (pairs < max)){
+
+                    // odd digit is the high nibble of the final byte
+                    out[pairs] = uint8_t(hex_table(tmp.back()) << 4);
+                }
+            }
+            else{
+
+                error = size_t(find_non_hex(&in[i * 2U], end) - in);
+            }
+
+            return (error == StringView::npos) ? ((tmp.size() + 1U) / 2U) : 0U;
+        }
+
+        /** Get the number of bytes value() decodes to as a hex string
+         *
+         * @return bytes (0 if value() is not a hex string)
+         *
+         * */
+        size_t get_hex_string_size() const
+        {
+            return get_hex_string(nullptr, 0);
+        }
+
+        /** Interpret value() as base64 encoded memory
+         *
+         * @note use is_b64_string() to test if all characters in value() appear to be base64
+         *
+         * @param[out] buffer   output
+         * @param[out] max      maximum size of buffer
+         *
+         * @retval bytes written to buffer
+         *
+         * */
+        size_t get_b64_string(void *buffer, size_t max) const
+        {
+            size_t error;
+
+            return get_b64_string(buffer, max, error);
+        }
+
+        /** Interpret value() as base64 encoded memory and report where decoding failed
+         *
+         * Padding is strict: value() must be a multiple of four characters,
+         * '=' may only appear as the final one or two characters, and bits
+         * made redundant by padding must be zero. If buffer is too small the
+         * remaining input is still validated.
+         *
+         * @param[out] buffer   output (may be nullptr to only validate)
+         * @param[out] max      maximum size of buffer
+         * @param[out] error    offset of the first invalid character in the stripped value (StringView::npos if none)
+         *
+         * @retval bytes decoded (0 if value() is not a base64 string)
+         *
+         * */
+        size_t get_b64_string(void *buffer, size_t max, size_t& error) const
+        {
+            auto tmp = stripped;
+            auto in = tmp.data();
+            auto end = in + tmp.size();
+            auto out = static_cast<uint8_t *>(buffer);
+
+            size_t retval = 0;
+
+            error = StringView::npos;
+
+            if(tmp.empty() || ((tmp.size() % 4U) != 0U)){
+
+                auto pos = find_non_b64(in, end);
+
+                error = (pos != end) ? size_t(pos - in) : tmp.size();
+            }
+            else{
+
+                // every quad except the last cannot contain padding
+                size_t body = (tmp.size() / 4U) - 1U;
+                size_t direct = (buffer != nullptr) ? std::min(body, max / 3U) : 0U;
+                size_t i;
+                uint8_t block[3];
+
+                for(i = 0; i < direct; i++){
+
+                    if(!b64_quad_to_bytes(&in[i * 4U], &out[i * 3U])){
+
+                        break;
+                    }
+                }
+
+                if(i == direct){
+
+                    for(; i < body; i++){
+
+                        if(!b64_quad_to_bytes(&in[i * 4U], block)){
+
+                            break;
+                        }
+
+                        copy_partial(out, max, i * 3U, block, sizeof(block));
+                    }
+                }
+
+                if(i < body){
+
+                    error = size_t(find_non_b64(&in[i * 4U], end) - in);
+                }
+                else{
+
+                    auto last = &in[body * 4U];
+                    size_t size = b64_final_quad_to_bytes(last, block, error);
+
+                    if(error == StringView::npos){
+
+                        copy_partial(out, max, body * 3U, block, size);
+                        retval = (body * 3U) + size;
+                    }
+                    else{
+
+                        error += body * 4U;
+                    }
+                }
+            }
+
+            return retval;
+        }
+
+        /** Get the number of bytes value() decodes to as a base64 string
+         *
+         * @return bytes (0 if value() is not a base64 string)
+         *
+         * */
+        size_t get_b64_string_size() const
+        {
+            return get_b64_string(nullptr, 0);
+        }
+
+    protected:
+
+        enum class Base {
+
+            Dec,
+            Hex,
+            Bin
+        };
+
+        StringView input;
+
+        // input without surrounding whitespace
+        StringView stripped;
+
+        // offset of the first '=' in input (StringView::npos if none, unscanned until needed)
+        mutable size_t eq;
+
+        static const size_t unscanned = StringView::npos - 1U;
+
+        void analyse()
+        {
+            stripped = strip(input);
+            eq = unscanned;
+        }
+
+        size_t eq_offset() const
+        {
+            if(eq == unscanned){
+
+                eq = input.find_first_of('=');
+            }
+
+            return eq;
+        }
+
+        // remove a "0x" or "0b" prefix and return the base it selects
+        static Base remove_base_prefix(StringView& s)
+        {
+            Base retval = Base::Dec;
+
+            if((s.size() > 2U) && (s[0] == '0')){
+
+                switch(s[1]){
+                case 'x':
+                case 'X':
+                    retval = Base::Hex;
+                    s.remove_prefix(2);
+                    break;
+                case 'b':
+                case 'B':
+                    retval = Base::Bin;
+                    s.remove_prefix(2);
+                    break;
+                default:
+                    break;
+                }
+            }
+
+            return retval;
+        }
+
+        // true if eight characters are all decimal digits
+        static bool is_eight_digits(uint64_t chunk)
+        {
+            return ((chunk & 0xf0f0f0f0f0f0f0f0ULL) == 0x3030303030303030ULL) &&
+                (((chunk + 0x0606060606060606ULL) & 0xf0f0f0f0f0f0f0f0ULL) == 0x3030303030303030ULL);
+        }
+
+        // value of eight decimal digits (first digit in the least significant byte)
+        static uint32_t eight_digits_to_value(uint64_t chunk)
+        {
+            uint64_t v = chunk - 0x3030303030303030ULL;
+
+            v = (v * 10U) + (v >> 8);
+            v = (((v & 0x000000ff000000ffULL) * (100U + (1000000ULL << 32))) +
+                (((v >> 16) & 0x000000ff000000ffULL) * (1U + (10000ULL << 32)))) >> 32;
+
+            return uint32_t(v);
+        }
+
+        static uint64_t load_eight(const char *p)
+        {
+            // assembled bytewise so that it is independent of byte order
+            return uint64_t(uint8_t(p[0])) |
+                (uint64_t(uint8_t(p[1])) << 8) |
+                (uint64_t(uint8_t(p[2])) << 16) |
+                (uint64_t(uint8_t(p[3])) << 24) |
+                (uint64_t(uint8_t(p[4])) << 32) |
+                (uint64_t(uint8_t(p[5])) << 40) |
+                (uint64_t(uint8_t(p[6])) << 48) |
+                (uint64_t(uint8_t(p[7])) << 56);
+        }
+
+        // parse digits (no prefix or sign) without overflow
+        static bool digits_to_uint64(StringView s, Base base, uint64_t& value)
+        {
+            bool retval = false;
+            auto iter = s.data();
+            auto end = iter + s.size();
+
+            // leading zeros are insignificant
+            while(((end - iter) > 1) && (*iter == '0')){
+
+                ++iter;
+            }
+
+            if(iter != end){
+
+                switch(base){
+                default:
+                case Base::Dec:
+                    retval = dec_to_uint64(iter, end, value);
+                    break;
+                case Base::Hex:
+                    retval = hex_to_uint64(iter, end, value);
+                    break;
+                case Base::Bin:
+                    retval = bin_to_uint64(iter, end, value);
+                    break;
+                }
+            }
+
+            return retval;
+        }
+
+        static bool dec_to_uint64(const char *iter, const char *end, uint64_t& value)
+        {
+            bool retval = true;
+            uint64_t v = 0;
+            size_t n = size_t(end - iter);
+
+            // UINT64_MAX has 20 digits, only the 20th can overflow
+            auto last = (n == 20U) ? (end - 1) : end;
+
+            if(n > 20U){
+
+                retval = false;
+            }
+
+            for(; retval && ((last - iter) >= 8); iter += 8){
+
+                uint64_t chunk = load_eight(iter);
+
+                if(is_eight_digits(chunk)){
+
+                    v = (v * 100000000ULL) + eight_digits_to_value(chunk);
+                }
+                else{
+
+                    retval = false;
+                }
+            }
+
+            for(; retval && (iter != last); ++iter){
+
+                if((*iter < '0') || (*iter > '9')){
+
+                    retval = false;
+                }
+                else{
+
+                    v = (v * 10U) + uint64_t(*iter - '0');
+                }
+            }
+
+            if(retval && (last != end)){
+
+                uint64_t d = uint64_t(*last - '0');
+
+                if((*last < '0') || (*last > '9') || (v > ((UINT64_MAX - d) / 10U))){
+
+                    retval = false;
+                }
+                else{
+
+                    v = (v * 10U) + d;
+                }
+            }
+
+            value = v;
+
+            return retval;
+        }
+
+        static bool hex_to_uint64(const char *iter, const char *end, uint64_t& value)
+        {
+            bool retval = ((end - iter) <= 16);
+            uint64_t v = 0;
+
+            for(; retval && (iter != end); ++iter){
+
+                uint8_t d = hex_table(*iter);
+
+                if(d > 0xfU){
+
+                    retval = false;
+                }
+                else{
+
+                    v = (v << 4) | d;
+                }
+            }
+
+            value = v;
+
+            return retval;
+        }
+
+        static bool bin_to_uint64(const char *iter, const char *end, uint64_t& value)
+        {
+            bool retval = ((end - iter) <= 64);
+            uint64_t v = 0;
+
+            for(; retval && (iter != end); ++iter){
+
+                if((*iter != '0') && (*iter != '1')){
+
+                    retval = false;
+                }
+                else{
+
+                    v = (v << 1) | uint64_t(*iter - '0');
+                }
+            }
+
+            value = v;
+
+            return retval;
+        }
+
+        template<typename T>
+        static bool s_to_uint(StringView s, T& value)
+        {
+            uint64_t v;
+            Base base = remove_base_prefix(s);
+            bool retval = digits_to_uint64(s, base, v) && (v <= uint64_t(std::numeric_limits<T>::max()));
+
+            if(retval){
+
+                value = T(v);
+            }
+
+            return retval;
+        }
+
+        template<typename T>
+        static bool s_to_float(StringView s, T& value)
+        {
+            auto end = s.data() + s.size();
+            T v;
+
+            bool retval = !s.empty() && (FloatFormat::from_chars(s.data(), end, v) == end);
+
+            if(retval){
+
+                value = v;
+            }
+
+            return retval;
+        }
+
+        // append decimal digit c to value
+        static bool digit_into(char c, uint64_t& value)
+        {
+            bool retval = false;
+
+            if((c >= '0') && (c <= '9')){
+
+                uint64_t d = uint64_t(c - '0');
+
+                if(value <= ((UINT64_MAX - d) / 10U)){
+
+                    value = (value * 10U) + d;
+                    retval = true;
+                }
+            }
+
+            return retval;
+        }
+
+        template<typename T>
+        static bool s_to_int(StringView s, T& value)
+        {
+            bool retval = false;
+            bool negative = !s.empty() && (s.front() == '-');
+            uint64_t v;
+            int64_t x = 0;
+
+            if(negative){
+
+                s.remove_prefix(1);
+            }
+
+            // sign is only valid with decimal
+            Base base = negative ? Base::Dec : remove_base_prefix(s);
+
+            if(digits_to_uint64(s, base, v)){
+
+                if(negative){
+
+                    // magnitude of the minimum is max + 1
+                    retval = (v <= (uint64_t(std::numeric_limits<T>::max()) + 1U));
+                    x = (v == 0U) ? 0 : (-int64_t(v - 1U) - 1);
+                }
+                else if(base == Base::Dec){
+
+                    retval = (v <= uint64_t(std::numeric_limits<T>::max()));
+                    x = int64_t(v);
+                }
+                else if(sizeof(T) <= sizeof(int32_t)){
+
+                    // two's complement of the value widened to 32 bits
+                    retval = (v <= UINT32_MAX);
+                    x = (v > uint64_t(INT32_MAX)) ? (-int64_t(UINT32_MAX - v) - 1) : int64_t(v);
+                }
+                else{
+
+                    retval = true;
+                    x = (v > uint64_t(INT64_MAX)) ? (-int64_t(UINT64_MAX - v) - 1) : int64_t(v);
+                }
+
+                retval = retval && (x >= int64_t(std::numeric_limits<T>::min())) && (x <= int64_t(std::numeric_limits<T>::max()));
+            }
+
+            if(retval){
+
+                value = T(x);
+            }
+
+            return retval;
+        }
+
+        static bool hex_to_value(char c, uint8_t& v)
+        {
+            v = hex_table(c);
+
+            return v <= 0xfU;
+        }
+
+        static const char *find_non_hex(const char *begin, const char *end)
+        {
+            auto iter = begin;
+
+            while((iter != end) && (hex_table(*iter) <= 0xfU)){
+
+                ++iter;
+            }
+
+            return iter;
+        }
+
+        // value of hex digit c, or 0xff if c is not a hex digit
+        static uint8_t hex_table(char c)
+        {
+            static const uint8_t table[256] = {
+                0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff,
+                0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff,
+                0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff,
+                0x00, 0x01, 0x02, 0x03, 0x04, 0x05, 0x06, 0x07, 0x08, 0x09, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff,
+                0xff, 0x0a, 0x0b, 0x0c, 0x0d, 0x0e, 0x0f, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff,
+                0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff,
+                0xff, 0x0a, 0x0b, 0x0c, 0x0d, 0x0e, 0x0f, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff,
+                0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff,
+                0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff,
+                0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff,
+                0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff,
+                0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff,
+                0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff,
+                0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff,
+                0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff,
+                0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff
+            };
+
+            return table[uint8_t(c)];
+        }
+
+        static const uint8_t kClassDec = 1U;       // 0-9
+        static const uint8_t kClassHex = 2U;       // 0-9, a-f, A-F
+        static const uint8_t kClassB64 = 4U;       // base64 alphabet and '='
+        static const uint8_t kClassNumber = 8U;    // characters that can appear in an integer or float
+
+        static uint8_t char_class(char c)
+        {
+            static const uint8_t table[256] = {
+                0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00,
+                0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00,
+                0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x0c, 0x00, 0x08, 0x08, 0x04,
+                0x0f, 0x0f, 0x0f, 0x0f, 0x0f, 0x0f, 0x0f, 0x0f, 0x0f, 0x0f, 0x00, 0x00, 0x00, 0x04, 0x00, 0x00,
+                0x00, 0x0e, 0x0e, 0x0e, 0x0e, 0x0e, 0x0e, 0x04, 0x04, 0x0c, 0x04, 0x04, 0x04, 0x04, 0x0c, 0x04,
+                0x04, 0x04, 0x04, 0x04, 0x04, 0x04, 0x04, 0x04, 0x0c, 0x04, 0x04, 0x00, 0x00, 0x00, 0x00, 0x00,
+                0x00, 0x0e, 0x0e, 0x0e, 0x0e, 0x0e, 0x0e, 0x04, 0x04, 0x0c, 0x04, 0x04, 0x04, 0x04, 0x0c, 0x04,
+                0x04, 0x04, 0x04, 0x04, 0x04, 0x04, 0x04, 0x04, 0x0c, 0x04, 0x04, 0x00, 0x00, 0x00, 0x00, 0x00,
+                0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00,
+                0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00,
+                0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00,
+                0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00,
+                0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00,
+                0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00,
+                0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00,
+                0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00
+            };
+
+            return table[uint8_t(c)];
+        }
+
+        // check '=' only appears as the final one or two characters and covers zero bits
+        static bool b64_padding_ok(const char *in, size_t size, size_t pad, size_t pads)
+        {
+            bool retval = (pads == 0U);
+            uint8_t v;
+
+            if(!retval && (pads <= 2U) && (pad == (size - pads)) && b64_to_value(in[pad - 1U], v)){
+
+                retval = (v & ((pads == 1U) ? 0x3U : 0xfU)) == 0U;
+            }
+
+            return retval;
+        }
+
+        static bool b64_to_value(char c, uint8_t& v)
+        {
+            v = b64_table(c);
+
+            return v <= 0x3fU;
+        }
+
+        static const char *find_non_b64(const char *begin, const char *end)
+        {
+            auto iter = begin;
+
+            while((iter != end) && (b64_table(*iter) <= 0x3fU)){
+
+                ++iter;
+            }
+
+            return iter;
+        }
+
+        // decode four characters that must not contain padding
+        static bool b64_quad_to_bytes(const char *in, uint8_t *out)
+        {
+            bool retval = false;
+
+            uint8_t a = b64_table(in[0]), b = b64_table(in[1]), c = b64_table(in[2]), d = b64_table(in[3]);
+
+            if((a | b | c | d) <= 0x3fU){
+
+                uint32_t v = (uint32_t(a) << 18) | (uint32_t(b) << 12) | (uint32_t(c) << 6) | uint32_t(d);
+
+                out[0] = uint8_t(v >> 16);
+                out[1] = uint8_t(v >> 8);
+                out[2] = uint8_t(v);
+
+                retval = true;
+            }
+
+            return retval;
+        }
+
+        // decode the last four characters where padding is allowed
+        static size_t b64_final_quad_to_bytes(const char *in, uint8_t *out, size_t& error)
+        {
+            size_t retval = 0;
+
+            uint8_t a = b64_table(in[0]), b = b64_table(in[1]), c = b64_table(in[2]), d = b64_table(in[3]);
+
+            error = StringView::npos;
+
+            if(a > 0x3fU){
+
+                error = 0;
+            }
+            else if(b > 0x3fU){
+
+                error = 1;
+            }
+            else if(c > 0x3fU){
+
+                if((in[2] != '=') || (in[3] != '=')){
+
+                    error = (in[2] != '=') ? 2 : 3;
+                }
+                else if((b & 0xfU) != 0U){
+
+                    error = 1;
+                }
+                else{
+
+                    out[0] = uint8_t((a << 2) | (b >> 4));
+                    retval = 1;
+                }
+            }
+            else if(d > 0x3fU){
+
+                if(in[3] != '='){
+
+                    error = 3;
+                }
+                else if((c & 0x3U) != 0U){
+
+                    error = 2;
+                }
+                else{
+
+                    out[0] = uint8_t((a << 2) | (b >> 4));
+                    out[1] = uint8_t((b << 4) | (c >> 2));
+                    retval = 2;
+                }
+            }
+            else{
+
+                out[0] = uint8_t((a << 2) | (b >> 4));
+                out[1] = uint8_t((b << 4) | (c >> 2));
+                out[2] = uint8_t((c << 6) | d);
+                retval = 3;
+            }
+
+            return retval;
+        }
+
+        // copy decoded bytes at offset into buffer, discarding what doesn't fit
+        static void copy_partial(uint8_t *buffer, size_t max, size_t offset, const uint8_t *bytes, size_t size)
+        {
+            if((buffer != nullptr) && (offset < max)){
+
+                (void)memcpy(&buffer[offset], bytes, std::min(size, max - offset));
+            }
+        }
+
+        // value of base64 digit c, or 0xff if c is not a base64 digit ('=' included)
+        static uint8_t b64_table(char c)
+        {
+            static const uint8_t table[256] = {
+                0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff,
+                0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff,
+                0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0x3e, 0xff, 0xff, 0xff, 0x3f,
+                0x34, 0x35, 0x36, 0x37, 0x38, 0x39, 0x3a, 0x3b, 0x3c, 0x3d, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff,
+                0xff, 0x00, 0x01, 0x02, 0x03, 0x04, 0x05, 0x06, 0x07, 0x08, 0x09, 0x0a, 0x0b, 0x0c, 0x0d, 0x0e,
+                0x0f, 0x10, 0x11, 0x12, 0x13, 0x14, 0x15, 0x16, 0x17, 0x18, 0x19, 0xff, 0xff, 0xff, 0xff, 0xff,
+                0xff, 0x1a, 0x1b, 0x1c, 0x1d, 0x1e, 0x1f, 0x20, 0x21, 0x22, 0x23, 0x24, 0x25, 0x26, 0x27, 0x28,
+                0x29, 0x2a, 0x2b, 0x2c, 0x2d, 0x2e, 0x2f, 0x30, 0x31, 0x32, 0x33, 0xff, 0xff, 0xff, 0xff, 0xff,
+                0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff,
+                0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff,
+                0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff,
+                0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff,
+                0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff,
+                0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff,
+                0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff,
+                0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff
+            };
+
+            return table[uint8_t(c)];
+        }
+
+        static bool case_insensitive_compare(const StringView& a, const StringView& b)
+        {
+            bool retval = false;
+
+            if(a.size() == b.size()){
+
+                auto a_iter = a.begin();
+                auto b_iter = b.begin();
+
+                retval = true;
+
+                for(; a_iter != a.end(); ++a_iter, ++b_iter){
+
+                    if(std::tolower(*a_iter) != std::tolower(*b_iter)){
+
+                        retval = false;
+                        break;
+                    }
+                }
+            }
+
+            return retval;
+        }
+    };
+};
+
+#endif
+/* #include "bramble_argument.hpp" first included at line 797 */
+/* #include "bramble_string_view.hpp" first included at line 231 */
+/* #include "bramble_buffer_stream.hpp" first included at line 824 */
+/* #include "bramble_function_ref.hpp" */
+/* Copyright (c) 2024 Cameron Harper
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ *
+ */
+
+#ifndef BRAMBLE_FUNCTION_REF_H_INCLUDED
+#define BRAMBLE_FUNCTION_REF_H_INCLUDED
+
+#include <memory>
+#include <type_traits>
+#include <utility>
+
+namespace Bramble {
+
+    /// @private
+    template<typename Fn>
+    class FunctionRef;
+
+    /** A non-owning reference to a callable
+     *
+     * Unlike std::function this never allocates. The callable must outlive the
+     * reference, which is always the case when a FunctionRef is only used as a
+     * parameter.
+     *
+     * @tparam R        return type
+     * @tparam Args     argument types
+     *
+     * */
+    template<typename R, typename... Args>
+    class FunctionRef<R(Args...)> {
+    public:
+
+        /** Refer to a callable object
+         *
+         * @param[in] f     callable (must outlive this instance)
+         *
+         * */
+        template<typename F, typename = typename std::enable_if<!std::is_same<typename std::decay<F>::type, FunctionRef>::value>::type>
+        FunctionRef(F&& f)
+            :
+            fn(call<typename std::remove_reference<F>::type>)
+        {
+            target.obj = const_cast<void *>(static_cast<const void *>(std::addressof(f)));
+        }
+
+        /** Refer to a function
+         *
+         * @param[in] f     function
+         *
+         * */
+        FunctionRef(R (*f)(Args...))
+            :
+            fn(call_ptr)
+        {
+            target.ptr = f;
+        }
+
+        /** Call the referenced callable
+         *
+         * */
+        R operator()(Args... args) const
+        {
+            return fn(target, std::forward<Args>(args)...);
+        }
+
+    private:
+
+        union Target {
+
+            void *obj;
+            R (*ptr)(Args...);
+        };
+
+        Target target;
+        R (*fn)(Target, Args...);
+
+        template<typename F>
+        static R call(Target target, Args... args)
+        {
+            return (*static_cast<F *>(target.obj))(std::forward<Args>(args)...);
+        }
+
+        static R call_ptr(Target target, Args... args)
+        {
+            return target.ptr(std::forward<Args>(args)...);
+        }
+    };
+};
+
+#endif
+/* #include "bramble_emit.hpp" */
+/* Copyright (c) 2024 Cameron Harper
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ *
+ */
+
+#ifndef BRAMBLE_EMIT_H_INCLUDED
+#define BRAMBLE_EMIT_H_INCLUDED
+
+/* #include "bramble_encoder.hpp" first included at line 2350 */
+/* #include "bramble_string_view.hpp" first included at line 231 */
+
+#include <cstddef>
+#include <cstdint>
+#include <type_traits>
+
+namespace Bramble {
+
+    /** A key=value argument, see kv()
+     *
+     * */
+    template<typename T>
+    struct KeyValue {
+
+        const char *key;    ///< key
+        T value;            ///< value
+    };
+
+    /** A binary argument encoded as hexadecimal, see hex()
+     *
+     * */
+    struct Hex {
+
+        const void *data;   ///< input buffer
+        size_t size;        ///< size of input buffer
+    };
+
+    /** A binary argument encoded as base64, see b64()
+     *
+     * */
+    struct B64 {
+
+        const void *data;   ///< input buffer
+        size_t size;        ///< size of input buffer
+    };
+
+    /** Check if T can be passed as an argument to the variadic emission functions
+     *
+     * Integers, floating point, bool, char, strings, StringView, KeyValue, Hex
+     * and B64 can be emitted.
+     *
+     * */
+    template<typename T, typename = void>
+    struct is_argument : std::false_type {};
+
+    /// @private
+    template<typename T>
+    struct is_argument<T, typename std::enable_if<std::is_integral<T>::value>::type> : std::true_type {};
+
+    /// @private
+    template<typename T>
+    struct is_argument<T, typename std::enable_if<std::is_floating_point<T>::value>::type> : std::true_type {};
+
+    /// @private
+    template<>
+    struct is_argument<const char *> : std::true_type {};
+
+    /// @private
+    template<>
+    struct is_argument<char *> : std::true_type {};
+
+    /// @private
+    template<size_t N>
+    struct is_argument<char[N]> : std::true_type {};
+
+    /// @private
+    template<>
+    struct is_argument<StringView> : std::true_type {};
+
+    /// @private
+    template<>
+    struct is_argument<Hex> : std::true_type {};
+
+    /// @private
+    template<>
+    struct is_argument<B64> : std::true_type {};
+
+    /// @private
+    template<typename T>
+    struct is_argument<KeyValue<T>> : is_argument<T> {};
+
+    /** Check if every type in a pack satisfies is_argument
+     *
+     * */
+    template<typename... T>
+    struct are_arguments : std::true_type {};
+
+    /// @private
+    template<typename T, typename... Rest>
+    struct are_arguments<T, Rest...> : std::integral_constant<bool, is_argument<T>::value && are_arguments<Rest...>::value> {};
+
+    /** Emit value as key=value
+     *
+     * @param[in] key       key
+     * @param[in] value     value (any type that satisfies is_argument except KeyValue)
+     *
+     * @return KeyValue
+     *
+     * */
+    template<typename T>
+    KeyValue<typename std::decay<const T>::type> kv(const char *key, const T& value)
+    {
+        return KeyValue<typename std::decay<const T>::type>{key, value};
+    }
+
+    /** Emit a buffer as hexadecimal
+     *
+     * @param[in] data      input buffer (must remain valid until emitted)
+     * @param[in] size      size of input buffer
+     *
+     * @return Hex
+     *
+     * */
+    inline Hex hex(const void *data, size_t size)
+    {
+        return Hex{data, size};
+    }
+
+    /** Emit a buffer as base64
+     *
+     * @param[in] data      input buffer (must remain valid until emitted)
+     * @param[in] size      size of input buffer
+     *
+     * @return B64
+     *
+     * */
+    inline B64 b64(const void *data, size_t size)
+    {
+        return B64{data, size};
+    }
+
+    /** Put a single argument
+     *
+     * Overloads are chosen at compile time according to the type of the argument.
+     *
+     * @param[in] e         encoder
+     * @param[in] value     argument
+     *
+     * */
+    template<typename T>
+    typename std::enable_if<std::is_integral<T>::value && std::is_signed<T>::value>::type
+    put_argument(Encoder& e, T value)
+    {
+        if(sizeof(T) > sizeof(int32_t)){
+
+            (void)e.put_int(int64_t(value));
+        }
+        else{
+
+            (void)e.put_int(int32_t(value));
+        }
+    }
+
+    /// @copydoc put_argument(Encoder&, T)
+    template<typename T>
+    typename std::enable_if<std::is_integral<T>::value && std::is_unsigned<T>::value>::type
+    put_argument(Encoder& e, T value)
+    {
+        if(sizeof(T) > sizeof(uint32_t)){
+
+            (void)e.put_int(uint64_t(value));
+        }
+        else{
+
+            (void)e.put_int(uint32_t(value));
+        }
+    }
+
+    /// @copydoc put_argument(Encoder&, T)
+    template<typename T>
+    typename std::enable_if<std::is_floating_point<T>::value>::type
+    put_argument(Encoder& e, T value)
+    {
+        if(sizeof(T) > sizeof(float)){
+
+            (void)e.put_double(double(value));
+        }
+        else{
+
+            (void)e.put_float(float(value));
+        }
+    }
+
+    /// @copydoc put_argument(Encoder&, T)
+    inline void put_argument(Encoder& e, bool value)
+    {
+        (void)e.put_bool(value);
+    }
+
+    /// @copydoc put_argument(Encoder&, T)
+    inline void put_argument(Encoder& e, char value)
+    {
+        (void)e.put_char(value);
+    }
+
+    /// @copydoc put_argument(Encoder&, T)
+    inline void put_argument(Encoder& e, const char *value)
+    {
+        (void)e.put_string(value);
+    }
+
+    /// @copydoc put_argument(Encoder&, T)
+    inline void put_argument(Encoder& e, const StringView& value)
+    {
+        (void)e.put_string(value);
+    }
+
+    /// @copydoc put_argument(Encoder&, T)
+    inline void put_argument(Encoder& e, const Hex& value)
+    {
+        (void)e.put_hex_string(value.data, value.size);
+    }
+
+    /// @copydoc put_argument(Encoder&, T)
+    inline void put_argument(Encoder& e, const B64& value)
+    {
+        (void)e.put_b64_string(value.data, value.size);
+    }
+
+    /// @copydoc put_argument(Encoder&, T)
+    template<typename T>
+    void put_argument(Encoder& e, const KeyValue<T>& value)
+    {
+        (void)e.put_string(value.key).put_char('=');
+        put_argument(e, value.value);
+    }
+
+    /** Put arguments separated by delimiters
+     *
+     * @param[in] e         encoder
+     *
+     * */
+    inline void put_arguments(Encoder& e)
+    {
+        (void)e;
+    }
+
+    /** @copydoc put_arguments(Encoder&)
+     *
+     * @param[in] first     first argument
+     * @param[in] rest      remaining arguments
+     *
+     * */
+    template<typename T, typename... Rest>
+    void put_arguments(Encoder& e, const T& first, const Rest&... rest)
+    {
+        put_argument(e, first);
+
+        if(sizeof...(Rest) > 0){
+
+            (void)e.space();
+            put_arguments(e, rest...);
+        }
+    }
+};
+
+#endif
+
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <array>
+#include <cctype>
+#include <algorithm>
+#include <atomic>
+#include <type_traits>
+
+namespace Bramble {
+
+    /** A Bramble server
+     *
+     * */
+    class Server {
+    private:
+
+        class Output;
+
+    public:
+
+        /** Writes additional arguments to a stream */
+        using ArgumentClosure = FunctionRef<void(Bramble::Stream&)>;
+
+        /** A command that will be completed after its handler has returned
+         *
+         * Obtained from Command::defer(). The ACK or NAK is sent when
+         * ack() or nak() is called, correlated with the command by its full
+         * name (including invocation id).
+         *
+         * If an Events queue is attached (see set_events()) the response is
+         * posted to it and written by process() or step() between lines, so
+         * completion may happen from another thread or interrupt provided that
+         * the server outlives the Deferred instance. If the response cannot be
+         * queued the Deferred remains pending and completion can be retried.
+         *
+         * Without an Events queue the response is written straight to the host,
+         * so ack() and nak() must be called from the same context as process()
+         * and not while the server is writing (e.g. from within Host::write()).
+         *
+         * A Deferred that is destroyed without being completed sends nothing.
+         *
+         * */
+        class Deferred {
+        public:
+
+            /** longest command name (including invocation id) that can be deferred */
+            static const size_t max_name = 64;
+
+            /** Create a Deferred that is not attached to a command
+             *
+             * */
+            Deferred()
+                :
+                server(nullptr),
+                size(0)
+            {
+            }
+
+            /// @private
+            Deferred(Server& server, const StringView& full_name)
+                :
+                server(&server),
+                size(full_name.size())
+            {
+                (void)memcpy(name.data(), full_name.data(), size);
+            }
+
+            Deferred(Deferred&& other)
+                :
+                server(other.server),
+                name(other.name),
+                size(other.size)
+            {
+                other.server = nullptr;
+            }
+
+            Deferred& operator=(Deferred&& other)
+            {
+                if(this != &other){
+
+                    server = other.server;
+                    name = other.name;
+                    size = other.size;
+
+                    other.server = nullptr;
+                }
+
+                return *this;
+            }
+
+            Deferred(const Deferred&) = delete;
+            Deferred& operator=(const Deferred&) = delete;
+
+            /** Check if this command is still waiting to be completed
+             *
+             * @retval true     ack() or nak() will send a response
+             *
+             * */
+            bool pending() const
+            {
+                return server != nullptr;
+            }
+
+            /** Command name (including invocation id)
+             *
+             * */
+            StringView full_name() const
+            {
+                return StringView(name.data(), size);
+            }
+
+            /** Complete with an ACK
+             *
+             * @retval true     response sent or queued
+             * @retval false    not pending, or could not be queued (still pending)
+             *
+             * */
+            bool ack()
+            {
+                return complete("ACK:", nullptr);
+            }
+
+            /** Complete with an ACK followed by arguments
+             *
+             * @param[in] fn    closure for arguments
+             *
+             * @retval true     response sent or queued
+             * @retval false    not pending, or could not be queued (still pending)
+             *
+             * */
+            bool ack(const ArgumentClosure& fn)
+            {
+                return complete("ACK:", &fn);
+            }
+
+            /** Complete with an ACK followed by arguments
+             *
+             * @param[in] args  arguments (see is_argument)
+             *
+             * @retval true     response sent or queued
+             * @retval false    not pending, or could not be queued (still pending)
+             *
+             * */
+            template<typename... Args>
+            typename std::enable_if<(sizeof...(Args) > 0) && are_arguments<Args...>::value, bool>::type
+            ack(const Args&... args)
+            {
+                auto fn = [&](Stream& out){ Encoder e(out); put_arguments(e, args...); };
+
+                return complete("ACK:", &fn);
+            }
+
+            /** Complete with a NAK
+             *
+             * @param[in] reason    reason for NAK
+             *
+             * @retval true     response sent or queued
+             * @retval false    not pending, or could not be queued (still pending)
+             *
+             * */
+            bool nak(const char *reason)
+            {
+                auto fn = [reason](Stream& out){ Encoder(out).put_string(reason); };
+
+                return complete("NAK:", &fn);
+            }
+
+        private:
+
+            Server *server;
+
+            std::array<char, max_name> name;
+            size_t size;
+
+            // queued through the events queue when one is attached, otherwise
+            // written straight to the host
+            template<typename Fn>
+            bool complete(const char *prefix, const Fn& fn)
+            {
+                bool retval = false;
+
+                if(server != nullptr){
+
+                    if(server->events != nullptr){
+
+                        retval = server->events->post(prefix, full_name(), fn);
+                    }
+                    else{
+
+                        Output output(*server);
+                        Encoder e(output);
+
+                        e.put_string(prefix).put_string(full_name());
+
+                        if(fn != nullptr){
+
+                            e.space();
+                            Events::put_args(output, fn);
+                        }
+
+                        e.put_string("\r\n");
+
+                        output.line_complete();
+                        output.flush();
+
+                        retval = true;
+                    }
+
+                    if(retval){
+
+                        server = nullptr;
+                    }
+                }
+
+                return retval;
+            }
+        };
+
+        /** Represents the command that is being handled
+         *
+         * */
+        class Command {
+        public:
+
+            /// @private
+            Command(Server& server)
+                :
+                server(server)
+            {}
+
+            /** Command name
+             *
+             * @return command name
+             *
+             * */
+            StringView name()
+            {
+                return server.name;
+            }
+
+            /** Initiate an ACK
+             *
+             * */
+            void ack()
+            {
+                (void)server.state->ack(server);
+            }
+
+            /** Initiate an ACK that will be followed by arguments
+             *
+             * @return output stream
+             *
+             * */
+            Stream& ack_with_arg()
+            {
+                return Encoder(server.state->ack(server)).space().s;
+            }
+
+            /** Initiate an ACK followed by arguments
+             *
+             * @code
+             * cmd.ack(Bramble::kv("freq", freq), Bramble::hex(id, sizeof(id)));
+             * @endcode
+             *
+             * @param[in] args  arguments (see is_argument)
+             *
+             * */
+            template<typename... Args>
+            typename std::enable_if<(sizeof...(Args) > 0) && are_arguments<Args...>::value>::type
+            ack(const Args&... args)
+            {
+                Encoder e(ack_with_arg());
+
+                put_arguments(e, args...);
+            }
+
+            /** Initiate a NAK
+             *
+             * @param[in] reason    reason for NAK
+             *
+             * */
+            void nak(const char *reason)
+            {
+                return server.state->nak(server, reason);
+            }
+
+            /** Force server to end the ACK/NAK line and drain the output now rather than on
+             * return from the handler.
+             *
+             * */
+            void end()
+            {
+                server.state->end(server);
+            }
+
+            /** Detach this command from its handler so that it can be completed later
+             *
+             * The server will not send the default ACK when the handler returns and
+             * will go on to process the next line. Further responses through this
+             * Command are ignored.
+             *
+             * Cannot defer if the handler has already responded or if
+             * the command name is longer than Deferred::max_name. In that case the returned
+             * Deferred is not pending and the command completes as usual.
+             *
+             * @return Deferred
+             *
+             * */
+            Deferred defer()
+            {
+                return server.state->defer(server);
+            }
+
+            /** Get the user pointer that was attached to server instance
+             *
+             * */
+            void *ctx()
+            {
+                return server.get_ctx();
+            }
+
+            /** Get the session that issued this command
+             *
+             * @return session id
+             *
+             * @see Server::session()
+             *
+             * */
+            size_t session() const
+            {
+                return server.session();
+            }
+
+            /** The server instance */
+            Server& server;
+        };
+
+        /** Server host interface
+         *
+         * Anything a server instance may want from the host.
+         *
+         * This class will need to be subclassed when porting to a new host.
+         *
+         * */
+        class Host {
+        public:
+
+            virtual ~Host(){}
+
+            /// called everytime a line is received
+            virtual void line_was_rx()
+            {}
+
+            /// called everytime a line is sent, after it has been passed to write()
+            virtual void line_was_tx()
+            {}
+
+            enum class GetCharStatus {
+
+                Ok,
+                Blocked,
+                Error
+            };
+
+            /** put a character to the transport layer
+             *
+             * @param[in] c     character
+             *
+             * */
+            virtual void put_char(char c)
+            {
+                (void)c;
+            };
+
+            /** put a block of characters to the transport layer
+             *
+             * Server calls this with as much of a transaction as it can
+             * gather at once. The default implementation calls put_char() for
+             * each character.
+             *
+             * @param[in] buffer    characters
+             * @param[in] size      number of characters
+             *
+             * */
+            virtual void write(const char *buffer, size_t size)
+            {
+                for(auto iter = buffer; iter != (buffer + size); ++iter){
+
+                    put_char(*iter);
+                }
+            }
+
+            /** block until output buffer has been emptied */
+            virtual void drain()
+            {};
+
+            /** get a character from the transport layer
+             *
+             * @param[out] c        output character
+             *
+             * @retval GetCharStatus::Ok
+             * @retval GetCharStatus::Error
+             * @retval GetCharStatus::Blocked
+             *
+             * */
+            virtual GetCharStatus get_char(char& c)
+            {
+                (void)c;
+                return GetCharStatus::Blocked;
+            };
+
+            /** get a block of characters from the transport layer
+             *
+             * Override this if the transport already holds received characters in
+             * bulk (e.g. a FIFO, DMA buffer or socket). The default implementation
+             * calls get_char() until it stops returning GetCharStatus::Ok or
+             * the buffer is full.
+             *
+             * @param[out] buffer   output buffer
+             * @param[in] max       size of buffer
+             *
+             * @return number of characters written to buffer (0 if none available)
+             *
+             * */
+            virtual size_t read(char *buffer, size_t max)
+            {
+                size_t retval = 0;
+
+                while((retval < max) && get_char_status_ok(get_char(buffer[retval]))){
+
+                    retval++;
+                }
+
+                return retval;
+            }
+
+            /** call to evaluate the status code
+             *
+             * @param[in] status
+             *
+             * @retval true     character is valid
+             *
+             * */
+            static bool get_char_status_ok(GetCharStatus status)
+            {
+                return (status == GetCharStatus::Ok);
+            }
+
+            /** Lookup and execute a command handler by name
+             *
+             * @note The command name is accessible from Command::name()
+             *
+             * @param[in] cmd       the command being handled
+             * @param[in] args      arguments
+             *
+             * @retval true         handler exists and was called
+             * @retval false        no handler exists for command name
+             *
+             * */
+            virtual bool call(Command& cmd, const Argument& args)
+            {
+                (void)cmd;
+                (void)args;
+                return false;
+            }
+        };
+
+        /** A fixed capacity queue of received lines
+         *
+         * When a queue is attached to a server (see set_queue()) complete lines are
+         * queued as they are received and then dispatched one at a time by step().
+         * This lets the transport be drained while a handler is running elsewhere in the
+         * main loop, and lets clients send several commands without waiting for each
+         * response.
+         *
+         * Lines are tokenized when they are dispatched.
+         *
+         * Storage is provided by a subclass, see LineQueue.
+         *
+         * @note a queue is not thread safe; process() and step() must be
+         * called from the same context and not from within a handler
+         *
+         * */
+        class Queue {
+        public:
+
+            /** what to do with a line that arrives when the queue is full */
+            enum class Overflow {
+
+                Reject,     ///< NAK the command with reason "queue_full"
+                DropNewest, ///< NAK the line that was queued most recently with reason "dropped" and queue the line that just arrived
+                DropOldest  ///< NAK the line that has been queued the longest with reason "dropped" and queue the line that just arrived
+            };
+
+            /** number of lines waiting to be dispatched
+             *
+             * */
+            size_t size() const
+            {
+                return count;
+            }
+
+            /** maximum number of lines that can be queued
+             *
+             * */
+            size_t capacity() const
+            {
+                return depth;
+            }
+
+            /** number of lines that have been rejected or dropped
+             *
+             * Every rejected or dropped line is NAKed.
+             *
+             * */
+            size_t dropped() const
+            {
+                return drop_count;
+            }
+
+            /** largest line that can be queued
+             *
+             * */
+            size_t max_line_size() const
+            {
+                return line_size - 1U;
+            }
+
+        protected:
+
+            /** Create a queue
+             *
+             * @param[in] storage       depth * (max_line + 1) characters
+             * @param[in] depth         number of lines
+             * @param[in] max_line      largest line that can be queued
+             * @param[in] overflow      overflow policy
+             *
+             * */
+            Queue(char *storage, size_t depth, size_t max_line, Overflow overflow)
+                :
+                storage(storage),
+                depth(depth),
+                line_size(max_line + 1U),
+                overflow(overflow),
+                head(0),
+                count(0),
+                drop_count(0)
+            {
+            }
+
+            Queue(const Queue&) = delete;
+            Queue& operator=(const Queue&) = delete;
+
+        private:
+
+            friend class Server;
+
+            char *storage;
+            const size_t depth;
+            const size_t line_size;
+            const Overflow overflow;
+
+            size_t head;
+            size_t count;
+            size_t drop_count;
+
+            char *slot(size_t i)
+            {
+                return &storage[((head + i) % depth) * line_size];
+            }
+
+            bool full() const
+            {
+                return count == depth;
+            }
+
+            // queue must not be full
+            void push(const char *line, size_t size)
+            {
+                auto s = slot(count);
+
+                (void)memcpy(s, line, size);
+                s[size] = 0;
+                count++;
+            }
+
+            char *front()
+            {
+                return slot(0);
+            }
+
+            char *back()
+            {
+                return slot(count - 1U);
+            }
+
+            void pop()
+            {
+                head = (head + 1U) % depth;
+                count--;
+            }
+
+            void pop_back()
+            {
+                count--;
+            }
+        };
+
+        /** A bounded queue of event and log lines raised outside of the server's context
+         *
+         * Server::event() and Server::log() write straight to the output and so
+         * cannot be called while another context may be writing a response. Events
+         * raised through an attached queue (see set_events()) are formatted by the
+         * producer into a free slot and written by process() between
+         * transactions.
+         *
+         * Any number of producers (threads or interrupts) may post concurrently with
+         * each other and with the server. Producers never block: if the queue is full,
+         * or the line does not fit in a slot, the line is dropped and counted.
+         *
+         * Storage is provided by a subclass, see EventQueue.
+         *
+         * @note relies on std::atomic<size_t> being lock-free on your target
+         *
+         * */
+        class Events {
+        public:
+
+            /** Post an event
+             *
+             * @param[in] name     event name
+             *
+             * @retval true     event queued
+             * @retval false    event dropped
+             *
+             * */
+            bool event(const char *name)
+            {
+                return post("EVT: ", name, nullptr);
+            }
+
+            /** @copydoc event(const char *)
+             *
+             * @param[in] fn    callable taking a Stream& for additional arguments
+             *
+             *  */
+            template<typename Fn>
+            typename std::enable_if<!is_argument<Fn>::value, bool>::type
+            event(const char *name, const Fn& fn)
+            {
+                return post("EVT: ", name, &fn);
+            }
+
+            /** @copydoc event(const char *)
+             *
+             * @param[in] args  arguments (see is_argument)
+             *
+             *  */
+            template<typename... Args>
+            typename std::enable_if<(sizeof...(Args) > 0) && are_arguments<Args...>::value, bool>::type
+            event(const char *name, const Args&... args)
+            {
+                auto fn = [&](Stream& out){ Encoder e(out); put_arguments(e, args...); };
+
+                return post("EVT: ", name, &fn);
+            }
+
+            /** Post a log message
+             *
+             * @param[in] s     message
+             *
+             * @retval true     message queued
+             * @retval false    message dropped
+             *
+             * */
+            bool log(const char *s)
+            {
+                return post("LOG: ", s, nullptr);
+            }
+
+            /** @copydoc log(const char *)
+             *
+             * @param[in] fn    callable taking a Stream& for additional arguments
+             *
+             * */
+            template<typename Fn>
+            typename std::enable_if<!is_argument<Fn>::value, bool>::type
+            log(const char *s, const Fn& fn)
+            {
+                return post("LOG: ", s, &fn);
+            }
+
+            /** @copydoc log(const char *)
+             *
+             * @param[in] args  arguments (see is_argument)
+             *
+             * */
+            template<typename... Args>
+            typename std::enable_if<(sizeof...(Args) > 0) && are_arguments<Args...>::value, bool>::type
+            log(const char *s, const Args&... args)
+            {
+                auto fn = [&](Stream& out){ Encoder e(out); put_arguments(e, args...); };
+
+                return post("LOG: ", s, &fn);
+            }
+
+            /** number of lines that have been dropped
+             *
+             * */
+            size_t dropped() const
+            {
+                return drop_count.load(std::memory_order_relaxed);
+            }
+
+            /** maximum number of lines that can be queued
+             *
+             * */
+            size_t capacity() const
+            {
+                return depth;
+            }
+
+            /** largest line (excluding line ending) that can be queued
+             *
+             * */
+            size_t max_line_size() const
+            {
+                return line_size - 1U;
+            }
+
+        protected:
+
+            /** Create a queue
+             *
+             * @param[in] sequence  depth sequence numbers
+             * @param[in] sizes     depth line sizes
+             * @param[in] storage   depth * (max_line + 1) characters
+             * @param[in] depth     number of lines (a power of two, at least 2)
+             * @param[in] max_line  largest line that can be queued
+             *
+             * @note call init() once storage has been constructed
+             *
+             * */
+            Events(std::atomic<size_t> *sequence, size_t *sizes, char *storage, size_t depth, size_t max_line)
+                :
+                sequence(sequence),
+                sizes(sizes),
+                storage(storage),
+                depth(depth),
+                line_size(max_line + 1U),
+                tail(0),
+                head(0),
+                drop_count(0)
+            {
+            }
+
+            Events(const Events&) = delete;
+            Events& operator=(const Events&) = delete;
+
+            /** Mark every slot as free
+             *
+             * */
+            void init()
+            {
+                for(size_t i = 0; i < depth; i++){
+
+                    sequence[i].store(i, std::memory_order_relaxed);
+                }
+            }
+
+        private:
+
+            friend class Server;
+
+            // Each slot has a sequence number that says whose turn it is: equal to
+            // the position when free for a producer, position + 1 when full for
+            // the consumer.
+            std::atomic<size_t> *sequence;
+            size_t *sizes;
+            char *storage;
+            const size_t depth;
+            const size_t line_size;
+
+            std::atomic<size_t> tail;
+            size_t head;
+            std::atomic<size_t> drop_count;
+
+            template<typename Fn>
+            static void put_args(Stream& s, const Fn *fn)
+            {
+                (*fn)(s);
+            }
+
+            static void put_args(Stream&, std::nullptr_t)
+            {
+            }
+
+            template<typename Fn>
+            bool post(const char *prefix, const StringView& s, const Fn& fn)
+            {
+                bool retval = false;
+                size_t pos = tail.load(std::memory_order_relaxed);
+
+                for(;;){
+
+                    auto seq = sequence[pos & (depth - 1U)].load(std::memory_order_acquire);
+                    auto diff = intptr_t(seq) - intptr_t(pos);
+
+                    if(diff == 0){
+
+                        if(tail.compare_exchange_weak(pos, pos + 1U, std::memory_order_relaxed)){
+
+                            retval = true;
+                            break;
+                        }
+                    }
+                    else if(diff < 0){
+
+                        // full
+                        break;
+                    }
+                    else{
+
+                        pos = tail.load(std::memory_order_relaxed);
+                    }
+                }
+
+                if(retval){
+
+                    auto i = pos & (depth - 1U);
+                    BufferStream line(&storage[i * line_size], line_size);
+
+                    Encoder(line).put_string(prefix).put_string(s);
+
+                    if(fn != nullptr){
+
+                        Encoder(line).space();
+                        put_args(line, fn);
+                    }
+
+                    if(line.eof()){
+
+                        // slot is already claimed so publish it as empty
+                        sizes[i] = 0;
+                        retval = false;
+                    }
+                    else{
+
+                        sizes[i] = line.tell();
+                    }
+
+                    sequence[i].store(pos + 1U, std::memory_order_release);
+                }
+
+                if(!retval){
+
+                    drop_count.fetch_add(1U, std::memory_order_relaxed);
+                }
+
+                return retval;
+            }
+
+            // single consumer
+            bool front(StringView& line)
+            {
+                auto i = head & (depth - 1U);
+                bool retval = (sequence[i].load(std::memory_order_acquire) == (head + 1U));
+
+                if(retval){
+
+                    line = StringView(&storage[i * line_size], sizes[i]);
+                }
+
+                return retval;
+            }
+
+            void pop()
+            {
+                sequence[head & (depth - 1U)].store(head + depth, std::memory_order_release);
+                head++;
+            }
+        };
+
+        /** Create a new server instance
+         *
+         * Lines with more than max_args tokens are still handled but argument access
+         * is no longer O(1).
+         *
+         * @param[in] host      host interface
+         * @param[in] max_line  largest line server can receive
+         * @param[in] max_args  number of tokens to index per line
+         *
+         * */
+        Server(Host& host, size_t max_line = 1024, size_t max_args = 32)
+            :
+            host(host),
+            output(*this),
+            state(&Idle::instance()),
+            ctx(nullptr),
+            size(0),
+            end_offset(max_line),
+            index_max(max_args),
+            owned(true),
+            id(0),
+            queue(nullptr),
+            events(nullptr)
+        {
+            buffer = new char[max_line+1];
+            index = (max_args > 0) ? new StringView[max_args] : nullptr;
+
+            (void)memset(buffer, 0, max_line+1);
+        }
+
+        /** Create a new server instance that uses storage provided by the caller
+         *
+         * The storage must outlive the server and is not released by it.
+         *
+         * @param[in] host      host interface
+         * @param[in] buffer    line buffer (must be at least max_line + 1 characters)
+         * @param[in] max_line  largest line server can receive
+         * @param[in] index     token index (may be nullptr if max_args is 0)
+         * @param[in] max_args  number of tokens to index per line
+         * @param[in] session   session id (available from Command::session())
+         *
+         * */
+        Server(Host& host, char *buffer, size_t max_line, StringView *index, size_t max_args, size_t session = 0)
+            :
+            host(host),
+            output(*this),
+            state(&Idle::instance()),
+            ctx(nullptr),
+            buffer(buffer),
+            size(0),
+            end_offset(max_line),
+            index(index),
+            index_max((index != nullptr) ? max_args : 0),
+            owned(false),
+            id(session),
+            queue(nullptr),
+            events(nullptr)
+        {
+            (void)memset(buffer, 0, max_line+1);
+        }
+
+        Server(const Server&) = delete;
+        Server& operator=(const Server&) = delete;
+
+        /** Destroy this server
+         *
+         * */
+        ~Server()
+        {
+            if(owned){
+
+                delete[] buffer;
+                delete[] index;
+            }
+        }
+
+        /** Process input characters from Host::read()
+         *
+         * Most useful if your transport layer has a queue that needs to be polled for
+         * updates. Characters are read in chunks until Host::read() returns zero.
+         *
+         * @see process(const char*,size_t) if your server receives strings directly
+         *
+         * */
+        void process()
+        {
+            std::array<char, 64> chunk;
+            size_t n;
+
+            do{
+
+                n = host.read(chunk.data(), chunk.size());
+
+                process(chunk.data(), n);
+            }
+            while(n > 0);
+        }
+
+        /** Process input characters direct from buffer
+         *
+         * Most useful if your transport layer delivers messages directly into your application.
+         *
+         * @see alternative to process() if your server polls an existing queue infrastructure
+         *
+         * */
+        void process(const char *buffer, size_t size)
+        {
+            auto end = buffer + size;
+
+            put_events();
+
+            for(auto iter = buffer; iter != end;){
+
+                iter = state->input(*this, iter, end);
+            }
+        }
+
+        /** Write event and log lines raised through an Events queue
+         *
+         * @param[in] events    queue to drain from process() (nullptr to detach)
+         *
+         * */
+        void set_events(Events *events)
+        {
+            this->events = events;
+        }
+
+        /** Queue received lines instead of dispatching them from process()
+         *
+         * Lines that are already queued remain in the previous queue.
+         *
+         * @param[in] queue     queue to use (nullptr to dispatch from process())
+         *
+         * @retval true     queue attached
+         * @retval false    queue cannot hold lines of max_line_size()
+         *
+         * */
+        bool set_queue(Queue *queue)
+        {
+            bool retval = false;
+
+            if((queue == nullptr) || (queue->max_line_size() >= end_offset)){
+
+                this->queue = queue;
+                retval = true;
+            }
+
+            return retval;
+        }
+
+        /** Dispatch the oldest queued line
+         *
+         * @retval true     a line was dispatched
+         * @retval false    queue is empty or not attached
+         *
+         * */
+        bool step()
+        {
+            bool retval = false;
+
+            if((queue != nullptr) && (queue->size() > 0U)){
+
+                Handle::dispatch(*this, queue->front(), nullptr);
+                queue->pop();
+                retval = true;
+            }
+            else{
+
+                put_events();
+            }
+
+            return retval;
+        }
+
+        /** Block until output buffer becomes empty */
+        void drain()
+        {
+            output.drain();
+        }
+
+        /** Attach a user pointer which can be accessed in command handler
+         *
+         * */
+        void set_ctx(void *ctx)
+        {
+            this->ctx = ctx;
+        }
+
+        /** send an event
+         *
+         * @param[in] name     event name
+         *
+         * */
+        void event(const char *name)
+        {
+            Encoder(output).put_string("EVT: ").put_string(name);
+            put_line_end();
+            output.flush();
+        }
+
+        /** @copydoc event(const char *)
+         *
+         * @param[in] fn    closure for additional arguments
+         *
+         *  */
+        void event(const char *name, const ArgumentClosure& fn)
+        {
+            Encoder(output).put_string("EVT: ").put_string(name).space();
+            fn(output);
+            put_line_end();
+            output.flush();
+        }
+
+        /** @copydoc event(const char *)
+         *
+         * Each argument is formatted according to its type and the line is
+         * passed to the host in as few writes as possible:
+         *
+         * @code
+         * server.event("rx_done", Bramble::kv("rssi", rssi), Bramble::kv("snr", snr), Bramble::hex(buf, n));
+         * @endcode
+         *
+         * @param[in] args  arguments (see is_argument)
+         *
+         *  */
+        template<typename... Args>
+        typename std::enable_if<(sizeof...(Args) > 0) && are_arguments<Args...>::value>::type
+        event(const char *name, const Args&... args)
+        {
+            Encoder e(output);
+
+            e.put_string("EVT: ").put_string(name).space();
+            put_arguments(e, args...);
+            put_line_end();
+            output.flush();
+        }
+
+        /** Send a log message
+         *
+         * @param[in] s     message
+         *
+         * */
+        void log(const char *s)
+        {
+            Encoder(output).put_string("LOG: ").put_string(s);
+            put_line_end();
+            output.flush();
+        }
+
+        /** @copydoc log(const char *)
+         *
+         * @param[in] fn    closure for additional arguments
+         *
+         * */
+        void log(const char *s, const ArgumentClosure& fn)
+        {
+            Encoder(output).put_string("LOG: ").put_string(s).space();
+            fn(output);
+            put_line_end();
+            output.flush();
+        }
+
+        /** @copydoc log(const char *)
+         *
+         * @param[in] args  arguments (see is_argument)
+         *
+         * */
+        template<typename... Args>
+        typename std::enable_if<(sizeof...(Args) > 0) && are_arguments<Args...>::value>::type
+        log(const char *s, const Args&... args)
+        {
+            Encoder e(output);
+
+            e.put_string("LOG: ").put_string(s).space();
+            put_arguments(e, args...);
+            put_line_end();
+            output.flush();
+        }
+
+        /** Send without a prefix
+         *
+         * @param[in] s     message
+         *
+         * */
+        void no_prefix(const char *s)
+        {
+            Encoder(output).put_string(s);
+            put_line_end();
+            output.flush();
+        }
+
+        /** @copydoc no_prefix(const char *)
+         *
+         * @param[in] fn    closure for additional arguments
+         *
+         * */
+        void no_prefix(const char *s, const ArgumentClosure& fn)
+        {
+            Encoder(output).put_string(s);
+            fn(output);
+            put_line_end();
+            output.flush();
+        }
+
+        /** Get the maximum line size server able to echo and acknowledge
+         *
+         * @return maximum line size
+         *
+         * */
+        constexpr size_t max_line_size() const
+        {
+            return end_offset;
+        }
+
+        /** Get the session id of this server
+         *
+         * A server that was not given a session id is session 0.
+         *
+         * @return session id
+         *
+         * */
+        size_t session() const
+        {
+            return id;
+        }
+
+    private:
+
+        class State {
+        public:
+            virtual void before(Server&) const {}
+            virtual void after(Server&) const {}
+
+            virtual void input(Server&, char) const {}
+
+            // consume as much of [begin, end) as this state can, returning where it stopped
+            virtual const char *input(Server& self, const char *begin, const char *end) const
+            {
+                (void)end;
+                input(self, *begin);
+                return begin + 1;
+            }
+
+            virtual Stream& ack(Server& self) const { return self.output; }
+            virtual void nak(Server&, const char *) const {}
+            virtual void end(Server&) const {}
+            virtual Deferred defer(Server&) const { return Deferred(); }
+        };
+
+        class Idle : public State {
+        public:
+
+            static State& instance(){
+                static Idle inst;
+                return inst;
+            }
+
+            void before(Server& self) const
+            {
+                self.size = 0;
+                self.buffer[self.size] = 0;
+                self.name = StringView();
+            }
+
+            void input(Server& self, char c) const
+            {
+                if(std::isprint(c)){
+
+                    if(self.size < self.end_offset){
+
+                        self.buffer[self.size] = c;
+                        self.size++;
+                        self.buffer[self.size] = 0;
+                    }
+                    else{
+
+                        self.set_state(TooLong::instance());
+                    }
+                }
+                else if((c == '\r') && (self.size > 0U)){
+
+                    if(self.queue == nullptr){
+
+                        Handle::dispatch(self, self.buffer, nullptr);
+                    }
+                    else{
+
+                        // dispatched by step()
+                        self.enqueue(self.buffer, self.size);
+                    }
+
+                    self.set_state(Idle::instance());
+                }
+                else{
+
+                    // keep listening
+                }
+            }
+
+            const char *input(Server& self, const char *begin, const char *end) const
+            {
+                auto eol = static_cast<const char *>(memchr(begin, '\r', end - begin));
+                auto run_end = (eol != nullptr) ? eol : end;
+                auto retval = run_end;
+
+                for(auto iter = begin; iter != run_end;){
+
+                    auto run = iter;
+
+                    while((run != run_end) && std::isprint(*run)){
+
+                        ++run;
+                    }
+
+                    auto n = std::min(size_t(run - iter), self.end_offset - self.size);
+
+                    (void)memcpy(&self.buffer[self.size], iter, n);
+                    self.size += n;
+                    self.buffer[self.size] = 0;
+
+                    if((iter + n) != run){
+
+                        // the character that didn't fit is consumed by the transition
+                        self.set_state(TooLong::instance());
+                        retval = iter + n + 1;
+                        eol = nullptr;
+                        break;
+                    }
+
+                    while((run != run_end) && !std::isprint(*run)){
+
+                        ++run;
+                    }
+
+                    iter = run;
+                }
+
+                if(eol != nullptr){
+
+                    input(self, *eol);
+                    retval++;
+                }
+
+                return retval;
+            }
+        };
+
+        class Handle : public State {
+
+            static void detect_command_name(Server& self, Argument& args)
+            {
+                bool matched = true;
+
+                self.full_name = Decoder::strip(args.pop_front());
+
+                auto id_offset = self.full_name.find_first_of('#');
+
+                self.name = self.full_name.substr(0, id_offset);
+
+                if(id_offset == 0){
+
+                    matched = false;
+                }
+                else if(id_offset != StringView::npos){
+
+                    self.invoke_id = self.full_name.substr(id_offset + 1);
+                }
+                else{
+
+                    self.invoke_id = StringView();
+                }
+
+                // [a-zA-Z0-9_]+
+                for(auto iter = self.name.begin(); iter != self.name.end(); ++iter){
+
+                    if(!std::isupper(*iter) && !std::islower(*iter) && !std::isdigit(*iter) && (*iter != '_')){
+
+                        matched = false;
+                        break;
+                    }
+                }
+
+                // [0-9]+
+                if(self.invoke_id.empty()){
+
+                    if(id_offset != StringView::npos){
+
+                        matched = false;
+                    }
+                }
+                else{
+
+                    for(auto iter = self.invoke_id.begin(); iter != self.invoke_id.end(); ++iter){
+
+                        if(!std::isdigit(*iter)){
+
+                            matched = false;
+                            break;
+                        }
+                    }
+                }
+
+                if(!matched){
+
+                    self.name = self.full_name;
+                    self.invoke_id = StringView();
+                }
+            }
+
+        public:
+
+            static State& instance()
+            {
+                static Handle inst;
+                return inst;
+            }
+
+            // handle a complete line
+            //
+            // The receiving state is put aside while the handler runs so that a
+            // line can be dispatched from the queue without disturbing a line
+            // that is still being received. If reject is not nullptr the command
+            // is NAKed with that reason instead of being passed to the host.
+            static void dispatch(Server& self, char *line, const char *reject)
+            {
+                auto resume = self.state;
+
+                self.state = &Handle::instance();
+
+                self.host.line_was_rx();
+
+                self.put_cmd(line);
+                self.put_tx_line_end();
+
+                // will mutate contents of line into sequence of null-terminated strings
+                Argument args(line, line, self.end_offset, self.index, self.index_max);
+                Command cmd(self);
+
+                if(!args.empty()){
+
+                    detect_command_name(self, args);
+
+                    if(reject != nullptr){
+
+                        self.put_nak(reject);
+                        self.put_tx_line_end();
+                    }
+                    else if(!self.host.call(cmd, args)){
+
+                        self.put_nak("unknown_command");
+                        self.put_tx_line_end();
+                    }
+                    else{
+
+                        // default response is always ack
+                        if(self.state == &Handle::instance()){
+
+                            self.put_ack();
+                            self.put_tx_line_end();
+                        }
+                    }
+                }
+
+                self.set_state(Done::instance());
+
+                self.state = resume;
+
+                self.put_events();
+            }
+
+            Stream& ack(Server& self) const
+            {
+                self.set_state(Responding::instance());
+                self.put_ack();
+
+                return self.output;
+            }
+
+            void nak(Server& self, const char *reason) const
+            {
+                self.set_state(Responding::instance());
+                self.put_nak(reason);
+            }
+
+            void end(Server& self) const
+            {
+                self.set_state(Responding::instance());
+                self.state->end(self);
+            }
+
+            Deferred defer(Server& self) const
+            {
+                Deferred retval;
+
+                if(self.full_name.size() <= Deferred::max_name){
+
+                    self.set_state(Done::instance());
+                    retval = Deferred(self, self.full_name);
+                }
+
+                return retval;
+            }
+        };
+
+        // response has been sent or will be sent by a Deferred
+        class Done : public State {
+        public:
+            static State& instance()
+            {
+                static Done inst;
+                return inst;
+            }
+
+            void before(Server& self) const
+            {
+                // end of transaction
+                self.output.flush();
+            }
+
+            Stream& ack(Server&) const
+            {
+                static Stream discard;
+                return discard;
+            }
+        };
+
+        class Responding : public State {
+        public:
+            static State& instance()
+            {
+                static Responding inst;
+                return inst;
+            }
+
+            Stream& ack(Server& self) const
+            {
+                return self.output;
+            }
+
+            void end(Server& self) const
+            {
+                self.set_state(Done::instance());
+            }
+
+            void after(Server& self) const
+            {
+                self.put_tx_line_end();
+            }
+        };
+
+        class TooLong : public State {
+        public:
+
+            static State& instance()
+            {
+                static TooLong inst;
+                return inst;
+            }
+
+            void input(Server& self, char c) const
+            {
+                if(c == '\r'){
+
+                    self.set_state(Idle::instance());
+                }
+            }
+
+            const char *input(Server& self, const char *begin, const char *end) const
+            {
+                auto retval = end;
+                auto eol = static_cast<const char *>(memchr(begin, '\r', end - begin));
+
+                if(eol != nullptr){
+
+                    input(self, *eol);
+                    retval = eol + 1;
+                }
+
+                return retval;
+            }
+        };
+
+        // server output stream
+        //
+        // Gathers output into a small buffer so that a transaction reaches
+        // the host in as few Host::write() calls as possible.
+        //
+        // Host::line_was_tx() is deferred until the lines it reports have
+        // been passed to Host::write().
+        class Output final : public Stream {
+        public:
+
+            Output(Server& server)
+                :
+                server(&server),
+                pos(0),
+                lines(0)
+            {
+            }
+
+            Output()
+                :
+                server(nullptr),
+                pos(0),
+                lines(0)
+            {
+            }
+
+            size_t write(const void *buffer, size_t size)
+            {
+                if(server != nullptr){
+
+                    if(size > (pending.size() - pos)){
+
+                        flush();
+                    }
+
+                    if(size >= pending.size()){
+
+                        server->host.write((const char *)buffer, size);
+                    }
+                    else{
+
+                        (void)memcpy(&pending[pos], buffer, size);
+                        pos += size;
+                    }
+                }
+
+                return size;
+            }
+
+            void flush()
+            {
+                if(server != nullptr){
+
+                    if(pos > 0){
+
+                        server->host.write(pending.data(), pos);
+                        pos = 0;
+                    }
+
+                    while(lines > 0){
+
+                        lines--;
+                        server->host.line_was_tx();
+                    }
+                }
+            }
+
+            // a line has been completed and shall be reported on the next flush
+            void line_complete()
+            {
+                lines++;
+            }
+
+            void drain()
+            {
+                if(server != nullptr){
+
+                    flush();
+                    server->host.drain();
+                }
+            }
+
+        private:
+
+            Server *server;
+
+            std::array<char, 128> pending;
+            size_t pos;
+            size_t lines;
+        };
+
+        Host& host;
+
+        Output output;
+
+        const State *state;
 
-        /** decode a string
-         *
-         * @param[in] s     string
-         * @param[in] size  size of string
-         *
-         * */
-        Decoder(const char *s, size_t size)
-            :
-            input(s, size)
-        {
-        }
+        void *ctx;
 
-        /** decode a string view
-         *
-         * @param[in] v     string view
-         *
-         * */
-        Decoder(const StringView& v)
-            :
-            input(v)
+        void set_state(const State& value)
         {
+            state->after(*this);
+            state = &value;
+            state->before(*this);
         }
 
-        Decoder(const Decoder& other)
-            :
-            input(other.input)
-        {
-        }
+        char *buffer;
+        size_t size;
+        const size_t end_offset;
 
-        const Decoder& operator=(const Decoder& other)
-        {
-            input = other.input;
-            return *this;
-        }
+        StringView *index;
+        const size_t index_max;
 
-        void swap(Decoder& other)
-        {
-            auto tmp = other.input;
-            other.input = input;
-            input = tmp;
-        }
+        const bool owned;
+        const size_t id;
 
-        /** Test if input is a named argument
-         *
-         * @retval true     argument is named
-         * @retval false    argument is not named
-         *
-         * */
-        bool is_named() const
+        Queue *queue;
+        Events *events;
+
+        StringView name;
+        StringView full_name;
+        StringView invoke_id;
+
+        void put_cmd(const char *line)
         {
-            return input.find_first_of('=') != input.npos;
+            Encoder(output)
+                .put_string("CMD:")
+                .put_string(line);
         }
 
-        /** Get the name of a named argument
-         *
-         * @return StringView
-         *
-         * */
-        StringView name() const
+        void put_nak(const char *msg)
         {
-            return is_named() ? strip(input).substr(0, strip(input).find_first_of('=')) : StringView();
+            Encoder(output)
+                .put_string("NAK:")
+                .put_string(full_name)
+                .space()
+                .put_string(msg);
         }
 
-        /** Get the value associated with name()
-         *
-         * @return StringView
-         *
-         * */
-        StringView named_value() const
+        void put_ack()
         {
-            return input.substr(input.find_first_of('=')+1);
+            Encoder(output)
+                .put_string("ACK:")
+                .put_string(full_name);
         }
 
-        /** Get the input value as-is
-         *
-         * @return StringView
-         *
-         * */
-        StringView value() const
+        void put_line_end()
         {
-            return input;
+            Encoder(output).put_string("\r\n");
         }
 
-        /** Test named argument name
-         *
-         * @param[in] v     expected name
-         *
-         * @retval true     v == name()
-         * @retval false    v != name()
-         *
-         * */
-        bool name_eq(const char *v) const
+        // end a CMD/ACK/NAK line
+        void put_tx_line_end()
         {
-            return name_eq(StringView(v));
+            put_line_end();
+            output.line_complete();
         }
 
-        /// @copydoc name_eq(const char *) const
-        bool name_eq(const StringView v) const
+        // a line that cannot be queued is NAKed so that every line is answered
+        void enqueue(char *line, size_t size)
         {
-            return is_named() && (name().compare(v) == 0);
+            if(queue->full()){
+
+                queue->drop_count++;
+
+                switch(queue->overflow){
+                default:
+                case Queue::Overflow::Reject:
+                    Handle::dispatch(*this, line, "queue_full");
+                    break;
+                case Queue::Overflow::DropNewest:
+                    Handle::dispatch(*this, queue->back(), "dropped");
+                    queue->pop_back();
+                    queue->push(line, size);
+                    break;
+                case Queue::Overflow::DropOldest:
+                    Handle::dispatch(*this, queue->front(), "dropped");
+                    queue->pop();
+                    queue->push(line, size);
+                    break;
+                }
+            }
+            else{
+
+                queue->push(line, size);
+            }
         }
 
-        /** Test if value() is a boolean
-         *
-         * @retval true     value() is
-         * @retval false    value() is not
-         *
-         * */
-        bool is_bool() const
+        static bool is_response(const StringView& line)
         {
-            bool v;
-            return get_bool(v);
+            return (line.size() >= 4U) && ((memcmp(line.data(), "ACK:", 4) == 0) || (memcmp(line.data(), "NAK:", 4) == 0));
         }
 
-        /** Test if value() is integer (signed or unsigned)
-         *
-         * @retval true     value() is
-         * @retval false    value() is not
-         *
-         * */
-        bool is_int() const
+        // only called between transactions
+        void put_events()
         {
-            bool retval = false;
-
-            auto tmp = strip(input);
-
-            if(!tmp.empty()){
+            if(events != nullptr){
 
-                if(tmp.front() == '-'){
+                StringView line;
 
-                    tmp.remove_prefix(1);
-                }
+                while(events->front(line)){
 
-                retval = true;
+                    if(line.empty()){
 
-                for(auto iter = tmp.begin(); (iter != tmp.end()) && retval; ++iter){
+                        // dropped
+                    }
+                    else if(is_response(line)){
 
-                    if((*iter < '0') || (*iter > '9')){
+                        // completed by a Deferred
+                        Encoder(output).put_string(line);
+                        put_tx_line_end();
+                    }
+                    else{
 
-                        retval = false;
+                        Encoder(output).put_string(line);
+                        put_line_end();
                     }
+
+                    events->pop();
                 }
-            }
 
-            return retval;
+                output.flush();
+            }
         }
 
-        /** Test if value() is unsigned integer
-         *
-         * @retval true     value() is
-         * @retval false    value() is not
-         *
-         * */
-        bool is_unsigned() const
+        void *get_ctx()
         {
-            bool retval = false;
+            return ctx;
+        }
+    };
+};
+
+#endif
+/* #include "bramble_static_server.hpp" */
+/* Copyright (c) 2024 Cameron Harper
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ *
+ */
 
-            auto tmp = strip(input);
+#ifndef BRAMBLE_STATIC_SERVER_H_INCLUDED
+#define BRAMBLE_STATIC_SERVER_H_INCLUDED
 
-            if(!tmp.empty()){
+/* #include "bramble_server.hpp" first included at line 113 */
+/* #include "bramble_string_view.hpp" first included at line 231 */
 
-                retval = true;
+#include <cstddef>
+#include <array>
 
-                for(auto iter = tmp.begin(); (iter != tmp.end()) && retval; ++iter){
+namespace Bramble {
 
-                    if((*iter < '0') || (*iter > '9')){
+    /// @private
+    template<size_t MaxLine, size_t MaxArgs>
+    class StaticServerStorage {
+    protected:
 
-                        retval = false;
-                    }
-                }
-            }
+        std::array<char, MaxLine + 1> buffer;
+        std::array<StringView, MaxArgs> index;
 
-            return retval;
+        StringView *index_data()
+        {
+            return (MaxArgs > 0) ? index.data() : nullptr;
         }
+    };
 
-        /** Remove whitespace from before and after non-whitespace characters
-         *
-         * @param[in] v     input string
+    /** A Server with inline storage
+     *
+     * Equivalent to Server but the line buffer and token index are members rather than
+     * being allocated, so a StaticServer can be a global or live on the stack.
+     *
+     * @code
+     * static YourHost host;
+     * static Bramble::StaticServer<128, 8> server(host);
+     * @endcode
+     *
+     * @tparam MaxLine  largest line server can receive
+     * @tparam MaxArgs  number of tokens to index per line
+     *
+     * */
+    template<size_t MaxLine = 1024, size_t MaxArgs = 32>
+    class StaticServer : private StaticServerStorage<MaxLine, MaxArgs>, public Server {
+    private:
+
+        using Storage = StaticServerStorage<MaxLine, MaxArgs>;
+
+    public:
+
+        static_assert(MaxLine > 0, "line must have at least one character");
+
+        /** Create a new server instance
          *
-         * @return StringView
+         * @param[in] host      host interface
+         * @param[in] session   session id (available from Command::session())
          *
          * */
-        static StringView strip(const StringView& v)
+        StaticServer(Host& host, size_t session = 0)
+            :
+            Storage(),
+            Server(host, Storage::buffer.data(), MaxLine, Storage::index_data(), MaxArgs, session)
         {
-            StringView retval(v);
-
-            if(!retval.empty()){
+        }
+    };
+};
 
-                for(auto iter=retval.begin(); (iter != retval.end()) && std::isspace(*iter); ++iter){
+#endif
+/* #include "bramble_registry.hpp" */
+/* Copyright (c) 2024 Cameron Harper
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ *
+ */
 
-                    retval.remove_prefix(1);
-                }
+#ifndef BRAMBLE_REGISTRY_H_INCLUDED
+#define BRAMBLE_REGISTRY_H_INCLUDED
 
-                for(auto iter=retval.rbegin(); (iter != retval.rend()) && std::isspace(*iter); ++iter){
+/* #include "bramble_server.hpp" first included at line 113 */
+/* #include "bramble_hash.hpp" first included at line 1439 */
+/* #include "bramble_argument.hpp" first included at line 797 */
+/* #include "bramble_string_view.hpp" first included at line 231 */
 
-                    retval.remove_suffix(1);
-                }
-            }
+#include <cstddef>
 
-            return retval;
-        }
+namespace Bramble {
 
-        /// @copydoc strip(const StringView&)
-        static StringView strip(const char *v)
-        {
-            StringView tmp(v);
-            return strip(tmp);
-        }
+    /** A table of command handlers
+     *
+     * The table is indexed by command name at compile time so that a Server::Host can
+     * dispatch in O(1) without allocating:
+     *
+     * @code
+     * static constexpr Bramble::Registry::Entry commands[] = {
+     *     {"generate_cw", generate_cw},
+     *     {"send_lora", send_lora}
+     * };
+     *
+     * static constexpr auto registry = Bramble::Registry::make(commands);
+     *
+     * bool YourHost::call(Bramble::Server::Command& cmd, const Bramble::Argument& args)
+     * {
+     *     return registry.call(cmd, args);
+     * }
+     * @endcode
+     *
+     * */
+    class Registry {
+    public:
 
-        /** Test if value() is a string of hexadecimal characters
+        /** A command handler
          *
-         * @retval true     value() is
-         * @retval false    value() is not
+         * @param[in] cmd       the command being handled
+         * @param[in] args      arguments
          *
          * */
-        bool is_hex_string() const
-        {
-            return get_hex_string(nullptr, 0) > 0;
-        }
+        using Handler = void (*)(Server::Command& cmd, const Argument& args);
 
-        /** Test if value() is a valid b64 string
-         *
-         * @retval true     value() is
-         * @retval false    value() is not
-         *
-         * */
-        bool is_b64_string() const
-        {
-            return get_b64_string(nullptr, 0) > 0;
-        }
+        /** A registry entry */
+        struct Entry {
 
-        /** Get boolean from value()
-         *
-         * @param[out] v    output
+            const char *name;       ///< command name
+            Handler handler;        ///< handler (nullptr to accept without doing anything)
+        };
+
+        /** An indexed table of entries
          *
-         * @retval true     success
-         * @retval false    failure
+         * @tparam N    number of entries
          *
          * */
-        bool get_bool(bool& v) const
-        {
-            bool retval = true;
+        template<size_t N>
+        class Table {
+        public:
 
-            const StringView v_true("true");
-            const StringView v_false("false");
+            /** Index a table of entries
+             *
+             * @param[in] entries   table (must outlive this instance)
+             *
+             * */
+            constexpr Table(const Entry (&entries)[N])
+                :
+                index(entries)
+            {
+            }
 
-            auto vv = strip(value());
+            /** Find an entry by command name
+             *
+             * @param[in] name  command name
+             *
+             * @return pointer to entry or nullptr if not found
+             *
+             * */
+            const Entry *lookup(const StringView& name) const
+            {
+                return index.find(name);
+            }
 
-            if(case_insensitive_compare(v_true, vv)){
+            /** Lookup and execute a command handler by Server::Command::name()
+             *
+             * @param[in] cmd       the command being handled
+             * @param[in] args      arguments
+             *
+             * @retval true         handler exists and was called
+             * @retval false        no handler exists for command name
+             *
+             * */
+            bool call(Server::Command& cmd, const Argument& args) const
+            {
+                auto entry = lookup(cmd.name());
 
-                v = true;
-            }
-            else if(case_insensitive_compare(v_false, vv)){
+                if((entry != nullptr) && (entry->handler != nullptr)){
 
-                v = false;
+                    entry->handler(cmd, args);
+                }
+
+                return entry != nullptr;
             }
-            else{
 
-                retval = false;
+            /** number of entries
+             *
+             * */
+            constexpr size_t size() const
+            {
+                return N;
             }
 
-            return retval;
-        }
+        private:
 
-        /** Get signed integer from value()
+            HashIndex<Entry, N, &Entry::name> index;
+        };
+
+        /** Create an indexed table of entries
          *
-         * @param[out] v    output
+         * @param[in] entries   table (must outlive the result)
          *
-         * @retval true     success
-         * @retval false    failure
+         * @return Table
          *
          * */
-        bool get_int(int8_t& v) const
+        template<size_t N>
+        static constexpr Table<N> make(const Entry (&entries)[N])
         {
-            return get_int8(v);
+            return Table<N>(entries);
         }
+    };
+};
 
-        /// @copydoc get_int(int8_t&) const
-        bool get_int(int16_t& v) const
-        {
-            return get_int16(v);
-        }
+#endif
+/* #include "bramble_session_pool.hpp" */
+/* Copyright (c) 2024 Cameron Harper
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ *
+ */
 
-        /// @copydoc get_int(int8_t&) const
-        bool get_int(int32_t& v) const
-        {
-            return get_int32(v);
-        }
+#ifndef BRAMBLE_SESSION_POOL_H_INCLUDED
+#define BRAMBLE_SESSION_POOL_H_INCLUDED
 
-        /// @copydoc get_int(int8_t&) const
-        bool get_int(int64_t& v) const
-        {
-            return get_int64(v);
-        }
+/* #include "bramble_server.hpp" first included at line 113 */
+/* #include "bramble_string_view.hpp" first included at line 231 */
 
-        /** Get unsigned integer from value()
-         *
-         * @param[out] v    output
-         *
-         * @retval true     success
-         * @retval false    failure
-         *
-         * */
-        bool get_unsigned(uint8_t& v) const
-        {
-            return get_uint8(v);
-        }
+#include <cstddef>
+#include <new>
+#include <type_traits>
 
-        /// @copydoc get_unsigned(uint8_t&) const
-        bool get_unsigned(uint16_t& v) const
-        {
-            return get_uint16(v);
-        }
+namespace Bramble {
 
-        /// @copydoc get_unsigned(uint8_t&) const
-        bool get_unsigned(uint32_t& v) const
-        {
-            return get_uint32(v);
-        }
+    /** A fixed pool of Server sessions
+     *
+     * Each session is a Server with its own Host, line buffer, token index
+     * and output. All storage is reserved up front, so opening a session on a new
+     * connection does not allocate.
+     *
+     * Sessions share handlers by having each Host dispatch to the same
+     * immutable Registry:
+     *
+     * @code
+     * static constexpr auto registry = Bramble::Registry::make(commands);
+     *
+     * bool Connection::call(Bramble::Server::Command& cmd, const Bramble::Argument& args)
+     * {
+     *     // cmd.session() tells you which connection issued cmd
+     *     return registry.call(cmd, args);
+     * }
+     *
+     * Bramble::SessionPool<4> pool;
+     *
+     * Bramble::Server *session = pool.open(connection);
+     * @endcode
+     *
+     * @tparam Sessions     maximum number of open sessions
+     * @tparam MaxLine      largest line a session can receive
+     * @tparam MaxArgs      number of tokens to index per line
+     *
+     * */
+    template<size_t Sessions, size_t MaxLine = 1024, size_t MaxArgs = 32>
+    class SessionPool {
+    public:
 
-        /// @copydoc get_unsigned(uint8_t&) const
-        bool get_unsigned(uint64_t& v) const
-        {
-            return get_uint64(v);
-        }
+        static_assert(Sessions > 0, "pool must have at least one session");
+        static_assert(MaxLine > 0, "line must have at least one character");
+        static_assert(MaxArgs > 0, "index must have at least one token");
 
-        /** Get uint8_t from value()
-         *
-         * @param[out] v    output
-         *
-         * @retval true     success
-         * @retval false    failure
-         *
-         * */
-        bool get_uint8(uint8_t& v) const
+        SessionPool()
+            :
+            count(0)
         {
-            bool retval = false;
-            uint32_t tmp;
-
-            if(get_uint32(tmp) && (tmp <= UINT8_MAX)){
+            for(size_t i = 0; i < Sessions; i++){
 
-                v = uint8_t(tmp);
-                retval = true;
+                used[i] = false;
             }
-
-            return retval;
         }
 
-        /** Get uint16_t from value()
-         *
-         * @param[out] v    output
-         *
-         * @retval true     success
-         * @retval false    failure
+        SessionPool(const SessionPool&) = delete;
+        SessionPool& operator=(const SessionPool&) = delete;
+
+        /** Destroy this pool and any sessions that are still open
          *
          * */
-        bool get_uint16(uint16_t& v) const
+        ~SessionPool()
         {
-            bool retval = false;
-            uint32_t tmp;
+            for(size_t i = 0; i < Sessions; i++){
 
-            if(get_uint32(tmp) && (tmp <= UINT16_MAX)){
+                if(used[i]){
 
-                v = uint16_t(tmp);
-                retval = true;
+                    at(i)->~Server();
+                }
             }
-
-            return retval;
         }
 
-        /** Get uint32_t from value()
-         *
-         * @param[out] v    output
-         *
-         * @retval true     success
-         * @retval false    failure
+        /** Open a session
          *
-         * */
-        bool get_uint32(uint32_t& v) const
-        {
-            return s_to_uint<uint32_t>(strip(value()), v, Base::Dec);
-        }
-
-        /** Get uint64_t from value()
+         * The session id (Server::session()) is the slot the session occupies
+         * and may be reused after the session is closed.
          *
-         * @param[out] v    output
+         * @param[in] host  host interface for this session
          *
-         * @retval true     success
-         * @retval false    failure
+         * @return session or nullptr if the pool is full
          *
          * */
-        bool get_uint64(uint64_t& v) const
+        Server *open(Server::Host& host)
         {
-            return s_to_uint<uint64_t>(strip(value()), v, Base::Dec);
-        }
+            Server *retval = nullptr;
 
-        /** Get int8_t from value()
-         *
-         * @param[out] v    output
-         *
-         * @retval true     success
-         * @retval false    failure
-         *
-         * */
-        bool get_int8(int8_t& v) const
-        {
-            bool retval = false;
-            int32_t tmp;
+            for(size_t i = 0; i < Sessions; i++){
 
-            if(get_int32(tmp) && (tmp <= INT8_MAX) && (tmp >= INT8_MIN)){
+                if(!used[i]){
 
-                v = int8_t(tmp);
-                retval = true;
+                    retval = new(&slot[i]) Server(host, buffer[i], MaxLine, index[i], MaxArgs, i);
+                    used[i] = true;
+                    count++;
+                    break;
+                }
             }
 
             return retval;
         }
 
-        /** Get int16_t from value()
+        /** Close a session
          *
-         * @param[out] v    output
+         * Does nothing if session was not opened from this pool.
          *
-         * @retval true     success
-         * @retval false    failure
+         * @param[in] session   session to close
          *
          * */
-        bool get_int16(int16_t& v) const
+        void close(Server& session)
         {
-            bool retval = false;
-            int32_t tmp;
+            auto i = session.session();
 
-            if(get_int32(tmp) && (tmp <= INT16_MAX) && (tmp >= INT16_MIN)){
+            if((i < Sessions) && used[i] && (at(i) == &session)){
 
-                v = int16_t(tmp);
-                retval = true;
+                session.~Server();
+                used[i] = false;
+                count--;
             }
-
-            return retval;
-        }
-
-        /** Get int32_t from value()
-         *
-         * @param[out] v    output
-         *
-         * @retval true     success
-         * @retval false    failure
-         *
-         * */
-        bool get_int32(int32_t& v) const
-        {
-            return s_to_int<int32_t, uint32_t, INT32_MAX>(strip(value()), v);
         }
 
-        /** Get int64_t from value()
-         *
-         * @param[out] v    output
-         *
-         * @retval true     success
-         * @retval false    failure
+        /** number of open sessions
          *
          * */
-        bool get_int64(int64_t& v) const
+        size_t size() const
         {
-            return s_to_int<int64_t, uint64_t, INT64_MAX>(strip(value()), v);
-        }
-
-        /** Interpret value() as hex encoded memory
-         *
-         * @note use is_hex_string() to test if all characters in value() appear to be a hex string
-         *
-         * @param[out] buffer   output
-         * @param[out] max      maximum size of buffer
-         *
-         * @retval bytes written to buffer
+            return count;
+        }
+
+        /** maximum number of open sessions
          *
          * */
-        size_t get_hex_string(void *buffer, size_t max) const
+        static constexpr size_t capacity()
         {
-            size_t retval = 0;
-            uint8_t cc, c;
-            BufferStream output(buffer, max);
+            return Sessions;
+        }
 
-            auto tmp = strip(value());
+    private:
 
-            for(auto iter = tmp.begin(); iter != tmp.end(); ++iter){
+        typename std::aligned_storage<sizeof(Server), alignof(Server)>::type slot[Sessions];
+        bool used[Sessions];
 
-                if(!hex_to_value(*iter, cc)){
+        char buffer[Sessions][MaxLine + 1];
+        StringView index[Sessions][MaxArgs];
 
-                    retval = 0;
-                    break;
-                }
+        size_t count;
 
-                if(((iter - tmp.begin()) & 1) == 0){
+        Server *at(size_t i)
+        {
+            return reinterpret_cast<Server *>(&slot[i]);
+        }
+    };
+};
 
-                    c = (cc << 4) & uint8_t(0xf0);
+#endif
+/* #include "bramble_line_queue.hpp" */
+/* Copyright (c) 2024 Cameron Harper
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ *
+ */
 
-                    if((iter+1) == tmp.end()){
+#ifndef BRAMBLE_LINE_QUEUE_H_INCLUDED
+#define BRAMBLE_LINE_QUEUE_H_INCLUDED
 
-                        output.write(&c, sizeof(c));
-                        retval++;
-                    }
-                }
-                else{
+/* #include "bramble_server.hpp" first included at line 113 */
 
-                    c |= (cc & uint8_t(0xf));
+#include <cstddef>
 
-                    output.write(&c, sizeof(c));
-                    retval++;
-                }
-            }
+namespace Bramble {
 
-            return retval;
-        }
+    /** A Server::Queue with storage for a fixed number of lines
+     *
+     * @code
+     * Bramble::LineQueue<8> queue;
+     *
+     * server.set_queue(&queue);
+     *
+     * for(;;){
+     *
+     *     server.process();
+     *
+     *     while(server.step());
+     * }
+     * @endcode
+     *
+     * @tparam Depth    number of lines
+     * @tparam MaxLine  largest line that can be queued
+     *
+     * */
+    template<size_t Depth, size_t MaxLine = 1024>
+    class LineQueue : public Server::Queue {
+    public:
 
-        size_t get_hex_string_size() const
-        {
-            return get_hex_string(nullptr, 0);
-        }
+        static_assert(Depth > 0, "queue must hold at least one line");
 
-        /** Interpret value() as base64 encoded memory
-         *
-         * @note use is_b64_string() to test if all characters in value() appear to be base64
-         *
-         * @param[out] buffer   output
-         * @param[out] max      maximum size of buffer
+        /** Create a queue
          *
-         * @retval bytes written to buffer
+         * @param[in] overflow  overflow policy
          *
          * */
-        size_t get_b64_string(void *buffer, size_t max) const
+        LineQueue(Overflow overflow = Overflow::Reject)
+            :
+            Queue(&storage[0][0], Depth, MaxLine, overflow)
         {
-            size_t retval = 0;
-            uint8_t c, out, acc;
-            BufferStream output(buffer, max);
+        }
 
-            auto tmp = strip(value());
+    private:
 
-            for(auto iter = tmp.begin(); iter != tmp.end(); ++iter){
+        char storage[Depth][MaxLine + 1];
+    };
+};
 
-                if(b64_to_value(*iter, c)){
+#endif
+/* #include "bramble_event_queue.hpp" */
+/* Copyright (c) 2024 Cameron Harper
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ *
+ */
 
-                    switch((iter - tmp.begin()) % 4){
-                    case 0:
-                        acc = (c << 2);
-                        break;
-                    case 1:
-                        out = acc | (c >> 4);
-                        acc = (c << 4);
-                        output.write(&out, sizeof(out));
-                        retval++;
-                        break;
-                    case 2:
-                        out = acc | (c >> 2);
-                        acc = (c << 6);
-                        output.write(&out, sizeof(out));
-                        retval++;
-                        break;
-                    case 3:
-                        out = acc | c;
-                        output.write(&out, sizeof(out));
-                        retval++;
-                        break;
-                    }
-                }
-                else if(*iter == '='){
+#ifndef BRAMBLE_EVENT_QUEUE_H_INCLUDED
+#define BRAMBLE_EVENT_QUEUE_H_INCLUDED
 
-                    // skip
-                }
-                else{
+/* #include "bramble_server.hpp" first included at line 113 */
 
-                    retval = 0;
-                    break;
-                }
-            }
+#include <cstddef>
+#include <atomic>
 
-            return retval;
-        }
+namespace Bramble {
 
-        size_t get_b64_string_size() const
+    /** A Server::Events queue with storage for a fixed number of lines
+     *
+     * @code
+     * Bramble::EventQueue<16> events;
+     *
+     * server.set_events(&events);
+     *
+     * // from an interrupt or another thread
+     * if(!events.event("rx_done", [&](Bramble::Stream& s){ Bramble::Encoder(s).put_uint16(size); })){
+     *
+     *     // dropped, see events.dropped()
+     * }
+     * @endcode
+     *
+     * @tparam Depth    number of lines (a power of two, at least 2)
+     * @tparam MaxLine  largest line (excluding line ending) that can be queued
+     *
+     * */
+    template<size_t Depth, size_t MaxLine = 128>
+    class EventQueue : public Server::Events {
+    public:
+
+        // a slot's full and free sequence numbers coincide when there is only one
+        static_assert((Depth > 1) && ((Depth & (Depth - 1U)) == 0), "depth must be a power of two greater than one");
+
+        EventQueue()
+            :
+            Events(sequence, sizes, &storage[0][0], Depth, MaxLine)
         {
-            return get_b64_string(nullptr, 0);
+            init();
         }
 
-    protected:
+    private:
 
-        enum class Base {
+        std::atomic<size_t> sequence[Depth];
+        size_t sizes[Depth];
+        char storage[Depth][MaxLine + 1];
+    };
+};
 
-            Dec,
-            Hex
-        };
+#endif
+/* #include "bramble_task.hpp" */
+/* Copyright (c) 2024 Cameron Harper
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ *
+ */
 
-        StringView input;
+#ifndef BRAMBLE_TASK_H_INCLUDED
+#define BRAMBLE_TASK_H_INCLUDED
 
-        template<typename T>
-        bool s_to_uint(StringView s, T& value, Base base) const
-        {
-            bool retval = false;
+#if defined(__cpp_impl_coroutine) && defined(__has_include)
+#if __has_include(<coroutine>)
+#define BRAMBLE_HAS_COROUTINE
+#endif
+#endif
 
-            if(!s.empty()){
+#ifdef BRAMBLE_HAS_COROUTINE
 
-                value = 0;
+/* #include "bramble_server.hpp" first included at line 113 */
+/* #include "bramble_argument.hpp" first included at line 797 */
 
-                retval = true;
+#include <coroutine>
+#include <exception>
+#include <functional>
+#include <utility>
+#include <vector>
 
-                for(auto iter = s.begin(); (iter != s.end()) && retval; ++iter){
+namespace Bramble {
 
-                    switch(base){
-                    default:
-                    case Base::Dec:
+    /** A command handler written as a C++20 coroutine
+     *
+     * The coroutine runs as soon as it is called. If it finishes without
+     * suspending it behaves exactly like an ordinary handler. The first time it
+     * suspends, the command is deferred (see Server::Command::defer()) so that the
+     * server can go on processing input, and the ACK is sent when the coroutine
+     * finishes:
+     *
+     * @code
+     * Bramble::Loop loop;
+     *
+     * Bramble::Task calibrate(Bramble::Server::Command& cmd, const Bramble::Argument& args)
+     * {
+     *     auto steps = count(args);   // arguments are only valid until the first suspension
+     *
+     *     for(size_t i = 0; i < steps; i++){
+     *
+     *         start_step(i);
+     *
+     *         co_await loop.until([]{ return step_done(); });
+     *     }
+     *
+     *     if(!calibrated()){
+     *
+     *         (co_await Bramble::Task::deferred()).nak("failed");
+     *     }
+     * }
+     *
+     * bool YourHost::call(Bramble::Server::Command& cmd, const Bramble::Argument& args)
+     * {
+     *     calibrate(cmd, args);
+     *     return true;
+     * }
+     *
+     * // main loop
+     * for(;;){
+     *
+     *     server.process();
+     *     loop.poll();
+     * }
+     * @endcode
+     *
+     * The first parameter of the coroutine must be the Server::Command. The
+     * Command and Argument passed to the handler, and the strings the Argument refers
+     * to, are only valid until the first suspension. Copy anything needed after that.
+     *
+     * The coroutine frame is released when the coroutine finishes. The Task
+     * object itself does not need to be kept.
+     *
+     * */
+    class Task {
+    public:
 
-                        if((*iter < '0') || (*iter > '9')){
+        /** Awaitable that defers the command (if not already deferred) and
+         * returns the Server::Deferred used to complete it
+         *
+         * */
+        struct DeferredAwaiter {
 
-                            retval = false;
-                        }
-                        else{
+            /// @private
+            bool await_ready() const noexcept
+            {
+                return false;
+            }
+
+            /// @private
+            template<typename Promise>
+            bool await_suspend(std::coroutine_handle<Promise> handle) noexcept
+            {
+                deferred = &handle.promise().detach();
+                return false;
+            }
 
-                            auto pre = value;
+            /// @private
+            Server::Deferred& await_resume() const noexcept
+            {
+                return *deferred;
+            }
 
-                            value *= 10;
-                            value += (*iter - '0');
+            /// @private
+            Server::Deferred *deferred = nullptr;
+        };
 
-                            // overflow
-                            if(value < pre){
+        /** Get the Server::Deferred for this command
+         *
+         * Use this to NAK, or to ACK with arguments, after suspending. If the command
+         * has already been completed the Deferred is not pending.
+         *
+         * @code
+         * (co_await Bramble::Task::deferred()).nak("timeout");
+         * @endcode
+         *
+         * */
+        static DeferredAwaiter deferred()
+        {
+            return DeferredAwaiter();
+        }
 
-                                retval = false;
-                            }
-                        }
-                        break;
-                    }
-                }
+        /// @private
+        class promise_type {
+        public:
+
+            template<typename... Args>
+            promise_type(Server::Command& cmd, Args&&...)
+                :
+                cmd(cmd),
+                detached(false)
+            {
             }
 
-            return retval;
-        }
+            Task get_return_object()
+            {
+                return Task();
+            }
 
-        template<typename T, typename TU, size_t T_MAX>
-        bool s_to_int(StringView s, T& value) const
-        {
-            bool retval = false;
-            bool negative;
-            TU v;
+            std::suspend_never initial_suspend() noexcept
+            {
+                return {};
+            }
 
-            if(!s.empty()){
+            std::suspend_never final_suspend() noexcept
+            {
+                return {};
+            }
 
-                retval = true;
+            void return_void()
+            {
+                // default response is always ack
+                deferred.ack();
+            }
 
-                v = 0;
+            void unhandled_exception()
+            {
+                std::terminate();
+            }
 
-                if(s.front() == '-'){
+            template<typename Awaitable>
+            auto await_transform(Awaitable&& awaitable)
+            {
+                return Awaiter<Awaitable>(*this, std::forward<Awaitable>(awaitable));
+            }
 
-                    negative = true;
-                    s.remove_prefix(1);
-                }
-                else{
+            DeferredAwaiter await_transform(DeferredAwaiter awaitable)
+            {
+                return awaitable;
+            }
+
+            Server::Deferred& detach()
+            {
+                if(!detached){
 
-                    negative = false;
+                    // only ever reached before the handler returns
+                    deferred = cmd.defer();
+                    detached = true;
                 }
 
-                retval = s_to_uint<TU>(s, v, Base::Dec);
+                return deferred;
+            }
 
-                if(retval){
+        private:
 
-                    if(negative){
+            Server::Command cmd;
+            Server::Deferred deferred;
+            bool detached;
 
-                        // overflow
-                        if(v > T_MAX){
+            // defers the command before the coroutine first suspends
+            template<typename Awaitable>
+            class Awaiter {
+            public:
 
-                            retval = false;
-                        }
-                        else{
+                Awaiter(promise_type& promise, Awaitable&& awaitable)
+                    :
+                    promise(promise),
+                    awaitable(std::forward<Awaitable>(awaitable))
+                {
+                }
 
-                            value = T(0) - T(v);
-                        }
-                    }
-                    else{
+                bool await_ready()
+                {
+                    return awaitable.await_ready();
+                }
 
-                        value = T(v);
-                    }
+                template<typename Handle>
+                auto await_suspend(Handle handle)
+                {
+                    (void)promise.detach();
+
+                    return awaitable.await_suspend(handle);
                 }
-            }
 
-            return retval;
-        }
+                decltype(auto) await_resume()
+                {
+                    return awaitable.await_resume();
+                }
+
+            private:
+
+                promise_type& promise;
+                Awaitable awaitable;
+            };
+        };
+    };
+
+    /** A minimal scheduler for Task
+     *
+     * Coroutines wait on a condition and are resumed by poll() once it holds. Call
+     * poll() from the same loop that calls Server::process().
+     *
+     * */
+    class Loop {
+    public:
 
-        static bool hex_to_value(char c, uint8_t& v)
-        {
-            bool retval = true;
+        using Condition = std::function<bool()>;
 
-            if((c >= '0') && (c <= '9')){
+        /// @private
+        class Awaiter {
+        public:
 
-                v = c - '0';
+            Awaiter(Loop& loop, Condition condition)
+                :
+                loop(loop),
+                condition(std::move(condition))
+            {
             }
-            else if((c >= 'a') && (c <= 'f')){
 
-                v = c - 'a' + 10;
+            bool await_ready()
+            {
+                return condition();
             }
-            else if((c >= 'A') && (c <= 'F')){
 
-                v = c - 'A' + 10;
+            void await_suspend(std::coroutine_handle<> handle)
+            {
+                loop.waiting.push_back(Waiting{handle, std::move(condition)});
             }
-            else{
 
-                retval = false;
+            void await_resume()
+            {
             }
 
-            return retval;
-        }
-
-        static bool b64_to_value(char c, uint8_t& v)
-        {
-            bool retval = true;
+        private:
 
-            if((c >= 'A') && (c <= 'Z')){
+            Loop& loop;
+            Condition condition;
+        };
 
-                v = c - 'A';
-            }
-            else if((c >= 'a') && (c <= 'z')){
+        Loop() = default;
 
-                v = c - 'a' + 26;
-            }
-            else if((c >= '0') && (c <= '9')){
+        /** Destroy every coroutine that is still waiting
+         *
+         * The coroutines are not resumed and their commands are not answered.
+         *
+         * */
+        ~Loop()
+        {
+            for(auto& w : waiting){
 
-                v = c - '0' + 26 + 26;
+                w.handle.destroy();
             }
-            else if(c == '+'){
+        }
 
-                v = 26 + 26 + 10;
-            }
-            else if(c == '/'){
+        Loop(const Loop&) = delete;
+        Loop& operator=(const Loop&) = delete;
 
-                v = 26 + 26 + 10 + 1;
-            }
-            else{
+        /** Suspend until condition is true
+         *
+         * Does not suspend if condition is already true.
+         *
+         * @param[in] condition     evaluated on every poll()
+         *
+         * */
+        Awaiter until(Condition condition)
+        {
+            return Awaiter(*this, std::move(condition));
+        }
 
-                retval = false;
-            }
+        /** Suspend until the next poll()
+         *
+         * */
+        Awaiter yield()
+        {
+            bool first = true;
 
-            return retval;
+            return Awaiter(*this, [first]() mutable { return !std::exchange(first, false); });
         }
 
-        static bool case_insensitive_compare(const StringView& a, const StringView& b)
+        /** Resume every coroutine whose condition is true
+         *
+         * Coroutines that suspend again while being resumed are not resumed
+         * again until the next poll().
+         *
+         * @return number of coroutines resumed
+         *
+         * */
+        size_t poll()
         {
-            bool retval = false;
+            size_t retval = 0;
+            std::vector<Waiting> ready;
 
-            if(a.size() == b.size()){
+            for(auto iter = waiting.begin(); iter != waiting.end();){
 
-                auto a_iter = a.begin();
-                auto b_iter = b.begin();
+                if(iter->condition()){
 
-                retval = true;
+                    ready.push_back(std::move(*iter));
+                    iter = waiting.erase(iter);
+                }
+                else{
 
-                for(; a_iter != a.end(); ++a_iter, ++b_iter){
+                    ++iter;
+                }
+            }
 
-                    if(std::tolower(*a_iter) != std::tolower(*b_iter)){
+            for(auto& w : ready){
 
-                        retval = false;
-                        break;
-                    }
-                }
+                w.handle.resume();
+                retval++;
             }
 
             return retval;
         }
+
+        /** number of suspended coroutines
+         *
+         * */
+        size_t size() const
+        {
+            return waiting.size();
+        }
+
+    private:
+
+        struct Waiting {
+
+            std::coroutine_handle<> handle;
+            Condition condition;
+        };
+
+        std::vector<Waiting> waiting;
     };
 };
 
 #endif
+
+#endif
+/* #include "bramble_named_arguments.hpp" */
+/* Copyright (c) 2024 Cameron Harper
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ *
+ */
+
+#ifndef BRAMBLE_NAMED_ARGUMENTS_H_INCLUDED
+#define BRAMBLE_NAMED_ARGUMENTS_H_INCLUDED
+
 /* #include "bramble_argument.hpp" first included at line 797 */
+/* #include "bramble_decoder.hpp" first included at line 4287 */
 /* #include "bramble_string_view.hpp" first included at line 231 */
 
 #include <cstddef>
-#include <cstdint>
-#include <cstring>
-#include <functional>
-#include <cctype>
 
 namespace Bramble {
 
-    /** A Bramble server
+    /** An index of the named arguments (name=value) in an Argument container
+     *
+     * The index is built in one pass over the tokens and kept sorted by name,
+     * so each lookup is a binary search rather than a scan of every token.
+     * Storage is inline, so an index can live on the stack of a command handler.
+     *
+     * Lookups mark entries as consumed, which makes it possible to reject
+     * names the handler did not ask for:
+     *
+     * @code
+     * bool YourHost::call(Bramble::Server::Command& cmd, const Bramble::Argument& args)
+     * {
+     *     Bramble::NamedArguments<8> named(args);
+     *     Bramble::Decoder value;
+     *     uint32_t freq;
+     *
+     *     if(named.overflow() || named.has_duplicate()){
+     *
+     *         cmd.nak("bad_argument");
+     *     }
+     *     else if(!named.get("freq", value) || !value.get_uint32(freq)){
+     *
+     *         cmd.nak("freq");
+     *     }
+     *     else if(named.unconsumed() != nullptr){
+     *
+     *         cmd.nak("unknown_argument");
+     *     }
+     *     else{
+     *
+     *         cmd.ack();
+     *     }
+     *
+     *     return true;
+     * }
+     * @endcode
+     *
+     * Tokens without '=' are not indexed.
+     *
+     * @tparam N    maximum number of named arguments to index
      *
      * */
-    class Server {
+    template<size_t N>
+    class NamedArguments {
     public:
 
-        /** Represents the command that is being handled
+        static_assert(N > 0, "index must have at least one entry");
+
+        /** An indexed named argument
          *
          * */
-        class Command {
+        class Entry {
         public:
 
-            /// @private
-            Command(Server& server)
+            Entry()
                 :
-                server(server)
-            {}
-
-            /** Command name
-             *
-             * @return command name
-             *
-             * */
-            StringView name()
+                used(false)
             {
-                return server.name;
             }
 
-            /** Initiate an ACK
+            /** Get the name
+             *
+             * @return StringView
              *
              * */
-            void ack()
+            StringView name() const
             {
-                (void)server.state->ack(server);
+                return n;
             }
 
-            /** Initiate an ACK that will be followed by arguments
+            /** Get the value as-is (everything after the first '=')
              *
-             * @return output stream
+             * @return StringView
              *
              * */
-            Stream& ack_with_arg()
+            StringView value() const
             {
-                return Encoder(server.state->ack(server)).space().s;
+                return v;
             }
 
-            /** Initiate a NAK
+            /** Test if this entry has been looked up with find() or get()
              *
-             * @param[in] reason    reason for NAK
+             * @retval true     consumed
+             * @retval false    not consumed
              *
              * */
-            void nak(const char *reason)
+            bool consumed() const
             {
-                return server.state->nak(server, reason);
+                return used;
             }
 
-            /** Force server to end the ACK/NAK line and drain the output now rather than on
-             * return from the handler.
-             *
-             * */
-            void end()
-            {
-                server.state->end(server);
-            }
+        private:
 
-            /** Get the user pointer that was attached to server instance
-             *
-             * */
-            void *ctx()
-            {
-                return server.get_ctx();
-            }
+            friend class NamedArguments;
 
-            /** The server instance */
-            Server& server;
+            StringView n;
+            StringView v;
+            bool used;
         };
 
-        /** Server host interface
-         *
-         * Anything a server instance may want from the host.
+        typedef const Entry *const_iterator;
+
+        /** Index the named arguments in args
          *
-         * This class will need to be subclassed when porting to a new host.
+         * @param[in] args  argument container
          *
          * */
-        class Host {
-        public:
-
-            virtual ~Host(){}
-
-            /// called everytime a line is received
-            virtual void line_was_rx()
-            {}
-
-            /// called everytime a line is sent
-            virtual void line_was_tx()
-            {}
-
-            enum class GetCharStatus {
-
-                Ok,
-                Blocked,
-                Error
-            };
+        NamedArguments(const Argument& args)
+            :
+            count(0),
+            dropped(false),
+            duplicated(false)
+        {
+            for(auto token : args){
 
-            /** put a character to the transport layer
-             *
-             * @param[in] c     character
-             *
-             * */
-            virtual void put_char(char c)
-            {
-                (void)c;
-            };
+                auto eq = token.find_first_of('=');
 
-            /** block until output buffer has been emptied */
-            virtual void drain()
-            {};
+                if(eq != token.npos){
 
-            /** get a character from the transport layer
-             *
-             * @param[out] c        output character
-             *
-             * @retval GetCharStatus::Ok
-             * @retval GetCharStatus::Error
-             * @retval GetCharStatus::Blocked
-             *
-             * */
-            virtual GetCharStatus get_char(char& c)
-            {
-                (void)c;
-                return GetCharStatus::Blocked;
-            };
+                    auto name = Decoder::strip(token);
 
-            /** call to evaluate the status code
-             *
-             * @param[in] status
-             *
-             * @retval true     character is valid
-             *
-             * */
-            static bool get_char_status_ok(GetCharStatus status)
-            {
-                return (status == GetCharStatus::Ok);
+                    insert(name.substr(0, name.find_first_of('=')), token.substr(eq+1));
+                }
             }
+        }
 
-            /** Lookup and execute a command handler by name
-             *
-             * @note The command name is accessible from Command::name()
-             *
-             * @param[in] cmd       the command being handled
-             * @param[in] args      arguments
-             *
-             * @retval true         handler exists and was called
-             * @retval false        no handler exists for command name
-             *
-             * */
-            virtual bool call(Command& cmd, const Argument& args)
-            {
-                (void)cmd;
-                (void)args;
-                return false;
-            }
-        };
+        NamedArguments(const NamedArguments&) = delete;
+        NamedArguments& operator=(const NamedArguments&) = delete;
 
-        /** Create a new server instance
-         *
-         * @param[in] host      host interface
-         * @param[in] max_line  largest line server can receive
+        /** Number of indexed names
          *
          * */
-        Server(Host& host, size_t max_line = 1024)
-            :
-            host(host),
-            output(*this),
-            state(&Idle::instance()),
-            size(0),
-            end_offset(max_line)
+        size_t size() const
         {
-            buffer = new char[max_line+1];
-
-            (void)memset(buffer, 0, max_line+1);
+            return count;
         }
 
-        /** Destroy this server
+        /** Test if no names are indexed
          *
          * */
-        ~Server()
+        bool empty() const
         {
-            delete buffer;
+            return count == 0;
         }
 
-        /** Process input characters from HostInterface::get_char()
+        /** Test if there were more distinct names than the index can hold
          *
-         * Most useful if your transport layer has a queue that needs to be polled for
-         * updates.
+         * Names that did not fit are not indexed.
          *
-         * @see process(const char*,size_t) if your server receives strings directly
+         * @retval true     some names were not indexed
+         * @retval false    all names were indexed
          *
          * */
-        void process()
+        bool overflow() const
         {
-            char c;
-
-            while(host.get_char_status_ok(host.get_char(c))){
-
-                state->input(*this, c);
-            }
+            return dropped;
         }
 
-        /** Process input characters direct from buffer
+        /** Test if any name appeared more than once
          *
-         * Most useful if your transport layer delivers messages directly into your application.
+         * Only the first occurrence of a name is indexed.
          *
-         * @see alternative to process() if your server polls an existing queue infrastructure
+         * @retval true     a name was repeated
+         * @retval false    every name is unique
          *
          * */
-        void process(const char *buffer, size_t size)
+        bool has_duplicate() const
         {
-            for(auto iter = buffer; iter != (buffer + size); ++iter){
-
-                state->input(*this, *iter);
-            }
+            return duplicated;
         }
 
-        /** Block until output buffer becomes empty */
-        void drain()
+        /** Get the first name that was repeated
+         *
+         * @return StringView (empty if has_duplicate() is false)
+         *
+         * */
+        StringView duplicate() const
         {
-            output.drain();
+            return repeated;
         }
 
-        /** Attach a user pointer which can be accessed in command handler
+        /** Test if name is indexed without consuming it
+         *
+         * @param[in] name
+         *
+         * @retval true     indexed
+         * @retval false    not indexed
          *
          * */
-        void set_ctx(void *ctx)
+        bool contains(const StringView& name) const
         {
-            this->ctx = ctx;
+            return search(name) != nullptr;
         }
 
-        using ArgumentClosure = std::function<void(Bramble::Stream&)>;
+        /// @copydoc contains(const StringView&) const
+        bool contains(const char *name) const
+        {
+            return contains(StringView(name));
+        }
 
-        /** send an event
+        /** Find a name and mark it as consumed
          *
-         * @param[in] name     event name
+         * @param[in] name
+         *
+         * @return entry or nullptr if name is not indexed
          *
          * */
-        void event(const char *name)
+        const Entry *find(const StringView& name)
         {
-            Encoder(output).put_string("EVT: ").put_string(name);
-            put_line_end();
+            auto retval = search(name);
+
+            if(retval != nullptr){
+
+                retval->used = true;
+            }
+
+            return retval;
         }
 
-        /** @copydoc event(const char *)
-         *
-         * @param[in] fn    closure for additional arguments
-         *
-         *  */
-        void event(const char *name, const ArgumentClosure& fn)
+        /// @copydoc find(const StringView&)
+        const Entry *find(const char *name)
         {
-            Encoder(output).put_string("EVT: ").put_string(name).space();
-            fn(output);
-            put_line_end();
+            return find(StringView(name));
         }
 
-        /** Send a log message
+        /** Find a name, mark it as consumed, and get a Decoder for its value
          *
-         * @param[in] s     message
+         * @param[in] name
+         * @param[out] value    decoder for the value
+         *
+         * @retval true     found
+         * @retval false    not found
          *
          * */
-        void log(const char *s)
+        bool get(const StringView& name, Decoder& value)
         {
-            Encoder(output).put_string("LOG: ").put_string(s);
-            put_line_end();
+            auto entry = find(name);
+
+            if(entry != nullptr){
+
+                value = Decoder(entry->value());
+            }
+
+            return entry != nullptr;
         }
 
-        /** @copydoc log(const char *)
-         *
-         * @param[in] fn    closure for additional arguments
-         *
-         * */
-        void log(const char *s, const ArgumentClosure& fn)
+        /// @copydoc get(const StringView&, Decoder&)
+        bool get(const char *name, Decoder& value)
         {
-            Encoder(output).put_string("LOG: ").put_string(s).space();
-            fn(output);
-            put_line_end();
+            return get(StringView(name), value);
         }
 
-        /** Send without a prefix
+        /** Get the first (in name order) entry that has not been consumed
          *
-         * @param[in] s     message
+         * @return entry or nullptr if every entry has been consumed
          *
          * */
-        void no_prefix(const char *s)
+        const Entry *unconsumed() const
         {
-            Encoder(output).put_string(s);
-            put_line_end();
+            const Entry *retval = nullptr;
+
+            for(auto iter = begin(); iter != end(); ++iter){
+
+                if(!iter->used){
+
+                    retval = iter;
+                    break;
+                }
+            }
+
+            return retval;
         }
 
-        /** @copydoc no_prefix(const char *)
-         *
-         * @param[in] fn    closure for additional arguments
+        /** Returns an iterator to the first entry (in name order)
          *
          * */
-        void no_prefix(const char *s, const ArgumentClosure& fn)
+        const_iterator begin() const
         {
-            Encoder(output).put_string(s);
-            fn(output);
-            put_line_end();
+            return entries;
         }
 
-        /** Get the maximum line size server able to echo and acknowledge
-         *
-         * @return maximum line size
+        /** Returns an iterator to the end
          *
          * */
-        constexpr size_t max_line_size() const
+        const_iterator end() const
         {
-            return end_offset;
+            return entries + count;
         }
 
     private:
 
-        class State {
-        public:
-            virtual void before(Server&) const {}
-            virtual void after(Server&) const {}
+        Entry entries[N];
+        size_t count;
+        bool dropped;
+        bool duplicated;
+        StringView repeated;
 
-            virtual void input(Server&, char) const {}
+        // index of the first entry not less than name
+        size_t lower_bound(const StringView& name) const
+        {
+            size_t first = 0;
+            size_t n = count;
 
-            virtual Stream& ack(Server& self) const { return self.output; }
-            virtual void nak(Server&, const char *) const {}
-            virtual void end(Server&) const {}
-        };
+            while(n > 0){
 
-        class Idle : public State {
-        public:
+                auto half = n / 2;
 
-            static State& instance(){
-                static Idle inst;
-                return inst;
-            }
+                if(entries[first + half].n.compare(name) < 0){
 
-            void before(Server& self) const
-            {
-                self.size = 0;
-                self.buffer[self.size] = 0;
-                self.name = StringView();
+                    first += half + 1;
+                    n -= half + 1;
+                }
+                else{
+
+                    n = half;
+                }
             }
 
-            void input(Server& self, char c) const
-            {
-                if(std::isprint(c)){
+            return first;
+        }
 
-                    if(self.size < self.end_offset){
+        Entry *search(const StringView& name) const
+        {
+            auto i = lower_bound(name);
 
-                        self.buffer[self.size] = c;
-                        self.size++;
-                        self.buffer[self.size] = 0;
-                    }
-                    else{
+            return ((i < count) && (entries[i].n.compare(name) == 0)) ? const_cast<Entry *>(&entries[i]) : nullptr;
+        }
 
-                        self.set_state(TooLong::instance());
-                    }
+        void insert(const StringView& name, const StringView& value)
+        {
+            auto i = lower_bound(name);
+
+            if((i < count) && (entries[i].n.compare(name) == 0)){
+
+                if(!duplicated){
+
+                    repeated = entries[i].n;
+                    duplicated = true;
                 }
-                else if((c == '\r') && (self.size > 0U)){
+            }
+            else if(count == N){
+
+                dropped = true;
+            }
+            else{
+
+                for(auto j = count; j > i; j--){
 
-                    self.set_state(Handle::instance());
+                    entries[j] = entries[j-1];
                 }
-                else{
 
-                    // keep listening
-                }
+                entries[i].n = name;
+                entries[i].v = value;
+                entries[i].used = false;
+                count++;
+            }
+        }
+    };
+};
+
+#endif
+/* #include "bramble_schema.hpp" */
+/* Copyright (c) 2024 Cameron Harper
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ *
+ */
+
+#ifndef BRAMBLE_SCHEMA_H_INCLUDED
+#define BRAMBLE_SCHEMA_H_INCLUDED
+
+/* #include "bramble_server.hpp" first included at line 113 */
+/* #include "bramble_hash.hpp" first included at line 1439 */
+/* #include "bramble_argument.hpp" first included at line 797 */
+/* #include "bramble_decoder.hpp" first included at line 4287 */
+/* #include "bramble_buffer_stream.hpp" first included at line 824 */
+/* #include "bramble_encoder.hpp" first included at line 2350 */
+/* #include "bramble_string_view.hpp" first included at line 231 */
+
+#include <cstddef>
+#include <cstdint>
+
+namespace Bramble {
+
+    /** An inclusive range of accepted values for a Schema field
+     *
+     * @tparam V    value type (an integer type)
+     * @tparam Min  smallest accepted value
+     * @tparam Max  largest accepted value
+     *
+     * */
+    template<typename V, V Min, V Max>
+    struct Range {
+
+        static_assert(Min <= Max, "range is empty");
+
+        using type = V;
+
+        /// @private
+        static bool contains(const V& value)
+        {
+            return (value >= Min) && (value <= Max);
+        }
+    };
+
+    /// @private
+    template<typename R>
+    struct SchemaRange {
+
+        using type = R;
+
+        static bool contains(const R&)
+        {
+            return true;
+        }
+    };
+
+    /// @private
+    template<typename V, V Min, V Max>
+    struct SchemaRange<Range<V, Min, Max>> : Range<V, Min, Max> {
+    };
+
+    /** Binds the named arguments (name=value) of a command to the members of a struct
+     *
+     * Fields are declared in a table that is indexed by name at compile time,
+     * so binding is one walk over the tokens with one hash and one name
+     * compare per token:
+     *
+     * @code
+     * struct Transmit {
+     *     uint32_t freq;
+     *     int8_t dbm;
+     *     bool confirmed;
+     * };
+     *
+     * using TransmitSchema = Bramble::Schema<Transmit>;
+     *
+     * static constexpr TransmitSchema::Field transmit_fields[] = {
+     *     TransmitSchema::required<Bramble::Range<uint32_t, 863000000, 870000000>, &Transmit::freq>("freq"),
+     *     TransmitSchema::optional<Bramble::Range<int8_t, -10, 20>, &Transmit::dbm>("dbm"),
+     *     TransmitSchema::optional<bool, &Transmit::confirmed>("confirmed")
+     * };
+     *
+     * static constexpr auto transmit_schema = TransmitSchema::make(transmit_fields);
+     *
+     * void transmit(Bramble::Server::Command& cmd, const Bramble::Argument& args)
+     * {
+     *     Transmit t = {0, 14, false};
+     *
+     *     // NAKs with a reason like "out_of_range:freq" on failure
+     *     if(transmit_schema.bind(cmd, args, t)){
+     *
+     *         ...
+     *     }
+     * }
+     * @endcode
+     *
+     * A member is only written when its value decodes and is within range, so optional
+     * members keep whatever default the caller gave them. Tokens without '=' (such as
+     * the command name) are ignored. Names that are not in the table are rejected.
+     *
+     * Members can be bool, any of the fixed width integer types, float, double or
+     * StringView (the value as-is, pointing into the argument buffer).
+     *
+     * @tparam T    struct to bind into
+     *
+     * */
+    template<typename T>
+    class Schema {
+    public:
+
+        /** outcome of binding */
+        enum class Status {
+
+            Ok,             ///< all required fields were bound
+            Missing,        ///< a required field was not given
+            Invalid,        ///< a value could not be decoded as the member type
+            OutOfRange,     ///< a value was outside the field Range
+            Unknown,        ///< a name is not in the table
+            Duplicate       ///< a name was given more than once
+        };
+
+        /// @private
+        using Setter = Status (*)(T& obj, const StringView& value);
+
+        /** A field definition (create with required() or optional()) */
+        struct Field {
+
+            const char *name;       ///< argument name
+            Setter set;             ///< decodes value into the member
+            bool required;          ///< fail if not given
+        };
+
+        /** Result of binding
+         *
+         * */
+        class Result {
+        public:
+
+            /// @private
+            Result(Status status, const StringView& name)
+                :
+                s(status),
+                n(name)
+            {
+            }
+
+            /** Outcome
+             *
+             * */
+            Status status() const
+            {
+                return s;
+            }
+
+            /** Name of the field or argument that caused the failure
+             *
+             * @return StringView (empty on success)
+             *
+             * */
+            StringView name() const
+            {
+                return n;
+            }
+
+            /** A NAK reason token for status()
+             *
+             * @return null-terminated string ("ok" on success)
+             *
+             * */
+            const char *reason() const
+            {
+                return Schema::reason(s);
+            }
+
+            /** Test if binding succeeded
+             *
+             * */
+            bool ok() const
+            {
+                return s == Status::Ok;
             }
+
+        private:
+
+            Status s;
+            StringView n;
         };
 
-        class Handle : public State {
+        /** Define a field that must be given
+         *
+         * @tparam R        member type or a Range of the member type
+         * @tparam Member   pointer to member
+         *
+         * @param[in] name  argument name
+         *
+         * @return Field
+         *
+         * */
+        template<typename R, typename SchemaRange<R>::type T::*Member>
+        static constexpr Field required(const char *name)
+        {
+            return Field{name, &assign<R, Member>, true};
+        }
 
-            static void detect_command_name(Server& self, Argument& args)
-            {
-                bool matched = true;
+        /** Define a field that may be omitted
+         *
+         * @tparam R        member type or a Range of the member type
+         * @tparam Member   pointer to member
+         *
+         * @param[in] name  argument name
+         *
+         * @return Field
+         *
+         * */
+        template<typename R, typename SchemaRange<R>::type T::*Member>
+        static constexpr Field optional(const char *name)
+        {
+            return Field{name, &assign<R, Member>, false};
+        }
 
-                self.full_name = Decoder::strip(args.pop_front());
+        /** An indexed table of fields
+         *
+         * @tparam N    number of fields
+         *
+         * */
+        template<size_t N>
+        class Table {
+        public:
 
-                auto id_offset = self.full_name.find_first_of('#');
+            static_assert(N <= 64, "too many fields");
 
-                self.name = self.full_name.substr(0, id_offset);
+            /** largest NAK reason put by bind(Server::Command&, const Argument&, T&) const
+             * (longer names are truncated) */
+            static const size_t max_reason = 64;
 
-                if(id_offset == 0){
+            /** Index a table of fields
+             *
+             * @param[in] fields    table (must outlive this instance)
+             *
+             * */
+            constexpr Table(const Field (&fields)[N])
+                :
+                index(fields)
+            {
+            }
 
-                    matched = false;
-                }
-                else if(id_offset != StringView::npos){
+            /** Bind args into obj
+             *
+             * Stops at the first failure.
+             *
+             * @param[in] args  arguments
+             * @param[out] obj  struct to bind into
+             *
+             * @return Result
+             *
+             * */
+            Result bind(const Argument& args, T& obj) const
+            {
+                uint64_t seen = 0;
+                Status status = Status::Ok;
+                StringView name;
 
-                    self.invoke_id = self.full_name.substr(id_offset + 1);
-                }
-                else{
+                for(auto iter = args.begin(); (status == Status::Ok) && (iter != args.end()); ++iter){
 
-                    self.invoke_id = StringView();
-                }
+                    auto token = *iter;
+                    auto eq = token.find_first_of('=');
 
-                // [a-zA-Z0-9_]+
-                for(auto iter = self.name.begin(); iter != self.name.end(); ++iter){
+                    if(eq != token.npos){
 
-                    if(!std::isupper(*iter) && !std::islower(*iter) && !std::isdigit(*iter) && (*iter != '_')){
+                        name = Decoder::strip(token);
+                        name = name.substr(0, name.find_first_of('='));
 
-                        matched = false;
-                        break;
-                    }
-                }
+                        auto field = index.find(name);
 
-                // [0-9]+
-                if(self.invoke_id.empty()){
+                        if(field == nullptr){
 
-                    if(id_offset != StringView::npos){
+                            status = Status::Unknown;
+                        }
+                        else{
 
-                        matched = false;
-                    }
-                }
-                else{
+                            auto bit = uint64_t(1) << size_t(field - index.data());
 
-                    for(auto iter = self.invoke_id.begin(); iter != self.invoke_id.end(); ++iter){
+                            if((seen & bit) != 0){
 
-                        if(!std::isdigit(*iter)){
+                                status = Status::Duplicate;
+                            }
+                            else{
 
-                            matched = false;
-                            break;
+                                seen |= bit;
+                                status = field->set(obj, token.substr(eq+1));
+                            }
                         }
                     }
                 }
 
-                if(!matched){
+                for(size_t i = 0; (status == Status::Ok) && (i < N); i++){
 
-                    self.name = self.full_name;
-                    self.invoke_id = StringView();
-                }
-            }
+                    if(index.data()[i].required && ((seen & (uint64_t(1) << i)) == 0)){
 
-        public:
+                        status = Status::Missing;
+                        name = StringView(index.data()[i].name);
+                    }
+                }
 
-            static State& instance()
-            {
-                static Handle inst;
-                return inst;
+                return Result(status, (status == Status::Ok) ? StringView() : name);
             }
 
-            void before(Server& self) const
+            /** Bind args into obj and NAK cmd on failure
+             *
+             * The NAK reason is Result::reason() and the name joined by ':'
+             * (e.g. "missing_argument:freq"). The name comes from the client, so
+             * characters other than [A-Za-z0-9_-] are replaced with '_' to keep
+             * the reason a single token.
+             *
+             * @param[in] cmd   command to NAK
+             * @param[in] args  arguments
+             * @param[out] obj  struct to bind into
+             *
+             * @retval true     bound (cmd is untouched)
+             * @retval false    not bound (cmd has been NAKed)
+             *
+             * */
+            bool bind(Server::Command& cmd, const Argument& args, T& obj) const
             {
-                self.host.line_was_rx();
+                auto result = bind(args, obj);
 
-                self.put_cmd();
-                self.put_line_end();
+                if(!result.ok()){
 
-                self.host.line_was_tx();
+                    char reason[max_reason];
+                    BufferStream s(reason, sizeof(reason) - 1U);
 
-                // will mutate contents of self.buffer into sequence of null-terminated strings
-                Argument args(self.buffer, self.buffer, self.end_offset);
-                Command cmd(self);
-
-                if(!args.empty()){
+                    Encoder e(s);
 
-                    detect_command_name(self, args);
+                    e.put_string(result.reason()).put_char(':');
 
-                    if(!self.host.call(cmd, args)){
+                    for(auto c : result.name()){
 
-                        self.put_nak("unknown_command");
-                        self.put_line_end();
-                        self.host.line_was_tx();
+                        e.put_char(is_name_char(c) ? c : '_');
                     }
-                    else{
 
-                        // default response is always ack
-                        if(self.state == &Handle::instance()){
+                    reason[s.tell()] = 0;
 
-                            self.put_ack();
-                            self.put_line_end();
-                            self.host.line_was_tx();
-                        }
-                    }
+                    cmd.nak(reason);
                 }
 
-                self.set_state(Idle::instance());
-            }
-
-            Stream& ack(Server& self) const
-            {
-                self.set_state(Responding::instance());
-                self.put_ack();
-
-                return self.output;
-            }
-
-            void nak(Server& self, const char *reason) const
-            {
-                self.set_state(Responding::instance());
-                self.put_nak(reason);
-            }
-
-            void end(Server& self) const
-            {
-                self.set_state(Responding::instance());
-                self.state->end(self);
+                return result.ok();
             }
-        };
 
-        class Responding : public State {
-        public:
-            static State& instance()
+            /** number of fields
+             *
+             * */
+            constexpr size_t size() const
             {
-                static Responding inst;
-                return inst;
+                return N;
             }
 
-            Stream& ack(Server& self) const
-            {
-                return self.output;
-            }
+        private:
 
-            void end(Server& self) const
-            {
-                self.set_state(Idle::instance());
-            }
+            HashIndex<Field, N, &Field::name> index;
 
-            void after(Server& self) const
+            static bool is_name_char(char c)
             {
-                self.put_line_end();
-                self.host.line_was_tx();
+                return ((c >= 'a') && (c <= 'z'))
+                    || ((c >= 'A') && (c <= 'Z'))
+                    || ((c >= '0') && (c <= '9'))
+                    || (c == '_')
+                    || (c == '-');
             }
         };
 
-        class TooLong : public State {
-        public:
-
-            static State& instance()
-            {
-                static TooLong inst;
-                return inst;
-            }
+        /** Create an indexed table of fields
+         *
+         * @param[in] fields    table (must outlive the result)
+         *
+         * @return Table
+         *
+         * */
+        template<size_t N>
+        static constexpr Table<N> make(const Field (&fields)[N])
+        {
+            return Table<N>(fields);
+        }
 
-            void input(Server& self, char c) const
-            {
-                if(c == '\r'){
+        /** NAK reason token for a status
+         *
+         * @param[in] status
+         *
+         * @return null-terminated string
+         *
+         * */
+        static const char *reason(Status status)
+        {
+            const char *retval;
 
-                    self.set_state(Idle::instance());
-                }
+            switch(status){
+            default:
+            case Status::Ok:
+                retval = "ok";
+                break;
+            case Status::Missing:
+                retval = "missing_argument";
+                break;
+            case Status::Invalid:
+                retval = "invalid_argument";
+                break;
+            case Status::OutOfRange:
+                retval = "out_of_range";
+                break;
+            case Status::Unknown:
+                retval = "unknown_argument";
+                break;
+            case Status::Duplicate:
+                retval = "duplicate_argument";
+                break;
             }
-        };
 
-        // server output stream
-        class Output : public Stream {
-        public:
-
-            Output(Server& server)
-                :
-                server(&server)
-            {
-            }
+            return retval;
+        }
 
-            Output()
-                :
-                server(nullptr)
-            {
-            }
+    private:
 
-            size_t write(const void *buffer, size_t size)
-            {
-                if(server != nullptr){
+        template<typename R, typename SchemaRange<R>::type T::*Member>
+        static Status assign(T& obj, const StringView& value)
+        {
+            Status retval = Status::Invalid;
+            typename SchemaRange<R>::type v;
 
-                    auto begin = (const uint8_t *)buffer;
-                    auto end = begin + size;
+            if(decode(Decoder(value), v)){
 
-                    for(auto iter = begin; iter != end; ++iter){
+                if(SchemaRange<R>::contains(v)){
 
-                        server->host.put_char(*iter);
-                    }
+                    obj.*Member = v;
+                    retval = Status::Ok;
                 }
+                else{
 
-                return size;
-            }
-
-            void drain()
-            {
-                if(server != nullptr){
-
-                    server->host.drain();
+                    retval = Status::OutOfRange;
                 }
             }
 
-        private:
-
-            Server *server;
-        };
+            return retval;
+        }
 
-        Host& host;
+        static bool decode(const Decoder& d, bool& v)
+        {
+            return d.get_bool(v);
+        }
 
-        Output output;
+        static bool decode(const Decoder& d, uint8_t& v)
+        {
+            return d.get_uint8(v);
+        }
 
-        const State *state;
+        static bool decode(const Decoder& d, uint16_t& v)
+        {
+            return d.get_uint16(v);
+        }
 
-        void *ctx;
+        static bool decode(const Decoder& d, uint32_t& v)
+        {
+            return d.get_uint32(v);
+        }
 
-        void set_state(const State& value)
+        static bool decode(const Decoder& d, uint64_t& v)
         {
-            state->after(*this);
-            state = &value;
-            state->before(*this);
+            return d.get_uint64(v);
         }
 
-        char *buffer;
-        size_t size;
-        const size_t end_offset;
+        static bool decode(const Decoder& d, int8_t& v)
+        {
+            return d.get_int8(v);
+        }
 
-        StringView name;
-        StringView full_name;
-        StringView invoke_id;
+        static bool decode(const Decoder& d, int16_t& v)
+        {
+            return d.get_int16(v);
+        }
 
-        void put_cmd()
+        static bool decode(const Decoder& d, int32_t& v)
         {
-            Encoder(output)
-                .put_string("CMD:")
-                .put_string(buffer);
+            return d.get_int32(v);
         }
 
-        void put_nak(const char *msg)
+        static bool decode(const Decoder& d, int64_t& v)
         {
-            Encoder(output)
-                .put_string("NAK:")
-                .put_string(full_name)
-                .space()
-                .put_string(msg);
+            return d.get_int64(v);
         }
 
-        void put_ack()
+        static bool decode(const Decoder& d, float& v)
         {
-            Encoder(output)
-                .put_string("ACK:")
-                .put_string(full_name);
+            return d.get_float(v);
         }
 
-        void put_line_end()
+        static bool decode(const Decoder& d, double& v)
         {
-            Encoder(output).put_string("\r\n");
+            return d.get_double(v);
         }
 
-        void *get_ctx()
+        static bool decode(const Decoder& d, StringView& v)
         {
-            return ctx;
+            v = d.value();
+            return true;
         }
     };
 };
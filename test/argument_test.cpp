@@ -134,6 +134,105 @@ TEST(Argument, shall_pop_front_of_two_token)
     ASSERT_EQ(Bramble::StringView("two"), arg.front());
 }
 
+TEST(Argument, shall_handle_escape_and_quote)
+{
+    char argv[] = "one\\ two 'three four'five \"six\"";
+    Bramble::Argument arg(argv, argv, sizeof(argv));
+
+    ASSERT_EQ(3, arg.size());
+
+    auto iter = arg.begin();
+
+    ASSERT_EQ(Bramble::StringView("one two"), *iter);
+
+    ++iter;
+
+    ASSERT_EQ(Bramble::StringView("three fourfive"), *iter);
+
+    ++iter;
+
+    ASSERT_EQ(Bramble::StringView("six"), *iter);
+
+    ++iter;
+
+    ASSERT_EQ(arg.end(), iter);
+}
+
+TEST(Argument, shall_truncate_to_working_buffer)
+{
+    const char argv[] = "one two three";
+    char working[8];
+    Bramble::Argument arg(argv, working, sizeof(working));
+
+    ASSERT_EQ(2, arg.size());
+    ASSERT_EQ(Bramble::StringView("one"), arg.front());
+    ASSERT_EQ(Bramble::StringView("two"), *(arg.begin()+1));
+    ASSERT_EQ(arg.begin()+2, arg.end());
+}
+
+TEST(Argument, shall_index_tokens)
+{
+    char argv[] = "one two 'three four' five";
+    Bramble::StringView index[4];
+    Bramble::Argument arg(argv, argv, sizeof(argv), index, 4);
+
+    ASSERT_EQ(4, arg.size());
+
+    ASSERT_EQ(Bramble::StringView("one"), arg[0]);
+    ASSERT_EQ(Bramble::StringView("two"), arg[1]);
+    ASSERT_EQ(Bramble::StringView("three four"), arg[2]);
+    ASSERT_EQ(Bramble::StringView("five"), arg[3]);
+
+    ASSERT_EQ(arg.begin()+4, arg.end());
+    ASSERT_EQ(4, arg.end() - arg.begin());
+    ASSERT_EQ(Bramble::StringView("three four"), *(arg.end()-2));
+    ASSERT_EQ(Bramble::StringView("two"), arg.begin()[1]);
+
+    auto front = arg.pop_front();
+
+    ASSERT_EQ(Bramble::StringView("one"), front);
+    ASSERT_EQ(3, arg.size());
+    ASSERT_EQ(Bramble::StringView("two"), arg[0]);
+    ASSERT_EQ(Bramble::StringView("five"), arg[2]);
+    ASSERT_EQ(arg.begin()+3, arg.end());
+}
+
+TEST(Argument, shall_fall_back_when_index_too_small)
+{
+    char argv[] = "one two three";
+    char expected_argv[] = "one two three";
+    Bramble::StringView index[2];
+    Bramble::Argument arg(argv, argv, sizeof(argv), index, 2);
+    Bramble::Argument expected(expected_argv, expected_argv, sizeof(expected_argv));
+
+    ASSERT_EQ(expected.size(), arg.size());
+    ASSERT_EQ(Bramble::StringView("three"), arg[2]);
+    ASSERT_EQ(Bramble::StringView("two"), *(arg.end()-2));
+    ASSERT_EQ(arg.begin()+3, arg.end());
+
+    auto e = expected.begin();
+
+    for(auto a = arg.begin(); a != arg.end(); ++a, ++e){
+
+        ASSERT_EQ(*e, *a);
+    }
+
+    ASSERT_EQ(expected.end(), e);
+}
+
+TEST(Argument, shall_index_argv)
+{
+    const char *argv[] = {"one", "two", "three"};
+    char working[32];
+    Bramble::StringView index[3];
+    Bramble::Argument arg(3, argv, working, sizeof(working), index, 3);
+
+    ASSERT_EQ(3, arg.size());
+    ASSERT_EQ(Bramble::StringView("one"), arg[0]);
+    ASSERT_EQ(Bramble::StringView("three"), arg[2]);
+    ASSERT_EQ(arg.begin()+3, arg.end());
+}
+
 int main(int argc, char **argv)
 {
     testing::InitGoogleTest(&argc, argv);
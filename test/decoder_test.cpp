@@ -3,6 +3,8 @@
 #include "bramble.hpp"
 
 #include <string>
+#include <cstdio>
+#include <vector>
 
 TEST(Decoder, shall_get_true)
 {
@@ -257,6 +259,487 @@ TEST(Decoder, shall_detect_non_hex_string)
     ASSERT_FALSE(eut.is_hex_string());
 }
 
+TEST(Decoder, shall_report_first_non_hex_character)
+{
+    const char input[] = " 00112233445566778899aabbccddeefg ";
+    Bramble::Decoder eut(input);
+    uint8_t output[100];
+    size_t error;
+
+    ASSERT_EQ(0U, eut.get_hex_string(output, sizeof(output), error));
+    ASSERT_EQ(31U, error);
+
+    ASSERT_EQ(0U, eut.get_hex_string(output, 2U, error));
+    ASSERT_EQ(31U, error);
+
+    ASSERT_EQ(0U, eut.get_hex_string(nullptr, 0U, error));
+    ASSERT_EQ(31U, error);
+
+    ASSERT_EQ(0U, Bramble::Decoder("0x").get_hex_string(nullptr, 0U, error));
+    ASSERT_EQ(1U, error);
+
+    ASSERT_EQ(1U, Bramble::Decoder("a").get_hex_string(nullptr, 0U, error));
+    ASSERT_EQ(size_t(Bramble::StringView::npos), error);
+}
+
+TEST(Decoder, shall_validate_hex_that_does_not_fit)
+{
+    const char input[] = "00112233445566778899aabbccddeeff";
+    uint8_t output[3];
+
+    ASSERT_EQ(16U, Bramble::Decoder(input).get_hex_string(output, sizeof(output)));
+    ASSERT_EQ(0x00U, output[0]);
+    ASSERT_EQ(0x11U, output[1]);
+    ASSERT_EQ(0x22U, output[2]);
+
+    ASSERT_EQ(0U, Bramble::Decoder("00112233445566778899aabbccddeefz").get_hex_string(output, sizeof(output)));
+}
+
+TEST(Decoder, shall_decode_hex_of_any_length)
+{
+    const char digits[] = "0123456789abcdefABCDEF";
+
+    for(size_t size = 1; size < 40; size++){
+
+        std::string input;
+        std::vector<uint8_t> expected((size + 1) / 2, 0);
+
+        for(size_t i = 0; i < size; i++){
+
+            char c = digits[(i * 7U + size) % (sizeof(digits) - 1U)];
+            uint8_t v = uint8_t((c <= '9') ? (c - '0') : ((c | 0x20) - 'a' + 10));
+
+            input.push_back(c);
+            expected[i / 2] |= uint8_t(((i & 1U) == 0U) ? (v << 4) : v);
+        }
+
+        std::vector<uint8_t> output(expected.size() + 1U, 0x5a);
+        size_t error;
+
+        ASSERT_EQ(expected.size(), Bramble::Decoder(input.c_str()).get_hex_string(output.data(), output.size(), error)) << size;
+        ASSERT_EQ(size_t(Bramble::StringView::npos), error);
+        ASSERT_TRUE(std::equal(expected.begin(), expected.end(), output.begin())) << size;
+        ASSERT_EQ(0x5aU, output.back());
+
+        for(size_t bad = 0; bad < size; bad++){
+
+            auto tmp = input;
+
+            tmp[bad] = 'g';
+
+            ASSERT_EQ(0U, Bramble::Decoder(tmp.c_str()).get_hex_string(output.data(), output.size(), error));
+            ASSERT_EQ(bad, error);
+        }
+    }
+}
+
+TEST(Decoder, shall_decode_b64_of_any_length)
+{
+    for(size_t size = 1; size < 300; size++){
+
+        std::vector<uint8_t> expected;
+
+        for(size_t i = 0; i < size; i++){
+
+            expected.push_back(uint8_t((i * 37U) + size));
+        }
+
+        std::string input(((size + 2U) / 3U) * 4U, ' ');
+        Bramble::BufferStream s(&input[0], input.size());
+
+        Bramble::Encoder(s).put_b64_string(expected.data(), expected.size());
+
+        std::vector<uint8_t> output(expected.size() + 1U, 0x5a);
+        size_t error;
+
+        ASSERT_EQ(expected.size(), Bramble::Decoder(input.c_str()).get_b64_string(output.data(), output.size(), error)) << size;
+        ASSERT_EQ(size_t(Bramble::StringView::npos), error);
+        ASSERT_TRUE(std::equal(expected.begin(), expected.end(), output.begin())) << size;
+        ASSERT_EQ(0x5aU, output.back());
+
+        for(size_t bad = 0; bad < input.size(); bad++){
+
+            auto tmp = input;
+
+            tmp[bad] = '*';
+
+            ASSERT_EQ(0U, Bramble::Decoder(tmp.c_str()).get_b64_string(output.data(), output.size(), error));
+            ASSERT_EQ(bad, error) << size;
+        }
+    }
+}
+
+TEST(Decoder, shall_validate_b64_that_does_not_fit)
+{
+    uint8_t output[4];
+
+    (void)memset(output, 0, sizeof(output));
+
+    ASSERT_EQ(11U, Bramble::Decoder("aGVsbG8gd29ybGQ=").get_b64_string(output, sizeof(output)));
+    ASSERT_EQ(0, memcmp(output, "hell", sizeof(output)));
+
+    ASSERT_EQ(0U, Bramble::Decoder("aGVsbG8gd2*ybGQ=").get_b64_string(output, sizeof(output)));
+}
+
+TEST(Decoder, shall_reject_b64_with_bad_padding)
+{
+    uint8_t output[16];
+    size_t error;
+
+    // unpadded
+    ASSERT_EQ(0U, Bramble::Decoder("aGVsbG8gd29ybGQ").get_b64_string(output, sizeof(output), error));
+    ASSERT_EQ(15U, error);
+
+    // padding before the end
+    ASSERT_EQ(0U, Bramble::Decoder("aGVs=G8gd29ybGQ=").get_b64_string(output, sizeof(output), error));
+    ASSERT_EQ(4U, error);
+
+    // too much padding
+    ASSERT_EQ(0U, Bramble::Decoder("aGVsbG8gd29y====").get_b64_string(output, sizeof(output), error));
+    ASSERT_EQ(12U, error);
+
+    // data after padding
+    ASSERT_EQ(0U, Bramble::Decoder("aGVsbG8gd29yb=A=").get_b64_string(output, sizeof(output), error));
+    ASSERT_EQ(13U, error);
+
+    // non-zero bits made redundant by padding
+    ASSERT_EQ(0U, Bramble::Decoder("aGVsbG8gd29ybGR=").get_b64_string(output, sizeof(output), error));
+    ASSERT_EQ(14U, error);
+    ASSERT_EQ(0U, Bramble::Decoder("aGVsbG8gd29ybB==").get_b64_string(output, sizeof(output), error));
+    ASSERT_EQ(13U, error);
+
+    // empty
+    ASSERT_FALSE(Bramble::Decoder("").is_b64_string());
+    ASSERT_FALSE(Bramble::Decoder("====").is_b64_string());
+}
+
+TEST(Decoder, shall_detect_integer_overflow_at_every_width)
+{
+    uint8_t u8;
+    uint16_t u16;
+    uint32_t u32;
+    uint64_t u64;
+    int8_t i8;
+    int16_t i16;
+    int32_t i32;
+    int64_t i64;
+
+    ASSERT_TRUE(Bramble::Decoder("255").get_uint8(u8));
+    ASSERT_EQ(255U, u8);
+    ASSERT_FALSE(Bramble::Decoder("256").get_uint8(u8));
+
+    ASSERT_TRUE(Bramble::Decoder("65535").get_uint16(u16));
+    ASSERT_EQ(65535U, u16);
+    ASSERT_FALSE(Bramble::Decoder("65536").get_uint16(u16));
+
+    ASSERT_TRUE(Bramble::Decoder("4294967295").get_uint32(u32));
+    ASSERT_EQ(4294967295U, u32);
+    ASSERT_FALSE(Bramble::Decoder("4294967296").get_uint32(u32));
+    ASSERT_FALSE(Bramble::Decoder("42949672950").get_uint32(u32));
+    ASSERT_FALSE(Bramble::Decoder("9999999999").get_uint32(u32));
+
+    ASSERT_TRUE(Bramble::Decoder("18446744073709551615").get_uint64(u64));
+    ASSERT_EQ(UINT64_MAX, u64);
+    ASSERT_FALSE(Bramble::Decoder("18446744073709551616").get_uint64(u64));
+    ASSERT_FALSE(Bramble::Decoder("18446744073709551620").get_uint64(u64));
+    ASSERT_FALSE(Bramble::Decoder("28446744073709551615").get_uint64(u64));
+    ASSERT_FALSE(Bramble::Decoder("99999999999999999999").get_uint64(u64));
+    ASSERT_FALSE(Bramble::Decoder("100000000000000000000").get_uint64(u64));
+
+    ASSERT_TRUE(Bramble::Decoder("00000000000000000000000018446744073709551615").get_uint64(u64));
+    ASSERT_EQ(UINT64_MAX, u64);
+
+    ASSERT_TRUE(Bramble::Decoder("-128").get_int8(i8));
+    ASSERT_EQ(INT8_MIN, i8);
+    ASSERT_FALSE(Bramble::Decoder("-129").get_int8(i8));
+    ASSERT_TRUE(Bramble::Decoder("127").get_int8(i8));
+    ASSERT_FALSE(Bramble::Decoder("128").get_int8(i8));
+
+    ASSERT_TRUE(Bramble::Decoder("-32768").get_int16(i16));
+    ASSERT_EQ(INT16_MIN, i16);
+    ASSERT_FALSE(Bramble::Decoder("-32769").get_int16(i16));
+    ASSERT_FALSE(Bramble::Decoder("32768").get_int16(i16));
+
+    ASSERT_TRUE(Bramble::Decoder("-2147483648").get_int32(i32));
+    ASSERT_EQ(INT32_MIN, i32);
+    ASSERT_FALSE(Bramble::Decoder("-2147483649").get_int32(i32));
+    ASSERT_TRUE(Bramble::Decoder("2147483647").get_int32(i32));
+    ASSERT_FALSE(Bramble::Decoder("2147483648").get_int32(i32));
+
+    ASSERT_TRUE(Bramble::Decoder("-9223372036854775808").get_int64(i64));
+    ASSERT_EQ(INT64_MIN, i64);
+    ASSERT_FALSE(Bramble::Decoder("-9223372036854775809").get_int64(i64));
+    ASSERT_TRUE(Bramble::Decoder("9223372036854775807").get_int64(i64));
+    ASSERT_EQ(INT64_MAX, i64);
+    ASSERT_FALSE(Bramble::Decoder("9223372036854775808").get_int64(i64));
+
+    ASSERT_TRUE(Bramble::Decoder("-0").get_int64(i64));
+    ASSERT_EQ(0, i64);
+    ASSERT_FALSE(Bramble::Decoder("-").get_int64(i64));
+    ASSERT_FALSE(Bramble::Decoder("").get_int64(i64));
+    ASSERT_FALSE(Bramble::Decoder("--1").get_int64(i64));
+}
+
+TEST(Decoder, shall_get_hex_and_binary_integers)
+{
+    uint8_t u8;
+    uint64_t u64;
+    int8_t i8;
+    int32_t i32;
+    int64_t i64;
+
+    ASSERT_TRUE(Bramble::Decoder("0xff").get_uint8(u8));
+    ASSERT_EQ(0xffU, u8);
+    ASSERT_FALSE(Bramble::Decoder("0x100").get_uint8(u8));
+    ASSERT_TRUE(Bramble::Decoder("0X0000000000000000000000A5").get_uint8(u8));
+    ASSERT_EQ(0xa5U, u8);
+
+    ASSERT_TRUE(Bramble::Decoder("0b11111111").get_uint8(u8));
+    ASSERT_EQ(0xffU, u8);
+    ASSERT_FALSE(Bramble::Decoder("0b100000000").get_uint8(u8));
+    ASSERT_FALSE(Bramble::Decoder("0b102").get_uint8(u8));
+
+    ASSERT_TRUE(Bramble::Decoder("0xffffffffffffffff").get_uint64(u64));
+    ASSERT_EQ(UINT64_MAX, u64);
+    ASSERT_FALSE(Bramble::Decoder("0x10000000000000000").get_uint64(u64));
+    ASSERT_FALSE(Bramble::Decoder("0x").get_uint64(u64));
+    ASSERT_FALSE(Bramble::Decoder("0xg").get_uint64(u64));
+    ASSERT_FALSE(Bramble::Decoder("0b").get_uint64(u64));
+
+    // two's complement as put by Encoder::put_int()
+    ASSERT_TRUE(Bramble::Decoder("0xffffffff").get_int32(i32));
+    ASSERT_EQ(-1, i32);
+    ASSERT_TRUE(Bramble::Decoder("0x80000000").get_int32(i32));
+    ASSERT_EQ(INT32_MIN, i32);
+    ASSERT_FALSE(Bramble::Decoder("0x100000000").get_int32(i32));
+    ASSERT_TRUE(Bramble::Decoder("0xfffffffe").get_int8(i8));
+    ASSERT_EQ(-2, i8);
+    ASSERT_TRUE(Bramble::Decoder("0x7f").get_int8(i8));
+    ASSERT_EQ(127, i8);
+    ASSERT_FALSE(Bramble::Decoder("0xff").get_int8(i8));
+    ASSERT_TRUE(Bramble::Decoder("0x8000000000000000").get_int64(i64));
+    ASSERT_EQ(INT64_MIN, i64);
+
+    // sign only with decimal
+    ASSERT_FALSE(Bramble::Decoder("-0x1").get_int32(i32));
+
+    ASSERT_TRUE(Bramble::Decoder("0x10").is_unsigned());
+    ASSERT_TRUE(Bramble::Decoder("0x10").is_int());
+    ASSERT_FALSE(Bramble::Decoder("0x10").is_hex_string());
+}
+
+TEST(Decoder, shall_round_trip_every_16_bit_integer)
+{
+    for(uint32_t i = 0; i <= UINT16_MAX; i++){
+
+        char buf[32];
+        uint16_t u;
+        int16_t s;
+        int32_t expected = int32_t(i) - 32768;
+
+        (void)snprintf(buf, sizeof(buf), "%u", unsigned(i));
+        ASSERT_TRUE(Bramble::Decoder(buf).get_uint16(u)) << buf;
+        ASSERT_EQ(i, u);
+
+        (void)snprintf(buf, sizeof(buf), "0x%x", unsigned(i));
+        ASSERT_TRUE(Bramble::Decoder(buf).get_uint16(u)) << buf;
+        ASSERT_EQ(i, u);
+
+        (void)snprintf(buf, sizeof(buf), "%d", int(expected));
+        ASSERT_TRUE(Bramble::Decoder(buf).get_int16(s)) << buf;
+        ASSERT_EQ(expected, s);
+
+        (void)snprintf(buf, sizeof(buf), "0x%x", unsigned(uint32_t(expected)));
+        ASSERT_TRUE(Bramble::Decoder(buf).get_int16(s)) << buf;
+        ASSERT_EQ(expected, s);
+    }
+}
+
+TEST(Decoder, shall_reject_non_digit_in_every_position)
+{
+    const char digits[] = "12345678901234567890";
+    const char bad[] = {'/', ':', ' ', 'a', '-', '\x80', '\xb0'};
+
+    uint64_t expected = 0;
+
+    for(size_t size = 1; size < 20; size++){
+
+        std::string input(digits, size);
+        uint64_t v;
+
+        expected = (expected * 10U) + uint64_t(digits[size - 1] - '0');
+
+        ASSERT_TRUE(Bramble::Decoder(input.c_str()).get_uint64(v)) << input;
+        ASSERT_EQ(expected, v) << input;
+
+        for(size_t pos = 0; pos < size; pos++){
+
+            for(auto c : bad){
+
+                auto tmp = input;
+
+                tmp[pos] = c;
+
+                // whitespace at either end is stripped
+                if((c == ' ') && ((pos == 0) || (pos == (size - 1U)))){
+
+                    continue;
+                }
+
+                ASSERT_FALSE(Bramble::Decoder(tmp.c_str()).get_uint64(v)) << tmp;
+            }
+        }
+    }
+}
+
+TEST(Decoder, shall_get_double_and_float)
+{
+    double d;
+    float f;
+
+    ASSERT_TRUE(Bramble::Decoder(" 868.1 ").get_double(d));
+    ASSERT_EQ(868.1, d);
+    ASSERT_TRUE(Bramble::Decoder("-1e-7").get_double(d));
+    ASSERT_EQ(-1e-7, d);
+    ASSERT_TRUE(Bramble::Decoder("0.1").get_float(f));
+    ASSERT_EQ(0.1f, f);
+    ASSERT_TRUE(Bramble::Decoder("42").get_double(d));
+    ASSERT_EQ(42.0, d);
+
+    ASSERT_FALSE(Bramble::Decoder("868.1MHz").get_double(d));
+    ASSERT_FALSE(Bramble::Decoder("").get_double(d));
+    ASSERT_FALSE(Bramble::Decoder("1e39").get_float(f));
+}
+
+TEST(Decoder, shall_get_fixed)
+{
+    int64_t v;
+
+    ASSERT_TRUE(Bramble::Decoder("868.1").get_fixed(v, 3));
+    ASSERT_EQ(868100, v);
+    ASSERT_TRUE(Bramble::Decoder("-0.5").get_fixed(v, 1));
+    ASSERT_EQ(-5, v);
+    ASSERT_TRUE(Bramble::Decoder("42").get_fixed(v, 2));
+    ASSERT_EQ(4200, v);
+    ASSERT_TRUE(Bramble::Decoder(".25").get_fixed(v, 2));
+    ASSERT_EQ(25, v);
+    ASSERT_TRUE(Bramble::Decoder("1.2500").get_fixed(v, 2));
+    ASSERT_EQ(125, v);
+    ASSERT_TRUE(Bramble::Decoder("-9.223372036854775808").get_fixed(v, 18));
+    ASSERT_EQ(INT64_MIN, v);
+    ASSERT_TRUE(Bramble::Decoder("9223372036854775807").get_fixed(v, 0));
+    ASSERT_EQ(INT64_MAX, v);
+
+    // too many decimals
+    ASSERT_FALSE(Bramble::Decoder("1.251").get_fixed(v, 2));
+    // overflow
+    ASSERT_FALSE(Bramble::Decoder("9223372036854775808").get_fixed(v, 0));
+    ASSERT_FALSE(Bramble::Decoder("92233720368547758.08").get_fixed(v, 3));
+    ASSERT_FALSE(Bramble::Decoder("1").get_fixed(v, 19));
+    // syntax
+    ASSERT_FALSE(Bramble::Decoder("").get_fixed(v, 2));
+    ASSERT_FALSE(Bramble::Decoder(".").get_fixed(v, 2));
+    ASSERT_FALSE(Bramble::Decoder("-").get_fixed(v, 2));
+    ASSERT_FALSE(Bramble::Decoder("1.2.3").get_fixed(v, 3));
+    ASSERT_FALSE(Bramble::Decoder("1e3").get_fixed(v, 3));
+}
+
+TEST(Decoder, shall_keep_analysis_when_copied)
+{
+    Bramble::Decoder eut(" freq=868 ");
+    Bramble::Decoder other("42");
+    Bramble::Decoder copy(eut);
+
+    ASSERT_TRUE(copy.is_named());
+    ASSERT_EQ(Bramble::StringView("freq"), copy.name());
+    ASSERT_EQ(Bramble::StringView("868 "), copy.named_value());
+
+    copy.swap(other);
+
+    ASSERT_FALSE(copy.is_named());
+    ASSERT_TRUE(copy.name().empty());
+    ASSERT_TRUE(copy.is_unsigned());
+
+    ASSERT_TRUE(other.name_eq("freq"));
+
+    copy = eut;
+
+    ASSERT_TRUE(copy.name_eq("freq"));
+    ASSERT_FALSE(Bramble::Decoder().is_named());
+    ASSERT_EQ(0U, Bramble::Decoder().classify());
+}
+
+static unsigned classify_with_getters(const Bramble::Decoder& d)
+{
+    bool b;
+    uint64_t u;
+    int64_t i;
+    double f;
+    unsigned retval = 0U;
+
+    retval |= d.get_bool(b) ? unsigned(Bramble::Decoder::Bool) : 0U;
+    retval |= d.get_uint64(u) ? unsigned(Bramble::Decoder::Unsigned) : 0U;
+    retval |= d.get_int64(i) ? unsigned(Bramble::Decoder::Signed) : 0U;
+    retval |= d.get_double(f) ? unsigned(Bramble::Decoder::Float) : 0U;
+    retval |= d.is_hex_string() ? unsigned(Bramble::Decoder::Hex) : 0U;
+    retval |= d.is_b64_string() ? unsigned(Bramble::Decoder::Base64) : 0U;
+
+    return retval;
+}
+
+TEST(Decoder, shall_classify)
+{
+    const char *input[] = {
+        "", " ", "true", "FALSE", "truee", "0", "42", " 42 ", "-42", "1.5", "-1.5e3", "1e400",
+        "18446744073709551615", "18446744073709551616", "9223372036854775807", "9223372036854775808",
+        "-9223372036854775808", "-9223372036854775809", "0x1f", "0XFFFFFFFFFFFFFFFF", "0x10000000000000000",
+        "0b101", "0b", "0x", "-0x1", "+1", "inf", "-inf", "nan", "abcd", "ab=", "QQ==", "QR==", "QUE=",
+        "QUF=", "Q===", "====", "QUJD", "QUJDRA", "dead", "beef", "12345678", "00000000000000000000000001",
+        "1234", "123=", "deadbeef=", "x", "-", ".", "e5", "1e", "-0", "0.0"
+    };
+
+    for(auto s : input){
+
+        Bramble::Decoder eut(s);
+
+        ASSERT_EQ(classify_with_getters(eut), eut.classify()) << s;
+    }
+
+    ASSERT_EQ(unsigned(Bramble::Decoder::Unsigned | Bramble::Decoder::Signed | Bramble::Decoder::Float | Bramble::Decoder::Hex | Bramble::Decoder::Base64), Bramble::Decoder("1234").classify());
+    ASSERT_EQ(unsigned(Bramble::Decoder::Bool | Bramble::Decoder::Base64), Bramble::Decoder("true").classify());
+    ASSERT_EQ(unsigned(Bramble::Decoder::Signed | Bramble::Decoder::Float), Bramble::Decoder("-1").classify());
+}
+
+TEST(Decoder, shall_classify_random_input)
+{
+    const char alphabet[] = "0123456789abcdefxXbB+-.=eEinfINF/QZ t";
+    uint32_t x = 2463534242UL;
+
+    for(size_t n = 0; n < 100000; n++){
+
+        char buffer[12];
+
+        x ^= x << 13;
+        x ^= x >> 17;
+        x ^= x << 5;
+
+        size_t size = x % sizeof(buffer);
+
+        for(size_t i = 0; i < size; i++){
+
+            x ^= x << 13;
+            x ^= x >> 17;
+            x ^= x << 5;
+
+            buffer[i] = alphabet[x % (sizeof(alphabet) - 1U)];
+        }
+
+        Bramble::Decoder eut(buffer, size);
+
+        ASSERT_EQ(classify_with_getters(eut), eut.classify()) << std::string(buffer, size);
+    }
+}
+
 int main(int argc, char **argv)
 {
     testing::InitGoogleTest(&argc, argv);
@@ -3,6 +3,8 @@
 #include "bramble.hpp"
 
 #include <string>
+#include <vector>
+#include <cstdio>
 
 class TestStream : public Bramble::Stream {
 public:
@@ -10,11 +12,13 @@ public:
     size_t write(const void *value, size_t size)
     {
         s.append((const char *)value, size);
+        writes++;
 
         return size;
     }
 
     std::string s;
+    size_t writes = 0;
 };
 
 TEST(Encoder, shall_put_true)
@@ -101,6 +105,76 @@ TEST(Encoder, shall_put_hex_string_null_terminated)
     ASSERT_EQ("68656c6c6f20776f726c64", output.s);
 }
 
+TEST(Encoder, shall_put_upper_case_hex)
+{
+    TestStream output;
+    Bramble::Encoder eut(output);
+
+    const uint8_t input[] = {0x00, 0xab, 0xcd, 0xef, 0x19};
+
+    eut.put_hex_string(input, sizeof(input), Bramble::Encoder::Case::kUpper);
+
+    ASSERT_EQ("00ABCDEF19", output.s);
+}
+
+TEST(Encoder, shall_put_hex_dump)
+{
+    TestStream output;
+    Bramble::Encoder eut(output);
+
+    const uint8_t input[] = {0x00, 0x11, 0x22, 0x33, 0x44, 0x55, 0x66, 0x77, 0x88, 0x99};
+
+    eut.put_hex_dump(input, sizeof(input), 4);
+    eut.put_char('|');
+    eut.put_hex_dump(input, 4, 2, ':', Bramble::Encoder::Case::kUpper);
+    eut.put_char('|');
+    eut.put_hex_dump(input, 4, 4);
+    eut.put_char('|');
+    eut.put_hex_dump(input, 4, 0);
+
+    ASSERT_EQ("00112233 44556677 8899|0011:2233|00112233|00112233", output.s);
+}
+
+TEST(Encoder, shall_put_hex_in_blocks)
+{
+    const size_t groups[] = {0, 1, 3, 4, 63, 64, 65};
+
+    for(size_t size = 0; size < 300; size++){
+
+        std::vector<uint8_t> input;
+
+        for(size_t i = 0; i < size; i++){
+
+            input.push_back(uint8_t((i * 37U) + size));
+        }
+
+        for(auto group : groups){
+
+            std::string expected;
+
+            for(size_t i = 0; i < size; i++){
+
+                char tmp[3];
+
+                if((group > 0U) && (i > 0U) && ((i % group) == 0U)){
+
+                    expected.push_back('-');
+                }
+
+                (void)snprintf(tmp, sizeof(tmp), "%02x", input[i]);
+                expected.append(tmp);
+            }
+
+            TestStream output;
+
+            Bramble::Encoder(output).put_hex_dump(input.data(), input.size(), group, '-');
+
+            ASSERT_EQ(expected, output.s) << size << " " << group;
+            ASSERT_LE(output.writes, (expected.size() + 126U) / 127U) << size << " " << group;
+        }
+    }
+}
+
 TEST(Encoder, shall_put_b64)
 {
     TestStream output;
@@ -149,6 +223,41 @@ TEST(Encoder, shall_put_b64_null_terminated)
     ASSERT_EQ("aGVsbG8gd29ybGQ=", output.s);
 }
 
+TEST(Encoder, shall_put_b64_of_any_length)
+{
+    const char table[] = "ABCDEFGHIJKLMNOPQRSTUVWXYZabcdefghijklmnopqrstuvwxyz0123456789+/";
+
+    for(size_t size = 0; size < 300; size++){
+
+        std::string input;
+        std::string expected;
+
+        for(size_t i = 0; i < size; i++){
+
+            input.push_back(char((i * 37U) + size));
+        }
+
+        for(size_t i = 0; i < size; i += 3){
+
+            uint32_t v = uint32_t(uint8_t(input[i])) << 16;
+
+            v |= ((i + 1U) < size) ? (uint32_t(uint8_t(input[i + 1U])) << 8) : 0U;
+            v |= ((i + 2U) < size) ? uint32_t(uint8_t(input[i + 2U])) : 0U;
+
+            expected.push_back(table[(v >> 18) & 0x3fU]);
+            expected.push_back(table[(v >> 12) & 0x3fU]);
+            expected.push_back(((i + 1U) < size) ? table[(v >> 6) & 0x3fU] : '=');
+            expected.push_back(((i + 2U) < size) ? table[v & 0x3fU] : '=');
+        }
+
+        TestStream output;
+
+        Bramble::Encoder(output).put_b64_string(input.data(), input.size());
+
+        ASSERT_EQ(expected, output.s) << size;
+    }
+}
+
 TEST(Encoder, shall_put_unsigned_int)
 {
     TestStream output;
@@ -235,6 +344,70 @@ TEST(Encoder, shall_put_smallest_signed_int)
     ASSERT_EQ("-9223372036854775808", output.s);
 }
 
+TEST(Encoder, shall_put_smallest_int32)
+{
+    TestStream output;
+    Bramble::Encoder eut(output);
+
+    eut.put_int(int32_t(INT32_MIN));
+
+    ASSERT_EQ("-2147483648", output.s);
+    ASSERT_EQ(1U, output.writes);
+}
+
+TEST(Encoder, shall_put_hex_int)
+{
+    TestStream output;
+    Bramble::Encoder eut(output);
+
+    eut.put_int(uint32_t(0), Bramble::Encoder::Base::k16);
+    eut.put_space();
+    eut.put_int(uint64_t(UINT64_MAX), Bramble::Encoder::Base::k16);
+    eut.put_space();
+    eut.put_int(uint8_t(0xa5), Bramble::Encoder::Base::k16);
+
+    ASSERT_EQ("0x0 0xffffffffffffffff 0xa5", output.s);
+}
+
+TEST(Encoder, shall_put_negative_hex_int_as_twos_complement)
+{
+    TestStream output;
+    Bramble::Encoder eut(output);
+
+    eut.put_int(int32_t(-1), Bramble::Encoder::Base::k16);
+    eut.put_space();
+    eut.put_int(int64_t(INT64_MIN), Bramble::Encoder::Base::k16);
+    eut.put_space();
+    eut.put_int(int8_t(-2), Bramble::Encoder::Base::k16);
+
+    ASSERT_EQ("0xffffffff 0x8000000000000000 0xfffffffe", output.s);
+}
+
+TEST(Encoder, shall_put_double_and_float)
+{
+    TestStream output;
+    Bramble::Encoder eut(output);
+
+    eut.put_double(868.1).put_space().put_double(-1e-7).put_space().put_float(0.1f);
+
+    ASSERT_EQ("868.1 -1e-7 0.1", output.s);
+    ASSERT_EQ(5U, output.writes);
+}
+
+TEST(Encoder, shall_put_fixed)
+{
+    TestStream output;
+    Bramble::Encoder eut(output);
+
+    eut.put_fixed(868100, 3).put_space();
+    eut.put_fixed(-5, 1).put_space();
+    eut.put_fixed(7, 3).put_space();
+    eut.put_fixed(42, 0).put_space();
+    eut.put_fixed(INT64_MIN, 18);
+
+    ASSERT_EQ("868.100 -0.5 0.007 42 -9.223372036854775808", output.s);
+}
+
 int main(int argc, char **argv)
 {
     testing::InitGoogleTest(&argc, argv);
@@ -0,0 +1,204 @@
+#include "gtest/gtest.h"
+
+#include "bramble.hpp"
+
+#include <string>
+#include <thread>
+#include <vector>
+#include <set>
+
+class Host : public Bramble::Server::Host {
+public:
+
+    std::string output;
+
+    Bramble::Server::Events *events = nullptr;
+
+    bool call(Bramble::Server::Command&, const Bramble::Argument&)
+    {
+        // raised while the response is being written
+        if(events != nullptr){
+
+            events->event("during");
+        }
+
+        return true;
+    }
+
+    void write(const char *buffer, size_t size)
+    {
+        output.append(buffer, size);
+    }
+};
+
+static void process(Bramble::Server& server, const char *s)
+{
+    server.process(s, strlen(s));
+}
+
+TEST(EventQueue, shall_write_from_process)
+{
+    Host host;
+    Bramble::Server server(host);
+    Bramble::EventQueue<4, 32> events;
+
+    server.set_events(&events);
+
+    ASSERT_TRUE(events.event("one"));
+    ASSERT_TRUE(events.log("two", [](Bramble::Stream& s){
+
+        Bramble::Encoder(s).put_uint8(42);
+    }));
+
+    ASSERT_TRUE(host.output.empty());
+
+    process(server, "");
+
+    ASSERT_EQ("EVT: one\r\nLOG: two 42\r\n", host.output);
+}
+
+TEST(EventQueue, shall_write_between_transactions)
+{
+    Host host;
+    Bramble::Server server(host);
+    Bramble::EventQueue<4, 32> events;
+
+    server.set_events(&events);
+    host.events = &events;
+
+    process(server, "a\rb\r");
+
+    ASSERT_EQ("CMD:a\r\nACK:a\r\nEVT: during\r\nCMD:b\r\nACK:b\r\nEVT: during\r\n", host.output);
+}
+
+TEST(EventQueue, shall_drop_when_full)
+{
+    Host host;
+    Bramble::Server server(host);
+    Bramble::EventQueue<2, 32> events;
+
+    server.set_events(&events);
+
+    ASSERT_TRUE(events.event("one"));
+    ASSERT_TRUE(events.event("two"));
+    ASSERT_FALSE(events.event("three"));
+
+    ASSERT_EQ(1U, events.dropped());
+
+    process(server, "");
+
+    ASSERT_TRUE(events.event("four"));
+
+    process(server, "");
+
+    ASSERT_EQ("EVT: one\r\nEVT: two\r\nEVT: four\r\n", host.output);
+}
+
+TEST(EventQueue, shall_drop_too_long)
+{
+    Host host;
+    Bramble::Server server(host);
+    Bramble::EventQueue<2, 8> events;
+
+    server.set_events(&events);
+
+    ASSERT_TRUE(events.event("123"));
+    ASSERT_FALSE(events.event("1234"));
+    ASSERT_EQ(1U, events.dropped());
+
+    process(server, "");
+
+    ASSERT_EQ("EVT: 123\r\n", host.output);
+}
+
+TEST(EventQueue, shall_accept_many_producers)
+{
+    const size_t producers = 4;
+    const size_t per_producer = 10000;
+
+    Host host;
+    Bramble::Server server(host);
+    Bramble::EventQueue<64, 32> events;
+
+    server.set_events(&events);
+
+    std::vector<std::thread> threads;
+    std::atomic<size_t> posted(0);
+
+    for(size_t p = 0; p < producers; p++){
+
+        threads.emplace_back([&events, &posted, p, per_producer](){
+
+            for(size_t i = 0; i < per_producer; i++){
+
+                if(events.event("e", [p, i](Bramble::Stream& s){
+
+                    Bramble::Encoder(s).put_uint32(uint32_t(p)).space().put_uint32(uint32_t(i));
+                })){
+
+                    posted++;
+                }
+            }
+        });
+    }
+
+    while((posted + events.dropped()) < (producers * per_producer)){
+
+        process(server, "");
+    }
+
+    for(auto& t : threads){
+
+        t.join();
+    }
+
+    process(server, "");
+
+    ASSERT_EQ(producers * per_producer, posted + events.dropped());
+
+    // every line is intact and each producer's lines are in order
+    std::vector<long> last(producers, -1);
+    size_t lines = 0;
+
+    for(size_t pos = 0; pos < host.output.size();){
+
+        auto eol = host.output.find("\r\n", pos);
+
+        ASSERT_NE(std::string::npos, eol);
+
+        unsigned p, i;
+
+        ASSERT_EQ(2, sscanf(host.output.substr(pos, eol - pos).c_str(), "EVT: e %u %u", &p, &i));
+        ASSERT_LT(p, producers);
+        ASSERT_GT(long(i), last[p]);
+
+        last[p] = i;
+        lines++;
+        pos = eol + 2;
+    }
+
+    ASSERT_EQ(posted, lines);
+}
+
+TEST(EventQueue, shall_post_typed_arguments)
+{
+    Host host;
+    Bramble::Server server(host);
+    Bramble::EventQueue<4, 32> events;
+
+    server.set_events(&events);
+
+    ASSERT_TRUE(events.event("rx", Bramble::kv("rssi", -80), 3U));
+    ASSERT_TRUE(events.log("note", "x"));
+
+    process(server, "");
+
+    ASSERT_EQ("EVT: rx rssi=-80 3\r\nLOG: note x\r\n", host.output);
+}
+
+int main(int argc, char **argv)
+{
+    testing::InitGoogleTest(&argc, argv);
+
+    return RUN_ALL_TESTS();
+}
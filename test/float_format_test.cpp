@@ -0,0 +1,213 @@
+#include "gtest/gtest.h"
+
+#include "bramble.hpp"
+
+#include <string>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <cmath>
+#include <limits>
+
+template<typename T>
+static std::string format(T value)
+{
+    char buf[Bramble::FloatFormat::max_chars];
+
+    return std::string(buf, Bramble::FloatFormat::to_chars(buf, buf + sizeof(buf), value));
+}
+
+template<typename T>
+static bool parse(const char *s, T& value)
+{
+    auto end = s + strlen(s);
+
+    return Bramble::FloatFormat::from_chars(s, end, value) == end;
+}
+
+// xorshift
+static uint64_t next(uint64_t& x)
+{
+    x ^= x << 13;
+    x ^= x >> 7;
+    x ^= x << 17;
+
+    return x;
+}
+
+TEST(FloatFormat, shall_put_shortest_representation)
+{
+    ASSERT_EQ("868.1", format(868.1));
+    ASSERT_EQ("0.1", format(0.1));
+    ASSERT_EQ("0.3", format(0.3));
+    ASSERT_EQ("100", format(100.0));
+    ASSERT_EQ("-2.5", format(-2.5));
+    ASSERT_EQ("0", format(0.0));
+    ASSERT_EQ("-0", format(-0.0));
+    ASSERT_EQ("0.0001", format(1e-4));
+    ASSERT_EQ("1e-5", format(1e-5));
+    ASSERT_EQ("123456789012345", format(123456789012345.0));
+    ASSERT_EQ("1e21", format(1e21));
+    ASSERT_EQ("1.7976931348623157e308", format(std::numeric_limits<double>::max()));
+    ASSERT_EQ("5e-324", format(std::numeric_limits<double>::denorm_min()));
+    ASSERT_EQ("0.1", format(0.1f));
+    ASSERT_EQ("868.1", format(868.1f));
+    ASSERT_EQ("3.4028235e38", format(std::numeric_limits<float>::max()));
+    ASSERT_EQ("nan", format(std::numeric_limits<double>::quiet_NaN()));
+    ASSERT_EQ("inf", format(std::numeric_limits<double>::infinity()));
+    ASSERT_EQ("-inf", format(-std::numeric_limits<float>::infinity()));
+}
+
+TEST(FloatFormat, shall_round_trip_random_values)
+{
+    uint64_t x = 88172645463325252ULL;
+
+    for(size_t i = 0; i < 100000; i++){
+
+        uint64_t bits = next(x);
+        uint32_t fbits = uint32_t(bits >> 16);
+        double d, rd;
+        float f, rf;
+
+        (void)memcpy(&d, &bits, sizeof(d));
+        (void)memcpy(&f, &fbits, sizeof(f));
+
+        if(std::isfinite(d)){
+
+            auto s = format(d);
+
+            ASSERT_TRUE(parse(s.c_str(), rd)) << s;
+            ASSERT_EQ(0, memcmp(&d, &rd, sizeof(d))) << s;
+            ASSERT_EQ(d, strtod(s.c_str(), nullptr)) << s;
+        }
+
+        if(std::isfinite(f)){
+
+            auto s = format(f);
+
+            ASSERT_TRUE(parse(s.c_str(), rf)) << s;
+            ASSERT_EQ(0, memcmp(&f, &rf, sizeof(f))) << s;
+            ASSERT_EQ(f, strtof(s.c_str(), nullptr)) << s;
+        }
+    }
+}
+
+TEST(FloatFormat, shall_parse_correctly_rounded)
+{
+    uint64_t x = 88172645463325252ULL;
+
+    for(size_t i = 0; i < 100000; i++){
+
+        char s[64];
+        double d;
+        float f;
+
+        // up to 19 significant digits over the whole exponent range
+        (void)snprintf(s, sizeof(s), "%llue%d", (unsigned long long)(next(x) >> (next(x) % 64U)) % 10000000000000000000ULL, int(next(x) % 700U) - 360);
+
+        double expected = strtod(s, nullptr);
+        float expected_f = strtof(s, nullptr);
+
+        if(std::isinf(expected)){
+
+            ASSERT_FALSE(parse(s, d)) << s;
+        }
+        else{
+
+            ASSERT_TRUE(parse(s, d)) << s;
+            ASSERT_EQ(0, memcmp(&expected, &d, sizeof(d))) << s;
+        }
+
+        if(!std::isinf(expected_f)){
+
+            ASSERT_TRUE(parse(s, f)) << s;
+            ASSERT_EQ(0, memcmp(&expected_f, &f, sizeof(f))) << s;
+        }
+    }
+}
+
+TEST(FloatFormat, shall_parse_halfway_cases)
+{
+    const char *cases[] = {
+        "9007199254740993",             // 2^53 + 1, ties to even
+        "9007199254740995",
+        "2.2250738585072011e-308",      // largest subnormal boundary
+        "2.2250738585072012e-308",
+        "4.9406564584124654e-324",
+        "2.4703282292062328e-324",      // just above half the smallest subnormal
+        "2.4703282292062327e-324",      // just below
+        "1.7976931348623158e308",
+        "0.1000000000000000055511151231257827",
+        "7.038531e-26",
+        "1.000000059604644776",         // just above float halfway 1 + 2^-24
+        "1.000000059604644775",         // just below
+        "3.4028235677973366e38"
+    };
+
+    for(auto s : cases){
+
+        double d;
+        float f;
+
+        ASSERT_TRUE(parse(s, d)) << s;
+        ASSERT_EQ(strtod(s, nullptr), d) << s;
+
+        if(!std::isinf(strtof(s, nullptr))){
+
+            ASSERT_TRUE(parse(s, f)) << s;
+            ASSERT_EQ(strtof(s, nullptr), f) << s;
+        }
+    }
+}
+
+TEST(FloatFormat, shall_parse_syntax)
+{
+    double d;
+
+    ASSERT_TRUE(parse("1", d));
+    ASSERT_EQ(1.0, d);
+    ASSERT_TRUE(parse("-1.5e+3", d));
+    ASSERT_EQ(-1500.0, d);
+    ASSERT_TRUE(parse(".5", d));
+    ASSERT_EQ(0.5, d);
+    ASSERT_TRUE(parse("5.", d));
+    ASSERT_EQ(5.0, d);
+    ASSERT_TRUE(parse("0.000000000000000000000000000001", d));
+    ASSERT_EQ(1e-30, d);
+    ASSERT_TRUE(parse("1E2", d));
+    ASSERT_EQ(100.0, d);
+    ASSERT_TRUE(parse("1e-999999999", d));
+    ASSERT_EQ(0.0, d);
+    ASSERT_TRUE(parse("-inf", d));
+    ASSERT_TRUE(std::isinf(d) && (d < 0));
+    ASSERT_TRUE(parse("NaN", d));
+    ASSERT_TRUE(std::isnan(d));
+
+    ASSERT_FALSE(parse("", d));
+    ASSERT_FALSE(parse("-", d));
+    ASSERT_FALSE(parse(".", d));
+    ASSERT_FALSE(parse("e5", d));
+    ASSERT_FALSE(parse("1e", d));
+    ASSERT_FALSE(parse("1e+", d));
+    ASSERT_FALSE(parse("1.2.3", d));
+    ASSERT_FALSE(parse("1e309", d));
+    ASSERT_FALSE(parse("0x10", d));
+}
+
+TEST(FloatFormat, shall_not_write_if_it_does_not_fit)
+{
+    char buf[4] = {'a', 'b', 'c', 'd'};
+
+    ASSERT_EQ(nullptr, Bramble::FloatFormat::to_chars(buf, buf + 4, 868.1));
+    ASSERT_EQ(0, memcmp(buf, "abcd", sizeof(buf)));
+
+    ASSERT_EQ(buf + 3, Bramble::FloatFormat::to_chars(buf, buf + 4, 0.5));
+    ASSERT_EQ(0, memcmp(buf, "0.5d", sizeof(buf)));
+}
+
+int main(int argc, char **argv)
+{
+    testing::InitGoogleTest(&argc, argv);
+
+    return RUN_ALL_TESTS();
+}
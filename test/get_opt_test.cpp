@@ -2,6 +2,8 @@
 
 #include "bramble.hpp"
 
+#include <cstring>
+
 TEST(GetOpt, shall_have_init_state)
 {
     char argv[] = "";
@@ -581,6 +583,95 @@ TEST(GetOpt, shall_parse_short_chain3)
     ASSERT_EQ(Bramble::StringView("test"), value.value());
 }
 
+namespace {
+
+    constexpr Bramble::GetOpt::Option indexed_options[] = {
+        {"alpha", 'a', Bramble::GetOpt::Value::None, nullptr},
+        {"bravo", 'b', Bramble::GetOpt::Value::Required, nullptr},
+        {nullptr, 'c', Bramble::GetOpt::Value::Optional, nullptr},
+        {"delta", 0, Bramble::GetOpt::Value::None, nullptr},
+        {"extra", 'a', Bramble::GetOpt::Value::None, nullptr}
+    };
+
+    constexpr Bramble::GetOpt::Index<sizeof(indexed_options)/sizeof(*indexed_options)> indexed(indexed_options);
+}
+
+TEST(GetOpt, shall_parse_with_index)
+{
+    char argv[] = "-a --bravo=42 -c --delta";
+
+    Bramble::Argument arg(argv, argv, sizeof(argv));
+    Bramble::GetOpt value(arg.begin(), arg.end(), indexed);
+
+    value.next();
+    ASSERT_FALSE(value.finished());
+    ASSERT_EQ(Bramble::StringView("a"), value.name());
+
+    value.next();
+    ASSERT_FALSE(value.finished());
+    ASSERT_EQ(Bramble::StringView("bravo"), value.name());
+    ASSERT_EQ(Bramble::StringView("42"), value.value());
+
+    value.next();
+    ASSERT_FALSE(value.finished());
+    ASSERT_EQ(Bramble::StringView("c"), value.name());
+
+    value.next();
+    ASSERT_FALSE(value.finished());
+    ASSERT_EQ(Bramble::StringView("delta"), value.name());
+
+    value.next();
+    ASSERT_TRUE(value.finished());
+    ASSERT_FALSE(value.unknown());
+}
+
+TEST(GetOpt, shall_not_find_unknown_with_index)
+{
+    const char *unknown[] = {"-z", "--zulu", "--alph", "--alphaa"};
+
+    for(auto s : unknown){
+
+        char argv[16];
+
+        strcpy(argv, s);
+
+        Bramble::Argument arg(argv, argv, strlen(argv) + 1U);
+        Bramble::GetOpt value(arg.begin(), arg.end(), indexed);
+
+        value.next();
+
+        ASSERT_TRUE(value.finished());
+        ASSERT_TRUE(value.unknown());
+    }
+}
+
+TEST(GetOpt, shall_match_linear_lookup_with_index)
+{
+    const size_t size = sizeof(indexed_options)/sizeof(*indexed_options);
+
+    for(int c = 1; c < 256; c++){
+
+        if((c == '-') || (c == '=') || (c == ' ') || (c == '\\') || (c == '\'') || (c == '"')){
+
+            continue;
+        }
+
+        char argv[] = {'-', char(c), 0};
+
+        Bramble::Argument arg1(argv, argv, sizeof(argv));
+        Bramble::GetOpt linear(arg1.begin(), arg1.end(), indexed_options, size);
+
+        Bramble::Argument arg2(argv, argv, sizeof(argv));
+        Bramble::GetOpt hashed(arg2.begin(), arg2.end(), indexed);
+
+        linear.next();
+        hashed.next();
+
+        ASSERT_EQ(linear.unknown(), hashed.unknown()) << c;
+        ASSERT_EQ(linear.finished(), hashed.finished()) << c;
+    }
+}
+
 int main(int argc, char **argv)
 {
     testing::InitGoogleTest(&argc, argv);
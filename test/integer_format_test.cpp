@@ -0,0 +1,124 @@
+#include "gtest/gtest.h"
+
+#include "bramble.hpp"
+
+#include <string>
+#include <cinttypes>
+#include <cstdio>
+
+static std::string format(uint64_t value)
+{
+    char buf[Bramble::IntegerFormat::max_chars];
+
+    return std::string(buf, Bramble::IntegerFormat::to_chars(buf, buf + sizeof(buf), value));
+}
+
+static std::string format(int64_t value)
+{
+    char buf[Bramble::IntegerFormat::max_chars];
+
+    return std::string(buf, Bramble::IntegerFormat::to_chars(buf, buf + sizeof(buf), value));
+}
+
+static std::string format(int32_t value)
+{
+    char buf[Bramble::IntegerFormat::max_chars];
+
+    return std::string(buf, Bramble::IntegerFormat::to_chars(buf, buf + sizeof(buf), value));
+}
+
+TEST(IntegerFormat, shall_count_digits_at_every_power_of_ten)
+{
+    uint64_t p = 1;
+
+    ASSERT_EQ(1U, Bramble::IntegerFormat::count_digits(uint64_t(0)));
+    ASSERT_EQ(1U, Bramble::IntegerFormat::count_digits(uint32_t(0)));
+
+    for(size_t digits = 1; digits <= 20; digits++){
+
+        ASSERT_EQ(digits, Bramble::IntegerFormat::count_digits(p)) << p;
+
+        if(digits > 1){
+
+            ASSERT_EQ(digits - 1U, Bramble::IntegerFormat::count_digits(p - 1U)) << p;
+        }
+
+        if(p <= UINT32_MAX){
+
+            ASSERT_EQ(digits, Bramble::IntegerFormat::count_digits(uint32_t(p))) << p;
+            ASSERT_EQ(digits - ((digits > 1) ? 1U : 0U), Bramble::IntegerFormat::count_digits(uint32_t(p - ((digits > 1) ? 1U : 0U)))) << p;
+        }
+
+        if(digits < 20){
+
+            p *= 10U;
+        }
+    }
+
+    ASSERT_EQ(10U, Bramble::IntegerFormat::count_digits(uint32_t(UINT32_MAX)));
+    ASSERT_EQ(20U, Bramble::IntegerFormat::count_digits(uint64_t(UINT64_MAX)));
+}
+
+TEST(IntegerFormat, shall_format_limits)
+{
+    ASSERT_EQ("0", format(uint64_t(0)));
+    ASSERT_EQ("18446744073709551615", format(uint64_t(UINT64_MAX)));
+    ASSERT_EQ("9223372036854775807", format(int64_t(INT64_MAX)));
+    ASSERT_EQ("-9223372036854775808", format(int64_t(INT64_MIN)));
+    ASSERT_EQ("2147483647", format(int32_t(INT32_MAX)));
+    ASSERT_EQ("-2147483648", format(int32_t(INT32_MIN)));
+    ASSERT_EQ("-1", format(int32_t(-1)));
+}
+
+TEST(IntegerFormat, shall_match_printf)
+{
+    uint64_t x = 88172645463325252ULL;
+
+    for(size_t i = 0; i < 10000; i++){
+
+        char expected[32];
+
+        // xorshift, shifted so that every length is covered
+        x ^= x << 13;
+        x ^= x >> 7;
+        x ^= x << 17;
+
+        uint64_t u = x >> (i % 64U);
+        int64_t s = int64_t(u) * (((i & 1U) != 0U) ? -1 : 1);
+
+        (void)snprintf(expected, sizeof(expected), "%" PRIu64, u);
+        ASSERT_EQ(expected, format(u));
+
+        (void)snprintf(expected, sizeof(expected), "%" PRId64, s);
+        ASSERT_EQ(expected, format(s));
+
+        (void)snprintf(expected, sizeof(expected), "%" PRIx64, u);
+
+        char buf[16];
+
+        ASSERT_EQ(expected, std::string(buf, Bramble::IntegerFormat::to_hex_chars(buf, buf + sizeof(buf), u)));
+    }
+}
+
+TEST(IntegerFormat, shall_not_write_if_it_does_not_fit)
+{
+    char buf[4] = {'a', 'b', 'c', 'd'};
+
+    ASSERT_EQ(nullptr, Bramble::IntegerFormat::to_chars(buf, buf + 3, uint32_t(1000)));
+    ASSERT_EQ(nullptr, Bramble::IntegerFormat::to_chars(buf, buf + 3, int32_t(-100)));
+    ASSERT_EQ(nullptr, Bramble::IntegerFormat::to_hex_chars(buf, buf + 3, uint64_t(0x1000)));
+    ASSERT_EQ(0, memcmp(buf, "abcd", sizeof(buf)));
+
+    ASSERT_EQ(buf + 3, Bramble::IntegerFormat::to_chars(buf, buf + 3, uint32_t(999)));
+    ASSERT_EQ(0, memcmp(buf, "999d", sizeof(buf)));
+
+    ASSERT_EQ(buf + 4, Bramble::IntegerFormat::to_chars(buf, buf + 4, int32_t(-100)));
+    ASSERT_EQ(0, memcmp(buf, "-100", sizeof(buf)));
+}
+
+int main(int argc, char **argv)
+{
+    testing::InitGoogleTest(&argc, argv);
+
+    return RUN_ALL_TESTS();
+}
@@ -0,0 +1,168 @@
+#include "gtest/gtest.h"
+
+#include "bramble.hpp"
+
+#include <string>
+
+class Host : public Bramble::Server::Host {
+public:
+
+    std::string output;
+    std::string handled;
+
+    bool call(Bramble::Server::Command& cmd, const Bramble::Argument& args)
+    {
+        handled.append(cmd.name().data(), cmd.name().size());
+
+        for(auto iter = args.begin(); iter != args.end(); ++iter){
+
+            handled.push_back(' ');
+            handled.append((*iter).data(), (*iter).size());
+        }
+
+        handled.push_back(';');
+
+        return true;
+    }
+
+    void write(const char *buffer, size_t size)
+    {
+        output.append(buffer, size);
+    }
+};
+
+static void process(Bramble::Server& server, const char *s)
+{
+    server.process(s, strlen(s));
+}
+
+TEST(LineQueue, shall_not_attach_short_queue)
+{
+    Host host;
+    Bramble::Server server(host, 16);
+    Bramble::LineQueue<2, 15> queue;
+
+    ASSERT_FALSE(server.set_queue(&queue));
+    ASSERT_TRUE(server.set_queue(nullptr));
+}
+
+TEST(LineQueue, shall_dispatch_on_step)
+{
+    Host host;
+    Bramble::Server server(host, 16);
+    Bramble::LineQueue<4, 16> queue;
+
+    ASSERT_TRUE(server.set_queue(&queue));
+
+    process(server, "a#1 x y\rb#2\rc#3 z");
+
+    ASSERT_TRUE(host.output.empty());
+    ASSERT_EQ(2U, queue.size());
+
+    ASSERT_TRUE(server.step());
+
+    ASSERT_EQ("a x y;", host.handled);
+    ASSERT_EQ("CMD:a#1 x y\r\nACK:a#1\r\n", host.output);
+
+    // partially received line is not disturbed by step
+    process(server, "\r");
+
+    ASSERT_TRUE(server.step());
+    ASSERT_TRUE(server.step());
+    ASSERT_FALSE(server.step());
+
+    ASSERT_EQ("a x y;b;c z;", host.handled);
+    ASSERT_EQ("CMD:a#1 x y\r\nACK:a#1\r\nCMD:b#2\r\nACK:b#2\r\nCMD:c#3 z\r\nACK:c#3\r\n", host.output);
+    ASSERT_EQ(0U, queue.size());
+}
+
+TEST(LineQueue, shall_reject_when_full)
+{
+    Host host;
+    Bramble::Server server(host, 16);
+    Bramble::LineQueue<2, 16> queue;
+
+    ASSERT_TRUE(server.set_queue(&queue));
+
+    process(server, "a#1\rb#2\rc#3\r");
+
+    ASSERT_EQ("CMD:c#3\r\nNAK:c#3 queue_full\r\n", host.output);
+    ASSERT_EQ(1U, queue.dropped());
+
+    while(server.step());
+
+    ASSERT_EQ("a;b;", host.handled);
+}
+
+TEST(LineQueue, shall_drop_newest_when_full)
+{
+    Host host;
+    Bramble::Server server(host, 16);
+    Bramble::LineQueue<2, 16> queue(Bramble::Server::Queue::Overflow::DropNewest);
+
+    ASSERT_TRUE(server.set_queue(&queue));
+
+    process(server, "a\rb#2\rc#3\rd 1 2\r");
+
+    ASSERT_EQ("CMD:b#2\r\nNAK:b#2 dropped\r\nCMD:c#3\r\nNAK:c#3 dropped\r\n", host.output);
+
+    while(server.step());
+
+    // unlike Reject, the line that arrived last is kept
+    ASSERT_EQ("a;d 1 2;", host.handled);
+    ASSERT_EQ(2U, queue.dropped());
+}
+
+TEST(LineQueue, drop_newest_shall_differ_from_reject)
+{
+    using Overflow = Bramble::Server::Queue::Overflow;
+
+    Host reject_host;
+    Bramble::Server reject_server(reject_host, 16);
+    Bramble::LineQueue<2, 16> reject_queue(Overflow::Reject);
+
+    Host drop_host;
+    Bramble::Server drop_server(drop_host, 16);
+    Bramble::LineQueue<2, 16> drop_queue(Overflow::DropNewest);
+
+    ASSERT_TRUE(reject_server.set_queue(&reject_queue));
+    ASSERT_TRUE(drop_server.set_queue(&drop_queue));
+
+    process(reject_server, "a#1\rb#2\rc#3\r");
+    process(drop_server, "a#1\rb#2\rc#3\r");
+
+    // Reject answers the line that arrived, DropNewest the line it evicts
+    ASSERT_EQ("CMD:c#3\r\nNAK:c#3 queue_full\r\n", reject_host.output);
+    ASSERT_EQ("CMD:b#2\r\nNAK:b#2 dropped\r\n", drop_host.output);
+
+    while(reject_server.step());
+    while(drop_server.step());
+
+    ASSERT_EQ("a;b;", reject_host.handled);
+    ASSERT_EQ("a;c;", drop_host.handled);
+}
+
+TEST(LineQueue, shall_drop_oldest_when_full)
+{
+    Host host;
+    Bramble::Server server(host, 16);
+    Bramble::LineQueue<2, 16> queue(Bramble::Server::Queue::Overflow::DropOldest);
+
+    ASSERT_TRUE(server.set_queue(&queue));
+
+    process(server, "a#1\rb#2\rc\rd 1 2\r");
+
+    ASSERT_EQ("CMD:a#1\r\nNAK:a#1 dropped\r\nCMD:b#2\r\nNAK:b#2 dropped\r\n", host.output);
+
+    while(server.step());
+
+    ASSERT_EQ("c;d 1 2;", host.handled);
+    ASSERT_EQ(2U, queue.dropped());
+}
+
+int main(int argc, char **argv)
+{
+    testing::InitGoogleTest(&argc, argv);
+
+    return RUN_ALL_TESTS();
+}
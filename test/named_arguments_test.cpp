@@ -0,0 +1,138 @@
+#include "gtest/gtest.h"
+
+#include "bramble.hpp"
+
+#include <string>
+
+TEST(NamedArguments, shall_index_named_arguments)
+{
+    char argv[] = "tx sf=7 freq=868100000 positional dbm=-3 'note=a b'";
+    Bramble::Argument arg(argv, argv, sizeof(argv));
+    Bramble::NamedArguments<8> eut(arg);
+
+    ASSERT_EQ(4U, eut.size());
+    ASSERT_FALSE(eut.overflow());
+    ASSERT_FALSE(eut.has_duplicate());
+
+    ASSERT_TRUE(eut.contains("freq"));
+    ASSERT_FALSE(eut.contains("positional"));
+    ASSERT_FALSE(eut.contains("fre"));
+
+    auto entry = eut.find("note");
+
+    ASSERT_NE(nullptr, entry);
+    ASSERT_EQ(Bramble::StringView("note"), entry->name());
+    ASSERT_EQ(Bramble::StringView("a b"), entry->value());
+
+    Bramble::Decoder value;
+    uint32_t freq;
+    int8_t dbm;
+
+    ASSERT_TRUE(eut.get("freq", value));
+    ASSERT_TRUE(value.get_uint32(freq));
+    ASSERT_EQ(868100000U, freq);
+
+    ASSERT_TRUE(eut.get(Bramble::StringView("dbm"), value));
+    ASSERT_TRUE(value.get_int8(dbm));
+    ASSERT_EQ(-3, dbm);
+
+    ASSERT_FALSE(eut.get("bw", value));
+}
+
+TEST(NamedArguments, shall_iterate_in_name_order)
+{
+    char argv[] = "d=4 bb=2 a=1 c=3 ccc=5";
+    Bramble::Argument arg(argv, argv, sizeof(argv));
+    Bramble::NamedArguments<8> eut(arg);
+
+    std::string names;
+
+    for(auto& entry : eut){
+
+        names.append(entry.name().data(), entry.name().size());
+        names.append(",");
+    }
+
+    // longer names sort first (StringView::compare orders by size first)
+    ASSERT_EQ("ccc,bb,a,c,d,", names);
+}
+
+TEST(NamedArguments, shall_report_unconsumed)
+{
+    char argv[] = "a=1 b=2 c=";
+    Bramble::Argument arg(argv, argv, sizeof(argv));
+    Bramble::NamedArguments<4> eut(arg);
+
+    ASSERT_NE(nullptr, eut.unconsumed());
+
+    (void)eut.find("a");
+    (void)eut.find("c");
+
+    ASSERT_TRUE(eut.contains("b"));
+
+    auto entry = eut.unconsumed();
+
+    ASSERT_NE(nullptr, entry);
+    ASSERT_EQ(Bramble::StringView("b"), entry->name());
+    ASSERT_FALSE(entry->consumed());
+
+    ASSERT_TRUE(eut.find("c")->value().empty());
+    ASSERT_NE(nullptr, eut.find("b"));
+    ASSERT_EQ(nullptr, eut.unconsumed());
+}
+
+TEST(NamedArguments, shall_detect_duplicate)
+{
+    char argv[] = "a=1 b=2 a=3 b=4";
+    Bramble::Argument arg(argv, argv, sizeof(argv));
+    Bramble::NamedArguments<4> eut(arg);
+
+    ASSERT_EQ(2U, eut.size());
+    ASSERT_TRUE(eut.has_duplicate());
+    ASSERT_EQ(Bramble::StringView("a"), eut.duplicate());
+
+    // first occurrence wins
+    ASSERT_EQ(Bramble::StringView("1"), eut.find("a")->value());
+}
+
+TEST(NamedArguments, shall_detect_empty_duplicate)
+{
+    char argv[] = "=1 =2";
+    Bramble::Argument arg(argv, argv, sizeof(argv));
+    Bramble::NamedArguments<4> eut(arg);
+
+    ASSERT_EQ(1U, eut.size());
+    ASSERT_TRUE(eut.has_duplicate());
+    ASSERT_TRUE(eut.duplicate().empty());
+}
+
+TEST(NamedArguments, shall_report_overflow)
+{
+    char argv[] = "a=1 b=2 c=3";
+    Bramble::Argument arg(argv, argv, sizeof(argv));
+    Bramble::NamedArguments<2> eut(arg);
+
+    ASSERT_EQ(2U, eut.size());
+    ASSERT_TRUE(eut.overflow());
+    ASSERT_TRUE(eut.contains("a"));
+    ASSERT_TRUE(eut.contains("b"));
+    ASSERT_FALSE(eut.contains("c"));
+}
+
+TEST(NamedArguments, shall_handle_no_arguments)
+{
+    Bramble::Argument arg(nullptr, nullptr, 0);
+    Bramble::NamedArguments<1> eut(arg);
+
+    ASSERT_TRUE(eut.empty());
+    ASSERT_EQ(eut.begin(), eut.end());
+    ASSERT_EQ(nullptr, eut.unconsumed());
+    ASSERT_EQ(nullptr, eut.find("a"));
+}
+
+int main(int argc, char **argv)
+{
+    testing::InitGoogleTest(&argc, argv);
+
+    return RUN_ALL_TESTS();
+}
@@ -0,0 +1,118 @@
+#include "gtest/gtest.h"
+
+#include "bramble.hpp"
+
+#include <string>
+
+static void echo(Bramble::Server::Command& cmd, const Bramble::Argument& args)
+{
+    Bramble::Encoder encoder(cmd.ack_with_arg());
+
+    for(auto iter = args.begin(); iter != args.end(); ++iter){
+
+        if(iter != args.begin()){
+
+            encoder.space();
+        }
+
+        encoder.put_string(*iter);
+    }
+}
+
+static void fail(Bramble::Server::Command& cmd, const Bramble::Argument&)
+{
+    cmd.nak("failed");
+}
+
+static constexpr Bramble::Registry::Entry commands[] = {
+    {"echo", echo},
+    {"fail", fail},
+    {"nothing", nullptr},
+    {"echo", fail},
+    {nullptr, fail}
+};
+
+static constexpr auto registry = Bramble::Registry::make(commands);
+
+static_assert(registry.size() == 5, "registry is built at compile time");
+static_assert(Bramble::Hash::fnv1a("a") == 0xe40c292cUL, "hash is evaluated at compile time");
+
+class Host : public Bramble::Server::Host {
+public:
+
+    std::string output;
+
+    bool call(Bramble::Server::Command& cmd, const Bramble::Argument& args)
+    {
+        return registry.call(cmd, args);
+    }
+
+    void write(const char *buffer, size_t size)
+    {
+        output.append(buffer, size);
+    }
+};
+
+TEST(Registry, shall_lookup_by_name)
+{
+    ASSERT_EQ(&commands[0], registry.lookup("echo"));
+    ASSERT_EQ(&commands[1], registry.lookup("fail"));
+    ASSERT_EQ(&commands[2], registry.lookup("nothing"));
+}
+
+TEST(Registry, shall_not_lookup_unknown_name)
+{
+    ASSERT_EQ(nullptr, registry.lookup("unknown"));
+    ASSERT_EQ(nullptr, registry.lookup("ech"));
+    ASSERT_EQ(nullptr, registry.lookup("echoo"));
+    ASSERT_EQ(nullptr, registry.lookup(""));
+}
+
+TEST(Registry, shall_index_large_table)
+{
+    static constexpr Bramble::Registry::Entry large[] = {
+        {"c0", nullptr}, {"c1", nullptr}, {"c2", nullptr}, {"c3", nullptr}, {"c4", nullptr},
+        {"c5", nullptr}, {"c6", nullptr}, {"c7", nullptr}, {"c8", nullptr}, {"c9", nullptr},
+        {"c10", nullptr}, {"c11", nullptr}, {"c12", nullptr}, {"c13", nullptr}, {"c14", nullptr},
+        {"c15", nullptr}, {"c16", nullptr}, {"c17", nullptr}, {"c18", nullptr}, {"c19", nullptr}
+    };
+
+    static constexpr auto table = Bramble::Registry::make(large);
+
+    for(auto iter = std::begin(large); iter != std::end(large); ++iter){
+
+        ASSERT_EQ(iter, table.lookup(iter->name));
+    }
+
+    ASSERT_EQ(nullptr, table.lookup("c20"));
+}
+
+TEST(Registry, shall_dispatch_from_host)
+{
+    Host host;
+    Bramble::Server server(host);
+
+    std::string input("echo hello world\rfail\rnothing\runknown\r");
+
+    server.process(input.data(), input.size());
+
+    std::string expected;
+
+    expected.append("CMD:echo hello world\r\n");
+    expected.append("ACK:echo hello world\r\n");
+    expected.append("CMD:fail\r\n");
+    expected.append("NAK:fail failed\r\n");
+    expected.append("CMD:nothing\r\n");
+    expected.append("ACK:nothing\r\n");
+    expected.append("CMD:unknown\r\n");
+    expected.append("NAK:unknown unknown_command\r\n");
+
+    ASSERT_EQ(expected, host.output);
+}
+
+int main(int argc, char **argv)
+{
+    testing::InitGoogleTest(&argc, argv);
+
+    return RUN_ALL_TESTS();
+}
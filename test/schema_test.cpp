@@ -0,0 +1,191 @@
+#include "gtest/gtest.h"
+
+#include "bramble.hpp"
+
+#include <string>
+
+struct Transmit {
+
+    uint32_t freq;
+    int8_t dbm;
+    bool confirmed;
+    double gain;
+    Bramble::StringView note;
+};
+
+using TransmitSchema = Bramble::Schema<Transmit>;
+
+static constexpr TransmitSchema::Field transmit_fields[] = {
+    TransmitSchema::required<Bramble::Range<uint32_t, 863000000, 870000000>, &Transmit::freq>("freq"),
+    TransmitSchema::optional<Bramble::Range<int8_t, -10, 20>, &Transmit::dbm>("dbm"),
+    TransmitSchema::optional<bool, &Transmit::confirmed>("confirmed"),
+    TransmitSchema::optional<double, &Transmit::gain>("gain"),
+    TransmitSchema::optional<Bramble::StringView, &Transmit::note>("note")
+};
+
+static constexpr auto transmit_schema = TransmitSchema::make(transmit_fields);
+
+static_assert(transmit_schema.size() == 5, "schema is built at compile time");
+
+static Transmit defaults()
+{
+    Transmit retval;
+
+    retval.freq = 0;
+    retval.dbm = 14;
+    retval.confirmed = false;
+    retval.gain = 0.0;
+
+    return retval;
+}
+
+static TransmitSchema::Result bind(const char *line, Transmit& t)
+{
+    static char buffer[128];
+
+    strncpy(buffer, line, sizeof(buffer) - 1U);
+
+    Bramble::Argument args(buffer, buffer, sizeof(buffer));
+
+    return transmit_schema.bind(args, t);
+}
+
+static void transmit(Bramble::Server::Command& cmd, const Bramble::Argument& args)
+{
+    auto t = defaults();
+
+    if(transmit_schema.bind(cmd, args, t)){
+
+        cmd.ack(t.freq, int32_t(t.dbm));
+    }
+}
+
+static constexpr Bramble::Registry::Entry commands[] = {
+    {"tx", transmit}
+};
+
+static constexpr auto registry = Bramble::Registry::make(commands);
+
+class Host : public Bramble::Server::Host {
+public:
+
+    std::string output;
+
+    bool call(Bramble::Server::Command& cmd, const Bramble::Argument& args)
+    {
+        return registry.call(cmd, args);
+    }
+
+    void write(const char *buffer, size_t size)
+    {
+        output.append(buffer, size);
+    }
+};
+
+TEST(Schema, shall_bind_fields)
+{
+    auto t = defaults();
+    auto result = bind("tx freq=868100000 confirmed=true gain=1.5 'note=a b'", t);
+
+    ASSERT_TRUE(result.ok());
+    ASSERT_EQ(TransmitSchema::Status::Ok, result.status());
+    ASSERT_TRUE(result.name().empty());
+
+    ASSERT_EQ(868100000U, t.freq);
+    ASSERT_EQ(14, t.dbm);
+    ASSERT_TRUE(t.confirmed);
+    ASSERT_EQ(1.5, t.gain);
+    ASSERT_EQ(Bramble::StringView("a b"), t.note);
+}
+
+TEST(Schema, shall_accept_range_limits)
+{
+    auto t = defaults();
+
+    ASSERT_TRUE(bind("tx freq=863000000 dbm=-10", t).ok());
+    ASSERT_EQ(863000000U, t.freq);
+    ASSERT_EQ(-10, t.dbm);
+
+    ASSERT_TRUE(bind("tx freq=870000000 dbm=20", t).ok());
+    ASSERT_EQ(870000000U, t.freq);
+    ASSERT_EQ(20, t.dbm);
+}
+
+TEST(Schema, shall_report_failures)
+{
+    struct {
+        const char *line;
+        TransmitSchema::Status status;
+        const char *name;
+    } cases[] = {
+        {"tx", TransmitSchema::Status::Missing, "freq"},
+        {"tx dbm=1", TransmitSchema::Status::Missing, "freq"},
+        {"tx freq=868000000 dbm=21", TransmitSchema::Status::OutOfRange, "dbm"},
+        {"tx freq=862999999", TransmitSchema::Status::OutOfRange, "freq"},
+        {"tx freq=868000000 dbm=200", TransmitSchema::Status::Invalid, "dbm"},
+        {"tx freq=fast", TransmitSchema::Status::Invalid, "freq"},
+        {"tx freq=868000000 confirmed=maybe", TransmitSchema::Status::Invalid, "confirmed"},
+        {"tx freq=868000000 sf=7", TransmitSchema::Status::Unknown, "sf"},
+        {"tx freq=868000000 freq=868000000", TransmitSchema::Status::Duplicate, "freq"}
+    };
+
+    for(auto& c : cases){
+
+        auto t = defaults();
+        auto result = bind(c.line, t);
+
+        ASSERT_EQ(c.status, result.status()) << c.line;
+        ASSERT_EQ(Bramble::StringView(c.name), result.name()) << c.line;
+        ASSERT_FALSE(result.ok());
+    }
+}
+
+TEST(Schema, shall_not_write_member_on_failure)
+{
+    auto t = defaults();
+
+    ASSERT_FALSE(bind("tx dbm=50 freq=868000000", t).ok());
+    ASSERT_EQ(14, t.dbm);
+}
+
+TEST(Schema, shall_nak_with_reason)
+{
+    Host host;
+    Bramble::Server server(host);
+
+    std::string input("tx freq=868100000\rtx dbm=1\rtx freq=1\rtx freq=868100000 bw=125\r");
+
+    server.process(input.data(), input.size());
+
+    std::string expected;
+
+    expected.append("CMD:tx freq=868100000\r\n");
+    expected.append("ACK:tx 868100000 14\r\n");
+    expected.append("CMD:tx dbm=1\r\n");
+    expected.append("NAK:tx missing_argument:freq\r\n");
+    expected.append("CMD:tx freq=1\r\n");
+    expected.append("NAK:tx out_of_range:freq\r\n");
+    expected.append("CMD:tx freq=868100000 bw=125\r\n");
+    expected.append("NAK:tx unknown_argument:bw\r\n");
+
+    ASSERT_EQ(expected, host.output);
+}
+
+TEST(Schema, shall_nak_with_single_token_name)
+{
+    Host host;
+    Bramble::Server server(host);
+
+    std::string input("tx \"a b=1\" freq=868100000\r");
+
+    server.process(input.data(), input.size());
+
+    ASSERT_EQ("CMD:tx \"a b=1\" freq=868100000\r\nNAK:tx unknown_argument:a_b\r\n", host.output);
+}
+
+int main(int argc, char **argv)
+{
+    testing::InitGoogleTest(&argc, argv);
+
+    return RUN_ALL_TESTS();
+}
@@ -4,6 +4,7 @@
 
 #include <list>
 #include <string>
+#include <vector>
 
 class Host : public Bramble::Server::Host {
 public:
@@ -76,6 +77,18 @@ private:
     std::list<Record> list;
 };
 
+class BlockHost : public Host {
+public:
+
+    std::vector<std::string> writes;
+
+    void write(const char *buffer, size_t size)
+    {
+        writes.emplace_back(buffer, size);
+        output.append(buffer, size);
+    }
+};
+
 TEST(Server, shall_ignore_empty_command)
 {
     Host host;
@@ -346,6 +359,545 @@ TEST(Server, ack_shall_not_nak)
     ASSERT_EQ(expected, host.output);
 }
 
+TEST(Server, shall_handle_line_split_across_process)
+{
+    Host host;
+    Bramble::Server server(host);
+
+    bool called = false;
+
+    host.add_handler("test", [&called](Bramble::Server::Command& cmd, const Bramble::Argument& args){
+
+        ASSERT_EQ(Bramble::StringView("test"), cmd.name());
+        ASSERT_EQ(Bramble::StringView("token"), args.front());
+
+        called = true;
+    });
+
+    std::string first("te");
+    std::string second("st tok");
+    std::string third("en\r");
+
+    server.process(first.data(), first.size());
+    server.process(second.data(), second.size());
+
+    ASSERT_FALSE(called);
+
+    server.process(third.data(), third.size());
+
+    std::string expected("CMD:test token\r\n");
+    expected.append("ACK:test\r\n");
+
+    ASSERT_TRUE(called);
+    ASSERT_EQ(expected, host.output);
+}
+
+TEST(Server, shall_discard_non_printable)
+{
+    Host host;
+    Bramble::Server server(host);
+
+    host.add_handler("test", [](Bramble::Server::Command&, const Bramble::Argument&){});
+
+    std::string input("\nte\x01st\t\r");
+
+    server.process(input.data(), input.size());
+
+    std::string expected("CMD:test\r\n");
+    expected.append("ACK:test\r\n");
+
+    ASSERT_EQ(expected, host.output);
+}
+
+TEST(Server, shall_recover_after_too_long)
+{
+    Host host;
+    Bramble::Server server(host, 10);
+
+    host.add_handler("test", [](Bramble::Server::Command&, const Bramble::Argument&){});
+
+    std::string input("test hello world i am too long\rtest\r012345678\r");
+
+    server.process(input.data(), input.size());
+
+    std::string expected("CMD:test\r\n");
+    expected.append("ACK:test\r\n");
+    expected.append("CMD:012345678\r\n");
+    expected.append("NAK:012345678 unknown_command\r\n");
+
+    ASSERT_EQ(expected, host.output);
+}
+
+TEST(Server, process_buffer_shall_match_process_get_char)
+{
+    std::string input;
+
+    srand(42);
+
+    for(size_t i=0; i < 4096; i++){
+
+        switch(rand() % 8){
+        case 0:
+            input.push_back('\r');
+            break;
+        case 1:
+            input.push_back(char(rand() % 32));
+            break;
+        case 2:
+            input.push_back(' ');
+            break;
+        default:
+            input.push_back(char('a' + (rand() % 3)));
+            break;
+        }
+    }
+
+    Host buffer_host;
+    Bramble::Server buffer_server(buffer_host, 8);
+
+    Host char_host;
+    Bramble::Server char_server(char_host, 8);
+
+    for(auto h : {&buffer_host, &char_host}){
+
+        h->add_handler("a", [](Bramble::Server::Command&, const Bramble::Argument&){});
+        h->add_handler("b", [](Bramble::Server::Command& cmd, const Bramble::Argument&){ cmd.nak("b"); });
+    }
+
+    for(size_t i=0; i < input.size(); i += 7){
+
+        auto n = std::min(size_t(7), input.size() - i);
+
+        buffer_server.process(&input[i], n);
+    }
+
+    char_host.input = input;
+    char_server.process();
+
+    ASSERT_FALSE(buffer_host.output.empty());
+    ASSERT_EQ(char_host.output, buffer_host.output);
+}
+
+TEST(Server, shall_write_transaction_as_one_block)
+{
+    BlockHost host;
+    Bramble::Server server(host);
+
+    host.add_handler("test", [](Bramble::Server::Command& cmd, const Bramble::Argument&){
+
+        Bramble::Encoder(cmd.ack_with_arg()).put_string("token").space().put_int(42U);
+    });
+
+    std::string input("test hello world\r");
+
+    server.process(input.data(), input.size());
+
+    std::string expected("CMD:test hello world\r\n");
+    expected.append("ACK:test token 42\r\n");
+
+    ASSERT_EQ(1U, host.writes.size());
+    ASSERT_EQ(expected, host.output);
+}
+
+TEST(Server, shall_write_long_transaction_in_blocks)
+{
+    BlockHost host;
+    Bramble::Server server(host);
+
+    std::string input("test ");
+
+    input.append(std::string(300, 'a'));
+    input.append("\r");
+
+    server.process(input.data(), input.size());
+
+    std::string expected("CMD:");
+    expected.append(input);
+    expected.append("\n");
+    expected.append("NAK:test unknown_command\r\n");
+
+    ASSERT_GE(3U, host.writes.size());
+    ASSERT_EQ(expected, host.output);
+}
+
+TEST(Server, shall_write_event_as_one_block)
+{
+    BlockHost host;
+    Bramble::Server server(host);
+
+    server.event("test", [](Bramble::Stream& s){
+
+        Bramble::Encoder(s).put_string("a").space().put_string("b");
+    });
+
+    ASSERT_EQ(1U, host.writes.size());
+    ASSERT_EQ(std::string("EVT: test a b\r\n"), host.output);
+}
+
+class TxHost : public BlockHost {
+public:
+
+    std::vector<std::string> sent;
+
+    void line_was_tx()
+    {
+        sent.push_back(output);
+    }
+};
+
+TEST(Server, shall_report_line_tx_after_write)
+{
+    TxHost host;
+    Bramble::Server server(host);
+
+    host.add_handler("test", [](Bramble::Server::Command& cmd, const Bramble::Argument&){
+
+        Bramble::Encoder(cmd.ack_with_arg()).put_string("token");
+    });
+
+    std::string input("test hello\r");
+
+    server.process(input.data(), input.size());
+
+    ASSERT_EQ(2U, host.sent.size());
+    ASSERT_EQ(std::string("CMD:test hello\r\nACK:test token\r\n"), host.sent[0]);
+    ASSERT_EQ(host.sent[0], host.sent[1]);
+    ASSERT_EQ(1U, host.writes.size());
+}
+
+TEST(Server, shall_report_nak_tx_after_write)
+{
+    TxHost host;
+    Bramble::Server server(host);
+
+    std::string input("test\r");
+
+    server.process(input.data(), input.size());
+
+    ASSERT_EQ(2U, host.sent.size());
+    ASSERT_EQ(std::string("CMD:test\r\nNAK:test unknown_command\r\n"), host.sent[1]);
+}
+
+TEST(Server, shall_report_deferred_tx_after_write)
+{
+    TxHost host;
+    Bramble::Server server(host);
+    Bramble::Server::Deferred deferred;
+
+    host.add_handler("test", [&](Bramble::Server::Command& cmd, const Bramble::Argument&){
+
+        deferred = cmd.defer();
+    });
+
+    std::string input("test\r");
+
+    server.process(input.data(), input.size());
+
+    ASSERT_EQ(1U, host.sent.size());
+    ASSERT_EQ(std::string("CMD:test\r\n"), host.sent[0]);
+
+    deferred.ack();
+
+    ASSERT_EQ(2U, host.sent.size());
+    ASSERT_EQ(std::string("CMD:test\r\nACK:test\r\n"), host.sent[1]);
+}
+
+class ReadHost : public Host {
+public:
+
+    size_t reads = 0;
+
+    size_t read(char *buffer, size_t max)
+    {
+        auto retval = input.copy(buffer, max);
+
+        input.erase(0, retval);
+        reads++;
+
+        return retval;
+    }
+
+    GetCharStatus get_char(char&)
+    {
+        // must not be used when read() is overridden
+        ADD_FAILURE();
+        return GetCharStatus::Error;
+    }
+};
+
+TEST(Server, shall_process_host_read)
+{
+    ReadHost host;
+    Bramble::Server server(host);
+
+    host.add_handler("test", [](Bramble::Server::Command&, const Bramble::Argument&){});
+
+    for(size_t i=0; i < 10; i++){
+
+        host.input.append("test hello world\r");
+    }
+
+    server.process();
+
+    std::string expected;
+
+    for(size_t i=0; i < 10; i++){
+
+        expected.append("CMD:test hello world\r\n");
+        expected.append("ACK:test\r\n");
+    }
+
+    ASSERT_TRUE(host.input.empty());
+    ASSERT_GT(10U, host.reads);
+    ASSERT_EQ(expected, host.output);
+}
+
+TEST(Server, shall_defer_response)
+{
+    Host host;
+    Bramble::Server server(host);
+
+    std::vector<Bramble::Server::Deferred> deferred;
+
+    host.add_handler("sweep", [&deferred](Bramble::Server::Command& cmd, const Bramble::Argument&){
+
+        deferred.push_back(cmd.defer());
+
+        ASSERT_TRUE(deferred.back().pending());
+
+        // ignored once deferred
+        cmd.ack();
+        cmd.nak("ignored");
+    });
+
+    host.add_handler("test", [](Bramble::Server::Command&, const Bramble::Argument&){});
+
+    std::string input("sweep#1\rtest\rsweep#2\r");
+
+    server.process(input.data(), input.size());
+
+    ASSERT_EQ("CMD:sweep#1\r\nCMD:test\r\nACK:test\r\nCMD:sweep#2\r\n", host.output);
+    ASSERT_EQ(2U, deferred.size());
+
+    host.output.clear();
+
+    deferred[1].nak("busy");
+    deferred[0].ack([](Bramble::Stream& s){
+
+        Bramble::Encoder(s).put_string("done");
+    });
+
+    ASSERT_EQ("NAK:sweep#2 busy\r\nACK:sweep#1 done\r\n", host.output);
+
+    ASSERT_FALSE(deferred[0].pending());
+    ASSERT_FALSE(deferred[1].pending());
+
+    // completes only once
+    deferred[0].ack();
+
+    ASSERT_EQ("NAK:sweep#2 busy\r\nACK:sweep#1 done\r\n", host.output);
+}
+
+class CompletingHost : public BlockHost {
+public:
+
+    Bramble::Server::Deferred deferred;
+
+    void write(const char *buffer, size_t size)
+    {
+        BlockHost::write(buffer, size);
+
+        // completes while the server is part way through a line
+        (void)deferred.ack();
+    }
+};
+
+TEST(Server, shall_queue_deferred_response_between_lines)
+{
+    CompletingHost host;
+    Bramble::Server server(host);
+    Bramble::EventQueue<4, 64> events;
+
+    host.add_handler("slow", [&host](Bramble::Server::Command& cmd, const Bramble::Argument&){
+
+        host.deferred = cmd.defer();
+    });
+
+    std::string input("slow#1\r");
+
+    server.process(input.data(), input.size());
+
+    server.set_events(&events);
+
+    ASSERT_TRUE(host.deferred.pending());
+
+    std::string payload(200, 'x');
+
+    server.event("long", [&payload](Bramble::Stream& s){
+
+        Bramble::Encoder(s).put_string(payload.c_str());
+    });
+
+    ASSERT_GT(host.writes.size(), 2U);
+    ASSERT_FALSE(host.deferred.pending());
+
+    (void)server.step();
+
+    std::string expected("CMD:slow#1\r\n");
+    expected.append("EVT: long ");
+    expected.append(payload);
+    expected.append("\r\n");
+    expected.append("ACK:slow#1\r\n");
+
+    ASSERT_EQ(expected, host.output);
+}
+
+TEST(Server, shall_keep_deferred_pending_when_events_full)
+{
+    BlockHost host;
+    Bramble::Server server(host);
+    Bramble::EventQueue<2, 64> events;
+    Bramble::Server::Deferred deferred;
+
+    host.add_handler("slow", [&deferred](Bramble::Server::Command& cmd, const Bramble::Argument&){
+
+        deferred = cmd.defer();
+    });
+
+    server.set_events(&events);
+
+    std::string input("slow#1\r");
+
+    server.process(input.data(), input.size());
+
+    ASSERT_TRUE(events.event("busy"));
+    ASSERT_TRUE(events.event("busy"));
+
+    ASSERT_FALSE(deferred.nak("later"));
+    ASSERT_TRUE(deferred.pending());
+
+    (void)server.step();
+
+    ASSERT_TRUE(deferred.nak("later"));
+    ASSERT_FALSE(deferred.pending());
+
+    (void)server.step();
+
+    ASSERT_EQ("CMD:slow#1\r\nEVT: busy\r\nEVT: busy\r\nNAK:slow#1 later\r\n", host.output);
+}
+
+TEST(Server, shall_defer_response_from_handler)
+{
+    BlockHost host;
+    Bramble::Server server(host);
+
+    host.add_handler("test", [](Bramble::Server::Command& cmd, const Bramble::Argument&){
+
+        cmd.defer().ack();
+    });
+
+    std::string input("test#3\r");
+
+    server.process(input.data(), input.size());
+
+    ASSERT_EQ("CMD:test#3\r\nACK:test#3\r\n", host.output);
+    ASSERT_EQ(2U, host.writes.size());
+}
+
+TEST(Server, shall_not_defer_after_response)
+{
+    Host host;
+    Bramble::Server server(host);
+
+    bool pending = true;
+
+    host.add_handler("test", [&pending](Bramble::Server::Command& cmd, const Bramble::Argument&){
+
+        cmd.nak("now");
+        pending = cmd.defer().pending();
+    });
+
+    std::string input("test\r");
+
+    server.process(input.data(), input.size());
+
+    ASSERT_FALSE(pending);
+    ASSERT_EQ("CMD:test\r\nNAK:test now\r\n", host.output);
+}
+
+TEST(Server, shall_not_defer_long_name)
+{
+    Host host;
+    Bramble::Server server(host);
+
+    bool pending = true;
+
+    host.add_handler("test", [&pending](Bramble::Server::Command& cmd, const Bramble::Argument&){
+
+        pending = cmd.defer().pending();
+    });
+
+    std::string name("test#");
+
+    name.append(Bramble::Server::Deferred::max_name, '1');
+
+    std::string input(name + "\r");
+
+    server.process(input.data(), input.size());
+
+    ASSERT_FALSE(pending);
+    ASSERT_EQ("CMD:" + name + "\r\nACK:" + name + "\r\n", host.output);
+}
+
+TEST(Server, shall_emit_typed_arguments)
+{
+    BlockHost host;
+    Bramble::Server server(host);
+
+    const uint8_t id[] = {0xde, 0xad};
+    Bramble::StringView v("view");
+
+    server.event("rx_done", Bramble::kv("rssi", int16_t(-120)), Bramble::kv("snr", 7U), Bramble::hex(id, sizeof(id)), true, 'c', "s", v);
+
+    ASSERT_EQ("EVT: rx_done rssi=-120 snr=7 dead true c s view\r\n", host.output);
+    ASSERT_EQ(1U, host.writes.size());
+
+    host.output.clear();
+
+    server.log("stats", uint64_t(18446744073709551615ULL), int64_t(-5), Bramble::b64("ab", 2));
+
+    ASSERT_EQ("LOG: stats 18446744073709551615 -5 YWI=\r\n", host.output);
+}
+
+TEST(Server, shall_ack_with_typed_arguments)
+{
+    Host host;
+    Bramble::Server server(host);
+
+    host.add_handler("test", [](Bramble::Server::Command& cmd, const Bramble::Argument&){
+
+        cmd.ack(Bramble::kv("freq", 868100000UL), "ok");
+    });
+
+    host.add_handler("later", [](Bramble::Server::Command& cmd, const Bramble::Argument&){
+
+        cmd.defer().ack(42, Bramble::kv("name", "x"));
+    });
+
+    std::string input("test#1\rlater\r");
+
+    server.process(input.data(), input.size());
+
+    ASSERT_EQ("CMD:test#1\r\nACK:test#1 freq=868100000 ok\r\nCMD:later\r\nACK:later 42 name=x\r\n", host.output);
+}
+
+static_assert(Bramble::is_argument<int>::value, "");
+static_assert(Bramble::is_argument<Bramble::KeyValue<const char *>>::value, "");
+static_assert(!Bramble::is_argument<Bramble::KeyValue<std::string>>::value, "");
+static_assert(!Bramble::is_argument<std::string>::value, "");
+static_assert(Bramble::is_argument<double>::value, "");
+static_assert(!Bramble::is_argument<void *>::value, "");
+
 int main(int argc, char **argv)
 {
     testing::InitGoogleTest(&argc, argv);
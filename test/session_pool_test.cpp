@@ -0,0 +1,133 @@
+#include "gtest/gtest.h"
+
+#include "bramble.hpp"
+
+#include <string>
+
+static void whoami(Bramble::Server::Command& cmd, const Bramble::Argument&)
+{
+    Bramble::Encoder(cmd.ack_with_arg()).put_uint32(uint32_t(cmd.session()));
+}
+
+static constexpr Bramble::Registry::Entry commands[] = {
+    {"whoami", whoami}
+};
+
+static constexpr auto registry = Bramble::Registry::make(commands);
+
+class Connection : public Bramble::Server::Host {
+public:
+
+    std::string output;
+
+    bool call(Bramble::Server::Command& cmd, const Bramble::Argument& args)
+    {
+        return registry.call(cmd, args);
+    }
+
+    void write(const char *buffer, size_t size)
+    {
+        output.append(buffer, size);
+    }
+};
+
+static void process(Bramble::Server& server, const char *s)
+{
+    server.process(s, strlen(s));
+}
+
+TEST(SessionPool, shall_open_until_full)
+{
+    Bramble::SessionPool<2, 64, 4> pool;
+    Connection c1, c2, c3;
+
+    ASSERT_EQ(0U, pool.size());
+    ASSERT_EQ(2U, pool.capacity());
+
+    auto s1 = pool.open(c1);
+    auto s2 = pool.open(c2);
+
+    ASSERT_NE(nullptr, s1);
+    ASSERT_NE(nullptr, s2);
+    ASSERT_EQ(nullptr, pool.open(c3));
+    ASSERT_EQ(2U, pool.size());
+
+    ASSERT_EQ(0U, s1->session());
+    ASSERT_EQ(1U, s2->session());
+    ASSERT_EQ(64U, s1->max_line_size());
+}
+
+TEST(SessionPool, shall_reuse_closed_session)
+{
+    Bramble::SessionPool<2, 64, 4> pool;
+    Connection c1, c2, c3;
+
+    auto s1 = pool.open(c1);
+    (void)pool.open(c2);
+
+    pool.close(*s1);
+
+    ASSERT_EQ(1U, pool.size());
+
+    auto s3 = pool.open(c3);
+
+    ASSERT_NE(nullptr, s3);
+    ASSERT_EQ(0U, s3->session());
+}
+
+TEST(SessionPool, shall_ignore_foreign_session)
+{
+    Bramble::SessionPool<2, 64, 4> pool;
+    Connection c1, c2;
+
+    Bramble::Server other(c2);
+
+    (void)pool.open(c1);
+
+    pool.close(other);
+
+    ASSERT_EQ(1U, pool.size());
+}
+
+TEST(SessionPool, shall_keep_sessions_separate)
+{
+    Bramble::SessionPool<2, 64, 4> pool;
+    Connection c1, c2;
+
+    auto s1 = pool.open(c1);
+    auto s2 = pool.open(c2);
+
+    // interleave partial lines
+    process(*s1, "who");
+    process(*s2, "whoami#2");
+    process(*s1, "ami#1\r");
+    process(*s2, "\r");
+
+    ASSERT_EQ("CMD:whoami#1\r\nACK:whoami#1 0\r\n", c1.output);
+    ASSERT_EQ("CMD:whoami#2\r\nACK:whoami#2 1\r\n", c2.output);
+}
+
+TEST(SessionPool, shall_use_storage_provided_to_server)
+{
+    Connection host;
+    char buffer[9];
+    Bramble::StringView index[2];
+
+    {
+        Bramble::Server server(host, buffer, sizeof(buffer) - 1U, index, 2U, 7U);
+
+        ASSERT_EQ(8U, server.max_line_size());
+        ASSERT_EQ(7U, server.session());
+
+        process(server, "whoami\r");
+    }
+
+    ASSERT_EQ("CMD:whoami\r\nACK:whoami 7\r\n", host.output);
+}
+
+int main(int argc, char **argv)
+{
+    testing::InitGoogleTest(&argc, argv);
+
+    return RUN_ALL_TESTS();
+}
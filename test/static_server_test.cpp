@@ -0,0 +1,207 @@
+#include "gtest/gtest.h"
+
+#include "bramble.hpp"
+
+#include <cstdlib>
+#include <new>
+#include <string>
+
+static bool counting;
+static size_t allocations;
+
+void *operator new(size_t size)
+{
+    if(counting){
+
+        allocations++;
+    }
+
+    void *retval = malloc((size > 0) ? size : 1);
+
+    if(retval == nullptr){
+
+        throw std::bad_alloc();
+    }
+
+    return retval;
+}
+
+void operator delete(void *ptr) noexcept
+{
+    free(ptr);
+}
+
+void operator delete(void *ptr, size_t) noexcept
+{
+    free(ptr);
+}
+
+static Bramble::Server::Deferred deferred;
+
+static void echo(Bramble::Server::Command& cmd, const Bramble::Argument& args)
+{
+    Bramble::Encoder encoder(cmd.ack_with_arg());
+
+    for(auto iter = args.begin(); iter != args.end(); ++iter){
+
+        encoder.put_string(*iter).space();
+    }
+}
+
+static void report(Bramble::Server::Command& cmd, const Bramble::Argument& args)
+{
+    size_t count = args.size();
+
+    cmd.server.event("report", [count](Bramble::Stream& s){
+
+        Bramble::Encoder(s).put_uint32(uint32_t(count));
+    });
+
+    cmd.server.log("reported");
+
+    cmd.nak("done");
+}
+
+static void later(Bramble::Server::Command& cmd, const Bramble::Argument&)
+{
+    deferred = cmd.defer();
+}
+
+static constexpr Bramble::Registry::Entry commands[] = {
+    {"echo", echo},
+    {"report", report},
+    {"later", later}
+};
+
+static constexpr auto registry = Bramble::Registry::make(commands);
+
+class Host : public Bramble::Server::Host {
+public:
+
+    char output[1024];
+    size_t size = 0;
+
+    bool call(Bramble::Server::Command& cmd, const Bramble::Argument& args)
+    {
+        return registry.call(cmd, args);
+    }
+
+    void write(const char *buffer, size_t n)
+    {
+        n = std::min(n, sizeof(output) - size);
+
+        (void)memcpy(&output[size], buffer, n);
+        size += n;
+    }
+
+    std::string str() const
+    {
+        return std::string(output, size);
+    }
+};
+
+static void process(Bramble::Server& server, const char *s)
+{
+    server.process(s, strlen(s));
+}
+
+TEST(StaticServer, shall_use_inline_storage)
+{
+    Host host;
+    Bramble::StaticServer<16, 2> server(host, 3);
+
+    ASSERT_EQ(16U, server.max_line_size());
+    ASSERT_EQ(3U, server.session());
+
+    process(server, "echo a b c\r");
+
+    ASSERT_EQ("CMD:echo a b c\r\nACK:echo a b c \r\n", host.str());
+}
+
+TEST(StaticServer, shall_work_without_index)
+{
+    Host host;
+    Bramble::StaticServer<16, 0> server(host);
+
+    process(server, "echo a b\r");
+
+    ASSERT_EQ("CMD:echo a b\r\nACK:echo a b \r\n", host.str());
+}
+
+TEST(StaticServer, shall_not_allocate)
+{
+    static Host host;
+    static Bramble::StaticServer<64, 8> server(host);
+    static Bramble::LineQueue<2, 64> queue;
+    static Bramble::EventQueue<4, 32> events;
+
+    counting = true;
+    allocations = 0;
+
+    process(server, "echo#1 one \"two three\"\r");
+    process(server, "report#2 x y\r");
+    process(server, "later#3\r");
+
+    deferred.ack([](Bramble::Stream& s){
+
+        Bramble::Encoder(s).put_string("ok");
+    });
+
+    (void)server.set_queue(&queue);
+    server.set_events(&events);
+
+    (void)events.event("async", [](Bramble::Stream& s){
+
+        Bramble::Encoder(s).put_uint8(1);
+    });
+
+    process(server, "echo#4\r");
+
+    while(server.step());
+
+    counting = false;
+
+    ASSERT_EQ(0U, allocations);
+
+    ASSERT_EQ(
+        "CMD:echo#1 one \"two three\"\r\nACK:echo#1 one two three \r\n"
+        "CMD:report#2 x y\r\nEVT: report 2\r\nLOG: reported\r\nNAK:report#2 done\r\n"
+        "CMD:later#3\r\n"
+        "ACK:later#3 ok\r\n"
+        "EVT: async 1\r\n"
+        "CMD:echo#4\r\nACK:echo#4 \r\n",
+        host.str()
+    );
+}
+
+TEST(FunctionRef, shall_call_function_and_closure)
+{
+    int calls = 0;
+
+    auto closure = [&calls](int x){ calls += x; };
+
+    Bramble::FunctionRef<void(int)> a(closure);
+
+    a(2);
+
+    ASSERT_EQ(2, calls);
+
+    struct F {
+
+        static int twice(int x)
+        {
+            return x * 2;
+        }
+    };
+
+    Bramble::FunctionRef<int(int)> b(F::twice);
+
+    ASSERT_EQ(8, b(4));
+}
+
+int main(int argc, char **argv)
+{
+    testing::InitGoogleTest(&argc, argv);
+
+    return RUN_ALL_TESTS();
+}
@@ -0,0 +1,205 @@
+#include "gtest/gtest.h"
+
+#include "bramble.hpp"
+
+#include <string>
+
+static Bramble::Loop loop;
+static bool ready;
+
+static Bramble::Task sync(Bramble::Server::Command& cmd, const Bramble::Argument&)
+{
+    cmd.nak("now");
+    co_return;
+}
+
+static Bramble::Task wait(Bramble::Server::Command&, const Bramble::Argument&)
+{
+    co_await loop.until([]{ return ready; });
+}
+
+static Bramble::Task steps(Bramble::Server::Command&, const Bramble::Argument& args)
+{
+    std::string name((*args.begin()).data(), (*args.begin()).size());
+
+    co_await loop.yield();
+    co_await loop.yield();
+
+    auto& done = co_await Bramble::Task::deferred();
+
+    done.ack([&name](Bramble::Stream& s){
+
+        Bramble::Encoder(s).put_string(name.c_str());
+    });
+}
+
+static Bramble::Task fail(Bramble::Server::Command&, const Bramble::Argument&)
+{
+    co_await loop.yield();
+
+    (co_await Bramble::Task::deferred()).nak("failed");
+}
+
+static Bramble::Loop *other_loop;
+static size_t frames_destroyed;
+
+struct FrameCounter {
+
+    ~FrameCounter()
+    {
+        frames_destroyed++;
+    }
+};
+
+static Bramble::Task hold(Bramble::Server::Command&, const Bramble::Argument&, Bramble::Loop& l)
+{
+    FrameCounter counter;
+
+    co_await l.until([]{ return false; });
+}
+
+class Host : public Bramble::Server::Host {
+public:
+
+    std::string output;
+
+    bool call(Bramble::Server::Command& cmd, const Bramble::Argument& args)
+    {
+        bool retval = true;
+
+        if(cmd.name() == "sync"){
+
+            sync(cmd, args);
+        }
+        else if(cmd.name() == "wait"){
+
+            wait(cmd, args);
+        }
+        else if(cmd.name() == "steps"){
+
+            steps(cmd, args);
+        }
+        else if(cmd.name() == "fail"){
+
+            fail(cmd, args);
+        }
+        else if(cmd.name() == "hold"){
+
+            hold(cmd, args, *other_loop);
+        }
+        else{
+
+            retval = false;
+        }
+
+        return retval;
+    }
+
+    void write(const char *buffer, size_t size)
+    {
+        output.append(buffer, size);
+    }
+};
+
+static void process(Bramble::Server& server, const char *s)
+{
+    server.process(s, strlen(s));
+}
+
+TEST(Task, shall_respond_without_suspending)
+{
+    Host host;
+    Bramble::Server server(host);
+
+    process(server, "sync\r");
+
+    ASSERT_EQ("CMD:sync\r\nNAK:sync now\r\n", host.output);
+    ASSERT_EQ(0U, loop.size());
+}
+
+TEST(Task, shall_not_suspend_if_ready)
+{
+    Host host;
+    Bramble::Server server(host);
+
+    ready = true;
+
+    process(server, "wait\r");
+
+    ASSERT_EQ("CMD:wait\r\nACK:wait\r\n", host.output);
+    ASSERT_EQ(0U, loop.size());
+}
+
+TEST(Task, shall_ack_when_resumed)
+{
+    Host host;
+    Bramble::Server server(host);
+
+    ready = false;
+
+    process(server, "wait#1\rwait#2\r");
+
+    ASSERT_EQ("CMD:wait#1\r\nCMD:wait#2\r\n", host.output);
+    ASSERT_EQ(2U, loop.size());
+
+    ASSERT_EQ(0U, loop.poll());
+
+    ready = true;
+
+    ASSERT_EQ(2U, loop.poll());
+    ASSERT_EQ(0U, loop.size());
+
+    ASSERT_EQ("CMD:wait#1\r\nCMD:wait#2\r\nACK:wait#1\r\nACK:wait#2\r\n", host.output);
+}
+
+TEST(Task, shall_keep_many_in_flight)
+{
+    Host host;
+    Bramble::Server server(host);
+
+    process(server, "steps#1 a\rfail#2\rsteps#3 b\r");
+
+    ASSERT_EQ(3U, loop.size());
+
+    ASSERT_EQ(3U, loop.poll());
+    ASSERT_EQ(2U, loop.poll());
+    ASSERT_EQ(0U, loop.poll());
+
+    ASSERT_EQ(
+        "CMD:steps#1 a\r\nCMD:fail#2\r\nCMD:steps#3 b\r\n"
+        "NAK:fail#2 failed\r\n"
+        "ACK:steps#1 a\r\nACK:steps#3 b\r\n",
+        host.output
+    );
+}
+
+TEST(Task, shall_destroy_waiting_on_loop_destruction)
+{
+    Host host;
+    Bramble::Server server(host);
+
+    frames_destroyed = 0;
+
+    {
+        Bramble::Loop l;
+
+        other_loop = &l;
+
+        process(server, "hold#1\rhold#2\r");
+
+        ASSERT_EQ(2U, l.size());
+        ASSERT_EQ(0U, frames_destroyed);
+    }
+
+    other_loop = nullptr;
+
+    ASSERT_EQ(2U, frames_destroyed);
+    ASSERT_EQ("CMD:hold#1\r\nCMD:hold#2\r\n", host.output);
+}
+
+int main(int argc, char **argv)
+{
+    testing::InitGoogleTest(&argc, argv);
+
+    return RUN_ALL_TESTS();
+}
@@ -0,0 +1,159 @@
+#!/usr/bin/env ruby
+
+require 'json'
+require 'optparse'
+
+# Compare Google Benchmark JSON output against a baseline
+class BenchCompare
+
+  VERSION = "0.1.0"
+
+  # nanoseconds per time unit
+  UNITS = {"ns" => 1.0, "us" => 1e3, "ms" => 1e6, "s" => 1e9}
+
+  Result = Struct.new(:name, :baseline, :current) do
+
+    # current time as a fraction of baseline time (> 1.0 is slower)
+    def ratio
+      current / baseline
+    end
+
+  end
+
+  def initialize(**opts)
+
+    @threshold = opts[:threshold]||0.10
+    @allow_missing = opts[:allow_missing]||false
+    @output = opts[:output]||STDOUT
+
+  end
+
+  # load per benchmark cpu time (ns) from a JSON file
+  #
+  # The median aggregate is used when the file was produced with repetitions.
+  def load(file_name)
+
+    entries = JSON.parse(File.read(file_name))["benchmarks"]||[]
+
+    medians = entries.select { |b| b["aggregate_name"] == "median" }
+
+    (medians.empty? ? entries.select { |b| b["run_type"] != "aggregate" } : medians).map do |b|
+
+      [b["run_name"]||b["name"], b["cpu_time"] * UNITS.fetch(b["time_unit"]||"ns")]
+
+    end.to_h
+
+  end
+
+  # compare each pair of files and return true if nothing regressed or went missing
+  def run(pairs)
+
+    regressions = 0
+    missing = 0
+
+    pairs.each do |baseline_file, current_file|
+
+      baseline = load(baseline_file)
+      current = load(current_file)
+
+      @output.puts File.basename(current_file)
+      @output.puts format("  %-48s %12s %12s", "(cpu ns)", "baseline", "current")
+
+      (baseline.keys | current.keys).each do |name|
+
+        if !baseline.key?(name)
+
+          @output.puts format("  %-48s %12s %12.1f  new", name, "-", current[name])
+
+        elsif !current.key?(name)
+
+          missing += 1
+
+          @output.puts format("  %-48s %12.1f %12s  MISSING", name, baseline[name], "-")
+
+        else
+
+          r = Result.new(name, baseline[name], current[name])
+
+          status = if r.ratio > (1.0 + @threshold)
+            regressions += 1
+            "REGRESSED"
+          elsif r.ratio < (1.0 - @threshold)
+            "improved"
+          else
+            ""
+          end
+
+          @output.puts format("  %-48s %12.1f %12.1f %+7.1f%%  %s", name, r.baseline, r.current, (r.ratio - 1.0) * 100.0, status).rstrip
+
+        end
+
+      end
+
+    end
+
+    @output.puts "#{regressions} regression(s) beyond #{(@threshold * 100.0).round}%"
+    @output.puts "#{missing} benchmark(s) missing from current results#{@allow_missing ? " (allowed)" : ""}"
+
+    (regressions == 0) && (@allow_missing || (missing == 0))
+
+  end
+
+end
+
+threshold = 0.10
+allow_missing = false
+baseline_dir = nil
+
+OptionParser.new do |opts|
+
+  opts.banner = "bench_compare v#{BenchCompare::VERSION}"
+
+  opts.separator ""
+  opts.separator "Usage: #{File.basename(__FILE__)} [options] --baseline=DIR <current1.json> <current2.json> ..."
+  opts.separator ""
+  opts.separator "Compares cpu time (ns) of each benchmark against the file of the same name in DIR."
+  opts.separator "Exits with status 1 if any benchmark is slower than the threshold allows"
+  opts.separator "or is in the baseline but missing from the current results."
+  opts.separator ""
+  opts.separator "Options:"
+  opts.separator ""
+
+  opts.on("-h", "--help", "Prints this help") do
+    puts opts
+    exit
+  end
+
+  opts.on("-b=DIR", "--baseline=DIR", "Directory of baseline JSON files") do |n|
+
+    baseline_dir = n
+
+  end
+
+  opts.on("-t=PERCENT", "--threshold=PERCENT", Float, "Allowed slowdown in percent (default 10)") do |n|
+
+    threshold = n / 100.0
+
+  end
+
+  opts.on("-m", "--allow-missing", "Do not fail when a baseline benchmark is missing") do
+
+    allow_missing = true
+
+  end
+
+end.parse!
+
+abort("baseline directory is required") if baseline_dir.nil?
+
+pairs = ARGV.map do |f|
+
+  baseline = File.join(baseline_dir, File.basename(f))
+
+  abort("no baseline for #{f} (#{baseline})") unless File.exist?(baseline)
+
+  [baseline, f]
+
+end
+
+exit(BenchCompare.new(threshold: threshold, allow_missing: allow_missing).run(pairs) ? 0 : 1)
@@ -0,0 +1,891 @@
+#include "bramble.hpp"
+
+#include <algorithm>
+#include <atomic>
+#include <cerrno>
+#include <chrono>
+#include <cmath>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <fstream>
+#include <map>
+#include <memory>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include <fcntl.h>
+#include <poll.h>
+#include <sys/socket.h>
+#include <termios.h>
+#include <unistd.h>
+
+// Drives a Bramble::Server with a command script and reports throughput and
+// latency percentiles. See readme.md.
+
+using Overflow = Bramble::Server::Queue::Overflow;
+
+struct Config {
+
+    std::string transport = "memory";
+    std::string script;
+    size_t count = 100000;
+    double rate = 0.0;
+    size_t concurrency = 1;
+    size_t max_line = 1024;
+    size_t max_args = 32;
+    size_t queue = 0;
+    Overflow overflow = Overflow::Reject;
+    size_t chunk = 256;
+    double timeout = 2.0;
+    bool help = false;
+    bool error = false;
+};
+
+static int64_t now_ns()
+{
+    return std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now().time_since_epoch()).count();
+}
+
+/*
+ * Commands served by the server under test
+ *
+ * */
+
+static void noop(Bramble::Server::Command&, const Bramble::Argument&)
+{
+}
+
+static void echo(Bramble::Server::Command& cmd, const Bramble::Argument& args)
+{
+    Bramble::Encoder encoder(cmd.ack_with_arg());
+
+    for(auto iter = args.begin() + 1; iter != args.end(); ++iter){
+
+        encoder.put_string(*iter).space();
+    }
+}
+
+struct Transmit {
+
+    uint32_t freq;
+    int8_t dbm;
+    uint8_t sf;
+};
+
+using TransmitSchema = Bramble::Schema<Transmit>;
+
+static constexpr TransmitSchema::Field transmit_fields[] = {
+    TransmitSchema::required<Bramble::Range<uint32_t, 863000000, 870000000>, &Transmit::freq>("freq"),
+    TransmitSchema::optional<Bramble::Range<int8_t, -10, 20>, &Transmit::dbm>("dbm"),
+    TransmitSchema::required<Bramble::Range<uint8_t, 7, 12>, &Transmit::sf>("sf")
+};
+
+static constexpr auto transmit_schema = TransmitSchema::make(transmit_fields);
+
+static void tx(Bramble::Server::Command& cmd, const Bramble::Argument& args)
+{
+    Transmit t = {0, 14, 0};
+
+    if(transmit_schema.bind(cmd, args, t)){
+
+        cmd.ack(Bramble::kv("freq", t.freq));
+    }
+}
+
+struct Work {
+
+    uint32_t us;
+};
+
+using WorkSchema = Bramble::Schema<Work>;
+
+static constexpr WorkSchema::Field work_fields[] = {
+    WorkSchema::required<Bramble::Range<uint32_t, 0, 1000000>, &Work::us>("us")
+};
+
+static constexpr auto work_schema = WorkSchema::make(work_fields);
+
+// busy for a number of microseconds to stand in for a slow handler
+static void work(Bramble::Server::Command& cmd, const Bramble::Argument& args)
+{
+    Work w = {0};
+
+    if(work_schema.bind(cmd, args, w)){
+
+        auto until = now_ns() + (int64_t(w.us) * 1000);
+
+        while(now_ns() < until);
+    }
+}
+
+static constexpr Bramble::Registry::Entry commands[] = {
+    {"noop", noop},
+    {"echo", echo},
+    {"tx", tx},
+    {"work", work}
+};
+
+static constexpr auto registry = Bramble::Registry::make(commands);
+
+static const char *default_script[] = {
+    "tx freq=868100000 dbm=14 sf=7",
+    "echo hello world",
+    "noop"
+};
+
+/*
+ * Client side
+ *
+ * */
+
+// matches responses to commands by invocation id
+class Tracker {
+public:
+
+    size_t acked = 0;
+    size_t naked = 0;
+    size_t unmatched = 0;
+    size_t rx_bytes = 0;
+
+    std::vector<int64_t> latency;
+    std::map<std::string, size_t> reasons;
+
+    Tracker(size_t count)
+        :
+        start(new std::atomic<int64_t>[count]),
+        answered(count, false),
+        count(count),
+        completed_count(0)
+    {
+        latency.reserve(count);
+    }
+
+    // record when command id was sent (writer context)
+    void sent(size_t id, int64_t t)
+    {
+        start[id].store(t, std::memory_order_release);
+    }
+
+    // number of commands that have been answered (any context)
+    size_t completed() const
+    {
+        return completed_count.load(std::memory_order_acquire);
+    }
+
+    // process output from the server (reader context)
+    void receive(const char *buffer, size_t size, int64_t now)
+    {
+        rx_bytes += size;
+        partial.append(buffer, size);
+
+        size_t begin = 0;
+
+        for(auto end = partial.find("\r\n"); end != std::string::npos; end = partial.find("\r\n", begin)){
+
+            line(Bramble::StringView(partial.data() + begin, end - begin), now);
+            begin = end + 2U;
+        }
+
+        partial.erase(0, begin);
+    }
+
+private:
+
+    std::unique_ptr<std::atomic<int64_t>[]> start;
+    std::vector<bool> answered;
+    size_t count;
+    std::atomic<size_t> completed_count;
+    std::string partial;
+
+    void line(const Bramble::StringView& l, int64_t now)
+    {
+        bool ack = (l.substr(0, 4) == Bramble::StringView("ACK:"));
+        bool nak = (l.substr(0, 4) == Bramble::StringView("NAK:"));
+
+        if(ack || nak){
+
+            auto rest = l.substr(4);
+            auto space = rest.find_first_of(' ');
+            auto name = rest.substr(0, space);
+            auto hash = name.find_first_of('#');
+            uint64_t id;
+
+            if((hash != name.npos) && Bramble::Decoder(name.substr(hash + 1U)).get_uint64(id) && (id < count) && !answered[id]){
+
+                answered[id] = true;
+                latency.push_back(now - start[id].load(std::memory_order_acquire));
+
+                if(ack){
+
+                    acked++;
+                }
+                else{
+
+                    auto reason = (space != rest.npos) ? rest.substr(space + 1U) : Bramble::StringView();
+
+                    naked++;
+                    reasons[std::string(reason.data(), reason.size())]++;
+                }
+
+                completed_count.fetch_add(1, std::memory_order_release);
+            }
+            else{
+
+                unmatched++;
+            }
+        }
+    }
+};
+
+// produces tagged command lines at the configured rate and concurrency
+class Generator {
+public:
+
+    size_t lost = 0;
+    size_t tx_bytes = 0;
+
+    Generator(const std::vector<std::string>& script, const Config& config, Tracker& tracker)
+        :
+        script(script),
+        config(config),
+        tracker(tracker),
+        period((config.rate > 0.0) ? int64_t(1e9 / config.rate) : 0),
+        due(0),
+        sent_count(0)
+    {
+    }
+
+    // number of commands that have been sent (any context)
+    size_t sent() const
+    {
+        return sent_count.load(std::memory_order_acquire);
+    }
+
+    void begin(int64_t now)
+    {
+        due = now;
+    }
+
+    // every command has been sent (any context)
+    bool done() const
+    {
+        return sent() == config.count;
+    }
+
+    // commands sent but not yet answered or given up on (writer context)
+    size_t in_flight() const
+    {
+        return sent() - lost - tracker.completed();
+    }
+
+    // give up on every command in flight
+    void abandon()
+    {
+        lost += in_flight();
+    }
+
+    // time at which the next command may be sent
+    int64_t next_due() const
+    {
+        return due;
+    }
+
+    // append every command that may be sent now to out (writer context)
+    void fill(std::string& out, int64_t now)
+    {
+        while(!done() && (in_flight() < config.concurrency) && ((period == 0) || (now >= due))){
+
+            auto id = sent();
+            auto& line = script[id % script.size()];
+            auto split = std::min(line.find(' '), line.size());
+
+            // latency is measured from when the command was due so that a
+            // slow server cannot hide its backlog
+            tracker.sent(id, (period > 0) ? due : now);
+
+            out.append(line, 0, split);
+            out.append("#");
+            out.append(std::to_string(id));
+            out.append(line, split, std::string::npos);
+            out.append("\r");
+
+            sent_count.store(id + 1U, std::memory_order_release);
+            due += period;
+        }
+
+        tx_bytes += out.size();
+    }
+
+private:
+
+    const std::vector<std::string>& script;
+    const Config& config;
+    Tracker& tracker;
+    int64_t period;
+    int64_t due;
+    std::atomic<size_t> sent_count;
+};
+
+/*
+ * Server side
+ *
+ * */
+
+// line queue with a depth chosen at run time
+class RuntimeQueueStorage {
+protected:
+
+    std::vector<char> lines;
+
+    RuntimeQueueStorage(size_t depth, size_t max_line)
+        :
+        lines(depth * (max_line + 1U))
+    {
+    }
+};
+
+class RuntimeQueue : private RuntimeQueueStorage, public Bramble::Server::Queue {
+public:
+
+    RuntimeQueue(size_t depth, size_t max_line, Overflow overflow)
+        :
+        RuntimeQueueStorage(depth, max_line),
+        Queue(lines.data(), depth, max_line, overflow)
+    {
+    }
+};
+
+// a host that hands output straight to the tracker
+class MemoryHost : public Bramble::Server::Host {
+public:
+
+    MemoryHost(Tracker& tracker)
+        :
+        tracker(tracker)
+    {
+    }
+
+    bool call(Bramble::Server::Command& cmd, const Bramble::Argument& args)
+    {
+        return registry.call(cmd, args);
+    }
+
+    void write(const char *buffer, size_t size)
+    {
+        tracker.receive(buffer, size, now_ns());
+    }
+
+private:
+
+    Tracker& tracker;
+};
+
+// a host that writes output to a file descriptor
+class FdHost : public Bramble::Server::Host {
+public:
+
+    FdHost(int fd)
+        :
+        fd(fd)
+    {
+    }
+
+    bool call(Bramble::Server::Command& cmd, const Bramble::Argument& args)
+    {
+        return registry.call(cmd, args);
+    }
+
+    void write(const char *buffer, size_t size)
+    {
+        write_all(fd, buffer, size);
+    }
+
+    static void write_all(int fd, const char *buffer, size_t size)
+    {
+        while(size > 0){
+
+            auto n = ::write(fd, buffer, size);
+
+            if(n > 0){
+
+                buffer += n;
+                size -= size_t(n);
+            }
+            else if((n < 0) && (errno != EINTR) && (errno != EAGAIN)){
+
+                break;
+            }
+        }
+    }
+
+private:
+
+    int fd;
+};
+
+static void deliver(Bramble::Server& server, const std::string& input, size_t chunk)
+{
+    for(size_t i = 0; i < input.size(); i += chunk){
+
+        server.process(input.data() + i, std::min(chunk, input.size() - i));
+    }
+}
+
+static void drain_queue(Bramble::Server& server)
+{
+    while(server.step());
+}
+
+/*
+ * Transports
+ *
+ * */
+
+static bool run_memory(const Config& config, Generator& generator, Tracker& tracker, Bramble::Server::Queue *queue)
+{
+    MemoryHost host(tracker);
+    Bramble::Server server(host, config.max_line, config.max_args);
+    std::string out;
+    bool retval = (queue == nullptr) || server.set_queue(queue);
+
+    generator.begin(now_ns());
+
+    while(retval && !generator.done()){
+
+        out.clear();
+
+        generator.fill(out, now_ns());
+
+        if(out.empty()){
+
+            // rate limited: wait until the next command is due
+            while(now_ns() < generator.next_due());
+        }
+
+        deliver(server, out, config.chunk);
+        drain_queue(server);
+
+        // every line has been dispatched and every dispatched or dropped line
+        // is answered, so anything unanswered was ignored by the server
+        // (e.g. longer than max_line)
+        generator.abandon();
+    }
+
+    return retval;
+}
+
+static bool open_socketpair(int& client, int& server)
+{
+    int fd[2];
+    bool retval = (socketpair(AF_UNIX, SOCK_STREAM, 0, fd) == 0);
+
+    if(retval){
+
+        client = fd[0];
+        server = fd[1];
+    }
+
+    return retval;
+}
+
+// pseudo terminal in raw mode (no line discipline) standing in for a UART
+static bool open_pty(int& client, int& server)
+{
+    bool retval = false;
+    int master = posix_openpt(O_RDWR | O_NOCTTY);
+
+    if((master >= 0) && (grantpt(master) == 0) && (unlockpt(master) == 0)){
+
+        int slave = open(ptsname(master), O_RDWR | O_NOCTTY);
+        struct termios t;
+
+        if((slave >= 0) && (tcgetattr(slave, &t) == 0)){
+
+            cfmakeraw(&t);
+
+            if(tcsetattr(slave, TCSANOW, &t) == 0){
+
+                client = master;
+                server = slave;
+                retval = true;
+            }
+        }
+    }
+
+    return retval;
+}
+
+static bool run_fd(const Config& config, Generator& generator, Tracker& tracker, Bramble::Server::Queue *queue)
+{
+    int client_fd = -1;
+    int server_fd = -1;
+    bool retval = (config.transport == "pty") ? open_pty(client_fd, server_fd) : open_socketpair(client_fd, server_fd);
+    std::atomic<bool> stop(false);
+
+    if(!retval){
+
+        fprintf(stderr, "error: cannot open %s: %s\n", config.transport.c_str(), strerror(errno));
+    }
+    else{
+
+        FdHost host(server_fd);
+        Bramble::Server server(host, config.max_line, config.max_args);
+
+        retval = (queue == nullptr) || server.set_queue(queue);
+
+        std::thread server_thread([&](){
+
+            std::vector<char> buffer(config.chunk);
+            struct pollfd p = {server_fd, POLLIN, 0};
+
+            while(!stop.load()){
+
+                if(poll(&p, 1, 10) > 0){
+
+                    auto n = read(server_fd, buffer.data(), buffer.size());
+
+                    if(n > 0){
+
+                        server.process(buffer.data(), size_t(n));
+                        drain_queue(server);
+                    }
+                }
+            }
+        });
+
+        std::thread writer_thread([&](){
+
+            std::string out;
+
+            generator.begin(now_ns());
+
+            while(!generator.done() && !stop.load()){
+
+                out.clear();
+
+                generator.fill(out, now_ns());
+
+                if(out.empty()){
+
+                    std::this_thread::yield();
+                }
+                else{
+
+                    FdHost::write_all(client_fd, out.data(), out.size());
+                }
+            }
+        });
+
+        std::vector<char> buffer(4096);
+        struct pollfd p = {client_fd, POLLIN, 0};
+        int64_t last = now_ns();
+
+        // read until every command is answered or nothing has arrived for a while
+        while(!(generator.done() && (tracker.completed() == generator.sent())) && ((now_ns() - last) < int64_t(config.timeout * 1e9))){
+
+            if(generator.sent() == tracker.completed()){
+
+                // nothing outstanding: waiting on the rate, not the server
+                last = now_ns();
+            }
+
+            if(poll(&p, 1, 10) > 0){
+
+                auto n = read(client_fd, buffer.data(), buffer.size());
+
+                if(n > 0){
+
+                    last = now_ns();
+                    tracker.receive(buffer.data(), size_t(n), last);
+                }
+            }
+        }
+
+        stop.store(true);
+
+        writer_thread.join();
+        server_thread.join();
+
+        close(client_fd);
+        close(server_fd);
+    }
+
+    return retval;
+}
+
+/*
+ * Report
+ *
+ * */
+
+static double percentile(const std::vector<int64_t>& sorted, double p)
+{
+    double retval = 0.0;
+
+    if(!sorted.empty()){
+
+        // nearest rank (the epsilon stops p * n rounding up to the next rank)
+        auto rank = size_t(std::ceil((p * double(sorted.size())) - 1e-9));
+
+        retval = double(sorted[std::min(std::max(rank, size_t(1)), sorted.size()) - 1U]) / 1e3;
+    }
+
+    return retval;
+}
+
+static void report(const Config& config, const Generator& generator, Tracker& tracker, const Bramble::Server::Queue *queue, double elapsed)
+{
+    auto answered = tracker.acked + tracker.naked;
+
+    std::sort(tracker.latency.begin(), tracker.latency.end());
+
+    printf("transport      %s\n", config.transport.c_str());
+    printf("commands       %zu sent, %zu answered (%zu ACK, %zu NAK), %zu unanswered, %zu unmatched\n",
+        generator.sent(), answered, tracker.acked, tracker.naked, generator.sent() - answered, tracker.unmatched);
+    printf("elapsed        %.3f s\n", elapsed);
+    printf("throughput     %.0f commands/s\n", (elapsed > 0.0) ? (double(answered) / elapsed) : 0.0);
+    printf("bytes          %zu to server, %zu from server\n", generator.tx_bytes, tracker.rx_bytes);
+    printf("latency (us)   p50 %.1f  p99 %.1f  p999 %.1f  max %.1f\n",
+        percentile(tracker.latency, 0.5),
+        percentile(tracker.latency, 0.99),
+        percentile(tracker.latency, 0.999),
+        percentile(tracker.latency, 1.0));
+
+    if(queue != nullptr){
+
+        printf("queue          depth %zu, %zu dropped or rejected\n", queue->capacity(), queue->dropped());
+    }
+
+    for(auto& r : tracker.reasons){
+
+        printf("nak            %s: %zu\n", r.first.c_str(), r.second);
+    }
+}
+
+/*
+ * Options
+ *
+ * */
+
+static Config& config_of(Bramble::GetOpt& self)
+{
+    return *static_cast<Config *>(self.get_ctx());
+}
+
+static void set_size(Bramble::GetOpt& self, size_t& v, size_t min)
+{
+    uint64_t u;
+
+    if(Bramble::Decoder(self.value()).get_uint64(u) && (u >= min)){
+
+        v = size_t(u);
+    }
+    else{
+
+        fprintf(stderr, "error: --%.*s must be an integer >= %zu\n", (int)self.name().size(), self.name().data(), min);
+        config_of(self).error = true;
+    }
+}
+
+static void set_seconds(Bramble::GetOpt& self, double& v)
+{
+    double d;
+
+    if(Bramble::Decoder(self.value()).get_double(d) && (d >= 0.0)){
+
+        v = d;
+    }
+    else{
+
+        fprintf(stderr, "error: --%.*s must be a number >= 0\n", (int)self.name().size(), self.name().data());
+        config_of(self).error = true;
+    }
+}
+
+static const Bramble::GetOpt::Option options[] = {
+    {"help", 'h', Bramble::GetOpt::Value::None, [](Bramble::GetOpt& self){ config_of(self).help = true; self.stop(); }},
+    {"transport", 't', Bramble::GetOpt::Value::Required, [](Bramble::GetOpt& self){ config_of(self).transport = std::string(self.value().data(), self.value().size()); }},
+    {"script", 's', Bramble::GetOpt::Value::Required, [](Bramble::GetOpt& self){ config_of(self).script = std::string(self.value().data(), self.value().size()); }},
+    {"count", 'n', Bramble::GetOpt::Value::Required, [](Bramble::GetOpt& self){ set_size(self, config_of(self).count, 1); }},
+    {"rate", 'r', Bramble::GetOpt::Value::Required, [](Bramble::GetOpt& self){ set_seconds(self, config_of(self).rate); }},
+    {"concurrency", 'c', Bramble::GetOpt::Value::Required, [](Bramble::GetOpt& self){ set_size(self, config_of(self).concurrency, 1); }},
+    {"max-line", 'l', Bramble::GetOpt::Value::Required, [](Bramble::GetOpt& self){ set_size(self, config_of(self).max_line, 1); }},
+    {"max-args", 'a', Bramble::GetOpt::Value::Required, [](Bramble::GetOpt& self){ set_size(self, config_of(self).max_args, 0); }},
+    {"queue", 'q', Bramble::GetOpt::Value::Required, [](Bramble::GetOpt& self){ set_size(self, config_of(self).queue, 0); }},
+    {"overflow", 'o', Bramble::GetOpt::Value::Required, [](Bramble::GetOpt& self)
+        {
+            auto& c = config_of(self);
+
+            if(self.value() == Bramble::StringView("reject")){
+
+                c.overflow = Overflow::Reject;
+            }
+            else if(self.value() == Bramble::StringView("drop_newest")){
+
+                c.overflow = Overflow::DropNewest;
+            }
+            else if(self.value() == Bramble::StringView("drop_oldest")){
+
+                c.overflow = Overflow::DropOldest;
+            }
+            else{
+
+                fprintf(stderr, "error: --overflow must be reject, drop_newest or drop_oldest\n");
+                c.error = true;
+            }
+        }
+    },
+    {"chunk", 'k', Bramble::GetOpt::Value::Required, [](Bramble::GetOpt& self){ set_size(self, config_of(self).chunk, 1); }},
+    {"timeout", 'w', Bramble::GetOpt::Value::Required, [](Bramble::GetOpt& self){ set_seconds(self, config_of(self).timeout); }}
+};
+
+static void usage()
+{
+    printf("bramble_load (Bramble v%s)\n", Bramble::get_version_string());
+    printf("\n");
+    printf("./bin/bramble_load [options]\n");
+    printf("\n");
+    printf("  --transport -t    memory, socketpair or pty (default memory)\n");
+    printf("  --script -s       file of command lines to replay (default built in)\n");
+    printf("  --count -n        commands to send (default 100000)\n");
+    printf("  --rate -r         commands per second (default 0, as fast as possible)\n");
+    printf("  --concurrency -c  commands in flight (default 1)\n");
+    printf("  --max-line -l     server max_line (default 1024)\n");
+    printf("  --max-args -a     server max_args (default 32)\n");
+    printf("  --queue -q        server line queue depth (default 0, no queue)\n");
+    printf("  --overflow -o     reject, drop_newest or drop_oldest (default reject)\n");
+    printf("  --chunk -k        bytes per Server::process() call (default 256)\n");
+    printf("  --timeout -w      seconds to wait for outstanding responses (default 2)\n");
+    printf("  --help -h         print this help\n");
+    printf("\n");
+    printf("Commands served: noop, echo, tx freq= dbm= sf=, work us=\n");
+}
+
+static bool load_script(const Config& config, std::vector<std::string>& script)
+{
+    bool retval = true;
+
+    if(config.script.empty()){
+
+        script.assign(std::begin(default_script), std::end(default_script));
+    }
+    else{
+
+        std::ifstream in(config.script);
+        std::string line;
+
+        while(std::getline(in, line)){
+
+            // blank lines and lines starting with ';' are skipped
+            auto first = line.find_first_not_of(" \t\r");
+
+            if((first != std::string::npos) && (line[first] != ';')){
+
+                script.push_back(line.substr(first, line.find_last_not_of(" \t\r") + 1U - first));
+            }
+        }
+
+        retval = in.eof() && !script.empty();
+
+        if(!retval){
+
+            fprintf(stderr, "error: cannot read commands from '%s'\n", config.script.c_str());
+        }
+    }
+
+    return retval;
+}
+
+int main(int argc, char **argv)
+{
+    Config config;
+
+    size_t max_working = 1;
+
+    for(auto iter = argv + 1; iter != (argv + argc); ++iter){
+
+        max_working += strlen(*iter) + 1U;
+    }
+
+    std::vector<char> working(max_working);
+
+    Bramble::Argument arg(argc-1, (const char **)argv+1, working.data(), working.size());
+    Bramble::GetOpt opt(arg.begin(), arg.end(), options, sizeof(options)/sizeof(*options));
+
+    opt.set_ctx(&config);
+
+    while(!opt.finished() && !config.error){
+
+        opt.next();
+
+        if(opt.unknown()){
+
+            fprintf(stderr, "error: option '%.*s' is unknown\n", (int)opt.name().size(), opt.name().data());
+            config.error = true;
+        }
+        else if(opt.missing()){
+
+            fprintf(stderr, "error: option '%.*s' requires a value\n", (int)opt.name().size(), opt.name().data());
+            config.error = true;
+        }
+        else if(opt.unexpected()){
+
+            fprintf(stderr, "error: option '%.*s' does not take a value\n", (int)opt.name().size(), opt.name().data());
+            config.error = true;
+        }
+    }
+
+    if(!config.error && (config.transport != "memory") && (config.transport != "socketpair") && (config.transport != "pty")){
+
+        fprintf(stderr, "error: --transport must be memory, socketpair or pty\n");
+        config.error = true;
+    }
+
+    std::vector<std::string> script;
+    int retval = 0;
+
+    if(config.help){
+
+        usage();
+    }
+    else if(config.error || !load_script(config, script)){
+
+        retval = 1;
+    }
+    else{
+
+        Tracker tracker(config.count);
+        Generator generator(script, config, tracker);
+        std::unique_ptr<RuntimeQueue> queue((config.queue > 0) ? new RuntimeQueue(config.queue, config.max_line, config.overflow) : nullptr);
+
+        auto start = now_ns();
+
+        bool ok = (config.transport == "memory")
+            ?
+            run_memory(config, generator, tracker, queue.get())
+            :
+            run_fd(config, generator, tracker, queue.get());
+
+        auto elapsed = double(now_ns() - start) / 1e9;
+
+        if(ok){
+
+            report(config, generator, tracker, queue.get(), elapsed);
+
+            if(generator.sent() < config.count){
+
+                fprintf(stderr, "error: %zu of %zu commands were not sent before --timeout expired\n", config.count - generator.sent(), config.count);
+                retval = 1;
+            }
+        }
+        else{
+
+            fprintf(stderr, "error: server could not be set up\n");
+            retval = 1;
+        }
+    }
+
+    return retval;
+}